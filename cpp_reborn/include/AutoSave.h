@@ -0,0 +1,91 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+
+// 自动存档的时机与预算 (只做决定，存档本身由 GameManager 完成)
+// 原版在进入场景时同步写自动档 (SaveR(6))。这里在场景切换或定时器到期后的第一个
+// 安全时机 (大地图/场景中行走，没有存档在写) 拍一份内存快照，写盘交给后台存档线程：
+//   - 主线程只复制内存中的数据 (驻留或改动过的场景、各表)，未驻留的场景由写盘线程读。
+//     预计复制时间 (按上次快照的速度估算) 超过 frameBudgetMs 时两种触发都推迟。
+//   - 两次自动存档至少间隔 minGapMs；最近一分钟写盘的字节数和写盘线程耗时超过预算时推迟。
+//   - 存档位在 firstSlot .. firstSlot + slotCount - 1 之间轮换。
+struct AutoSaveConfig {
+    int firstSlot = 6;                  // 原版的 "自動檔"
+    int slotCount = 1;                  // 0: autosave off
+    uint64_t intervalMs = 5 * 60 * 1000; // timer trigger, 0: scene changes only
+    uint64_t minGapMs = 60 * 1000;
+    double frameBudgetMs = 4.0;         // main thread time allowed for the snapshot
+    uint64_t ioBytesPerMinute = 64ull * 1024 * 1024; // 0: unlimited
+    double ioMsPerMinute = 2000.0;      // write thread time per minute, 0: unlimited
+};
+
+class AutoSaveScheduler {
+public:
+    enum class Trigger { None, SceneChange, Timer };
+
+    struct Stats {
+        int saves = 0;              // snapshots taken
+        int failures = 0;           // writes that failed
+        int deferred = 0;           // triggers that had to wait (writer, gap, frame or I/O budget)
+        int dropped = 0;            // scene changes inside the minimum gap
+        double lastSnapshotMs = -1; // main thread, -1: none since reset()
+        uint64_t lastSnapshotBytes = 0;
+        double maxSnapshotMs = 0;
+        double totalSnapshotMs = 0;
+        double lastWriteMs = 0;     // write thread
+        double totalWriteMs = 0;
+        uint64_t lastBytes = 0;
+        uint64_t totalBytes = 0;
+        double writeMsLastMinute = 0;
+        uint64_t bytesLastMinute = 0;
+    };
+
+    // A scene change counts as one only if the save happens this soon after it
+    static constexpr uint64_t SCENE_CHANGE_GRACE_MS = 2000;
+
+    void setConfig(const AutoSaveConfig& config) { m_config = config; }
+    const AutoSaveConfig& config() const { return m_config; }
+    bool enabled() const { return m_config.slotCount > 0; }
+
+    // New game or load: the timer restarts and the snapshot cost is unknown again
+    void reset(uint64_t nowMs);
+    void onSceneChange(uint64_t nowMs);
+
+    // Copy speed assumed until a snapshot has been measured
+    static constexpr double DEFAULT_MS_PER_MIB = 1.0;
+
+    // Call at a safe point with the bytes a snapshot would copy on this thread.
+    // Returns what should be saved now (None: nothing, or wait).
+    Trigger poll(uint64_t nowMs, bool writerBusy, uint64_t snapshotBytes);
+    // Main thread time a snapshot of 'bytes' is expected to take
+    double estimateSnapshotMs(uint64_t bytes) const;
+
+    // Slot 'offset' places after the next one in the rotation (0: the next one)
+    int slotAt(int offset) const;
+    // A snapshot of 'bytes' for 'slot' was taken (and its write submitted) in 'snapshotMs'
+    void recordSnapshot(uint64_t nowMs, int slot, double snapshotMs, uint64_t bytes);
+    // The write finished (from the save worker's completion callback)
+    void recordWrite(uint64_t nowMs, bool ok, double writeMs, uint64_t bytes);
+
+    // Stats with the one-minute window brought up to 'nowMs'
+    Stats stats(uint64_t nowMs);
+
+private:
+    struct Write {
+        uint64_t atMs;
+        double ms;
+        uint64_t bytes;
+    };
+    void prune(uint64_t nowMs);
+    bool withinIoBudget() const;
+
+    AutoSaveConfig m_config;
+    Stats m_stats;
+    std::deque<Write> m_recent; // writes of the last minute
+    uint64_t m_lastSaveMs = 0;
+    uint64_t m_sceneChangeMs = 0;
+    bool m_sceneChangePending = false;
+    bool m_waiting = false;     // the pending trigger was already counted as deferred
+    int m_next = 0;             // rotation index of the next slot
+    double m_msPerMiB = DEFAULT_MS_PER_MIB;
+};
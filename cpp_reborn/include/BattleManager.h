@@ -4,8 +4,12 @@
 #include <vector>
 #include <cstdint>
 #include <string>
+#include <memory>
 #include "BattleRole.h"
 #include "WarData.h"
+#include "MappedFile.h"
+#include "GroupFile.h"
+#include "MemoryStats.h"
 
 class BattleManager {
 public:
@@ -26,6 +30,11 @@ public:
     // Load battle field map
     bool LoadBattleField(int fieldNum);
 
+    // 开发模式热重载: War.sta / warfld 变化后丢弃句柄，下次使用时重新打开
+    bool ReloadResource(const std::string& name);
+
+    void ReportMemory(MemoryStats& stats) const;
+
     // Accessors
     BattleRole& getBattleRole(int index);
     int getBattleRoleCount() const;
@@ -124,6 +133,10 @@ private:
     // Current War Data
     WarData m_warData;
 
+    // War.sta / warfld 只打开一次，之后每场战斗只做指针运算
+    MappedFile m_warSta;
+    std::shared_ptr<const GroupFile> m_warFld;
+
     // Helper to read War.sta file
     std::string m_warStaPath;
     std::string m_warFldIdxPath;
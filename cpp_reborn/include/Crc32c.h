@@ -0,0 +1,15 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+// CRC-32C (Castagnoli)，存档容器的块校验
+// 支持 SSE4.2 (x86/x64，运行时检测) 或 ARMv8 CRC 指令时用硬件计算，否则查表 (slicing-by-8)。
+class Crc32c {
+public:
+    // CRC of 'size' bytes. Pass a previous result as 'crc' to continue over more data.
+    static uint32_t compute(const void* data, size_t size, uint32_t crc = 0);
+    static uint32_t computeSoftware(const void* data, size_t size, uint32_t crc = 0);
+
+    // true if compute() uses the CPU's CRC instructions
+    static bool hardware();
+};
@@ -0,0 +1,127 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <utility>
+#include "SaveImage.h"
+
+// 存档 / 场景数据检查 (save_inspector, analyze_data 共用)
+// 不依赖 SDL 和 windows.h。输入用 SaveContainer::mapFile 映射 (压缩存档解包到内存)，
+// 一个文件一份报告，报告之间没有共享状态，可以按文件并行处理成千上万份玩家存档。
+// 输出为 JSON (一个数组) 或 CSV (一行一个文件)，顺序与输入顺序相同。
+
+// ranger.grp / R*.grp
+struct SaveReport {
+    struct Member {
+        int roleId = -1;
+        std::string name; // UTF-8
+        int level = 0;
+        int hp = 0;
+        int maxHp = 0;
+    };
+    struct Stack {
+        int itemId = -1;
+        int amount = 0;
+    };
+
+    std::string path;
+    bool ok = false;
+    std::string error;        // set when ok is false
+    size_t fileBytes = 0;     // on disk
+    size_t rawBytes = 0;      // after unpacking
+    bool compressed = false;
+
+    int inShip = 0;
+    int sceneId = -1;
+    std::string sceneName;    // UTF-8
+    int mapX = 0;
+    int mapY = 0;
+    int face = 0;
+    int time = 0;
+    std::vector<Member> team;
+    int itemKinds = 0;            // non-empty bag slots
+    long long itemTotal = 0;
+    std::vector<Stack> inventory; // the slots themselves, in bag order (withInventory only)
+
+    int roleCount = 0;
+    int itemCount = 0;
+    int sceneCount = 0;
+    int magicCount = 0;
+
+    std::vector<std::string> problems; // out of range ids, short file ...
+};
+
+// 一对场景数据: allsin.grp + alldef.grp 或 S<n>.grp + D<n>.grp
+struct SceneDataReport {
+    static constexpr int LAYERS = 6;
+
+    struct SceneStats {
+        int scene = 0;
+        int tiles[LAYERS] = {};  // non-zero cells per layer (layer 3: cells holding an event)
+        int events = 0;          // DData entries that are not all zero
+        int placed = 0;          // DData entries whose position is on the map
+        int stale = 0;           // layer-3 cells that disagree with the DData positions
+    };
+
+    std::string mapPath;
+    std::string eventPath;
+    bool ok = false;
+    std::string error;
+    bool compressed = false;   // either file is a container
+    int mapScenes = 0;
+    int eventScenes = 0;
+    std::vector<SceneStats> scenes; // scenes with any tile or event
+    long long events = 0;
+    long long stale = 0;
+
+    std::vector<std::string> problems;
+};
+
+class DataInspector {
+public:
+    enum class Format { Json, Csv };
+
+    // 'layout' comes from the ranger.idx next to the save (or one given on the command line)
+    static SaveReport inspectSave(const std::string& path, const SaveLayout& layout, bool withInventory = false);
+    static SceneDataReport inspectSceneData(const std::string& mapPath, const std::string& eventPath);
+
+    // Save files (ranger.grp, R<n>.grp) under 'root', recursively, sorted. A file is returned as is.
+    static std::vector<std::string> findSaves(const std::string& root);
+    // Scene data pairs under 'root': allsin.grp/alldef.grp and S<n>.grp/D<n>.grp in the same directory
+    static std::vector<std::pair<std::string, std::string>> findSceneData(const std::string& root);
+    // ranger.idx (or Ranger.idx / RANGER.IDX) in the save's directory or the nearest parent, empty if none
+    static std::string findLayout(const std::string& savePath);
+
+    static void write(std::ostream& out, const std::vector<SaveReport>& reports, Format format, bool withInventory = false);
+    static void write(std::ostream& out, const std::vector<SceneDataReport>& reports, Format format, bool withScenes = false);
+
+    // GBK (game data) to UTF-8. Bytes that cannot be converted become U+FFFD.
+    static std::string gbkToUtf8(const std::string& gbk);
+    static std::string jsonEscape(const std::string& utf8);
+    static std::string csvField(const std::string& utf8);
+
+    // fn(i) for i in [0, count) on 'jobs' threads (0: hardware_concurrency). Each index runs once.
+    template <typename Fn>
+    static void parallelFor(size_t count, unsigned jobs, Fn&& fn) {
+        if (jobs == 0) jobs = std::max(1u, std::thread::hardware_concurrency());
+        jobs = static_cast<unsigned>(std::min<size_t>(jobs, count));
+        if (jobs <= 1) {
+            for (size_t i = 0; i < count; ++i) fn(i);
+            return;
+        }
+        std::atomic<size_t> next{ 0 };
+        std::vector<std::thread> workers;
+        workers.reserve(jobs);
+        for (unsigned t = 0; t < jobs; ++t) {
+            workers.emplace_back([&]() {
+                for (size_t i = next++; i < count; i = next++) fn(i);
+            });
+        }
+        for (auto& w : workers) w.join();
+    }
+};
@@ -3,6 +3,8 @@
 #include <string>
 #include <cstdint>
 #include "GameTypes.h"
+#include "MappedFile.h"
+#include "MemoryStats.h"
 
 class EventManager {
 public:
@@ -15,6 +17,11 @@ public:
     bool LoadScripts();
     bool LoadDialogues();
 
+    // 开发模式热重载: kdef / talk / name 变化后重新加载
+    bool ReloadResource(const std::string& name);
+
+    void ReportMemory(MemoryStats& stats) const; // kdef / talk / name 映射
+
     void Instruct_JmpScene(int sceneId, int x, int y); // instruct_71 (Public for testing)
 
     // Event Handling
@@ -95,16 +102,16 @@ private:
     // Returns the value and increments offset
     // int16_t ReadScriptArg(int& offset); // Moved to public
 
-    // Data
-    std::vector<int16_t> m_eventScripts; // kdef.grp (viewed as int16)
-    std::vector<int32_t> m_eventIndices; // kdef.idx
+    // Data (只读，直接映射，不复制到堆上)
+    MappedFile::View<int16_t> m_eventScripts; // kdef.grp (viewed as int16)
+    MappedFile::View<int32_t> m_eventIndices; // kdef.idx
 
-    std::vector<uint8_t> m_talkData; // talk.grp
-    std::vector<int32_t> m_talkIndices; // talk.idx
+    MappedFile m_talkData; // talk.grp
+    MappedFile::View<int32_t> m_talkIndices; // talk.idx
     
     // Name Data
-    std::vector<uint8_t> m_nameData; // name.grp
-    std::vector<int32_t> m_nameIndices; // name.idx
+    MappedFile m_nameData; // name.grp
+    MappedFile::View<int32_t> m_nameIndices; // name.idx
     
     // Helper to load name
     std::string GetNameFromData(int nameNum);
@@ -4,20 +4,84 @@
 #include <cstdint>
 #include <fstream>
 #include <iostream>
+#include <cstring>
+#include <map>
+#include "MappedFile.h"
+
+class VirtualFS;
 
 class FileLoader {
 public:
     // Helper to read entire file
     static std::vector<uint8_t> loadFile(const std::string& filename);
 
+    // Map a read-only file in place (mmap, falls back to a heap read).
+    // Use for archives that are only ever read (smp, mmap.grp, kdef.grp, talk.grp ...)
+    static MappedFile mapFile(const std::string& filename);
+
+    // Read a file straight into a typed vector (single copy, no intermediate byte buffer).
+    // Use for data that is modified after loading (allsin/alldef, save files).
+    // byteSize (optional) receives the on-disk size so callers can validate it.
+    template <typename T>
+    static std::vector<T> loadFileAs(const std::string& filename, size_t* byteSize = nullptr) {
+        MappedFile packed = findPacked(filename);
+        if (!packed.empty()) {
+            if (byteSize) *byteSize = packed.size();
+            std::vector<T> out(packed.size() / sizeof(T));
+            std::memcpy(out.data(), packed.data(), out.size() * sizeof(T));
+            return out;
+        }
+
+        std::string path = getResourcePath(filename);
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) {
+            std::cerr << "Failed to open file: " << path << std::endl;
+            return {};
+        }
+        std::streamsize size = file.tellg();
+        if (byteSize) *byteSize = size > 0 ? static_cast<size_t>(size) : 0;
+        if (size <= 0) return {};
+        file.seekg(0, std::ios::beg);
+
+        std::vector<T> out(static_cast<size_t>(size) / sizeof(T));
+        if (!file.read(reinterpret_cast<char*>(out.data()), out.size() * sizeof(T))) {
+            return {};
+        }
+        return out;
+    }
+
     // Read a specific record from a Group file (.grp) using an Index file (.idx)
-    // The .idx file is assumed to be a list of 4-byte offsets.
-    // The size of record 'i' is calculated as offset[i+1] - offset[i].
+    // The .idx file is a list of 4-byte END offsets (Pascal convention):
+    // record 'i' spans [offset[i-1], offset[i]), record 0 starts at 0.
+    // Returns a copy; use GroupFile::open(...)->record(i) for a zero-copy view.
     static std::vector<uint8_t> loadGroupRecord(const std::string& grpPath, const std::string& idxPath, int index);
 
-    // Helper to get the resource path prefix (e.g., "resource/")
+    // Resource layers (see VirtualFS): the resource dir, kys.pak (built by kys_pack),
+    // then every mod under mods/ in load order. Upper layers win.
+    static bool hasPack();
+    // Pack entry for a resource name, empty if the top-most layer holding it is not a pack
+    static MappedFile findPacked(const std::string& filename);
+    // Per-record replacements for a grp ("<grp>.d/<n>" in any layer), keyed by record index
+    static std::map<int, MappedFile> findRecordOverrides(const std::string& grpName);
+    static const VirtualFS& virtualFS();
+
+    // --dev: loose files are read into memory (MappedFile::read) instead of mapped. An editor
+    // that truncates a mapped file while saving would otherwise crash the game (SIGBUS).
+    // Set before the first resource is loaded.
+    static void setReadLooseFiles(bool enabled);
+
+    // Disk path of a resource: the top-most loose file, else resource prefix + name
     static std::string getResourcePath(const std::string& filename);
 
     // Helper to write entire file
     static bool saveFile(const std::string& filename, const void* data, size_t size);
+
+    // Write the whole file in one call to 'path.tmp', flush it to disk and rename it over 'path'.
+    // A crash leaves either the old file or the new one, never a truncated mix; on POSIX the
+    // directory is synced after the rename so the new name survives a power loss too.
+    static bool saveFileAtomic(const std::string& path, const void* data, size_t size);
+
+    // Cut 'path' to 'offset' bytes (creating it when offset is 0), append 'data' and fsync.
+    // Used for append-only journals: a torn or stale tail past 'offset' is dropped first.
+    static bool appendFileSynced(const std::string& path, uint64_t offset, const void* data, size_t size);
 };
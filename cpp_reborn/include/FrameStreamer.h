@@ -0,0 +1,69 @@
+#pragma once
+#include <SDL3/SDL.h>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <atomic>
+#include <cstdint>
+
+// 帧序列流式播放器
+// 工作线程按顺序提前解码最多 ringSize 帧 (SDL_Surface)，主线程把它们上传到两张
+// 轮换的流式纹理中，并按固定时钟呈现；落后超过一帧时丢帧追赶而不是整体变慢。
+// 解码函数由调用方提供，因此同一个播放器可用于 Begin.Pic 开场动画、过场动画或
+// 任意贴图序列。一次 play() 结束后可以再次 start() 播放别的序列。
+class FrameStreamer {
+public:
+    // Decode frame 'index' (called on the worker thread). Return nullptr for an empty frame.
+    using DecodeFunc = std::function<SDL_Surface*(int index)>;
+
+    struct PlaybackOptions {
+        uint32_t frameIntervalMs = 40;
+        // Polled once per presented frame on the main thread; return true to stop early
+        std::function<bool()> shouldStop;
+        // Draws the frame texture (renderer clear/present are done by the streamer).
+        // Default stretches it over the whole render target.
+        std::function<void(SDL_Renderer*, SDL_Texture*)> draw;
+    };
+
+    explicit FrameStreamer(size_t ringSize = 4);
+    ~FrameStreamer();
+
+    FrameStreamer(const FrameStreamer&) = delete;
+    FrameStreamer& operator=(const FrameStreamer&) = delete;
+
+    // Start decoding frames [0, frameCount). Stops any previous sequence first.
+    bool start(int frameCount, DecodeFunc decode);
+
+    // Cancel decoding, join the worker and free frames that were never presented
+    void stop();
+
+    // Next decoded frame in order; blocks until it is ready.
+    // Returns false once all frames were consumed or the streamer was stopped.
+    // The caller owns the returned surface (may be nullptr for an empty frame).
+    bool nextFrame(int& index, SDL_Surface*& surface);
+
+    // Present the whole sequence on a steady clock. Returns the number of frames shown.
+    int play(SDL_Renderer* renderer, const PlaybackOptions& options);
+
+    // Frames dropped by the last play() because decoding or presenting fell behind
+    int droppedFrames() const { return m_dropped; }
+
+private:
+    struct Frame {
+        int index;
+        SDL_Surface* surface;
+    };
+
+    void workerLoop(int frameCount, DecodeFunc decode);
+
+    size_t m_ringSize;
+    std::thread m_worker;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::deque<Frame> m_ready;
+    std::atomic<bool> m_cancel{ false };
+    bool m_workerDone = true;
+    int m_dropped = 0;
+};
@@ -5,36 +5,46 @@
 #include <SDL3/SDL.h>
 #include <array>
 #include <cstdint>
+#include <functional>
 #include "Role.h"
 #include "Item.h"
 #include "Scene.h"
 #include "Magic.h"
 #include "PicLoader.h"
+#include "SpriteCache.h"
+#include "ResourceWatcher.h"
+#include "SaveImage.h"
+#include "SaveWorker.h"
+#include "SaveSlotInfo.h"
+#include "SnapshotRing.h"
+#include "AutoSave.h"
+#include "PagedFile.h"
+#include "MemoryStats.h"
+
+// 快速存档: 存档会写的全部状态 (加上 x50) 在内存中的一份拷贝
+struct QuickSaveState {
+    uint64_t takenAtMs = 0;
+    std::vector<int16_t> header;   // same layout as the R*.grp header
+    RoleTable roles;
+    ItemTable items;
+    SceneTable scenes;
+    MagicTable magics;
+    std::vector<uint8_t> shopRaw;
+    std::vector<int16_t> x50;
+    int savedWorldX = 0, savedWorldY = 0;
+    PagedFile::Image map;          // SData, shares unchanged scenes with the previous quicksave
+    PagedFile::Image events;       // DData
+};
 
 class GameManager {
     // Global Variables (x50 array from Pascal)
     // Range: -32768 to 32767 (mapped to 0..65535)
     std::vector<int16_t> m_x50;
 
-    // MMap Data (480x480)
-    std::vector<int16_t> m_earth;
-    std::vector<int16_t> m_surface;
-    std::vector<int16_t> m_building;
-    std::vector<int16_t> m_buildX;
-    std::vector<int16_t> m_buildY;
-    std::vector<int16_t> m_entrance;
-
 public:
     static GameManager& getInstance();
 
-    // MMap Accessors
-    const std::vector<int16_t>& getEarth() const { return m_earth; }
-    const std::vector<int16_t>& getSurface() const { return m_surface; }
-    const std::vector<int16_t>& getBuilding() const { return m_building; }
-    const std::vector<int16_t>& getBuildX() const { return m_buildX; }
-    const std::vector<int16_t>& getBuildY() const { return m_buildY; }
-    const std::vector<int16_t>& getEntrance() const { return m_entrance; }
-
+    // 大地图 (earth/surface/building/buildx/buildy/entrance) 由 SceneManager::GetWorldMap() 提供
     void reSetEntrance();
 
     int16_t getX50(int index) const {
@@ -51,6 +61,12 @@ public:
     void Run();
     void Quit();
 
+    // 开发模式: 监视资源目录，文件改动后只重载对应资源 (--dev)
+    void EnableDevMode();
+
+    // 内存统计: 汇总各管理器持有的资源 (F9 / --memstats)，退出时写 memory_stats.csv
+    void PrintMemoryReport();
+
     // Data Access
     Role& getRole(int index);
     int getRoleCount() const { return (int)m_roles.size(); }
@@ -116,8 +132,30 @@ public:
     int getNextLevelExp(int level);
 
     // Save/Load
-    void SaveGame(int slot);
+    // SaveGame snapshots the game state and writes it on a background thread;
+    // false if the snapshot could not be taken. Completion shows a status message.
+    bool SaveGame(int slot);
     bool LoadGame(int slot);
+    int PollSaves() { return m_saveWorker.poll(); } // once per frame (also from modal menus); saves finished
+    void WaitForSaves() { m_saveWorker.wait(); }
+    // Quicksave (F5) / quickload (F8): the last QUICKSAVE_COUNT states kept in memory, no disk access.
+    // FlushQuickSave writes one of them to a save slot in the background (age 0 = newest).
+    static const size_t QUICKSAVE_COUNT = 4;
+    bool QuickSave();
+    bool QuickLoad(size_t age = 0);
+    bool FlushQuickSave(size_t age, int slot);
+    const SnapshotRing<QuickSaveState>& GetQuickSaves() const { return m_quickSaves; }
+    // --compressed-saves: later saves are written as SaveContainer (smaller, checksummed).
+    // ExportRawSave writes a slot in the original raw format (for the original game).
+    void SetSaveCompression(bool compressed);
+    bool ExportRawSave(int slot, const std::string& dstDir) const;
+    // R<slot>.inf written next to each save (header only unless withThumbnail); false if missing
+    bool ReadSaveSlotInfo(int slot, SaveSlotInfo& out, bool withThumbnail = false) const;
+    // Autosave (see AutoSave.h): on scene changes and a timer, from a snapshot written in the background
+    void SetAutoSaveConfig(const AutoSaveConfig& config);
+    AutoSaveScheduler& GetAutoSave() { return m_autoSave; }
+    // The autosave slot written last (the menu's "自動檔")
+    int LatestAutoSaveSlot() const;
 
     // Game Logic
     bool GetEquipState(int roleIdx, int state);
@@ -150,15 +188,44 @@ private:
     GameManager& operator=(const GameManager&) = delete;
 
     // Game Data
-    std::vector<Role> m_roles;
-    std::vector<Item> m_items;
-    // std::vector<Scene> m_scenes; // Moved to SceneManager
-    std::vector<Magic> m_magics;
+    RoleTable m_roles;
+    ItemTable m_items;
+    // SceneTable m_scenes; // Moved to SceneManager
+    MagicTable m_magics;
     std::vector<PicImage> m_heads; // Cached head images
+    SpriteCache m_headCache;       // Pre-decoded Heads.Pic (cache/heads.kcc)
+    void FreeHeads();
+
+    // Dev mode hot reload
+    bool m_devMode = false;
+    ResourceWatcher m_resourceWatcher;
+
+    SaveWorker m_saveWorker;
+    SnapshotRing<QuickSaveState> m_quickSaves{ QUICKSAVE_COUNT };
+    bool m_compressSaves = false;
+    std::vector<int16_t> BuildSaveHeader() const;
+    void ApplySaveHeader(const std::vector<int16_t>& header);
+    // 'deferSceneReads': scenes that are not resident are read by the save worker (see PagedFile::capture)
+    bool CaptureState(QuickSaveState& state, const QuickSaveState* previous, bool deferSceneReads = false) const;
+    uint64_t CaptureBytes(const QuickSaveState* previous, bool deferSceneReads) const; // copied on the main thread
+    // Write a snapshot to a slot on the save worker; false if it cannot be submitted
+    using StateWriteDone = std::function<void(bool ok, const std::string& error, double writeMs, uint64_t bytes)>;
+    bool SubmitStateWrite(const std::shared_ptr<const QuickSaveState>& state, int slot, StateWriteDone done);
+    bool IsLiveSlot(int slot) const; // its S/D files are being paged from
+    AutoSaveScheduler m_autoSave;
+    std::shared_ptr<const QuickSaveState> m_lastAutoSave; // the next snapshot shares unchanged scenes with it
+    void UpdateAutoSave();
+    void PollHotReload();
+
+    // Memory accounting, sampled once per second so peaks are tracked
+    MemoryStats m_memoryStats;
+    uint64_t m_lastMemorySampleMs = 0;
+    void CollectMemoryStats();
     
     std::vector<int> m_teamList; // Stores role IDs of current party members
     std::vector<InventoryItem> m_inventory;
     std::vector<uint8_t> m_shopRaw;
+    SaveLayout m_saveLayout; // ranger.idx, read once by loadData/LoadGame
     std::vector<int16_t> m_levelUpList;
     std::vector<std::array<int16_t, 4>> m_setNum;
     
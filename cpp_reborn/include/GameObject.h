@@ -5,41 +5,58 @@
 #include <algorithm>
 
 // Base class for game entities that need to maintain binary compatibility
+// The record is either owned (a standalone object) or a view into a RecordTable block
+// (see RecordTable.h). Copies always own their data; assignment writes the values
+// through, so 'table[i] = role' updates the table.
 class GameObject {
 public:
-    GameObject(size_t dataSize) : m_data(dataSize, 0) {}
+    GameObject(size_t dataSize) : m_own(dataSize, 0), m_data(m_own.data()), m_size(dataSize) {}
+    GameObject(const GameObject& other)
+        : m_own(other.m_data, other.m_data + other.m_size), m_data(m_own.data()), m_size(other.m_size) {}
+    // A moved view stays a view of the same record
+    GameObject(GameObject&& other) noexcept
+        : m_own(std::move(other.m_own)), m_data(other.m_data), m_size(other.m_size) {
+        if (!m_own.empty()) m_data = m_own.data();
+        other.m_data = nullptr;
+        other.m_size = 0;
+    }
+    GameObject& operator=(const GameObject& other) {
+        if (this != &other) assignValues(other.m_data, other.m_size);
+        return *this;
+    }
+    GameObject& operator=(GameObject&& other) { return *this = static_cast<const GameObject&>(other); }
     virtual ~GameObject() = default;
 
     // Direct access for serialization
-    int16* getRawData() { return m_data.data(); }
-    const int16* getRawData() const { return m_data.data(); }
-    size_t getDataSize() const { return m_data.size(); }
+    int16* getRawData() { return m_data; }
+    const int16* getRawData() const { return m_data; }
+    size_t getDataSize() const { return m_size; }
+    bool isView() const { return m_own.empty() && m_data != nullptr; }
 
     void setDataVector(const std::vector<int16>& data) {
-        if (data.size() == m_data.size()) {
-            m_data = data;
-        } else if (data.size() < m_data.size()) {
-             std::copy(data.begin(), data.end(), m_data.begin());
-        } else {
-             m_data = data; // Or resize? Usually we want fixed size.
-        }
+        assignValues(data.data(), data.size());
     }
 
     void loadFromBuffer(const int16* buffer, size_t size) {
-        if (size <= m_data.size()) {
-            std::memcpy(m_data.data(), buffer, size * sizeof(int16));
+        if (size <= m_size) {
+            std::memcpy(m_data, buffer, size * sizeof(int16));
         }
     }
 
 protected:
-    std::vector<int16> m_data;
+    // View of 'dataSize' values owned by someone else (RecordTable)
+    GameObject(int16* data, size_t dataSize) : m_data(data), m_size(dataSize) {}
+
+    std::vector<int16> m_own; // empty for a view
+    int16* m_data;
+    size_t m_size;
 
     int16 getData(size_t index) const {
-        return (index < m_data.size()) ? m_data[index] : 0;
+        return (index < m_size) ? m_data[index] : 0;
     }
 
     void setData(size_t index, int16 value) {
-        if (index < m_data.size()) {
+        if (index < m_size) {
             m_data[index] = value;
         }
     }
@@ -65,4 +82,16 @@ protected:
         std::memset(ptr, 0, length * 2);
         std::strncpy(ptr, val.c_str(), length * 2 - 1);
     }
+
+private:
+    // Same size: copy. Owned records grow to a longer source (WarData); views keep their size.
+    void assignValues(const int16* src, size_t size) {
+        if (size > m_size && !isView()) {
+            m_own.assign(src, src + size);
+            m_data = m_own.data();
+            m_size = size;
+            return;
+        }
+        if (size > 0) std::memmove(m_data, src, std::min(size, m_size) * sizeof(int16));
+    }
 };
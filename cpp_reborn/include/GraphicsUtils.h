@@ -26,6 +26,11 @@ public:
     // Decodes and draws an RLE-encoded image from the buffer
     // rawData: The chunk of data starting at the offset found in .idx
     static void DrawRLE8(SDL_Surface* dest, int x, int y, const uint8_t* rawData, size_t dataSize, int shadow = 0, float scale = 1.0f);
+
+    // Same output as DrawRLE8, from a pre-decoded palette index + mask bitmap (SpriteCache)
+    // pixels/mask: h rows of 'stride' bytes; (xs, ys) is the hotspot
+    static void DrawIndexed8(SDL_Surface* dest, int x, int y, int w, int h, int xs, int ys, int stride,
+                             const uint8_t* pixels, const uint8_t* mask, int shadow = 0, float scale = 1.0f);
     
 private:
     static std::vector<uint8_t> m_fullPaletteData; // 4 * 256 * 3 bytes
@@ -0,0 +1,55 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <memory>
+#include <map>
+#include <cstdint>
+#include "MappedFile.h"
+
+// 组文件 (.grp + .idx) 句柄
+// KYS 的 idx 存的是每条记录的“结束偏移”(与 Pascal 一致):
+//   记录 0: [0, idx[0])
+//   记录 i: [idx[i-1], idx[i])
+// 打开时解析一次索引并映射 grp，之后 record(i) 只做指针运算，不再有系统调用。
+// 资源层中的 "<grp名>.d/<i>" 会替换第 i 条记录 (见 VirtualFS)，可超出原有记录数以追加记录。
+// 对象打开后不可变，可在多个线程中同时读取。
+class GroupFile {
+public:
+    // Open (or fetch from cache) the grp/idx pair. Names go through FileLoader::getResourcePath.
+    // Returns nullptr if either file is missing.
+    static std::shared_ptr<const GroupFile> open(const std::string& grpName, const std::string& idxName);
+
+    // Drop cached handles (e.g. after files on disk were replaced). Existing shared_ptrs stay valid.
+    static void clearCache();
+
+    size_t count() const { return m_count; }
+    size_t recordSize(int index) const;
+    // Start offset of record 'index' in the base grp (0 for index 0, idx[index-1] otherwise).
+    // Meaningless for overridden records; use record()/recordFrom().
+    size_t recordOffset(int index) const;
+
+    // View of record 'index'. Empty if the index is out of range or the record is empty.
+    MappedFile record(int index) const;
+
+    // Up to 'length' bytes starting at record 'index', running past the record end into the
+    // following ones (Pascal reads fixed-size blocks from idx offsets, e.g. warfld).
+    // An overridden record is returned on its own.
+    MappedFile recordFrom(int index, size_t length) const;
+
+    bool isOverridden(int index) const { return m_overrides.count(index) != 0; }
+
+    // Whole-archive grp + end-offset idx with overrides applied, for code that addresses the
+    // grp by absolute offset (kdef scripts). Without overrides grp is the original mapping;
+    // with overrides the records are spliced into a new buffer.
+    void flatten(MappedFile& grp, MappedFile& idx) const;
+
+    const MappedFile& data() const { return m_grp; }
+
+    GroupFile(MappedFile grp, std::vector<int32_t> offsets, std::map<int, MappedFile> overrides = {});
+
+private:
+    MappedFile m_grp;
+    std::vector<int32_t> m_offsets; // end offsets, clamped to grp size
+    std::map<int, MappedFile> m_overrides;
+    size_t m_count = 0;
+};
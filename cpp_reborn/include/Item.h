@@ -1,5 +1,6 @@
 #pragma once
 #include "GameObject.h"
+#include "RecordTable.h"
 #include <string>
 
 // Mapping TItem from kys_main.pas
@@ -9,6 +10,8 @@ constexpr size_t ITEM_DATA_SIZE = 95;
 class Item : public GameObject {
 public:
     Item() : GameObject(ITEM_DATA_SIZE) {}
+    // View of record data in a ItemTable
+    explicit Item(int16* data) : GameObject(data, ITEM_DATA_SIZE) {}
     virtual ~Item() = default;
 
     // --- Property Accessors based on Pascal Record Layout ---
@@ -253,3 +256,5 @@ public:
     int16 getNeedMatAmount(int index) const { return (index >= 0 && index < 5) ? m_data[90 + index] : 0; }
     void setNeedMatAmount(int index, int16 v) { if (index >= 0 && index < 5) m_data[90 + index] = v; }
 };
+
+using ItemTable = RecordTable<Item, ITEM_DATA_SIZE>;
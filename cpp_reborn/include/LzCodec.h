@@ -0,0 +1,22 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// 简单的 LZ77 字节流压缩 (LZ4 风格的 token 格式，不依赖第三方库)
+// 每个序列: token(高 4 位字面量长度, 低 4 位匹配长度-4)
+//          [字面量长度扩展] 字面量 [偏移 u16] [匹配长度扩展]
+// 最后一个序列只有字面量。长度字段为 15 时后跟若干字节，每字节累加，直到某字节 < 255。
+class LzCodec {
+public:
+    // Compress 'size' bytes. Output may be larger than input for incompressible data;
+    // callers decide whether to keep it.
+    static std::vector<uint8_t> compress(const uint8_t* src, size_t size);
+
+    // Decompress into dst which must be exactly 'rawSize' bytes.
+    // Returns false on malformed input (never writes past dst + rawSize).
+    static bool decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t rawSize);
+
+    // Worst case compressed size for 'size' input bytes
+    static size_t maxCompressedSize(size_t size) { return size + size / 255 + 16; }
+};
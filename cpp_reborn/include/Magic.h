@@ -1,5 +1,6 @@
 #pragma once
 #include "GameObject.h"
+#include "RecordTable.h"
 #include <string>
 
 constexpr size_t MAGIC_DATA_SIZE = 111;
@@ -7,6 +8,8 @@ constexpr size_t MAGIC_DATA_SIZE = 111;
 class Magic : public GameObject {
 public:
     Magic() : GameObject(MAGIC_DATA_SIZE) {}
+    // View of record data in a MagicTable
+    explicit Magic(int16* data) : GameObject(data, MAGIC_DATA_SIZE) {}
     virtual ~Magic() = default;
 
     // 0: ListNum
@@ -134,3 +137,5 @@ public:
     // 81-110: Introduction
     std::string getIntroduction() const { return getString(81, 30); }
 };
+
+using MagicTable = RecordTable<Magic, MAGIC_DATA_SIZE>;
@@ -0,0 +1,90 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+// 只读文件映射 (Read-only file mapping)
+// 优先使用 mmap / CreateFileMapping 把资源文件直接映射进地址空间，
+// 映射失败或平台不支持时退回到一次性读入堆内存。
+// 对象本身是轻量的视图：拷贝只增加引用计数，底层映射在最后一个视图释放时才解除。
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    // Map a file by absolute/relative path (no resource path resolution).
+    // Returns an empty MappedFile on failure or for zero-length files.
+    static MappedFile open(const std::string& path);
+
+    // Read the whole file into heap memory instead of mapping it: later changes to the file
+    // on disk (even truncation) cannot affect the returned bytes. Empty on failure.
+    static MappedFile read(const std::string& path);
+
+    // Wrap an already-loaded buffer (used by the fallback path and for data that
+    // does not come from disk, e.g. decompressed pack entries).
+    static MappedFile fromBuffer(std::vector<uint8_t>&& buffer);
+
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    const uint8_t& operator[](size_t i) const { return m_data[i]; }
+    const uint8_t* begin() const { return m_data; }
+    const uint8_t* end() const { return m_data + m_size; }
+
+    // true if backed by an OS mapping, false if backed by heap memory
+    bool isMapped() const;
+
+    // Sub-range sharing the same backing storage. Clamped to the file size.
+    MappedFile slice(size_t offset, size_t length) const;
+
+    // Typed view over the bytes, keeps the backing storage alive
+    template <typename T>
+    class View {
+    public:
+        View() = default;
+        const T* data() const { return m_ptr; }
+        size_t size() const { return m_count; }
+        bool empty() const { return m_count == 0; }
+        const T& operator[](size_t i) const { return m_ptr[i]; }
+        const T* begin() const { return m_ptr; }
+        const T* end() const { return m_ptr + m_count; }
+        // Same as MappedFile::isMapped (false for heap buffers and unaligned copies)
+        bool isMapped() const { return m_mapped; }
+
+    private:
+        friend class MappedFile;
+        std::shared_ptr<const void> m_keepAlive;
+        const T* m_ptr = nullptr;
+        size_t m_count = 0;
+        bool m_mapped = false;
+    };
+
+    // Trailing bytes that do not form a whole T are ignored
+    template <typename T>
+    View<T> as() const;
+
+private:
+    struct Region;
+
+    std::shared_ptr<const Region> m_region;
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+};
+
+template <typename T>
+MappedFile::View<T> MappedFile::as() const {
+    View<T> view;
+    if (m_size < sizeof(T)) return view;
+
+    // mmap 与 vector 的起始地址都满足对齐；只有奇数偏移的 slice 需要拷贝一份
+    MappedFile aligned = *this;
+    if (reinterpret_cast<uintptr_t>(m_data) % alignof(T) != 0) {
+        aligned = fromBuffer(std::vector<uint8_t>(m_data, m_data + m_size));
+    }
+    view.m_keepAlive = aligned.m_region;
+    view.m_ptr = reinterpret_cast<const T*>(aligned.m_data);
+    view.m_count = aligned.m_size / sizeof(T);
+    view.m_mapped = aligned.isMapped();
+    return view;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+#include <ostream>
+
+// 资源内存统计
+// 每次采样时各管理器通过 ReportMemory() 把自己持有的资源逐项 add() 进来；
+// 同一 (owner, asset) 的峰值跨采样保留。mapped 表示只读映射 (mmap)，
+// 这部分由系统按需换页，不计入堆内存但仍占地址空间/页缓存。
+class MemoryStats {
+public:
+    struct Entry {
+        std::string owner;  // e.g. "SceneManager"
+        std::string asset;  // e.g. "smp"
+        uint64_t bytes = 0;
+        uint64_t count = 0; // number of sprites/records/textures, 0 if not meaningful
+        uint64_t peakBytes = 0;
+        bool mapped = false;
+        bool gpu = false;   // texture memory (estimated w * h * 4)
+    };
+
+    // Start a new sample: current sizes reset to 0, peaks are kept
+    void begin();
+    void add(const std::string& owner, const std::string& asset, uint64_t bytes, uint64_t count = 0,
+             bool mapped = false, bool gpu = false);
+
+    const std::vector<Entry>& entries() const { return m_entries; }
+    uint64_t totalBytes() const;
+    uint64_t peakTotalBytes() const { return m_peakTotal; }
+
+    void print(std::ostream& os) const;
+    // owner,asset,kind,bytes,count,peak_bytes
+    bool writeCsv(const std::string& path) const;
+
+private:
+    std::vector<Entry> m_entries;
+    std::map<std::pair<std::string, std::string>, size_t> m_index;
+    uint64_t m_peakTotal = 0;
+};
@@ -0,0 +1,233 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <memory>
+#include "MappedFile.h"
+
+// 按记录分页的可写数据文件 (allsin.grp / alldef.grp 以及存档 S*.grp / D*.grp)
+// 文件是若干等长记录 (一个场景一条) 的简单拼接。open() 只读取文件大小，
+// 记录在第一次访问时才读入；最多保留 maxResident 条，超出时淘汰最久未用的干净记录。
+// 被修改过 (dirty) 的记录一直驻留，直到 save() 把它们写出——存档之前不会改动源文件。
+// 文件格式与原版完全一致。
+// 驻留记录在内存中的形式由子类决定 (RawPagedFile 原样保存字节)。
+//
+// 存档写法 (WriteMode):
+//   InPlace  改动过的记录覆盖进整份文件后原子替换 (临时文件 + rename + fsync)，
+//            文件随时可被原版读取，存档时崩溃也不会留下半条记录。
+//   Journal  改动的记录追加到 <file>.jnl (顺序写、可检测半截块)，源文件不动；
+//            open() 时日志覆盖在源文件之上。日志超过源文件的 compactRatio 倍，
+//            或调用 compact() 时，合并成完整文件 (原子替换) 并删除日志——
+//            原版只能读取合并后的文件。换源 (open() 别的文件、另存为别的文件) 时
+//            旧源文件的日志也会合并，不会留下原版读不到的改动。
+// 压缩存档 (setCompressed): 每次存档写出完整的 SaveContainer (原子替换)；
+// 打开容器时整份解压到内存，从内存分页 (与资源包条目相同)。
+class PagedFile {
+public:
+    struct Stats {
+        uint64_t pageIns = 0;
+        uint64_t evictions = 0;
+        uint64_t writeBacks = 0;   // dirty records patched into the file or journaled by save()
+        uint64_t compactions = 0;  // journal merged back into the file
+    };
+
+    enum class WriteMode { InPlace, Journal };
+
+    PagedFile() = default;
+    virtual ~PagedFile() = default;
+    PagedFile(const PagedFile&) = delete;
+    PagedFile& operator=(const PagedFile&) = delete;
+
+    // Resolves 'filename' like FileLoader::loadFileAs (pack entry or disk path).
+    // Trailing bytes that do not form a whole record are ignored (a warning is logged).
+    bool open(const std::string& filename, size_t recordSize, size_t maxResident);
+    void close();
+
+    // open() in two steps, so several files can be checked before any of them is switched:
+    // locate() resolves and validates 'filename' without touching the open file,
+    // open(Source) then switches to it and cannot fail.
+    struct Source {
+        std::string path;   // disk file (empty for a pack entry or a compressed save)
+        MappedFile packed;
+        size_t recordSize = 0;
+        size_t records = 0;
+    };
+    static bool locate(const std::string& filename, size_t recordSize, Source& out);
+    void open(Source&& source, size_t maxResident);
+
+    size_t count() const { return m_pages.size(); }
+    size_t recordSize() const { return m_recordSize; }
+
+    // Applies to later saves; also kept across open()
+    void setWriteMode(WriteMode mode, double compactRatio = 0.5) {
+        m_writeMode = mode;
+        m_compactRatio = compactRatio;
+    }
+    WriteMode writeMode() const { return m_writeMode; }
+    // Later saves write compressed containers (whole file, WriteMode is ignored); kept across open()
+    void setCompressed(bool compressed) { m_compressed = compressed; }
+    bool compressed() const { return m_compressed; }
+    size_t journalRecords() const; // records currently read from the journal
+    // Merge the journal (and dirty records) into the file we paged from. true if there was nothing to do.
+    bool compact();
+    // Merge 'path'.jnl into 'path' without opening it (only what was saved, nothing in memory).
+    // true if there was no journal. Used when the source switches away from a journaled file.
+    static bool compactJournal(const std::string& path, size_t recordSize);
+    // Write 'src' with its journal applied to 'dst' as a raw file (--export-raw-save).
+    // 'src' and its journal are left as they are.
+    static bool exportRaw(const std::string& src, const std::string& dst, size_t recordSize);
+
+    // Write the current contents to 'path'. If it is the file we paged from, only dirty
+    // records are copied (patched into the file or appended to the journal, see WriteMode); otherwise the whole
+    // file is written and becomes the new source. Either way every record is clean afterwards.
+    // Same as snapshot() + writeSnapshot() + commit().
+    bool save(const std::string& path);
+
+    // 异步存档: snapshot() 在主线程复制 dirty 记录 (不读盘)，writeSnapshot() 可在任意线程写盘，
+    // commit() 回到主线程把写出的记录标为干净。写盘期间 dirty 记录仍驻留 (不会被淘汰后从
+    // 正在写的文件重读)；期间又被修改的记录 commit 后仍是 dirty。
+    struct Snapshot {
+        enum class Kind {
+            InPlace,   // the carried records are patched into 'path', which is then replaced atomically
+            Journal,   // the carried records are appended to 'path'.jnl at journalEnd
+            FullImage  // 'path' is replaced atomically and its journal removed
+        };
+        std::string path;             // destination
+        Kind kind = Kind::FullImage;
+        std::string sourcePath;       // FullImage: records not carried come from this file...
+        std::vector<uint8_t> base;    // ...or from this image (the source is a pack entry)
+        std::string journalPath;      // FullImage: journal of the source, applied over it
+        std::vector<std::pair<size_t, uint64_t>> journalBlocks; // record, payload offset
+        bool compactSource = false;   // FullImage to another file: then merge the source's journal
+        uint64_t journalEnd = 0;      // Journal: append offset (0 = start a new journal)
+        size_t recordSize = 0;
+        size_t count = 0;
+        std::vector<size_t> indices;  // carried records
+        std::vector<uint64_t> versions;
+        std::vector<uint8_t> records; // indices.size() * recordSize bytes
+        uint64_t openSerial = 0;
+        bool compressed = false;      // FullImage: write a SaveContainer
+        // compressed: writeSnapshot() leaves the raw image here and commit() pages from it
+        std::shared_ptr<std::vector<uint8_t>> unpacked;
+    };
+    Snapshot snapshot(const std::string& path) const;
+    static bool writeSnapshot(const Snapshot& snap);
+    // 'written' is the result of writeSnapshot. Ignored if the file was reopened meanwhile.
+    void commit(const Snapshot& snap, bool written);
+
+    // 快速存档: 全部记录在内存中的拷贝，不写盘。
+    // 同一次 open() 内版本号相同的记录内容相同，所以 capture() 与 'previous' 共享没改过的
+    // 记录，连续快速存档只复制改动过的记录；restore() 也只替换可能不同的记录。
+    struct Image {
+        uint64_t openSerial = 0;
+        size_t recordSize = 0;
+        std::vector<std::shared_ptr<const std::vector<uint8_t>>> records;
+        std::vector<uint64_t> versions;
+        // capture(deferReads): null records are clean and read from here by snapshotOf()
+        std::string sourcePath;
+        MappedFile packed;
+        std::string journalPath;
+        std::vector<uint64_t> journalOffsets; // per record, 0 = not in the journal
+    };
+    // Resident records are copied from memory, the others read from the source.
+    // 'deferReads': records that are not resident are left null (nothing is read on this
+    // thread); such an image can only be written with snapshotOf(), not restore()d.
+    // false if a record could not be read ('out' is then unusable).
+    bool capture(Image& out, const Image* previous = nullptr, bool deferReads = false) const;
+    // Bytes capture() would copy on this thread
+    uint64_t captureBytes(const Image* previous, bool deferReads) const;
+    // Make every record equal to 'image' without reading the source: replaced records become
+    // resident and dirty. Returns the number replaced, -1 if the image is for another file shape.
+    int restore(const Image& image);
+    // A FullImage snapshot that writes 'image' to 'path' (commit() ignores it). Deferred
+    // records are read from the image's source here, so call it on the writing thread.
+    // count is 0 (writeSnapshot fails) if one cannot be read.
+    static Snapshot snapshotOf(const Image& image, const std::string& path, bool compressed = false);
+    const std::string& sourcePath() const { return m_path; } // empty when paging from a pack entry
+
+    bool isResident(size_t index) const { return index < m_pages.size() && m_pages[index].resident; }
+    bool isDirty(size_t index) const { return index < m_pages.size() && m_pages[index].dirty; }
+    size_t residentCount() const;
+    uint64_t residentBytes() const; // in-memory size of the resident records
+    size_t maxResident() const { return m_maxResident; }
+    const Stats& stats() const { return m_stats; }
+
+protected:
+    // Make 'index' resident and most recently used. false if out of range or the read failed.
+    bool touch(size_t index) {
+        if (index < m_pages.size() && m_pages[index].resident) {
+            m_pages[index].lastUse = ++m_tick;
+            return true;
+        }
+        return pageIn(index);
+    }
+    void markDirty(size_t index) {
+        m_pages[index].dirty = true;
+        ++m_pages[index].version;
+    }
+
+    // Resident payload hooks
+    virtual void resize(size_t count) = 0;                                  // one slot per record
+    virtual void decode(size_t index, const uint8_t* raw) = 0;              // record bytes -> payload
+    virtual void encode(size_t index, uint8_t* out) const = 0;              // payload -> record bytes
+    virtual void release(size_t index) = 0;                                 // drop the payload
+    virtual size_t payloadBytes(size_t index) const = 0;
+    virtual void onWritten(size_t index) { (void)index; }                   // record is clean again
+
+private:
+    struct Page {
+        bool resident = false;
+        bool dirty = false;
+        uint64_t lastUse = 0;
+        uint64_t version = 0; // bumped by every markDirty
+    };
+
+    bool pageIn(size_t index);
+    bool readRecord(size_t index, uint8_t* out) const;
+    void evictIfNeeded();
+    void loadJournal();
+    Snapshot snapshotAs(const std::string& path, Snapshot::Kind kind) const;
+
+    std::string m_path;     // disk file the records come from (empty when m_packed is used)
+    MappedFile m_packed;    // pack entry source
+    size_t m_recordSize = 0;
+    size_t m_maxResident = 0;
+    std::vector<Page> m_pages;
+    uint64_t m_tick = 0;
+    uint64_t m_openSerial = 0; // bumped by open(), see commit()
+    Stats m_stats;
+
+    WriteMode m_writeMode = WriteMode::InPlace;
+    double m_compactRatio = 0.5;
+    bool m_compressed = false;
+    std::vector<uint64_t> m_journalOffsets; // per record: payload offset in the journal, 0 = none
+    uint64_t m_journalEnd = 0;              // journal size (0 = no journal)
+};
+
+// 原样保存记录字节
+class RawPagedFile : public PagedFile {
+public:
+    // Record bytes, paging them in on first use; nullptr if out of range or the read failed.
+    // The pointer stays valid until the next call that may page in another record.
+    const uint8_t* read(size_t index) {
+        return touch(index) ? m_data[index].data() : nullptr;
+    }
+    // Same as read(), and marks the record dirty
+    uint8_t* write(size_t index) {
+        if (!touch(index)) return nullptr;
+        markDirty(index);
+        return m_data[index].data();
+    }
+
+protected:
+    void resize(size_t count) override;
+    void decode(size_t index, const uint8_t* raw) override;
+    void encode(size_t index, uint8_t* out) const override;
+    void release(size_t index) override;
+    size_t payloadBytes(size_t index) const override { return m_data[index].size(); }
+
+private:
+    std::vector<std::vector<uint8_t>> m_data;
+};
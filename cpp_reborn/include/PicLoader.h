@@ -26,4 +26,8 @@ public:
 
     // Free the surface inside PicImage
     static void freePic(PicImage& pic);
+
+    // Each .pic is mapped (or unpacked from kys.pak) once and kept for later calls.
+    // Drop the cached files after they were replaced on disk (hot reload).
+    static void clearCache();
 };
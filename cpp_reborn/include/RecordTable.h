@@ -0,0 +1,85 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+// 同一类记录 (Role / Item / Magic / Scene) 的表: 全部记录放在一块连续的 int16 内存里，
+// 与存档中的段布局相同，读档/存档/快照都是整段拷贝。
+// table[i] 返回指向块内第 i 条记录的视图 (T(int16*) 构造)，getter/setter 与单独的对象相同。
+// 视图在 resize / push_back / 赋值后重新绑定，之前取得的引用和指针失效 (与 std::vector 相同)。
+template <typename T, size_t N>
+class RecordTable {
+public:
+    static constexpr size_t RECORD_VALUES = N;
+
+    RecordTable() = default;
+    explicit RecordTable(size_t count) { resize(count); }
+    RecordTable(const RecordTable& other) : m_block(other.m_block) { bind(); }
+    RecordTable& operator=(const RecordTable& other) {
+        if (this != &other) {
+            m_block = other.m_block;
+            bind();
+        }
+        return *this;
+    }
+    // Moving the vectors keeps the block where it is, so the views stay valid
+    RecordTable(RecordTable&&) noexcept = default;
+    RecordTable& operator=(RecordTable&&) noexcept = default;
+
+    size_t size() const { return m_views.size(); }
+    bool empty() const { return m_views.empty(); }
+
+    T& operator[](size_t i) { return m_views[i]; }
+    const T& operator[](size_t i) const { return m_views[i]; }
+    typename std::vector<T>::iterator begin() { return m_views.begin(); }
+    typename std::vector<T>::iterator end() { return m_views.end(); }
+    typename std::vector<T>::const_iterator begin() const { return m_views.begin(); }
+    typename std::vector<T>::const_iterator end() const { return m_views.end(); }
+
+    // count * N values, record i at i * N
+    int16_t* data() { return m_block.data(); }
+    const int16_t* data() const { return m_block.data(); }
+
+    // New records are zero
+    void resize(size_t count) {
+        m_block.resize(count * N, 0);
+        bind();
+    }
+    void clear() {
+        m_block.clear();
+        m_views.clear();
+    }
+
+    // 'count' records from a packed buffer (any alignment) in one copy
+    void assign(const void* records, size_t count) {
+        m_block.resize(count * N);
+        if (count > 0) std::memcpy(m_block.data(), records, count * N * sizeof(int16_t));
+        bind();
+    }
+
+    // Appends a copy of 'record' (its first N values; zero-padded if shorter)
+    void push_back(const T& record) {
+        size_t at = m_block.size();
+        m_block.resize(at + N, 0);
+        std::memcpy(m_block.data() + at, record.getRawData(), std::min(record.getDataSize(), N) * sizeof(int16_t));
+        bind();
+    }
+
+    // Heap bytes held (block + views)
+    uint64_t memoryBytes() const {
+        return m_block.capacity() * sizeof(int16_t) + m_views.capacity() * sizeof(T);
+    }
+
+private:
+    void bind() {
+        size_t count = m_block.size() / N;
+        if (m_views.size() == count && (count == 0 || m_views[0].getRawData() == m_block.data())) return;
+        m_views.clear();
+        m_views.reserve(count);
+        for (size_t i = 0; i < count; ++i) m_views.emplace_back(m_block.data() + i * N);
+    }
+
+    std::vector<int16_t> m_block;
+    std::vector<T> m_views;
+};
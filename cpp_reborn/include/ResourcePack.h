@@ -0,0 +1,85 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "MappedFile.h"
+
+// 单文件资源包 (kys.pak)
+// 布局:
+//   PackHeader
+//   条目数据 (每条 16 字节对齐，可选 LZ 压缩)
+//   目录: PackEntry[entryCount] | uint32 slots[slotCount] | 文件名字符串
+// 目录以 FNV-1a 哈希做开放寻址 (线性探测)，slot 存 条目下标+1，0 表示空。
+// 文件名统一为小写、'/' 分隔、相对 resource 目录。
+class ResourcePack {
+public:
+    static const char MAGIC[8];
+    static const uint32_t VERSION = 1;
+    static const uint32_t ALIGNMENT = 16;
+    static const uint32_t FLAG_LZ = 1;
+
+#pragma pack(push, 1)
+    struct PackHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t slotCount;
+        uint32_t reserved;
+        uint64_t dirOffset;
+        uint64_t dirSize;
+        uint8_t padding[24];
+    };
+
+    struct PackEntry {
+        uint64_t hash;
+        uint64_t offset;
+        uint64_t storedSize;
+        uint64_t size;
+        uint32_t flags;
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        uint32_t reserved;
+    };
+#pragma pack(pop)
+
+    // Source file for building a pack
+    struct BuildInput {
+        std::string name;  // name inside the pack (normalized on write)
+        std::string path;  // file on disk
+    };
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return !m_file.empty(); }
+    size_t entryCount() const { return m_entryCount; }
+
+    bool contains(const std::string& name) const { return findEntry(name) != nullptr; }
+
+    // Entry contents. Raw entries are zero-copy slices of the pack mapping,
+    // compressed entries are decoded into a fresh buffer.
+    MappedFile find(const std::string& name) const;
+
+    // Stored (uncompressed) size of an entry, 0 if absent
+    uint64_t entrySize(const std::string& name) const;
+
+    // Normalized name of entry 'index' (directory order), "" if out of range
+    std::string entryName(size_t index) const;
+
+    // Write a pack. compress: try LZ per entry, keep it only if it saves at least 1/8.
+    // Fails (and removes 'outPath') if an input cannot be read or two names normalize to the same key.
+    static bool write(const std::string& outPath, const std::vector<BuildInput>& inputs, bool compress);
+
+    static std::string normalizeName(const std::string& name);
+    static uint64_t hashName(const std::string& normalizedName);
+
+private:
+    const PackEntry* findEntry(const std::string& name) const;
+
+    MappedFile m_file;
+    const PackEntry* m_entries = nullptr;
+    const uint32_t* m_slots = nullptr;
+    const char* m_names = nullptr;
+    size_t m_namesSize = 0;
+    uint32_t m_entryCount = 0;
+    uint32_t m_slotCount = 0;
+};
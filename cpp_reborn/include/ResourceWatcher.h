@@ -0,0 +1,49 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+
+// 资源目录监视 (开发模式热重载用)
+// Linux 下用 inotify，只在文件写完 (IN_CLOSE_WRITE) 或被替换 (IN_MOVED_TO) 时报告；
+// 其他平台退回每秒比较一次 修改时间/大小。
+// 变化的文件名与 VirtualFS 一致: 小写、'/' 分隔、相对监视根目录。
+// 同一文件在 settleMs 内的多次变化合并为一次，避免编辑器分段写入时重复重载。
+class ResourceWatcher {
+public:
+    ResourceWatcher() = default;
+    ~ResourceWatcher();
+
+    ResourceWatcher(const ResourceWatcher&) = delete;
+    ResourceWatcher& operator=(const ResourceWatcher&) = delete;
+
+    // Watch every directory in 'roots' recursively. Returns false if none could be watched.
+    bool start(const std::vector<std::string>& roots, uint32_t settleMs = 250);
+    void stop();
+    bool isRunning() const { return m_running; }
+
+    // Non-blocking. Appends names whose changes have settled (each name at most once).
+    void poll(std::vector<std::string>& changed);
+
+private:
+    void collect(uint64_t nowMs);
+    void scanSnapshot(std::map<std::string, std::pair<int64_t, uint64_t>>& out) const;
+
+    std::vector<std::string> m_roots;
+    std::map<std::string, uint64_t> m_pending; // name -> last change time (ms)
+    uint32_t m_settleMs = 250;
+    bool m_running = false;
+
+#ifdef __linux__
+    int m_fd = -1;
+    struct WatchDir {
+        size_t root;     // index into m_roots
+        std::string rel; // "" or "sub/dir/"
+    };
+    std::map<int, WatchDir> m_watchDirs; // watch descriptor -> directory
+    void addWatch(size_t root, const std::string& rel);
+#endif
+    // 轮询模式的快照: name -> (mtime, size)
+    std::map<std::string, std::pair<int64_t, uint64_t>> m_snapshot;
+    uint64_t m_lastScanMs = 0;
+};
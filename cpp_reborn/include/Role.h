@@ -1,5 +1,6 @@
 #pragma once
 #include "GameObject.h"
+#include "RecordTable.h"
 #include <string>
 
 // Mapping TRole from kys_main.pas
@@ -9,6 +10,8 @@ constexpr size_t ROLE_DATA_SIZE = 91;
 class Role : public GameObject {
 public:
     Role() : GameObject(ROLE_DATA_SIZE) {}
+    // View of record data in a RoleTable
+    explicit Role(int16* data) : GameObject(data, ROLE_DATA_SIZE) {}
     virtual ~Role() = default;
 
     // --- Property Accessors based on Pascal Record Layout ---
@@ -231,3 +234,5 @@ public:
     void setTakingItemAmount(int index, int16 v) { if (index >= 0 && index < 4) m_data[87 + index] = v; }
     
 };
+
+using RoleTable = RecordTable<Role, ROLE_DATA_SIZE>;
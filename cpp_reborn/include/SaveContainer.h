@@ -0,0 +1,37 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "MappedFile.h"
+
+// 压缩存档容器 (--compressed-saves)
+// 存档本来是 int16 原样转储，SData 里大半是 0 和重复图块。容器把文件切成等长块，
+// 每块用 LzCodec 压缩 (压不小就原样存)，并带 CRC-32C 校验：
+//   头部 32 字节: "KSAV", 版本 u16, 0 u16, 块长 u32, 块数 u32, 原始长度 u64,
+//                 头部校验 u32 (头部前 24 字节 + 块表), 0 u32
+//   块表: 每块 { 存储长度 u32 (最高位 = 未压缩), 原始数据的 CRC-32C u32 }
+//   数据: 各块依次排列
+// 读存档的地方都通过 readFile()，原始格式的存档照常读取；exportRaw() 转回原版能读的格式。
+class SaveContainer {
+public:
+    static const uint32_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+    static bool isContainer(const uint8_t* data, size_t size);
+    static bool isContainerFile(const std::string& path);
+
+    static std::vector<uint8_t> pack(const uint8_t* raw, size_t size, uint32_t blockSize = DEFAULT_BLOCK_SIZE);
+    // false (and a log line) if the container is truncated, malformed or fails a checksum
+    static bool unpack(const uint8_t* data, size_t size, std::vector<uint8_t>& raw);
+
+    // A save file as raw bytes: containers are unpacked, anything else is returned as is
+    static bool readFile(const std::string& path, std::vector<uint8_t>& raw);
+    // Same, but a raw file stays mapped in place (MappedFile::open); containers are unpacked
+    // to the heap. Empty on failure. 'compressed' (optional) tells whether it was a container.
+    static MappedFile mapFile(const std::string& path, bool* compressed = nullptr);
+    // Atomic write (FileLoader::saveFileAtomic), packed when 'compressed'
+    static bool writeFile(const std::string& path, const uint8_t* raw, size_t size, bool compressed);
+    // Write 'src' (container or raw) to 'dst' in the original raw format.
+    // Refused if 'src' has a journal: paged S*/D*.grp go through PagedFile::exportRaw.
+    static bool exportRaw(const std::string& src, const std::string& dst);
+};
@@ -0,0 +1,138 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <utility>
+#include "MappedFile.h"
+#include "RecordTable.h"
+
+// ranger.idx: 存档 (ranger.grp / R*.grp) 各段的起始偏移
+// 头部 | Role | Item | Scene | Magic | WeiShop，totalLength 是整个文件的长度
+struct SaveLayout {
+    int32_t roleOffset = 0;
+    int32_t itemOffset = 0;
+    int32_t sceneOffset = 0;
+    int32_t magicOffset = 0;
+    int32_t shopOffset = 0;
+    int32_t totalLength = 0;
+
+    // Sections are in order and the file is not empty
+    bool valid() const {
+        return roleOffset >= 0 && roleOffset <= itemOffset && itemOffset <= sceneOffset &&
+               sceneOffset <= magicOffset && magicOffset <= shopOffset && shopOffset <= totalLength &&
+               totalLength > 0;
+    }
+
+    // Read the six offsets from ranger.idx. false (and a log line) if missing or invalid.
+    static bool load(const std::string& idxPath, SaveLayout& out);
+};
+
+// 在一块连续内存中拼出整个存档，最后一次写出。
+// 未写入的字节 (段尾、放不下的记录) 保持为 0，与原逐字段写法的结果逐字节相同。
+class SaveImageWriter {
+public:
+    explicit SaveImageWriter(const SaveLayout& layout)
+        : m_layout(layout), m_bytes(static_cast<size_t>(std::max(layout.totalLength, 0)), 0) {}
+
+    // int16 header values from offset 0; anything past roleOffset is dropped
+    void putHeader(const std::vector<int16_t>& values);
+
+    // Whole records of 'recordValues' int16 each into [begin, end). Records that do not
+    // fit are dropped. Returns the number of records written.
+    template <typename T>
+    size_t putTable(int32_t begin, int32_t end, const std::vector<T>& records, size_t recordValues) {
+        const size_t recordBytes = recordValues * sizeof(int16_t);
+        size_t capacity = sectionBytes(begin, end);
+        if (recordBytes == 0) return 0;
+        size_t count = std::min(records.size(), capacity / recordBytes);
+        uint8_t* out = m_bytes.data() + begin;
+        for (size_t i = 0; i < count; ++i) {
+            size_t values = std::min(records[i].getDataSize(), recordValues);
+            std::memcpy(out + i * recordBytes, records[i].getRawData(), values * sizeof(int16_t));
+        }
+        return count;
+    }
+
+    // A RecordTable is already laid out like the section: one copy
+    template <typename T, size_t N>
+    size_t putTable(int32_t begin, int32_t end, const RecordTable<T, N>& records) {
+        const size_t recordBytes = N * sizeof(int16_t);
+        size_t count = std::min(records.size(), sectionBytes(begin, end) / recordBytes);
+        if (count > 0) std::memcpy(m_bytes.data() + begin, records.data(), count * recordBytes);
+        return count;
+    }
+
+    // Raw bytes into [begin, end), truncated to the section
+    void putBytes(int32_t begin, int32_t end, const std::vector<uint8_t>& bytes);
+
+    const SaveLayout& layout() const { return m_layout; }
+    const std::vector<uint8_t>& bytes() const { return m_bytes; }
+
+    // One atomic write (FileLoader::saveFileAtomic); a SaveContainer when 'compressed'
+    bool writeTo(const std::string& path, bool compressed = false) const;
+
+private:
+    size_t sectionBytes(int32_t begin, int32_t end) const;
+
+    SaveLayout m_layout;
+    std::vector<uint8_t> m_bytes;
+};
+
+// 读档: 整个存档一次读入 (SaveContainer::readFile) 后，头部与各表按 ranger.idx 的偏移整段拷贝。
+// 文件比 totalLength 短时缺的部分按 0 处理 (原逐字段读法读到文件尾后也不再写入)。
+class SaveImageReader {
+public:
+    SaveImageReader(const SaveLayout& layout, std::vector<uint8_t> bytes)
+        : m_layout(layout), m_bytes(MappedFile::fromBuffer(std::move(bytes))) {}
+    // Read in place from a mapping (see SaveContainer::mapFile)
+    SaveImageReader(const SaveLayout& layout, MappedFile bytes)
+        : m_layout(layout), m_bytes(std::move(bytes)) {}
+
+    const SaveLayout& layout() const { return m_layout; }
+    size_t size() const { return m_bytes.size(); }
+
+    // int16 values of [0, roleOffset)
+    std::vector<int16_t> header() const;
+
+    // Whole records of 'recordValues' int16 each from [begin, end) into 'records'
+    // (resized to the number of records). Returns the number of records.
+    template <typename T>
+    size_t getTable(int32_t begin, int32_t end, std::vector<T>& records, size_t recordValues) const {
+        const size_t recordBytes = recordValues * sizeof(int16_t);
+        size_t count = recordBytes == 0 ? 0 : sectionBytes(begin, end, false) / recordBytes;
+        records.clear();
+        records.resize(count);
+        size_t available = sectionBytes(begin, end, true);
+        const uint8_t* in = count > 0 ? m_bytes.data() + begin : nullptr;
+        for (size_t i = 0; i < count; ++i) {
+            size_t at = i * recordBytes;
+            if (at >= available) break;
+            size_t bytes = std::min({ records[i].getDataSize() * sizeof(int16_t), recordBytes, available - at });
+            std::memcpy(records[i].getRawData(), in + at, bytes);
+        }
+        return count;
+    }
+
+    template <typename T, size_t N>
+    size_t getTable(int32_t begin, int32_t end, RecordTable<T, N>& records) const {
+        const size_t recordBytes = N * sizeof(int16_t);
+        size_t count = sectionBytes(begin, end, false) / recordBytes;
+        records.clear();
+        records.resize(count);
+        size_t bytes = std::min(count * recordBytes, sectionBytes(begin, end, true));
+        if (bytes > 0) std::memcpy(records.data(), m_bytes.data() + begin, bytes);
+        return count;
+    }
+
+    // Raw bytes of [begin, end); bytes past the end of the file are 0
+    std::vector<uint8_t> getBytes(int32_t begin, int32_t end) const;
+
+private:
+    // Bytes of [begin, end) by the layout, or only those present in the file
+    size_t sectionBytes(int32_t begin, int32_t end, bool presentOnly) const;
+
+    SaveLayout m_layout;
+    MappedFile m_bytes;
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// 存档位说明文件 R*.inf (与 R*.grp 放在一起，存档成功后写出)
+// 存档菜单只读每个存档位的固定头部 (约一百字节)，不必打开整个存档；
+// 缩略图 (RGB565) 跟在头部后面，只在需要显示时才读。
+// 原版不认识这个文件，缺失时菜单只显示存档位名称。
+struct SaveSlotInfo {
+    static constexpr uint16_t VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 96;
+    static constexpr size_t NAME_BYTES = 16;   // GBK, zero padded
+    static constexpr int MAX_TEAM = 6;
+
+    int16_t sceneId = -1;                  // -1: world map
+    std::string sceneName;                 // GBK, as stored in the scene record
+    int16_t mapX = 0;
+    int16_t mapY = 0;
+    std::string leadName;                  // GBK
+    int16_t leadLevel = 0;
+    std::vector<int16_t> team;             // role ids, at most MAX_TEAM
+    int64_t savedAt = 0;                   // unix seconds
+    uint16_t thumbWidth = 0;
+    uint16_t thumbHeight = 0;
+    std::vector<uint16_t> thumbnail;       // RGB565, thumbWidth * thumbHeight; empty if not read
+
+    // "save/R1.grp" -> "save/R1.inf"
+    static std::string pathFor(const std::string& grpPath);
+
+    std::vector<uint8_t> serialize() const;
+    // false if the magic, version or sizes do not match. The thumbnail is only
+    // decoded when 'withThumbnail' is set (and the data is long enough).
+    static bool parse(const uint8_t* data, size_t size, SaveSlotInfo& out, bool withThumbnail);
+
+    // Atomic write (FileLoader::saveFileAtomic)
+    bool writeTo(const std::string& path) const;
+    // Reads only the header unless 'withThumbnail'. false (quietly) if the file is missing.
+    static bool read(const std::string& path, SaveSlotInfo& out, bool withThumbnail = false);
+
+    // Point-samples a 32-bit XRGB/ARGB frame down to an outW x outH RGB565 image
+    static std::vector<uint16_t> downscale(const uint32_t* pixels, int width, int height, int pitchBytes,
+                                           int outW, int outH);
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <string>
+
+// 后台存档线程
+// 主线程先把要写的内容做成快照，再提交 (写盘函数, 完成回调)。写盘函数在工作线程上
+// 按提交顺序执行；完成回调在主线程调用 poll() / wait() 时执行，因此回调里可以直接
+// 改游戏状态 (标记记录干净、显示提示)。
+class SaveWorker {
+public:
+    // Runs on the worker thread. Return false and fill 'error' on failure.
+    using WriteFunc = std::function<bool(std::string& error)>;
+    // Runs on the main thread from poll()/wait()
+    using DoneFunc = std::function<void(bool ok, const std::string& error)>;
+
+    SaveWorker() = default;
+    ~SaveWorker(); // finishes every submitted write before returning
+
+    SaveWorker(const SaveWorker&) = delete;
+    SaveWorker& operator=(const SaveWorker&) = delete;
+
+    void submit(WriteFunc write, DoneFunc done);
+
+    // Call once per frame: runs the callbacks of finished writes. Returns how many ran.
+    int poll();
+    // Block until every submitted write finished, then poll()
+    void wait();
+
+    // A write is queued or running, or a callback has not been polled yet
+    bool busy() const;
+
+private:
+    struct Job {
+        WriteFunc write;
+        DoneFunc done;
+        bool ok = false;
+        std::string error;
+    };
+
+    void workerLoop();
+
+    std::thread m_worker;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::deque<Job> m_pending;  // waiting for the worker (the front one may be running)
+    std::deque<Job> m_finished; // waiting for poll()
+    bool m_stop = false;
+};
@@ -1,5 +1,6 @@
 #pragma once
 #include "GameObject.h"
+#include "RecordTable.h"
 #include <string>
 
 constexpr size_t SCENE_DATA_SIZE = 26; // Pascal TScene size (0..25)
@@ -7,6 +8,8 @@ constexpr size_t SCENE_DATA_SIZE = 26; // Pascal TScene size (0..25)
 class Scene : public GameObject {
 public:
     Scene() : GameObject(SCENE_DATA_SIZE) {}
+    // View of record data in a SceneTable
+    explicit Scene(int16* data) : GameObject(data, SCENE_DATA_SIZE) {}
     virtual ~Scene() = default;
 
     // 0: ListNum
@@ -60,3 +63,5 @@ public:
     // 23: mapnum
     int16 getMapNum() const { return m_data[23]; }
 };
+
+using SceneTable = RecordTable<Scene, SCENE_DATA_SIZE>;
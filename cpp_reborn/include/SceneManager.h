@@ -1,29 +1,117 @@
 #pragma once
 #include <vector>
 #include <string>
+#include <cassert>
 #include <SDL3/SDL.h>
 #include "Scene.h"
+#include "MappedFile.h"
+#include "TileLayer.h"
+#include "WorldMap.h"
+#include "SpriteCache.h"
+#include "MemoryStats.h"
 #include "GameTypes.h" // Assuming this exists or I should create it for common types
 
 // Constants
 constexpr int MAX_SCENES = 100; // Adjust as needed
 constexpr int SCENE_MAP_SIZE = 64;
 constexpr int SCENE_LAYERS = 6;
+constexpr int SCENE_PAGE_LIMIT = 8; // SData/DData scenes kept resident (dirty ones are never dropped)
+constexpr size_t MAP_RECORD_SIZE = SCENE_LAYERS * SCENE_MAP_SIZE * SCENE_MAP_SIZE * sizeof(int16_t); // one scene in SData
+
+// 场景一格的全部图层 (SData[scene, 0..5, x, y])
+// 0 地面, 1 建筑, 2 装饰, 3 事件编号, 4 建筑高度, 5 装饰高度
+struct SceneTile {
+    int16_t layer[SCENE_LAYERS];
+};
+static_assert(sizeof(SceneTile) == SCENE_LAYERS * sizeof(int16_t), "SceneTile must match the interleaved record");
+
+// 一个场景全部 64x64 格的只读视图。场景编号只在 GetSceneTiles() 检查一次，
+// 之后直接访问内存；坐标只在 Debug 构建中 assert。
+// 视图在换入其他场景 (LRU 淘汰) 或重新 LoadMapData 之前有效，不要跨帧保存。
+class SceneTileView {
+public:
+    bool valid() const { return m_tiles != nullptr; }
+    explicit operator bool() const { return valid(); }
+
+    // 固定 x 的一行 SCENE_MAP_SIZE 格 (文件中 index = x * 64 + y)
+    const SceneTile* row(int x) const {
+        assert(m_tiles && x >= 0 && x < SCENE_MAP_SIZE);
+        return m_tiles + x * SCENE_MAP_SIZE;
+    }
+    const SceneTile& at(int x, int y) const {
+        assert(y >= 0 && y < SCENE_MAP_SIZE);
+        return row(x)[y];
+    }
+    int16_t get(int layer, int x, int y) const {
+        assert(layer >= 0 && layer < SCENE_LAYERS);
+        return at(x, y).layer[layer];
+    }
+
+private:
+    friend class SceneManager;
+    const SceneTile* m_tiles = nullptr;
+};
+
+// 驻留场景在内存中的形式，文件格式不受影响。
+// 按场景扫描 (SceneTileView) 时交错与平面布局一样快 (见 bench_scene_layout)；
+// 默认用交错布局是因为 SceneTileView 可以直接指向驻留记录，平面或紧凑布局都要先转置一份。
+enum class SceneLayout {
+    Interleaved, // [tile][layer] (默认)
+    Compact      // 每层 dense / run-length / sparse，内存约为前者的 1/4
+};
 
 class SceneManager {
 public:
     static SceneManager& getInstance();
 
     bool Init();
-    bool LoadEventData(const std::string& path); // Loads Event Data (DData) from alldef.grp
-    bool LoadMapData(const std::string& path); // Loads Map data (SData) from allsin.grp
+    // Opens Event Data (DData, alldef.grp) / Map data (SData, allsin.grp).
+    // Scenes are paged in on first access and kept in a small LRU
+    bool LoadEventData(const std::string& path);
+    bool LoadMapData(const std::string& path);
+    // Both of a save slot at once: checks that both open before switching either,
+    // so on failure the current scenes (unsaved changes included) stay as they are
+    bool LoadSaveData(const std::string& mapPath, const std::string& eventPath);
     
-    // Save Data
+    // Save Data (same file: modified scenes patched in, then replaced atomically)
     bool SaveEventData(const std::string& path);
     bool SaveMapData(const std::string& path);
+    // Background save: copy the dirty scenes now, write them on another thread,
+    // then commit on the main thread (see PagedFile::snapshot)
+    PagedFile::Snapshot SnapshotEventData(const std::string& path) const { return m_eventPages.snapshot(path); }
+    PagedFile::Snapshot SnapshotMapData(const std::string& path) const { return MapStore().snapshot(path); }
+    void CommitEventData(const PagedFile::Snapshot& snap, bool written) { m_eventPages.commit(snap, written); }
+    void CommitMapData(const PagedFile::Snapshot& snap, bool written) { MapStore().commit(snap, written); }
+
+    // Quicksave: in-memory copies of SData/DData, sharing unchanged scenes with 'previous'
+    bool CaptureMapData(PagedFile::Image& out, const PagedFile::Image* previous, bool deferReads = false) const {
+        return MapStore().capture(out, previous, deferReads);
+    }
+    bool CaptureEventData(PagedFile::Image& out, const PagedFile::Image* previous, bool deferReads = false) const {
+        return m_eventPages.capture(out, previous, deferReads);
+    }
+    // Bytes the two captures would copy on the main thread
+    uint64_t CaptureBytes(const PagedFile::Image* previousMap, const PagedFile::Image* previousEvents, bool deferReads) const {
+        return MapStore().captureBytes(previousMap, deferReads) + m_eventPages.captureBytes(previousEvents, deferReads);
+    }
+    // Quickload: no disk access; replaced scenes become dirty
+    bool RestoreSaveData(const PagedFile::Image& map, const PagedFile::Image& events);
+    const std::string& MapSourcePath() const { return MapStore().sourcePath(); }
+    const std::string& EventSourcePath() const { return m_eventPages.sourcePath(); }
+    // SData/DData files in the original raw format, journal applied; 'src' is left as it is
+    static bool ExportMapData(const std::string& src, const std::string& dst);
+    static bool ExportEventData(const std::string& src, const std::string& dst);
+
+    // Save format for SData/DData (see PagedFile::WriteMode). Journal saves must be
+    // compacted before the original game can read the slot: PagedFile does it when the source
+    // switches to another slot, GameManager for the current slot on quit.
+    void SetSaveWriteMode(PagedFile::WriteMode mode);
+    bool CompactSaveData();
+    // SData/DData saves written as SaveContainer (see PagedFile::setCompressed)
+    void SetSaveCompression(bool compressed);
 
     // Set Scenes (loaded from ranger.grp/save file)
-    void SetScenes(const std::vector<Scene>& scenes);
+    void SetScenes(SceneTable scenes);
     
     // Core drawing function
     // centerX, centerY: Tile coordinates of the camera center (player position)
@@ -44,6 +132,15 @@ public:
     // Accessors for SData equivalent
     int16_t GetSceneTile(int sceneId, int layer, int x, int y) const;
     void SetSceneTile(int sceneId, int layer, int x, int y, int16_t value);
+    // All layers of one tile; false (and 'out' untouched) if out of range or not loaded
+    bool GetSceneTileRecord(int sceneId, int x, int y, SceneTile& out) const;
+    // Whole scene for loops over many tiles; invalid view if the scene is not available.
+    // Writes still go through SetSceneTile (which keeps the view current).
+    SceneTileView GetSceneTiles(int sceneId) const;
+
+    // Takes effect at the next LoadMapData
+    void SetSceneLayout(SceneLayout layout) { m_sceneLayout = layout; }
+    SceneLayout GetSceneLayout() const { return m_sceneLayout; }
     
     // Update Event Position in Map (Layer 3)
     void UpdateEventPosition(int sceneId, int eventId, int oldX, int oldY, int newX, int newY);
@@ -57,13 +154,20 @@ public:
     // Accessors for Scene definitions
     Scene* GetScene(int sceneId);
     size_t GetSceneCount() const { return m_scenes.size(); }
-    const std::vector<Scene>& getScenes() const { return m_scenes; }
+    const SceneTable& getScenes() const { return m_scenes; }
     
     // 刷新事件层 (根据 DData 同步 SData 的 Layer 3)
     void RefreshEventLayer(int sceneId);
     
     // 加载资源 (贴图等)
     bool LoadResources();
+
+    // 开发模式热重载: 重新加载 name (VirtualFS 规范名) 所属的资源。
+    // 返回 false 表示该文件不归 SceneManager 管或重载失败
+    bool ReloadResource(const std::string& name);
+
+    // 内存统计: 逐项报告当前持有的资源
+    void ReportMemory(MemoryStats& stats) const;
     
     // Testing Helper
     void CreateMockScene(int id);
@@ -93,6 +197,9 @@ public:
     void ResetEntrance();
     int16_t GetEntrance(int x, int y) const;
 
+    // 大地图全部图层 (与 GameManager 共用)
+    const WorldMap& GetWorldMap() const { return m_worldMap; }
+
 private:
     SceneManager();
     ~SceneManager() = default;
@@ -100,45 +207,68 @@ private:
     SceneManager& operator=(const SceneManager&) = delete;
 
     // 大地图数据 (World Map) - 对应 Pascal 中的
-    // earth, surface, building, buildx, buildy 五个数组
-    // 坐标范围 0..479 x 0..479, 存储方式: index = x * 480 + y
-    std::vector<int16_t> m_worldEarth;    // EARTH.002
-    std::vector<int16_t> m_worldSurface;  // surface.002
-    std::vector<int16_t> m_worldBuilding; // building.002
-    std::vector<int16_t> m_worldBuildX;   // buildx.002
-    std::vector<int16_t> m_worldBuildY;   // buildy.002
-    std::vector<int16_t> m_worldEntrance; // Entrance: 世界坐标到场景编号映射
-    int m_worldMapWidth = 480;
-    int m_worldMapHeight = 480;
+    // earth, surface, building, buildx, buildy, Entrance，每格一条记录
+    WorldMap m_worldMap;
     
     // 战斗地图资源 (WarMap) - wmp/wdx
-    std::vector<uint8_t> m_wmpPicData; // wmp
-    std::vector<int32_t> m_wmpIdxData; // wdx
+    MappedFile m_wmpPicData; // wmp
+    MappedFile::View<int32_t> m_wmpIdxData; // wdx
 
     // Helper to draw World Map
     void DrawWorldMap(SDL_Renderer* renderer, int centerX, int centerY);
     bool LoadWorldMap();
 
+    // LoadResources 的各个部分，可单独重载
+    bool LoadSceneTiles();    // smp/sdx
+    bool LoadMmapSprites();   // mmap.grp/mmap.idx
+    bool LoadScenePics();     // Scene.Pic
+    bool LoadCloudSprites();  // cloud.grp/cloud.idx
+    bool LoadWarMapSprites(); // wmp/wdx
+    void LoadPalette();       // MMAP.COL
+    void FreeScenePics();
+
     // Scene Definitions
-    std::vector<Scene> m_scenes;
+    SceneTable m_scenes;
     
-    // Map Data: [SceneId][Layer][Y][X]
-    std::vector<int16_t> m_mapData;
+    // Map Data: [SceneId][Layer][X][Y] on disk, one page per scene.
+    // Only the store matching m_sceneLayout is open.
+    SceneLayout m_sceneLayout = SceneLayout::Interleaved;
+    mutable InterleavedTileFile m_mapTiles{ SCENE_LAYERS, SCENE_MAP_SIZE * SCENE_MAP_SIZE };
+    mutable TileLayerFile m_mapPages{ SCENE_LAYERS, SCENE_MAP_SIZE * SCENE_MAP_SIZE };
+    PagedFile& MapStore() const;
+    void OpenMapData(PagedFile::Source&& source);
+    // Compact 布局下 GetSceneTiles 展开的场景 (每次只缓存一个)
+    mutable std::vector<SceneTile> m_tileScratch;
+    mutable int m_scratchSceneId = -1;
 
     // Event Data: [SceneId][EventId][Index]
     // EventId max 200, Index max 11
     struct EventData {
         int16_t data[200][11];
     };
-    std::vector<EventData> m_eventData;
+    mutable RawPagedFile m_eventPages;
+    void OpenEventData(PagedFile::Source&& source, const std::string& path);
+
+    // Resident scene page, nullptr if out of range
+    const TileLayer* SceneTiles(int sceneId) const; // SCENE_LAYERS layers (Compact layout)
+    const EventData* SceneEvents(int sceneId) const;
     
     // 场景图块资源 (SceneMap) - smp/sdx
-    std::vector<uint8_t> m_smpPicData; // smp
-    std::vector<int32_t> m_smpIdxData; // sdx
+    MappedFile m_smpPicData; // smp
+    MappedFile::View<int32_t> m_smpIdxData; // sdx
     
     // 大地图资源 (MaxMap) - mmap.grp/mmap.idx
-    std::vector<uint8_t> m_mmpPicData; // mmp
-    std::vector<int32_t> m_mmpIdxData; // midx
+    MappedFile m_mmpPicData; // mmp
+    MappedFile::View<int32_t> m_mmpIdxData; // midx
+
+    // 预解码贴图缓存 (cache/*.kcc)，未就绪时退回 DrawRLE8
+    SpriteCache m_smpSprites;
+    SpriteCache m_mmpSprites;
+    SpriteCache m_cloudSprites;
+
+    // Draw RLE sprite 'index' from 'cache', or decode the raw RLE at 'offset' if the cache has no entry
+    void DrawRLEPic(SDL_Surface* screen, const SpriteCache& cache, const MappedFile& pics,
+                    int index, int offset, int x, int y, float scale = 1.0f);
 
     // 动态场景贴图 (Scene.Pic) - PNG 格式集合
     struct ScenePic {
@@ -156,8 +286,8 @@ private:
         int alpha;
     };
     std::vector<Cloud> m_clouds;
-    std::vector<uint8_t> m_cloudPicData; // cloud.grp
-    std::vector<int32_t> m_cloudIdxData; // cloud.idx
+    MappedFile m_cloudPicData; // cloud.grp
+    MappedFile::View<int32_t> m_cloudIdxData; // cloud.idx
     
     int m_currentSceneId;
     
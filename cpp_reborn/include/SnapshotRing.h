@@ -0,0 +1,41 @@
+#pragma once
+#include <deque>
+#include <memory>
+#include <cstddef>
+
+// 最近 capacity 份快照 (快速存档)。新的放在最前，满了丢掉最旧的。
+// 元素以 shared_ptr<const T> 保存：后台写盘时拿着一份引用，环转走了也不会失效。
+template <typename T>
+class SnapshotRing {
+public:
+    explicit SnapshotRing(size_t capacity = 4) : m_capacity(capacity > 0 ? capacity : 1) {}
+
+    size_t capacity() const { return m_capacity; }
+    size_t size() const { return m_items.size(); }
+    bool empty() const { return m_items.empty(); }
+
+    // Drops the oldest entries that no longer fit
+    void setCapacity(size_t capacity) {
+        m_capacity = capacity > 0 ? capacity : 1;
+        while (m_items.size() > m_capacity) m_items.pop_back();
+    }
+
+    std::shared_ptr<const T> push(T value) {
+        auto item = std::make_shared<const T>(std::move(value));
+        m_items.push_front(item);
+        if (m_items.size() > m_capacity) m_items.pop_back();
+        return item;
+    }
+
+    // age 0 = newest; nullptr if there are not that many
+    std::shared_ptr<const T> at(size_t age) const {
+        return age < m_items.size() ? m_items[age] : nullptr;
+    }
+    std::shared_ptr<const T> latest() const { return at(0); }
+
+    void clear() { m_items.clear(); }
+
+private:
+    size_t m_capacity;
+    std::deque<std::shared_ptr<const T>> m_items;
+};
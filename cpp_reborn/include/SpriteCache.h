@@ -0,0 +1,90 @@
+#pragma once
+#include <SDL3/SDL.h>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "MappedFile.h"
+
+// 预解码贴图缓存 (cache/*.kcc)
+// 首次运行时把 RLE8 贴图 (smp, mmap.grp, cloud.grp) 解码为 8 位调色板索引 + 不透明掩码，
+// 把 PNG 贴图 (Scene.Pic, Heads.Pic) 解码为 ARGB8888，写入缓存文件；之后直接映射使用。
+// 保留调色板索引是因为水面调色板轮换 (ChangeCol) 和阴影需要在绘制时查表。
+// 缓存头记录源文件的 大小 / 修改时间 / FNV 哈希，任何一项对不上就重建；
+// 重建失败时 isOpen() 为 false，调用方继续走原始 RLE/PNG 路径。
+class SpriteCache {
+public:
+    enum Kind : uint32_t {
+        KIND_RLE8 = 1, // pixels = palette index plane, mask = opaque plane
+        KIND_ARGB = 2  // pixels = ARGB8888, mask = nullptr
+    };
+
+    struct Sprite {
+        int w = 0, h = 0;
+        int x = 0, y = 0;   // RLE8: hotspot (xs, ys); ARGB: Pic x, y
+        int black = 0;      // ARGB only (Pic header)
+        int stride = 0;     // bytes per row, multiple of 16
+        const uint8_t* pixels = nullptr;
+        const uint8_t* mask = nullptr;
+    };
+
+    // RLE8 archive where idx[i] is the start offset of sprite i (smp/sdx, mmap.grp/mmap.idx ...)
+    bool openRLE(const std::string& grpName, const std::string& idxName, const std::string& cacheName);
+
+    // .Pic archive (count, end-offset table, then x/y/black + PNG per entry), PicLoader indexing
+    bool openPic(const std::string& picName, const std::string& cacheName);
+
+    void close();
+    bool isOpen() const { return !m_file.empty(); }
+    size_t count() const { return m_count; }
+    size_t sizeBytes() const { return m_file.size(); }
+    bool isMapped() const { return m_file.isMapped(); }
+
+    // false if out of range or the sprite is empty
+    bool get(int index, Sprite& out) const;
+
+    // New surface copied from an ARGB entry (caller owns it), nullptr if absent
+    SDL_Surface* createSurface(int index) const;
+
+    // Directory the caches are written to (relative to the working dir, like save/)
+    static const char* CACHE_DIR;
+
+private:
+#pragma pack(push, 1)
+    struct CacheHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t kind;
+        uint32_t count;
+        uint32_t reserved;
+        uint64_t srcSize;
+        int64_t srcMtime;
+        uint64_t srcHash;
+        uint8_t padding[16];
+    };
+
+    struct CacheEntry {
+        int32_t w, h, x, y, black;
+        uint32_t stride;
+        uint64_t offset;
+    };
+#pragma pack(pop)
+
+    struct SourceKey {
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        uint64_t hash = 0;
+    };
+
+    bool openOrBuild(Kind kind, const std::vector<std::string>& sources, const std::string& cacheName);
+    bool adopt(MappedFile file, Kind kind);
+
+    static SourceKey statSources(const std::vector<std::string>& sources);
+    static uint64_t hashSources(const std::vector<MappedFile>& data);
+    static std::vector<uint8_t> buildRLE(const MappedFile& grp, const MappedFile& idx);
+    static std::vector<uint8_t> buildPic(const MappedFile& pic);
+
+    MappedFile m_file;
+    const CacheEntry* m_entries = nullptr;
+    uint32_t m_count = 0;
+    uint32_t m_kind = 0;
+};
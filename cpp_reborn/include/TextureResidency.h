@@ -0,0 +1,56 @@
+#pragma once
+#include <SDL3/SDL.h>
+#include <functional>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+
+// 纹理驻留管理
+// 一组按槽位编号的纹理 (例如 Background.Pic 的 11 张菜单底图)：第一次 acquire() 时才创建，
+// 之后每次使用都刷新时间戳；trim() 释放超过 idle 时间未使用的纹理。
+// 菜单每帧都会 acquire 自己的底图，所以“菜单关闭一段时间后释放”就是“超过 idle 时间未使用”。
+// 只能在渲染线程调用；析构时不会调用 SDL，渲染器销毁前请先 releaseAll()。
+class TextureResidency {
+public:
+    // Create the texture for 'slot', or nullptr if it does not exist
+    using LoadFunc = std::function<SDL_Texture*(int slot)>;
+
+    struct SlotStats {
+        uint32_t loads = 0;     // textures created
+        uint32_t hits = 0;      // acquire() served from a resident texture
+        uint32_t evictions = 0; // textures released by trim()
+        uint64_t bytes = 0;     // estimated size while resident (w * h * 4)
+        uint64_t lastUsedMs = 0;
+    };
+
+    void init(int slotCount, LoadFunc loader, uint64_t idleReleaseMs);
+    bool isInitialized() const { return !m_slots.empty(); }
+
+    // Resident texture for 'slot', loading it on first use
+    SDL_Texture* acquire(int slot);
+
+    // Release textures that have not been acquired for idleReleaseMs.
+    // Returns the number of textures released.
+    int trim(uint64_t nowMs);
+
+    // Destroy every resident texture (stats are kept)
+    void releaseAll();
+
+    int residentCount() const;
+    uint64_t residentBytes() const;
+    const SlotStats& stats(int slot) const { return m_slots[slot].stats; }
+    int slotCount() const { return static_cast<int>(m_slots.size()); }
+
+    void printStats(std::ostream& os, const char* const* names = nullptr) const;
+
+private:
+    struct Slot {
+        SDL_Texture* texture = nullptr;
+        bool missing = false; // loader returned nullptr; don't retry every frame
+        SlotStats stats;
+    };
+
+    std::vector<Slot> m_slots;
+    LoadFunc m_loader;
+    uint64_t m_idleReleaseMs = 0;
+};
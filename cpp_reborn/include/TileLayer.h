@@ -0,0 +1,135 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include "PagedFile.h"
+
+// 单个场景图层 (64 x 64 个 int16) 的紧凑存储
+// 事件层、高度层、装饰层大部分是 0 或 -1，按内容选择最小的表示:
+//   Dense  - 原样数组
+//   Runs   - 游程: 每段的起始下标 + 值 (大片相同值)
+//   Sparse - 一个填充值 + 少量 (下标, 值) (零星几个非默认格子)
+// get() 按种类分派；set() 改动非 Dense 图层时先展开为 Dense，compact() 重新选择表示。
+class TileLayer {
+public:
+    enum class Kind : uint8_t { Dense, Runs, Sparse };
+
+    // Copy 'count' tiles (at most 65536) and pick the smallest representation
+    void assign(const int16_t* tiles, size_t count);
+    void copyTo(int16_t* out) const;
+    void clear();
+
+    int16_t get(size_t i) const {
+        switch (m_kind) {
+        case Kind::Dense:
+            return m_dense[i];
+        case Kind::Runs: {
+            // 最后一个 start <= i 的游程
+            auto it = std::upper_bound(m_index.begin(), m_index.end(), static_cast<uint16_t>(i));
+            return m_values[(it - m_index.begin()) - 1];
+        }
+        case Kind::Sparse: {
+            auto it = std::lower_bound(m_index.begin(), m_index.end(), static_cast<uint16_t>(i));
+            if (it != m_index.end() && *it == i) return m_values[it - m_index.begin()];
+            return m_fill;
+        }
+        }
+        return 0;
+    }
+
+    void set(size_t i, int16_t value);
+
+    // Re-pick the representation from the current contents (after a batch of writes)
+    void compact();
+
+    Kind kind() const { return m_kind; }
+    size_t size() const { return m_size; }
+    size_t memoryBytes() const;
+
+private:
+    Kind m_kind = Kind::Dense;
+    size_t m_size = 0;
+    int16_t m_fill = 0;              // Sparse: value of every tile not listed
+    std::vector<int16_t> m_dense;    // Dense
+    std::vector<uint16_t> m_index;   // Runs: run start, Sparse: tile index (both ascending)
+    std::vector<int16_t> m_values;   // value per m_index entry
+};
+
+// 每条记录由 layerCount 个图层组成的分页文件 (allsin.grp / S*.grp)，驻留场景以 TileLayer 保存
+class TileLayerFile : public PagedFile {
+public:
+    TileLayerFile(size_t layerCount, size_t tilesPerLayer)
+        : m_layerCount(layerCount), m_tilesPerLayer(tilesPerLayer) {}
+
+    using PagedFile::open;
+    bool open(const std::string& filename, size_t maxResident) {
+        return PagedFile::open(filename, m_layerCount * m_tilesPerLayer * sizeof(int16_t), maxResident);
+    }
+
+    // Layers of record 'index' (m_layerCount of them), paged in on first use; nullptr if unavailable
+    const TileLayer* layers(size_t index) {
+        return touch(index) ? &m_layers[index * m_layerCount] : nullptr;
+    }
+    // Same as layers(), and marks the record dirty
+    TileLayer* modifyLayers(size_t index) {
+        if (!touch(index)) return nullptr;
+        markDirty(index);
+        return &m_layers[index * m_layerCount];
+    }
+
+    size_t layerCount() const { return m_layerCount; }
+    size_t tilesPerLayer() const { return m_tilesPerLayer; }
+
+protected:
+    void resize(size_t count) override;
+    void decode(size_t index, const uint8_t* raw) override;
+    void encode(size_t index, uint8_t* out) const override;
+    void release(size_t index) override;
+    size_t payloadBytes(size_t index) const override;
+    void onWritten(size_t index) override;
+
+private:
+    size_t m_layerCount;
+    size_t m_tilesPerLayer;
+    std::vector<TileLayer> m_layers; // record * m_layerCount + layer
+};
+
+// 同一种文件的另一种内存布局: 一格的所有图层连续存放 ([tile][layer])，
+// 整个场景可以直接当作 SceneTile 数组读取。只在读入 (decode) 和写出 (encode) 时与原 [layer][tile] 布局互转。
+class InterleavedTileFile : public PagedFile {
+public:
+    InterleavedTileFile(size_t layerCount, size_t tilesPerLayer)
+        : m_layerCount(layerCount), m_tilesPerLayer(tilesPerLayer) {}
+
+    using PagedFile::open;
+    bool open(const std::string& filename, size_t maxResident) {
+        return PagedFile::open(filename, m_layerCount * m_tilesPerLayer * sizeof(int16_t), maxResident);
+    }
+
+    // m_layerCount values of tile 'tile' in record 'index'; nullptr if unavailable
+    const int16_t* tile(size_t index, size_t tile) {
+        return touch(index) ? &m_tiles[index][tile * m_layerCount] : nullptr;
+    }
+    // Same as tile(), and marks the record dirty
+    int16_t* modifyTile(size_t index, size_t tile) {
+        if (!touch(index)) return nullptr;
+        markDirty(index);
+        return &m_tiles[index][tile * m_layerCount];
+    }
+
+    size_t layerCount() const { return m_layerCount; }
+    size_t tilesPerLayer() const { return m_tilesPerLayer; }
+
+protected:
+    void resize(size_t count) override;
+    void decode(size_t index, const uint8_t* raw) override;
+    void encode(size_t index, uint8_t* out) const override;
+    void release(size_t index) override;
+    size_t payloadBytes(size_t index) const override { return m_tiles[index].capacity() * sizeof(int16_t); }
+
+private:
+    size_t m_layerCount;
+    size_t m_tilesPerLayer;
+    std::vector<std::vector<int16_t>> m_tiles; // per record: tile * m_layerCount + layer
+};
@@ -6,6 +6,9 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include "TextureResidency.h"
+#include "SpriteCache.h"
+#include "MemoryStats.h"
 
 class Role;
 
@@ -17,7 +20,11 @@ public:
     void Cleanup();
 
     // Resource Loading
-    bool LoadSystemGraphics(); // Loads Background.Pic and others
+    bool LoadSystemGraphics(); // Indexes Background.Pic; textures load on first use
+    void TrimSystemGraphics(); // Releases Background.Pic textures idle for a while (call once per frame)
+    void PrintTextureStats() const;
+    void ReportMemory(MemoryStats& stats) const;
+    bool ReloadResource(const std::string& name); // Dev hot reload (Background.Pic)
     void PlayTitleAnimation(); // Plays Begin.Pic
     void DrawTitleScreen();    // Draws Background.Pic index 0
     void DrawTitleBackground(); // Draws the last frame of Begin.Pic
@@ -65,8 +72,17 @@ public:
     // Force screen update (for blocking loops)
     void UpdateScreen();
 
+    // 不阻塞的一行提示 (例如后台存档完成)，显示 durationMs 毫秒
+    void SetStatusMessage(const std::string& textUtf8, uint32_t durationMs = 2000);
+    void DrawStatusMessage(); // call right before SDL_RenderPresent
+
     SDL_Renderer* GetRenderer() const { return m_renderer; }
 
+    // 打开菜单时截下的画面缩小成的存档缩略图 (RGB565)，没有截图时为空
+    static constexpr int SAVE_THUMB_W = 80;
+    static constexpr int SAVE_THUMB_H = 60;
+    const std::vector<uint16_t>& GetSaveThumbnail() const { return m_saveThumbnail; }
+
 private:
     UIManager();
     ~UIManager() = default;
@@ -82,21 +98,33 @@ private:
     // Need to verify color format. SDL3 usually uses SDL_Color.
     SDL_Color Uint32ToColor(uint32_t color);
 
-    // System Graphics from Background.Pic
-    SDL_Texture* m_texTitle = nullptr;    // Index 0
-    SDL_Texture* m_texMagic = nullptr;    // Index 1
-    SDL_Texture* m_texState = nullptr;    // Index 2
-    SDL_Texture* m_texSystem = nullptr;   // Index 3
-    SDL_Texture* m_texMap = nullptr;      // Index 4
-    SDL_Texture* m_texSkill = nullptr;    // Index 5
-    SDL_Texture* m_texMenuEsc = nullptr;  // Index 6
-    SDL_Texture* m_texMenuEscBack = nullptr; // Index 7
-    SDL_Texture* m_texBattle = nullptr;   // Index 8
-    SDL_Texture* m_texTeammate = nullptr; // Index 9
-    SDL_Texture* m_texMenuItem = nullptr; // Index 10
-    
+    // System Graphics from Background.Pic (按需加载，闲置后释放)
+    enum SystemTexture {
+        TEX_TITLE = 0,
+        TEX_MAGIC = 1,
+        TEX_STATE = 2,
+        TEX_SYSTEM = 3,
+        TEX_MAP = 4,
+        TEX_SKILL = 5,
+        TEX_MENU_ESC = 6,
+        TEX_MENU_ESC_BACK = 7,
+        TEX_BATTLE = 8,
+        TEX_TEAMMATE = 9,
+        TEX_MENU_ITEM = 10,
+        SYSTEM_TEXTURE_COUNT = 11
+    };
+    static const uint64_t SYSTEM_TEXTURE_IDLE_MS = 30000;
+    SDL_Texture* GetSystemTexture(SystemTexture id);
+    TextureResidency m_systemTextures;
+    SpriteCache m_backgroundSprites;
+    uint64_t m_lastTrimMs = 0;
+
+    std::string m_statusMessage;
+    uint64_t m_statusUntilMs = 0;
+
     SDL_Texture* m_texBeginBackground = nullptr; // Last frame of Begin.Pic
     SDL_Texture* m_texMenuBackground = nullptr; // Captured screen for transparency
+    std::vector<uint16_t> m_saveThumbnail;       // Same capture, SAVE_THUMB_W x SAVE_THUMB_H
 
     // Helper to load texture from surface and free surface
     SDL_Texture* LoadTextureFromPic(const std::string& filename, int index);
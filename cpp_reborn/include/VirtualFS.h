@@ -0,0 +1,67 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include "MappedFile.h"
+#include "ResourcePack.h"
+
+// 分层虚拟文件系统 (base → patch → mod1 → ...)
+// 每一层是一个目录或一个 .pak。mount() 时把该层的全部文件名并入同一张哈希表，
+// 上层覆盖下层；之后按名字查找只做一次哈希，不再逐层探测磁盘。
+// 文件名统一为小写、'/' 分隔、相对层根目录 (与 ResourcePack::normalizeName 一致)。
+//
+// 单条记录覆盖: 层里的 "<grp名>.d/<记录号>[.扩展名]" (例如 "kdef.grp.d/12.bin")
+// 替换该 grp 中的第 12 条记录，无需复制整个 grp/idx。更上层提供整个 grp 时，下层的记录覆盖不再生效。
+//
+// 构建完成后只读，可在多个线程中同时查询。
+class VirtualFS {
+public:
+    struct Entry {
+        int layer = -1;
+        std::string name; // normalized name
+        std::string path; // loose file on disk; empty when the entry lives in the layer's pack
+    };
+
+    // record index -> replacement entry
+    using RecordOverrides = std::map<int, Entry>;
+
+    // Mount a directory or a .pak on top of the current layers
+    bool mount(const std::string& root);
+    void clear();
+
+    // Top-most entry for a resource name, nullptr if no layer has it
+    const Entry* find(const std::string& name) const;
+
+    // Contents of an entry (zero-copy map for loose files and raw pack entries)
+    MappedFile map(const Entry& entry) const;
+
+    // Per-record overrides for a grp, nullptr if there are none
+    const RecordOverrides* recordOverrides(const std::string& grpName) const;
+
+    size_t layerCount() const { return m_layers.size(); }
+    size_t entryCount() const { return m_entries.size(); }
+    const std::string& layerRoot(int layer) const { return m_layers[layer].root; }
+    bool layerIsPack(int layer) const { return m_layers[layer].pack != nullptr; }
+    // Loose files of lower layers that this layer hides (edits to them have no effect)
+    size_t layerShadowedFiles(int layer) const { return m_layers[layer].shadowedFiles; }
+
+    // Mod roots under modsDir in load order (bottom first): the lines of
+    // modsDir/load_order.txt if present ('#' comments), otherwise every
+    // subdirectory and .pak sorted by name.
+    static std::vector<std::string> discoverMods(const std::string& modsDir);
+
+private:
+    struct Layer {
+        std::string root;
+        std::unique_ptr<ResourcePack> pack;
+        size_t shadowedFiles = 0;
+    };
+
+    void addEntry(Entry entry);
+
+    std::vector<Layer> m_layers;
+    std::unordered_map<std::string, Entry> m_entries;
+    std::unordered_map<std::string, RecordOverrides> m_records;
+};
@@ -0,0 +1,55 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Scene.h"
+
+// 大地图每格的全部数据 (对应 Pascal 的 earth, surface, building, buildx, buildy, Entrance)
+// 16 字节一格，一次查询只碰一条缓存行
+struct WorldTile {
+    int16_t earth = 0;
+    int16_t surface = 0;
+    int16_t building = 0;
+    int16_t buildX = 0;
+    int16_t buildY = 0;
+    int16_t entrance = -1; // 场景编号，-1 表示不是入口
+    uint16_t flags = 0;    // WorldMap::Flag
+    int16_t reserved = 0;
+};
+static_assert(sizeof(WorldTile) == 16, "WorldTile must stay 16 bytes");
+
+// 大地图 (480 x 480)，SceneManager 持有，GameManager 通过 SceneManager::GetWorldMap() 访问。
+// 坐标与原文件一致: index = x * 480 + y
+class WorldMap {
+public:
+    static constexpr int SIZE = 480;
+
+    enum Flag : uint16_t {
+        WALKABLE = 1 << 0, // 与 Pascal CanWalk 的结果一致 (与是否在船上无关)
+        WATER    = 1 << 1, // 走上去就是乘船
+    };
+
+    // Load the five *.002 layers. Missing layers other than earth are left at 0.
+    bool load();
+    // Build from in-memory layers (each SIZE * SIZE values, or empty for all 0)
+    void assign(const std::vector<int16_t>& earth, const std::vector<int16_t>& surface,
+                const std::vector<int16_t>& building, const std::vector<int16_t>& buildX,
+                const std::vector<int16_t>& buildY);
+    bool isLoaded() const { return !m_tiles.empty(); }
+
+    // nullptr outside the map or before load()
+    const WorldTile* tile(int x, int y) const {
+        if (m_tiles.empty() || x < 0 || x >= SIZE || y < 0 || y >= SIZE) return nullptr;
+        return &m_tiles[static_cast<size_t>(x) * SIZE + y];
+    }
+
+    // Entrance of each scene's main entrances (Pascal ReSetEntrance)
+    void resetEntrances(const SceneTable& scenes);
+
+    size_t memoryBytes() const { return m_tiles.capacity() * sizeof(WorldTile); }
+
+private:
+    static uint16_t computeFlags(int x, int y, const WorldTile& t);
+
+    std::vector<WorldTile> m_tiles;
+};
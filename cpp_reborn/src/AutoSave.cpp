@@ -0,0 +1,104 @@
+#include "AutoSave.h"
+
+namespace {
+    const uint64_t MINUTE_MS = 60 * 1000;
+    const uint64_t SPEED_SAMPLE_BYTES = 256 * 1024;
+}
+
+void AutoSaveScheduler::reset(uint64_t nowMs) {
+    m_lastSaveMs = nowMs;
+    m_sceneChangePending = false;
+    m_waiting = false;
+    m_stats.lastSnapshotMs = -1;
+    m_msPerMiB = DEFAULT_MS_PER_MIB;
+}
+
+void AutoSaveScheduler::onSceneChange(uint64_t nowMs) {
+    if (!enabled()) return;
+    if (m_stats.saves > 0 && nowMs - m_lastSaveMs < m_config.minGapMs) {
+        ++m_stats.dropped;
+        return;
+    }
+    m_sceneChangePending = true;
+    m_sceneChangeMs = nowMs;
+}
+
+void AutoSaveScheduler::prune(uint64_t nowMs) {
+    while (!m_recent.empty() && nowMs - m_recent.front().atMs >= MINUTE_MS) m_recent.pop_front();
+    m_stats.writeMsLastMinute = 0;
+    m_stats.bytesLastMinute = 0;
+    for (const Write& w : m_recent) {
+        m_stats.writeMsLastMinute += w.ms;
+        m_stats.bytesLastMinute += w.bytes;
+    }
+}
+
+bool AutoSaveScheduler::withinIoBudget() const {
+    // 下一次大概和上一次一样大
+    if (m_config.ioBytesPerMinute > 0 && m_stats.bytesLastMinute + m_stats.lastBytes > m_config.ioBytesPerMinute) return false;
+    if (m_config.ioMsPerMinute > 0 && m_stats.writeMsLastMinute + m_stats.lastWriteMs > m_config.ioMsPerMinute) return false;
+    return true;
+}
+
+double AutoSaveScheduler::estimateSnapshotMs(uint64_t bytes) const {
+    return m_msPerMiB * static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+
+AutoSaveScheduler::Trigger AutoSaveScheduler::poll(uint64_t nowMs, bool writerBusy, uint64_t snapshotBytes) {
+    if (!enabled()) return Trigger::None;
+
+    // 场景切换后太久才轮到的 (存档线程忙、超预算) 不再算场景切换，改按定时器的规则
+    if (m_sceneChangePending && nowMs - m_sceneChangeMs > SCENE_CHANGE_GRACE_MS) m_sceneChangePending = false;
+
+    Trigger trigger = Trigger::None;
+    if (m_sceneChangePending) {
+        trigger = Trigger::SceneChange;
+    } else if (m_config.intervalMs > 0 && nowMs - m_lastSaveMs >= m_config.intervalMs) {
+        trigger = Trigger::Timer;
+    }
+    if (trigger == Trigger::None) return Trigger::None;
+
+    prune(nowMs);
+    const bool gapPassed = m_stats.saves == 0 || nowMs - m_lastSaveMs >= m_config.minGapMs;
+    const bool withinFrame = estimateSnapshotMs(snapshotBytes) <= m_config.frameBudgetMs;
+    if (writerBusy || !gapPassed || !withinFrame || !withinIoBudget()) {
+        if (!m_waiting) ++m_stats.deferred;
+        m_waiting = true;
+        return Trigger::None;
+    }
+    return trigger;
+}
+
+int AutoSaveScheduler::slotAt(int offset) const {
+    if (m_config.slotCount <= 0) return m_config.firstSlot;
+    return m_config.firstSlot + (m_next + offset) % m_config.slotCount;
+}
+
+void AutoSaveScheduler::recordSnapshot(uint64_t nowMs, int slot, double snapshotMs, uint64_t bytes) {
+    ++m_stats.saves;
+    m_stats.lastSnapshotMs = snapshotMs;
+    m_stats.lastSnapshotBytes = bytes;
+    // 太小的快照量不出速度 (固定开销为主)
+    if (bytes >= SPEED_SAMPLE_BYTES) m_msPerMiB = snapshotMs * 1024.0 * 1024.0 / static_cast<double>(bytes);
+    m_stats.totalSnapshotMs += snapshotMs;
+    if (snapshotMs > m_stats.maxSnapshotMs) m_stats.maxSnapshotMs = snapshotMs;
+    m_lastSaveMs = nowMs;
+    m_sceneChangePending = false;
+    m_waiting = false;
+    if (m_config.slotCount > 0) m_next = (slot - m_config.firstSlot + 1) % m_config.slotCount;
+}
+
+void AutoSaveScheduler::recordWrite(uint64_t nowMs, bool ok, double writeMs, uint64_t bytes) {
+    if (!ok) ++m_stats.failures;
+    m_stats.lastWriteMs = writeMs;
+    m_stats.totalWriteMs += writeMs;
+    m_stats.lastBytes = bytes;
+    m_stats.totalBytes += bytes;
+    m_recent.push_back({ nowMs, writeMs, bytes });
+    prune(nowMs);
+}
+
+AutoSaveScheduler::Stats AutoSaveScheduler::stats(uint64_t nowMs) {
+    prune(nowMs);
+    return m_stats;
+}
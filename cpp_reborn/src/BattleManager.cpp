@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <iostream>
 #include <cmath>
+#include <cstring>
 
 // --- Helper Functions (Ported from kys_event.pas/kys_battle.pas) ---
 
@@ -325,17 +326,43 @@ bool BattleManager::Init() {
     return true;
 }
 
+bool BattleManager::ReloadResource(const std::string& name) {
+    if (name == "war.sta") {
+        m_warSta = MappedFile();
+        return true;
+    }
+    if (name == "warfld.grp" || name == "warfld.idx" || name.compare(0, 12, "warfld.grp.d") == 0) {
+        m_warFld.reset();
+        return true;
+    }
+    return false;
+}
+
+void BattleManager::ReportMemory(MemoryStats& stats) const {
+    const char* owner = "BattleManager";
+    stats.add(owner, "war.sta", m_warSta.size(), 0, m_warSta.isMapped());
+    if (m_warFld) {
+        stats.add(owner, "warfld", m_warFld->data().size(), m_warFld->count(), m_warFld->data().isMapped());
+    } else {
+        stats.add(owner, "warfld", 0, 0, true);
+    }
+    stats.add(owner, "battle_field", sizeof(m_battleField), 8);
+    stats.add(owner, "battle_roles", m_battleRoles.capacity() * sizeof(BattleRole), m_battleRoles.size());
+}
+
 bool BattleManager::LoadWarData(int battleId) {
-    auto data = FileLoader::loadFile("War.sta");
-    if (data.empty()) return false;
+    if (m_warSta.empty()) {
+        m_warSta = FileLoader::mapFile("War.sta");
+        if (m_warSta.empty()) return false;
+    }
     
     const int recordSize = 312;
-    if (battleId < 0 || (battleId + 1) * recordSize > data.size()) {
+    if (battleId < 0 || (size_t)(battleId + 1) * recordSize > m_warSta.size()) {
         std::cerr << "Battle ID " << battleId << " out of range" << std::endl;
         return false;
     }
     
-    const uint8_t* ptr = data.data() + battleId * recordSize;
+    const uint8_t* ptr = m_warSta.data() + battleId * recordSize;
     std::vector<int16_t> warVec(156);
     std::memcpy(warVec.data(), ptr, recordSize);
     
@@ -344,45 +371,47 @@ bool BattleManager::LoadWarData(int battleId) {
 }
 
 bool BattleManager::LoadBattleField(int fieldNum) {
-    auto idxData = FileLoader::loadFile("warfld.idx");
-    if (idxData.empty()) return false;
-    
-    const int32_t* offsets = reinterpret_cast<const int32_t*>(idxData.data());
-    if (fieldNum < 0 || (fieldNum + 1) * 4 > idxData.size()) return false;
-    
-    int offset = offsets[fieldNum];
-    int nextOffset = (fieldNum + 1 < idxData.size() / 4) ? offsets[fieldNum + 1] : -1;
-    
-    auto grpData = FileLoader::loadFile("warfld.grp");
-    if (grpData.empty()) return false;
-    
-    if (nextOffset == -1) nextOffset = grpData.size();
-    int len = nextOffset - offset;
-    
-    if (offset < 0 || offset + len > grpData.size()) return false;
-    
-    const uint8_t* pData = grpData.data() + offset;
-    
+    if (!m_warFld) {
+        m_warFld = GroupFile::open("warfld.grp", "warfld.idx");
+        if (!m_warFld) return false;
+    }
+
+    // Pascal InitialBField:
+    //   fieldnum = 0 时 offset := 0，否则 offset := idx[fieldnum - 1]
+    //   从 offset 处读 2 * 64 * 64 个 int16 (地面层 + 建筑层)，不看记录长度
+    //   Bfield[2], [4], [5] 置 -1
+    // warfld.grp 只有这一种原始格式，没有压缩变体。
+    if (fieldNum < 0 || fieldNum >= (int)m_warFld->count()) {
+        std::cerr << "[BattleManager] Battle field " << fieldNum << " out of range (" << m_warFld->count() << ")" << std::endl;
+        return false;
+    }
+
+    const size_t layerCount = 2 * 64 * 64;
+    MappedFile layers = m_warFld->recordFrom(fieldNum, layerCount * 2);
+    if (layers.size() < layerCount * 2) {
+        std::cerr << "[BattleManager] Battle field " << fieldNum << " is short (" << layers.size()
+                  << " bytes), missing tiles are left empty" << std::endl;
+    }
+
     // Clear field
     for(int i=0; i<8; i++)
         for(int x=0; x<64; x++)
             for(int y=0; y<64; y++)
-                m_battleField[i][x][y] = 0;
-                
-    if (len == 16384) {
-        // Raw
-        const int16_t* pInt = reinterpret_cast<const int16_t*>(pData);
-        for(int y=0; y<64; y++) {
-            for(int x=0; x<64; x++) {
-                m_battleField[0][x][y] = pInt[y*64 + x];
-                m_battleField[1][x][y] = pInt[64*64 + y*64 + x];
+                m_battleField[i][x][y] = (i == 2 || i == 4 || i == 5) ? -1 : 0;
+
+    // 文件中按 Bfield[层][y][x] 存放，这里保持 m_battleField[层][x][y] 的约定
+    size_t available = layers.size() / 2;
+    const uint8_t* pData = layers.data();
+    for (int l = 0; l < 2; l++) {
+        for (int y = 0; y < 64; y++) {
+            for (int x = 0; x < 64; x++) {
+                size_t n = (size_t)l * 4096 + y * 64 + x;
+                if (n >= available) continue;
+                int16_t v;
+                std::memcpy(&v, pData + n * 2, 2);
+                m_battleField[l][x][y] = v;
             }
         }
-    } else {
-        // Fallback or RLE
-        for(int x=0; x<64; x++)
-            for(int y=0; y<64; y++)
-                m_battleField[0][x][y] = 1;
     }
     return true;
 }
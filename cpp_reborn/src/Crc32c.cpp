@@ -0,0 +1,124 @@
+#include "Crc32c.h"
+#include <cstring>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <nmmintrin.h>
+#define KYS_CRC32C_X86 1
+#define KYS_CRC32C_TARGET
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <nmmintrin.h>
+#define KYS_CRC32C_X86 1
+#define KYS_CRC32C_TARGET __attribute__((target("sse4.2")))
+#elif defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define KYS_CRC32C_ARM 1
+#endif
+
+namespace {
+    const uint32_t POLY = 0x82F63B78u; // reflected Castagnoli
+
+    struct Tables {
+        uint32_t t[8][256];
+        Tables() {
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; ++k) c = (c & 1) ? (c >> 1) ^ POLY : c >> 1;
+                t[0][i] = c;
+            }
+            for (uint32_t i = 0; i < 256; ++i) {
+                for (int s = 1; s < 8; ++s) t[s][i] = (t[s - 1][i] >> 8) ^ t[0][t[s - 1][i] & 0xFF];
+            }
+        }
+    };
+
+    const Tables& GetTables() {
+        static const Tables tables;
+        return tables;
+    }
+
+    uint32_t Software(const uint8_t* p, size_t size, uint32_t crc) {
+        const Tables& tb = GetTables();
+        while (size >= 8) {
+            uint32_t lo, hi;
+            std::memcpy(&lo, p, 4);
+            std::memcpy(&hi, p + 4, 4);
+            lo ^= crc;
+            crc = tb.t[7][lo & 0xFF] ^ tb.t[6][(lo >> 8) & 0xFF] ^ tb.t[5][(lo >> 16) & 0xFF] ^ tb.t[4][lo >> 24] ^
+                  tb.t[3][hi & 0xFF] ^ tb.t[2][(hi >> 8) & 0xFF] ^ tb.t[1][(hi >> 16) & 0xFF] ^ tb.t[0][hi >> 24];
+            p += 8;
+            size -= 8;
+        }
+        while (size--) crc = (crc >> 8) ^ tb.t[0][(crc ^ *p++) & 0xFF];
+        return crc;
+    }
+
+#if defined(KYS_CRC32C_X86)
+    bool DetectHardware() {
+#if defined(_MSC_VER)
+        int info[4] = {};
+        __cpuid(info, 1);
+        return (info[2] & (1 << 20)) != 0; // SSE4.2
+#else
+        return __builtin_cpu_supports("sse4.2");
+#endif
+    }
+
+    KYS_CRC32C_TARGET uint32_t Hardware(const uint8_t* p, size_t size, uint32_t crc) {
+#if defined(__x86_64__) || defined(_M_X64)
+        uint64_t c = crc;
+        while (size >= 8) {
+            uint64_t v;
+            std::memcpy(&v, p, 8);
+            c = _mm_crc32_u64(c, v);
+            p += 8;
+            size -= 8;
+        }
+        crc = static_cast<uint32_t>(c);
+#endif
+        while (size >= 4) {
+            uint32_t v;
+            std::memcpy(&v, p, 4);
+            crc = _mm_crc32_u32(crc, v);
+            p += 4;
+            size -= 4;
+        }
+        while (size--) crc = _mm_crc32_u8(crc, *p++);
+        return crc;
+    }
+#elif defined(KYS_CRC32C_ARM)
+    bool DetectHardware() { return true; }
+
+    uint32_t Hardware(const uint8_t* p, size_t size, uint32_t crc) {
+        while (size >= 8) {
+            uint64_t v;
+            std::memcpy(&v, p, 8);
+            crc = __crc32cd(crc, v);
+            p += 8;
+            size -= 8;
+        }
+        while (size--) crc = __crc32cb(crc, *p++);
+        return crc;
+    }
+#endif
+}
+
+bool Crc32c::hardware() {
+#if defined(KYS_CRC32C_X86) || defined(KYS_CRC32C_ARM)
+    static const bool supported = DetectHardware();
+    return supported;
+#else
+    return false;
+#endif
+}
+
+uint32_t Crc32c::compute(const void* data, size_t size, uint32_t crc) {
+#if defined(KYS_CRC32C_X86) || defined(KYS_CRC32C_ARM)
+    if (hardware()) return ~Hardware(static_cast<const uint8_t*>(data), size, ~crc);
+#endif
+    return ~Software(static_cast<const uint8_t*>(data), size, ~crc);
+}
+
+uint32_t Crc32c::computeSoftware(const void* data, size_t size, uint32_t crc) {
+    return ~Software(static_cast<const uint8_t*>(data), size, ~crc);
+}
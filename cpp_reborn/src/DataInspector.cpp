@@ -0,0 +1,515 @@
+#include "DataInspector.h"
+#include "SaveContainer.h"
+#include "Role.h"
+#include "Item.h"
+#include "Scene.h"
+#include "Magic.h"
+#include <filesystem>
+#include <map>
+#include <cctype>
+#include <cstdio>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(__has_include)
+#if __has_include(<iconv.h>)
+#include <iconv.h>
+#include <cerrno>
+#define KYS_HAVE_ICONV 1
+#endif
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+    // 与 SceneManager.h 相同 (那里会引入 SDL，这里不包含)
+    const int MAP_SIZE = 64;
+    const int LAYERS = SceneDataReport::LAYERS;
+    const int EVENTS = 200;
+    const int EVENT_VALUES = 11;
+    const size_t MAP_SCENE_BYTES = static_cast<size_t>(MAP_SIZE) * MAP_SIZE * LAYERS * sizeof(int16_t);
+    const size_t EVENT_SCENE_BYTES = static_cast<size_t>(EVENTS) * EVENT_VALUES * sizeof(int16_t);
+
+    const char REPLACEMENT[] = "\xEF\xBF\xBD"; // U+FFFD
+
+    std::string Lower(std::string s) {
+        for (auto& c : s) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        return s;
+    }
+
+    bool IsDigits(const std::string& s) {
+        return !s.empty() && std::all_of(s.begin(), s.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; });
+    }
+
+    // ranger.grp, r<n>.grp (lower case)
+    bool IsSaveName(const std::string& lower) {
+        if (lower == "ranger.grp") return true;
+        return lower.size() > 5 && lower[0] == 'r' && lower.compare(lower.size() - 4, 4, ".grp") == 0 &&
+               IsDigits(lower.substr(1, lower.size() - 5));
+    }
+
+    // allsin.grp -> alldef.grp, s<n>.grp -> d<n>.grp (lower case), empty if not a map file
+    std::string EventNameFor(const std::string& lower) {
+        if (lower == "allsin.grp") return "alldef.grp";
+        if (lower.size() > 5 && lower[0] == 's' && lower.compare(lower.size() - 4, 4, ".grp") == 0 &&
+            IsDigits(lower.substr(1, lower.size() - 5))) {
+            return "d" + lower.substr(1);
+        }
+        return "";
+    }
+
+    std::string Str(long long v) { return std::to_string(v); }
+
+#if defined(KYS_HAVE_ICONV)
+    // iconv_t 不能跨线程共用，每个线程一个
+    struct GbkConverter {
+        iconv_t cd = iconv_open("UTF-8", "GBK");
+        ~GbkConverter() {
+            if (cd != reinterpret_cast<iconv_t>(-1)) iconv_close(cd);
+        }
+    };
+#endif
+}
+
+std::string DataInspector::gbkToUtf8(const std::string& gbk) {
+    if (std::all_of(gbk.begin(), gbk.end(), [](char c) { return static_cast<unsigned char>(c) < 0x80; })) return gbk;
+
+#if defined(_WIN32)
+    int wideLen = MultiByteToWideChar(936, 0, gbk.data(), static_cast<int>(gbk.size()), nullptr, 0);
+    if (wideLen > 0) {
+        std::wstring wide(static_cast<size_t>(wideLen), L'\0');
+        MultiByteToWideChar(936, 0, gbk.data(), static_cast<int>(gbk.size()), &wide[0], wideLen);
+        int utf8Len = WideCharToMultiByte(CP_UTF8, 0, wide.data(), wideLen, nullptr, 0, nullptr, nullptr);
+        if (utf8Len > 0) {
+            std::string utf8(static_cast<size_t>(utf8Len), '\0');
+            WideCharToMultiByte(CP_UTF8, 0, wide.data(), wideLen, &utf8[0], utf8Len, nullptr, nullptr);
+            return utf8;
+        }
+    }
+#elif defined(KYS_HAVE_ICONV)
+    thread_local GbkConverter converter;
+    if (converter.cd != reinterpret_cast<iconv_t>(-1)) {
+        iconv(converter.cd, nullptr, nullptr, nullptr, nullptr);
+        std::string in = gbk;
+        std::string out;
+        char buffer[256];
+        char* src = &in[0];
+        size_t srcLeft = in.size();
+        while (srcLeft > 0) {
+            char* dst = buffer;
+            size_t dstLeft = sizeof(buffer);
+            size_t rc = iconv(converter.cd, &src, &srcLeft, &dst, &dstLeft);
+            out.append(buffer, static_cast<size_t>(dst - buffer));
+            if (rc == static_cast<size_t>(-1) && errno != E2BIG) {
+                // 无法转换的字节 (或被截断的双字节字): 替换后跳过一个字节
+                out += REPLACEMENT;
+                ++src;
+                --srcLeft;
+                iconv(converter.cd, nullptr, nullptr, nullptr, nullptr);
+            }
+        }
+        return out;
+    }
+#endif
+
+    // 无法转换: 保留 ASCII，每个双字节字换成 U+FFFD
+    std::string out;
+    for (size_t i = 0; i < gbk.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(gbk[i]);
+        if (c < 0x80) {
+            out += static_cast<char>(c);
+        } else {
+            out += REPLACEMENT;
+            if (c >= 0x81 && c <= 0xFE && i + 1 < gbk.size()) ++i;
+        }
+    }
+    return out;
+}
+
+std::string DataInspector::jsonEscape(const std::string& utf8) {
+    std::string out;
+    out.reserve(utf8.size() + 2);
+    for (char ch : utf8) {
+        unsigned char c = static_cast<unsigned char>(ch);
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (c < 0x20) {
+                char esc[8];
+                std::snprintf(esc, sizeof(esc), "\\u%04x", c);
+                out += esc;
+            } else {
+                out += ch;
+            }
+        }
+    }
+    return out;
+}
+
+std::string DataInspector::csvField(const std::string& utf8) {
+    if (utf8.find_first_of(",\"\r\n") == std::string::npos) return utf8;
+    std::string out = "\"";
+    for (char c : utf8) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    return out + "\"";
+}
+
+SaveReport DataInspector::inspectSave(const std::string& path, const SaveLayout& layout, bool withInventory) {
+    SaveReport r;
+    r.path = path;
+    std::error_code ec;
+    r.fileBytes = static_cast<size_t>(fs::file_size(path, ec));
+    if (ec) {
+        r.error = "cannot read file";
+        return r;
+    }
+    if (!layout.valid()) {
+        r.error = "no valid ranger.idx";
+        return r;
+    }
+    if (r.fileBytes == 0) {
+        r.error = "empty file";
+        return r;
+    }
+    MappedFile data = SaveContainer::mapFile(path, &r.compressed);
+    if (data.empty()) {
+        r.error = r.compressed ? "damaged container" : "cannot read file";
+        return r;
+    }
+    r.rawBytes = data.size();
+
+    SaveImageReader image(layout, data);
+    RoleTable roles;
+    ItemTable items;
+    SceneTable scenes;
+    r.roleCount = static_cast<int>(image.getTable(layout.roleOffset, layout.itemOffset, roles));
+    r.itemCount = static_cast<int>(image.getTable(layout.itemOffset, layout.sceneOffset, items));
+    r.sceneCount = static_cast<int>(image.getTable(layout.sceneOffset, layout.magicOffset, scenes));
+    r.magicCount = static_cast<int>((layout.shopOffset - layout.magicOffset) / static_cast<int32_t>(MAGIC_DATA_SIZE * sizeof(int16_t)));
+
+    if (r.rawBytes != static_cast<size_t>(layout.totalLength)) {
+        r.problems.push_back("file is " + Str(static_cast<long long>(r.rawBytes)) + " bytes, ranger.idx expects " +
+                             Str(layout.totalLength));
+    }
+
+    // 头部顺序与 GameManager::ApplySaveHeader 相同
+    std::vector<int16_t> header = image.header();
+    size_t at = 0;
+    auto next = [&]() -> int { return at < header.size() ? header[at++] : 0; };
+    r.inShip = next();
+    r.sceneId = next();
+    r.mapX = next();
+    r.mapY = next();
+    r.face = next();
+    at += 2; // ship x, y
+    r.time = next();
+    at += 3; // time event, random event, sub map face
+
+    if (r.sceneId >= r.sceneCount) {
+        r.problems.push_back("scene " + Str(r.sceneId) + " out of range");
+    } else if (r.sceneId >= 0) {
+        r.sceneName = gbkToUtf8(scenes[r.sceneId].getName());
+    }
+
+    for (int i = 0; i < MAX_TEAM_SIZE; ++i) {
+        int id = next();
+        if (id < 0) continue;
+        SaveReport::Member m;
+        m.roleId = id;
+        if (id < r.roleCount) {
+            const Role& role = roles[id];
+            m.name = gbkToUtf8(role.getName());
+            m.level = role.getLevel();
+            m.hp = role.getCurrentHP();
+            m.maxHp = role.getMaxHP();
+            if (m.hp < 0 || m.hp > m.maxHp) {
+                r.problems.push_back("role " + Str(id) + " hp " + Str(m.hp) + "/" + Str(m.maxHp));
+            }
+        } else {
+            r.problems.push_back("team slot " + Str(i) + ": role " + Str(id) + " out of range");
+        }
+        r.team.push_back(m);
+    }
+    if (r.team.empty()) r.problems.push_back("empty team");
+
+    for (int i = 0; i < MAX_ITEM_AMOUNT; ++i) {
+        SaveReport::Stack s;
+        s.itemId = next();
+        s.amount = next();
+        if (s.itemId < 0 || s.amount == 0) continue;
+        if (s.itemId >= r.itemCount) {
+            r.problems.push_back("bag slot " + Str(i) + ": item " + Str(s.itemId) + " out of range");
+        } else if (s.amount < 0) {
+            r.problems.push_back("bag slot " + Str(i) + ": item " + Str(s.itemId) + " amount " + Str(s.amount));
+        }
+        ++r.itemKinds;
+        r.itemTotal += s.amount;
+        if (withInventory) r.inventory.push_back(s);
+    }
+
+    r.ok = true;
+    return r;
+}
+
+SceneDataReport DataInspector::inspectSceneData(const std::string& mapPath, const std::string& eventPath) {
+    SceneDataReport r;
+    r.mapPath = mapPath;
+    r.eventPath = eventPath;
+
+    bool mapPacked = false, eventPacked = false;
+    MappedFile mapFile = SaveContainer::mapFile(mapPath, &mapPacked);
+    MappedFile eventFile = SaveContainer::mapFile(eventPath, &eventPacked);
+    r.compressed = mapPacked || eventPacked;
+    if (mapFile.empty() || eventFile.empty()) {
+        r.error = "cannot read " + (mapFile.empty() ? mapPath : eventPath);
+        return r;
+    }
+
+    r.mapScenes = static_cast<int>(mapFile.size() / MAP_SCENE_BYTES);
+    r.eventScenes = static_cast<int>(eventFile.size() / EVENT_SCENE_BYTES);
+    if (mapFile.size() % MAP_SCENE_BYTES != 0) {
+        r.problems.push_back("map data has " + Str(static_cast<long long>(mapFile.size() % MAP_SCENE_BYTES)) + " trailing bytes");
+    }
+    if (eventFile.size() % EVENT_SCENE_BYTES != 0) {
+        r.problems.push_back("event data has " + Str(static_cast<long long>(eventFile.size() % EVENT_SCENE_BYTES)) + " trailing bytes");
+    }
+    if (r.mapScenes != r.eventScenes) {
+        r.problems.push_back(Str(r.mapScenes) + " map scenes but " + Str(r.eventScenes) + " event scenes");
+    }
+
+    MappedFile::View<int16_t> tiles = mapFile.as<int16_t>();
+    MappedFile::View<int16_t> events = eventFile.as<int16_t>();
+    const int sceneCount = std::max(r.mapScenes, r.eventScenes);
+    std::vector<int16_t> expected(MAP_SIZE * MAP_SIZE);
+
+    for (int s = 0; s < sceneCount; ++s) {
+        SceneDataReport::SceneStats st;
+        st.scene = s;
+
+        // DData 位置 -> 事件层应有的内容 (与 SceneManager::RefreshEventLayer 相同)
+        std::fill(expected.begin(), expected.end(), static_cast<int16_t>(-1));
+        if (s < r.eventScenes) {
+            const int16_t* ev = events.data() + static_cast<size_t>(s) * EVENTS * EVENT_VALUES;
+            for (int e = 0; e < EVENTS; ++e) {
+                const int16_t* v = ev + e * EVENT_VALUES;
+                if (std::any_of(v, v + EVENT_VALUES, [](int16_t x) { return x != 0; })) ++st.events;
+                int x = v[10], y = v[9];
+                if (x > 0 && x < MAP_SIZE && y >= 0 && y < MAP_SIZE) {
+                    expected[x * MAP_SIZE + y] = static_cast<int16_t>(e);
+                    ++st.placed;
+                }
+            }
+        }
+
+        int badRefs = 0;
+        if (s < r.mapScenes) {
+            // 文件中按层存放: [layer][64*64]，交错的 SceneTile 只在内存中
+            const size_t cellCount = static_cast<size_t>(MAP_SIZE) * MAP_SIZE;
+            const int16_t* cells = tiles.data() + static_cast<size_t>(s) * cellCount * LAYERS;
+            for (size_t i = 0; i < cellCount; ++i) {
+                for (int l = 0; l < LAYERS; ++l) {
+                    if (l != 3 && cells[l * cellCount + i] != 0) ++st.tiles[l];
+                }
+                int16_t eventId = cells[3 * cellCount + i];
+                if (eventId >= 0 && eventId < EVENTS) {
+                    ++st.tiles[3];
+                } else {
+                    if (eventId != -1) ++badRefs;
+                    eventId = -1;
+                }
+                if (s < r.eventScenes && eventId != expected[i]) ++st.stale;
+            }
+        }
+
+        if (badRefs > 0) r.problems.push_back("scene " + Str(s) + ": " + Str(badRefs) + " event-layer cells out of range");
+        if (st.stale > 0) r.problems.push_back("scene " + Str(s) + ": " + Str(st.stale) + " event-layer cells differ from DData");
+        r.events += st.events;
+        r.stale += st.stale;
+        if (st.events > 0 || std::any_of(st.tiles, st.tiles + LAYERS, [](int n) { return n > 0; })) r.scenes.push_back(st);
+    }
+
+    r.ok = true;
+    return r;
+}
+
+std::vector<std::string> DataInspector::findSaves(const std::string& root) {
+    std::vector<std::string> out;
+    std::error_code ec;
+    if (fs::is_regular_file(root, ec)) return { root };
+    for (auto it = fs::recursive_directory_iterator(root, fs::directory_options::skip_permission_denied, ec);
+         it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        if (ec) break;
+        if (it->is_regular_file(ec) && IsSaveName(Lower(it->path().filename().string()))) out.push_back(it->path().string());
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+std::vector<std::pair<std::string, std::string>> DataInspector::findSceneData(const std::string& root) {
+    // 目录 -> (小写文件名 -> 路径)
+    std::map<fs::path, std::map<std::string, fs::path>> dirs;
+    std::error_code ec;
+    const bool single = fs::is_regular_file(root, ec);
+    if (single) {
+        fs::path dir = fs::path(root).parent_path();
+        for (auto it = fs::directory_iterator(dir.empty() ? fs::path(".") : dir, ec); !ec && it != fs::directory_iterator(); it.increment(ec)) {
+            dirs[dir][Lower(it->path().filename().string())] = it->path();
+        }
+    } else {
+        for (auto it = fs::recursive_directory_iterator(root, fs::directory_options::skip_permission_denied, ec);
+             it != fs::recursive_directory_iterator(); it.increment(ec)) {
+            if (ec) break;
+            if (it->is_regular_file(ec)) dirs[it->path().parent_path()][Lower(it->path().filename().string())] = it->path();
+        }
+    }
+
+    std::vector<std::pair<std::string, std::string>> out;
+    const std::string only = single ? Lower(fs::path(root).filename().string()) : "";
+    for (const auto& dir : dirs) {
+        for (const auto& file : dir.second) {
+            if (single && file.first != only) continue;
+            std::string eventName = EventNameFor(file.first);
+            if (eventName.empty()) continue;
+            auto partner = dir.second.find(eventName);
+            fs::path eventPath = partner != dir.second.end() ? partner->second : dir.first / eventName;
+            out.emplace_back(file.second.string(), eventPath.string());
+        }
+    }
+    if (single && out.empty()) out.emplace_back(root, "");
+    return out;
+}
+
+std::string DataInspector::findLayout(const std::string& savePath) {
+    std::error_code ec;
+    fs::path dir = fs::absolute(savePath, ec).parent_path();
+    while (!dir.empty()) {
+        for (const char* name : { "ranger.idx", "Ranger.idx", "RANGER.IDX" }) {
+            if (fs::is_regular_file(dir / name, ec)) return (dir / name).string();
+        }
+        if (dir == dir.root_path()) break;
+        dir = dir.parent_path();
+    }
+    return "";
+}
+
+void DataInspector::write(std::ostream& out, const std::vector<SaveReport>& reports, Format format, bool withInventory) {
+    auto problems = [](const std::vector<std::string>& list, const char* sep) {
+        std::string s;
+        for (size_t i = 0; i < list.size(); ++i) s += (i ? sep : "") + list[i];
+        return s;
+    };
+
+    if (format == Format::Csv) {
+        out << "path,ok,error,compressed,fileBytes,rawBytes,inShip,sceneId,sceneName,mapX,mapY,face,time,"
+               "team,leadName,leadLevel,itemKinds,itemTotal,roles,items,scenes,magics,problems\n";
+        for (const auto& r : reports) {
+            std::string team;
+            for (size_t i = 0; i < r.team.size(); ++i) team += (i ? " " : "") + Str(r.team[i].roleId);
+            out << csvField(r.path) << ',' << (r.ok ? 1 : 0) << ',' << csvField(r.error) << ',' << (r.compressed ? 1 : 0) << ','
+                << r.fileBytes << ',' << r.rawBytes << ',';
+            if (r.ok) {
+                out << r.inShip << ',' << r.sceneId << ',' << csvField(r.sceneName) << ',' << r.mapX << ',' << r.mapY << ','
+                    << r.face << ',' << r.time << ',' << team << ',' << csvField(r.team.empty() ? "" : r.team[0].name) << ','
+                    << (r.team.empty() ? 0 : r.team[0].level) << ',' << r.itemKinds << ',' << r.itemTotal << ','
+                    << r.roleCount << ',' << r.itemCount << ',' << r.sceneCount << ',' << r.magicCount << ','
+                    << csvField(problems(r.problems, "; "));
+            } else {
+                out << ",,,,,,,,,,,,,,,,";
+            }
+            out << '\n';
+        }
+        return;
+    }
+
+    out << "[";
+    for (size_t n = 0; n < reports.size(); ++n) {
+        const SaveReport& r = reports[n];
+        out << (n ? ",\n" : "\n") << "  {\"path\": \"" << jsonEscape(r.path) << "\", \"ok\": " << (r.ok ? "true" : "false");
+        if (!r.ok) {
+            out << ", \"error\": \"" << jsonEscape(r.error) << "\"}";
+            continue;
+        }
+        out << ", \"compressed\": " << (r.compressed ? "true" : "false") << ", \"fileBytes\": " << r.fileBytes
+            << ", \"rawBytes\": " << r.rawBytes << ",\n   \"inShip\": " << r.inShip << ", \"sceneId\": " << r.sceneId
+            << ", \"sceneName\": \"" << jsonEscape(r.sceneName) << "\", \"mapX\": " << r.mapX << ", \"mapY\": " << r.mapY
+            << ", \"face\": " << r.face << ", \"time\": " << r.time << ",\n   \"team\": [";
+        for (size_t i = 0; i < r.team.size(); ++i) {
+            const auto& m = r.team[i];
+            out << (i ? ", " : "") << "{\"role\": " << m.roleId << ", \"name\": \"" << jsonEscape(m.name) << "\", \"level\": "
+                << m.level << ", \"hp\": " << m.hp << ", \"maxHp\": " << m.maxHp << "}";
+        }
+        out << "],\n   \"itemKinds\": " << r.itemKinds << ", \"itemTotal\": " << r.itemTotal;
+        if (withInventory) {
+            out << ", \"inventory\": [";
+            for (size_t i = 0; i < r.inventory.size(); ++i) {
+                out << (i ? ", " : "") << "[" << r.inventory[i].itemId << ", " << r.inventory[i].amount << "]";
+            }
+            out << "]";
+        }
+        out << ",\n   \"roles\": " << r.roleCount << ", \"items\": " << r.itemCount << ", \"scenes\": " << r.sceneCount
+            << ", \"magics\": " << r.magicCount << ",\n   \"problems\": [";
+        for (size_t i = 0; i < r.problems.size(); ++i) out << (i ? ", " : "") << "\"" << jsonEscape(r.problems[i]) << "\"";
+        out << "]}";
+    }
+    out << (reports.empty() ? "]\n" : "\n]\n");
+}
+
+void DataInspector::write(std::ostream& out, const std::vector<SceneDataReport>& reports, Format format, bool withScenes) {
+    if (format == Format::Csv) {
+        if (withScenes) {
+            out << "mapPath,eventPath,scene,layer0,layer1,layer2,layer3,layer4,layer5,events,placed,stale\n";
+            for (const auto& r : reports) {
+                for (const auto& s : r.scenes) {
+                    out << csvField(r.mapPath) << ',' << csvField(r.eventPath) << ',' << s.scene;
+                    for (int l = 0; l < LAYERS; ++l) out << ',' << s.tiles[l];
+                    out << ',' << s.events << ',' << s.placed << ',' << s.stale << '\n';
+                }
+            }
+            return;
+        }
+        out << "mapPath,eventPath,ok,error,compressed,mapScenes,eventScenes,activeScenes,events,staleCells,problems\n";
+        for (const auto& r : reports) {
+            std::string problems;
+            for (size_t i = 0; i < r.problems.size(); ++i) problems += (i ? "; " : "") + r.problems[i];
+            out << csvField(r.mapPath) << ',' << csvField(r.eventPath) << ',' << (r.ok ? 1 : 0) << ',' << csvField(r.error) << ','
+                << (r.compressed ? 1 : 0) << ',' << r.mapScenes << ',' << r.eventScenes << ',' << r.scenes.size() << ','
+                << r.events << ',' << r.stale << ',' << csvField(problems) << '\n';
+        }
+        return;
+    }
+
+    out << "[";
+    for (size_t n = 0; n < reports.size(); ++n) {
+        const SceneDataReport& r = reports[n];
+        out << (n ? ",\n" : "\n") << "  {\"mapPath\": \"" << jsonEscape(r.mapPath) << "\", \"eventPath\": \""
+            << jsonEscape(r.eventPath) << "\", \"ok\": " << (r.ok ? "true" : "false");
+        if (!r.ok) {
+            out << ", \"error\": \"" << jsonEscape(r.error) << "\"}";
+            continue;
+        }
+        out << ", \"compressed\": " << (r.compressed ? "true" : "false") << ",\n   \"mapScenes\": " << r.mapScenes
+            << ", \"eventScenes\": " << r.eventScenes << ", \"activeScenes\": " << r.scenes.size() << ", \"events\": "
+            << r.events << ", \"staleCells\": " << r.stale;
+        if (withScenes) {
+            out << ",\n   \"scenes\": [";
+            for (size_t i = 0; i < r.scenes.size(); ++i) {
+                const auto& s = r.scenes[i];
+                out << (i ? ",\n     " : "\n     ") << "{\"scene\": " << s.scene << ", \"tiles\": [";
+                for (int l = 0; l < LAYERS; ++l) out << (l ? ", " : "") << s.tiles[l];
+                out << "], \"events\": " << s.events << ", \"placed\": " << s.placed << ", \"stale\": " << s.stale << "}";
+            }
+            out << "]";
+        }
+        out << ",\n   \"problems\": [";
+        for (size_t i = 0; i < r.problems.size(); ++i) out << (i ? ", " : "") << "\"" << jsonEscape(r.problems[i]) << "\"";
+        out << "]}";
+    }
+    out << (reports.empty() ? "]\n" : "\n]\n");
+}
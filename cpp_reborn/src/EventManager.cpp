@@ -1,4 +1,5 @@
 #include "EventManager.h"
+#include "GroupFile.h"
 #include "FileLoader.h"
 #include "GameManager.h"
 #include "SceneManager.h"
@@ -109,37 +110,34 @@ bool EventManager::Init() {
 }
 
 bool EventManager::LoadScripts() {
-    auto idxData = FileLoader::loadFile("kdef.idx");
-    if (idxData.empty()) {
+    // 经 GroupFile 打开，这样 mod 中的 kdef.grp.d/<事件号> 可以单独替换某个事件脚本
+    auto kdef = GroupFile::open("kdef.grp", "kdef.idx");
+    if (!kdef) {
         // Try capitalized if lowercase failed (though Windows is case-insensitive, simple FileLoader might be picky if cached)
-        idxData = FileLoader::loadFile("Kdef.idx");
-        if (idxData.empty()) return false;
+        kdef = GroupFile::open("Kdef.grp", "Kdef.idx");
+        if (!kdef) return false;
     }
 
+    MappedFile idxData, grpData;
+    kdef->flatten(grpData, idxData);
+    if (idxData.empty() || grpData.empty()) return false;
+
     if (idxData.size() % 4 != 0) {
         std::cerr << "kdef.idx size is not multiple of 4" << std::endl;
         return false;
     }
 
-    size_t count = idxData.size() / 4;
-    m_eventIndices.resize(count);
-    std::memcpy(m_eventIndices.data(), idxData.data(), idxData.size());
+    m_eventIndices = idxData.as<int32_t>();
+    size_t count = m_eventIndices.size();
     
     std::cout << "[EventManager] Loaded kdef.idx. Size: " << idxData.size() << " bytes. Script Count: " << count << std::endl;
 
-    auto grpData = FileLoader::loadFile("kdef.grp");
-    if (grpData.empty()) {
-        grpData = FileLoader::loadFile("Kdef.grp");
-        if (grpData.empty()) return false;
-    }
-
     if (grpData.size() % 2 != 0) {
         std::cerr << "kdef.grp size is not multiple of 2" << std::endl;
         return false;
     }
 
-    m_eventScripts.resize(grpData.size() / 2);
-    std::memcpy(m_eventScripts.data(), grpData.data(), grpData.size());
+    m_eventScripts = grpData.as<int16_t>();
 
     std::cout << "Loaded " << count << " event scripts." << std::endl;
     if (count >= 101) {
@@ -151,15 +149,34 @@ bool EventManager::LoadScripts() {
     return true;
 }
 
+bool EventManager::ReloadResource(const std::string& name) {
+    if (name == "kdef.grp" || name == "kdef.idx" || name.compare(0, 10, "kdef.grp.d") == 0) {
+        return LoadScripts();
+    }
+    if (name == "talk.grp" || name == "talk.idx" || name == "name.grp" || name == "name.idx") {
+        return LoadDialogues();
+    }
+    return false;
+}
+
+void EventManager::ReportMemory(MemoryStats& stats) const {
+    const char* owner = "EventManager";
+    // grp 与 idx 分开记: 有覆盖文件或 --dev 时其中之一可能在堆上
+    stats.add(owner, "kdef.grp", m_eventScripts.size() * sizeof(int16_t), m_eventIndices.size(), m_eventScripts.isMapped());
+    stats.add(owner, "kdef.idx", m_eventIndices.size() * sizeof(int32_t), 0, m_eventIndices.isMapped());
+    stats.add(owner, "talk.grp", m_talkData.size(), m_talkIndices.size(), m_talkData.isMapped());
+    stats.add(owner, "talk.idx", m_talkIndices.size() * sizeof(int32_t), 0, m_talkIndices.isMapped());
+    stats.add(owner, "name.grp", m_nameData.size(), m_nameIndices.size(), m_nameData.isMapped());
+    stats.add(owner, "name.idx", m_nameIndices.size() * sizeof(int32_t), 0, m_nameIndices.isMapped());
+}
+
 bool EventManager::LoadDialogues() {
-    auto idxData = FileLoader::loadFile("talk.idx");
-    if (idxData.empty()) return false;
+    m_talkIndices = FileLoader::mapFile("talk.idx").as<int32_t>();
+    if (m_talkIndices.empty()) return false;
 
-    size_t count = idxData.size() / 4;
-    m_talkIndices.resize(count);
-    std::memcpy(m_talkIndices.data(), idxData.data(), idxData.size());
+    size_t count = m_talkIndices.size();
 
-    m_talkData = FileLoader::loadFile("talk.grp");
+    m_talkData = FileLoader::mapFile("talk.grp");
     if (m_talkData.empty()) {
          std::cerr << "Failed to load talk.grp" << std::endl;
          return false;
@@ -167,12 +184,10 @@ bool EventManager::LoadDialogues() {
     std::cout << "Loaded " << count << " dialogues." << std::endl;
 
     // Load Name Data (Optional but recommended)
-    auto nameIdx = FileLoader::loadFile("name.idx");
-    if (!nameIdx.empty()) {
-        size_t nc = nameIdx.size() / 4;
-        m_nameIndices.resize(nc);
-        std::memcpy(m_nameIndices.data(), nameIdx.data(), nameIdx.size());
-        m_nameData = FileLoader::loadFile("name.grp");
+    m_nameIndices = FileLoader::mapFile("name.idx").as<int32_t>();
+    if (!m_nameIndices.empty()) {
+        size_t nc = m_nameIndices.size();
+        m_nameData = FileLoader::mapFile("name.grp");
         if (!m_nameData.empty()) {
              std::cout << "Loaded " << nc << " names." << std::endl;
         }
@@ -182,13 +197,16 @@ bool EventManager::LoadDialogues() {
 }
 
 std::string EventManager::GetNameFromData(int nameNum) {
-    if (nameNum <= 0 || nameNum > m_nameIndices.size()) return "";
+    // 文件远小于 2GB，边界检查时转成 int 一次
+    const int nameCount = static_cast<int>(m_nameIndices.size());
+    const int nameBytes = static_cast<int>(m_nameData.size());
+    if (nameNum <= 0 || nameNum > nameCount) return "";
     
     int offset = m_nameIndices[nameNum - 1];
-    int nextOffset = (nameNum < m_nameIndices.size()) ? m_nameIndices[nameNum] : m_nameData.size();
+    int nextOffset = (nameNum < nameCount) ? m_nameIndices[nameNum] : nameBytes;
     
     int len = nextOffset - offset;
-    if (len <= 0 || offset + len > m_nameData.size()) return "";
+    if (offset < 0 || len <= 0 || offset + len > nameBytes) return "";
     
     std::string name;
     // Name data is also XOR 0xFF encoded?
@@ -242,18 +260,20 @@ void EventManager::CheckAutoEvents(int sceneId) {
 }
 
 int16_t EventManager::ReadScriptArg(int& offset) {
-    if (offset < 0 || offset >= m_eventScripts.size()) return 0;
+    if (offset < 0 || offset >= static_cast<int>(m_eventScripts.size())) return 0;
     return m_eventScripts[offset++];
 }
 
 void EventManager::ExecuteEvent(int eventScriptId) {
-    if (eventScriptId <= 0 || eventScriptId > m_eventIndices.size()) {
+    const int eventCount = static_cast<int>(m_eventIndices.size());
+    const int scriptWords = static_cast<int>(m_eventScripts.size());
+    if (eventScriptId <= 0 || eventScriptId > eventCount) {
         std::cerr << "ExecuteEvent: Invalid ID " << eventScriptId << ". Max ID: " << m_eventIndices.size() << std::endl;
         return;
     }
 
     int offset = m_eventIndices[eventScriptId - 1];
-    int nextOffset = (eventScriptId < m_eventIndices.size()) ? m_eventIndices[eventScriptId] : m_eventScripts.size() * 2;
+    int nextOffset = (eventScriptId < eventCount) ? m_eventIndices[eventScriptId] : scriptWords * 2;
     
     int lengthBytes = nextOffset - offset;
     int lengthWords = lengthBytes / 2;
@@ -262,7 +282,7 @@ void EventManager::ExecuteEvent(int eventScriptId) {
     int scriptEnd = scriptStart + lengthWords;
     
     // Check range validity
-    if (scriptStart >= m_eventScripts.size() || scriptEnd > m_eventScripts.size()) {
+    if (scriptStart < 0 || scriptStart >= scriptWords || scriptEnd > scriptWords) {
         std::cerr << "Event " << eventScriptId << " out of bounds! Start: " << scriptStart 
                   << " End: " << scriptEnd << " Size: " << m_eventScripts.size() << std::endl;
         return;
@@ -609,18 +629,20 @@ void EventManager::Instruct_NewTalk0(int headNum, int talkNum, int nameNum, int
     // FIX: Talk IDs are 1-based in script, so we subtract 1 to get 0-based index.
     int actualTalkNum = talkNum - 1;
 
-    if (actualTalkNum < 0 || actualTalkNum >= m_talkIndices.size()) {
+    const int talkCount = static_cast<int>(m_talkIndices.size());
+    const int talkBytes = static_cast<int>(m_talkData.size());
+    if (actualTalkNum < 0 || actualTalkNum >= talkCount) {
         std::string err = "Error: TalkID " + std::to_string(talkNum) + " Missing!";
         UIManager::getInstance().ShowDialogue(err, 0, 0);
         return;
     }
     int offset = m_talkIndices[actualTalkNum];
-    int nextOffset = (actualTalkNum + 1 < m_talkIndices.size()) ? m_talkIndices[actualTalkNum + 1] : m_talkData.size();
+    int nextOffset = (actualTalkNum + 1 < talkCount) ? m_talkIndices[actualTalkNum + 1] : talkBytes;
     
     int len = nextOffset - offset;
     
     // Safety check for garbage data - FORCE DISPLAY ERROR
-    if (len <= 0 || offset + len > m_talkData.size()) {
+    if (offset < 0 || len <= 0 || offset + len > talkBytes) {
          std::string err = "Error: TalkID " + std::to_string(talkNum) + " Empty/Invalid!";
          UIManager::getInstance().ShowDialogue(err, 0, 0);
          return;
@@ -651,7 +673,7 @@ void EventManager::Instruct_NewTalk0(int headNum, int talkNum, int nameNum, int
     
     // Convert to String and Clean up
     std::string fullText;
-    int p = 0;
+    size_t p = 0;
     while (p < decoded.size() && decoded[p] != 0) {
         fullText += (char)decoded[p];
         p++;
@@ -789,13 +811,15 @@ void EventManager::Instruct_ReSetName(int type, int id, int newNameId) {
 void EventManager::Instruct_Dialogue(int talkId, int headId, int mode) {
     // FIX: Talk IDs are 1-based in script.
     int actualTalkId = talkId - 1;
-    if (actualTalkId < 0 || actualTalkId >= m_talkIndices.size()) return;
+    const int talkCount = static_cast<int>(m_talkIndices.size());
+    const int talkBytes = static_cast<int>(m_talkData.size());
+    if (actualTalkId < 0 || actualTalkId >= talkCount) return;
     int offset = m_talkIndices[actualTalkId];
-    int nextOffset = (actualTalkId + 1 < m_talkIndices.size()) ? m_talkIndices[actualTalkId + 1] : m_talkData.size();
+    int nextOffset = (actualTalkId + 1 < talkCount) ? m_talkIndices[actualTalkId + 1] : talkBytes;
     
     int len = nextOffset - offset;
     // Safety check for garbage data
-    if (len <= 0 || offset + len > m_talkData.size()) return;
+    if (offset < 0 || len <= 0 || offset + len > talkBytes) return;
     if (len > 2000) len = 2000;
 
     std::vector<uint8_t> decoded(len + 1, 0);
@@ -848,12 +872,14 @@ void EventManager::Instruct_ShowTitle(int talkNum, int color) {
     // Instruction 70: Show a big title on screen
     int actualTalkNum = (talkNum > 0) ? talkNum - 1 : 0;
     
-    if (actualTalkNum < 0 || actualTalkNum >= m_talkIndices.size()) return;
+    const int talkCount = static_cast<int>(m_talkIndices.size());
+    const int talkBytes = static_cast<int>(m_talkData.size());
+    if (actualTalkNum < 0 || actualTalkNum >= talkCount) return;
     int offset = m_talkIndices[actualTalkNum];
-    int nextOffset = (actualTalkNum + 1 < m_talkIndices.size()) ? m_talkIndices[actualTalkNum + 1] : m_talkData.size();
+    int nextOffset = (actualTalkNum + 1 < talkCount) ? m_talkIndices[actualTalkNum + 1] : talkBytes;
     
     int len = nextOffset - offset;
-    if (len <= 0 || offset + len > m_talkData.size()) return;
+    if (offset < 0 || len <= 0 || offset + len > talkBytes) return;
     if (len > 2000) len = 2000;
 
     std::vector<uint8_t> decoded;
@@ -1162,12 +1188,15 @@ void EventManager::Instruct_38(int sceneId, int layer, int oldPic, int newPic) {
     
     // Iterate over all tiles in layer and replace oldPic with newPic
     // Pascal: Sdata[snum, layernum, i1, i2]
-    // Optimization: SceneManager could expose a "ReplaceTile" function
-    // But for now, we can iterate.
-    for (int x = 0; x < 64; ++x) {
-        for (int y = 0; y < 64; ++y) {
-            if (SceneManager::getInstance().GetSceneTile(sceneId, layer, x, y) == oldPic) {
-                SceneManager::getInstance().SetSceneTile(sceneId, layer, x, y, newPic);
+    if (layer < 0 || layer >= SCENE_LAYERS) return;
+    SceneManager& sm = SceneManager::getInstance();
+    SceneTileView tiles = sm.GetSceneTiles(sceneId);
+    if (!tiles) return;
+    for (int x = 0; x < SCENE_MAP_SIZE; ++x) {
+        const SceneTile* row = tiles.row(x);
+        for (int y = 0; y < SCENE_MAP_SIZE; ++y) {
+            if (row[y].layer[layer] == oldPic) {
+                sm.SetSceneTile(sceneId, layer, x, y, newPic);
             }
         }
     }
@@ -1,40 +1,74 @@
 #include "FileLoader.h"
+#include "GroupFile.h"
+#include "ResourcePack.h"
+#include "VirtualFS.h"
 #include <filesystem>
 #include <iostream>
 #include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstdio>
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#endif
 
 const std::string RESOURCE_DIR = "resource/";
+const std::string PACK_NAME = "kys.pak";
+const std::string MODS_DIR = "mods";
 
-std::string FileLoader::getResourcePath(const std::string& filename) {
-    static std::string resourcePrefix = "";
-    static bool initialized = false;
-    
-    // If input is absolute path, use it directly
-    if (filename.find(":") != std::string::npos || filename.find("/") == 0 || filename.find("\\") == 0) {
-        return filename;
+namespace {
+    bool IsAbsolutePath(const std::string& filename) {
+        return filename.find(":") != std::string::npos || filename.find("/") == 0 || filename.find("\\") == 0;
+    }
+
+    // 新建或 rename 过来的目录项要 fsync 所在目录才落盘 (POSIX)。Windows 的 MoveFileEx 不需要。
+    // 有的文件系统不支持对目录 fsync (EINVAL)，这时只记一行日志，文件本身已经写好。
+    void SyncParentDirectory(const std::string& path) {
+#if !defined(_WIN32)
+        std::filesystem::path parent = std::filesystem::path(path).parent_path();
+        if (parent.empty()) parent = ".";
+        int fd = ::open(parent.c_str(), O_RDONLY | O_DIRECTORY);
+        if (fd < 0 || ::fsync(fd) != 0) {
+            std::cerr << "[FileLoader] Warning: could not sync directory " << parent.string() << std::endl;
+        }
+        if (fd >= 0) ::close(fd);
+#else
+        (void)path;
+#endif
+    }
+
+    std::atomic<bool> g_readLooseFiles{ false };
+
+    MappedFile MapLoose(const std::string& path) {
+        return g_readLooseFiles ? MappedFile::read(path) : MappedFile::open(path);
     }
 
-    if (!initialized) {
+    std::string DiscoverResourcePrefix() {
+        std::string resourcePrefix;
+
         // Candidates for resource directory
-         std::vector<std::string> candidates = {
-             "resource", 
-             "../resource", 
-             "../../resource", 
-             "../../../resource",
-             "Debug/resource",
-             "build/Debug/resource",
-             "build/Release/resource"
-         };
- 
-         // 1. Try to find a resource dir that contains key file 'smp'
-         for (const auto& dir : candidates) {
-             std::string testPath = dir + "/smp";
-             std::ifstream f(testPath.c_str());
-             if (f.good()) {
-                 resourcePrefix = dir + "/";
-                 break;
-             }
-         }
+        std::vector<std::string> candidates = {
+            "resource", 
+            "../resource", 
+            "../../resource", 
+            "../../../resource",
+            "Debug/resource",
+            "build/Debug/resource",
+            "build/Release/resource"
+        };
+
+        // 1. Try to find a resource dir that contains key file 'smp' (or a packed archive)
+        for (const auto& dir : candidates) {
+            std::ifstream f((dir + "/smp").c_str());
+            std::ifstream p((dir + "/" + PACK_NAME).c_str());
+            if (f.good() || p.good()) {
+                resourcePrefix = dir + "/";
+                break;
+            }
+        }
 
         // 2. If not found, fall back to any existing resource dir
         if (resourcePrefix.empty()) {
@@ -48,35 +82,122 @@ std::string FileLoader::getResourcePath(const std::string& filename) {
         
         // 3. Final fallback
         if (resourcePrefix.empty()) {
-             resourcePrefix = RESOURCE_DIR;
+            resourcePrefix = RESOURCE_DIR;
         }
 
-        initialized = true;
         std::cout << "[FileLoader] Discovered resource path: " << resourcePrefix << std::endl;
+        return resourcePrefix;
     }
 
-    std::string cleanName = filename;
-    
-    // Debug: Print input
-    // std::cout << "[FileLoader] Input: " << filename << std::endl;
+    // 只探测一次；函数内 static 的初始化是线程安全的 (GroupFile 等可能在工作线程里调用)
+    const std::string& ResourcePrefix() {
+        static const std::string prefix = DiscoverResourcePrefix();
+        return prefix;
+    }
+
+    // Name relative to the resource dir, "" for absolute paths (those never come from the pack)
+    std::string CleanResourceName(const std::string& filename) {
+        if (IsAbsolutePath(filename)) return "";
 
-    // Remove "resource/" or "resource\" from start of filename if present to avoid duplication
-    if (cleanName.find("resource/") == 0) {
-        cleanName = cleanName.substr(9);
-    } else if (cleanName.find("resource\\") == 0) {
-        cleanName = cleanName.substr(9);
+        std::string cleanName = filename;
+
+        // Remove "resource/" or "resource\" from start of filename if present to avoid duplication
+        if (cleanName.find("resource/") == 0) {
+            cleanName = cleanName.substr(9);
+        } else if (cleanName.find("resource\\") == 0) {
+            cleanName = cleanName.substr(9);
+        }
+        
+        // Handle "../resource/" case if present
+        if (cleanName.find("../resource/") == 0) {
+            cleanName = cleanName.substr(12);
+        }
+
+        // Already resolved against the discovered prefix
+        const std::string& prefix = ResourcePrefix();
+        if (cleanName.compare(0, prefix.size(), prefix) == 0) {
+            cleanName = cleanName.substr(prefix.size());
+        }
+        return cleanName;
     }
-    
-    // Handle "../resource/" case if present
-    if (cleanName.find("../resource/") == 0) {
-        cleanName = cleanName.substr(12);
+
+    // 资源层: resource 目录 → kys.pak → mods/ 下的各个 mod (按加载顺序)
+    // 启动时一次性合并成一张表，之后每次查找只做一次哈希
+    const VirtualFS& Vfs() {
+        static VirtualFS vfs;
+        static std::once_flag once;
+        std::call_once(once, [] {
+            const std::string& prefix = ResourcePrefix();
+            std::string baseDir = prefix.substr(0, prefix.size() - 1);
+            if (std::filesystem::is_directory(baseDir)) vfs.mount(baseDir);
+
+            std::ifstream probe((prefix + PACK_NAME).c_str());
+            if (probe.good()) vfs.mount(prefix + PACK_NAME);
+
+            for (const auto& mod : VirtualFS::discoverMods(prefix + "../" + MODS_DIR)) {
+                vfs.mount(mod);
+            }
+        });
+        return vfs;
     }
+}
 
-    // std::cout << "[FileLoader] Final Path: " << resourcePrefix + cleanName << std::endl;
-    return resourcePrefix + cleanName;
+std::string FileLoader::getResourcePath(const std::string& filename) {
+    // If input is absolute path, use it directly
+    if (IsAbsolutePath(filename)) {
+        return filename;
+    }
+    std::string name = CleanResourceName(filename);
+
+    // 最上层的散文件 (可能来自 mod 目录)
+    const VirtualFS::Entry* entry = Vfs().find(name);
+    if (entry && !entry->path.empty()) return entry->path;
+
+    return ResourcePrefix() + name;
+}
+
+bool FileLoader::hasPack() {
+    const VirtualFS& vfs = Vfs();
+    for (size_t i = 0; i < vfs.layerCount(); ++i) {
+        if (vfs.layerIsPack(static_cast<int>(i))) return true;
+    }
+    return false;
+}
+
+MappedFile FileLoader::findPacked(const std::string& filename) {
+    std::string name = CleanResourceName(filename);
+    if (name.empty()) return {};
+    const VirtualFS::Entry* entry = Vfs().find(name);
+    if (!entry || !entry->path.empty()) return {};
+    return Vfs().map(*entry);
+}
+
+std::map<int, MappedFile> FileLoader::findRecordOverrides(const std::string& grpName) {
+    std::map<int, MappedFile> out;
+    std::string name = CleanResourceName(grpName);
+    if (name.empty()) return out;
+    const VirtualFS::RecordOverrides* overrides = Vfs().recordOverrides(name);
+    if (!overrides) return out;
+    for (const auto& kv : *overrides) {
+        out[kv.first] = kv.second.path.empty() ? Vfs().map(kv.second) : MapLoose(kv.second.path);
+    }
+    return out;
+}
+
+void FileLoader::setReadLooseFiles(bool enabled) {
+    g_readLooseFiles = enabled;
+}
+
+const VirtualFS& FileLoader::virtualFS() {
+    return Vfs();
 }
 
 std::vector<uint8_t> FileLoader::loadFile(const std::string& filename) {
+    MappedFile packed = findPacked(filename);
+    if (!packed.empty()) {
+        return std::vector<uint8_t>(packed.begin(), packed.end());
+    }
+
     std::string path = getResourcePath(filename);
     std::ifstream file(path, std::ios::binary | std::ios::ate);
     if (!file) {
@@ -94,6 +215,18 @@ std::vector<uint8_t> FileLoader::loadFile(const std::string& filename) {
     return {};
 }
 
+MappedFile FileLoader::mapFile(const std::string& filename) {
+    MappedFile packed = findPacked(filename);
+    if (!packed.empty()) return packed;
+
+    std::string path = getResourcePath(filename);
+    MappedFile file = MapLoose(path);
+    if (file.empty()) {
+        std::cerr << "Failed to map file: " << path << std::endl;
+    }
+    return file;
+}
+
 bool FileLoader::saveFile(const std::string& filename, const void* data, size_t size) {
     // We assume saving to the same folder structure or a dedicated save folder
     // But getResourcePath finds the *read* path.
@@ -119,48 +252,79 @@ bool FileLoader::saveFile(const std::string& filename, const void* data, size_t
     return file.good();
 }
 
-std::vector<uint8_t> FileLoader::loadGroupRecord(const std::string& grpName, const std::string& idxName, int index) {
-    std::string idxPath = getResourcePath(idxName);
-    std::string grpPath = getResourcePath(grpName);
+bool FileLoader::saveFileAtomic(const std::string& path, const void* data, size_t size) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::path target(path);
+    if (target.has_parent_path()) fs::create_directories(target.parent_path(), ec);
 
-    std::ifstream idxFile(idxPath, std::ios::binary);
-    if (!idxFile) {
-        std::cerr << "Failed to open index file: " << idxPath << std::endl;
-        return {};
+    const std::string tmpPath = path + ".tmp";
+    FILE* file = std::fopen(tmpPath.c_str(), "wb");
+    if (!file) {
+        std::cerr << "[FileLoader] Failed to open file for writing: " << tmpPath << std::endl;
+        return false;
     }
 
-    int32_t offsetCurrent = 0;
-    int32_t offsetNext = 0;
+    bool ok = size == 0 || std::fwrite(data, 1, size, file) == size;
+    ok = ok && std::fflush(file) == 0;
+#if defined(_WIN32)
+    ok = ok && _commit(_fileno(file)) == 0;
+#else
+    ok = ok && fsync(fileno(file)) == 0;
+#endif
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok) {
+        std::cerr << "[FileLoader] Failed to write " << tmpPath << std::endl;
+        fs::remove(tmpPath, ec);
+        return false;
+    }
 
-    idxFile.seekg(index * 4);
-    if (!idxFile.read(reinterpret_cast<char*>(&offsetCurrent), 4)) {
-        return {};
+    // 同一卷内 rename 是原子的 (Windows 下 std::filesystem 使用 MoveFileEx 覆盖)
+    fs::rename(tmpPath, target, ec);
+    if (ec) {
+        std::cerr << "[FileLoader] Failed to replace " << path << ": " << ec.message() << std::endl;
+        fs::remove(tmpPath, ec);
+        return false;
     }
+    SyncParentDirectory(path);
+    return true;
+}
 
-    if (!idxFile.read(reinterpret_cast<char*>(&offsetNext), 4)) {
-        std::ifstream grpFileCheck(grpPath, std::ios::binary | std::ios::ate);
-        if (grpFileCheck) {
-            offsetNext = static_cast<int32_t>(grpFileCheck.tellg());
-        } else {
-            return {};
+bool FileLoader::appendFileSynced(const std::string& path, uint64_t offset, const void* data, size_t size) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    FILE* file = nullptr;
+    if (offset == 0) {
+        file = std::fopen(path.c_str(), "wb");
+    } else {
+        if (fs::file_size(path, ec) < offset || ec) {
+            std::cerr << "[FileLoader] " << path << " is shorter than " << offset << " bytes" << std::endl;
+            return false;
         }
+        fs::resize_file(path, offset, ec);
+        if (!ec) file = std::fopen(path.c_str(), "ab");
     }
-
-    int32_t length = offsetNext - offsetCurrent;
-    if (length <= 0) {
-        return {};
+    if (!file) {
+        std::cerr << "[FileLoader] Failed to open file for writing: " << path << std::endl;
+        return false;
     }
 
-    std::ifstream grpFile(grpPath, std::ios::binary);
-    if (!grpFile) {
-        return {};
-    }
+    bool ok = size == 0 || std::fwrite(data, 1, size, file) == size;
+    ok = ok && std::fflush(file) == 0;
+#if defined(_WIN32)
+    ok = ok && _commit(_fileno(file)) == 0;
+#else
+    ok = ok && fsync(fileno(file)) == 0;
+#endif
+    ok = (std::fclose(file) == 0) && ok;
+    if (ok && offset == 0) SyncParentDirectory(path); // 新建的日志
+    return ok;
+}
 
-    grpFile.seekg(offsetCurrent);
-    std::vector<uint8_t> buffer(length);
-    if (!grpFile.read(reinterpret_cast<char*>(buffer.data()), length)) {
-        return {};
-    }
+std::vector<uint8_t> FileLoader::loadGroupRecord(const std::string& grpName, const std::string& idxName, int index) {
+    auto group = GroupFile::open(grpName, idxName);
+    if (!group) return {};
 
-    return buffer;
+    MappedFile record = group->record(index);
+    return std::vector<uint8_t>(record.begin(), record.end());
 }
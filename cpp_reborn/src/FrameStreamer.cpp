@@ -0,0 +1,151 @@
+#include "FrameStreamer.h"
+#include <iostream>
+
+FrameStreamer::FrameStreamer(size_t ringSize) : m_ringSize(ringSize < 1 ? 1 : ringSize) {}
+
+FrameStreamer::~FrameStreamer() {
+    stop();
+}
+
+bool FrameStreamer::start(int frameCount, DecodeFunc decode) {
+    stop();
+    if (frameCount <= 0 || !decode) return false;
+
+    m_cancel = false;
+    m_workerDone = false;
+    m_dropped = 0;
+    m_worker = std::thread(&FrameStreamer::workerLoop, this, frameCount, std::move(decode));
+    return true;
+}
+
+void FrameStreamer::stop() {
+    m_cancel = true;
+    m_cond.notify_all();
+    if (m_worker.joinable()) m_worker.join();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& f : m_ready) {
+        if (f.surface) SDL_DestroySurface(f.surface);
+    }
+    m_ready.clear();
+    m_workerDone = true;
+}
+
+void FrameStreamer::workerLoop(int frameCount, DecodeFunc decode) {
+    for (int i = 0; i < frameCount && !m_cancel; ++i) {
+        // 环满时等待主线程取走
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cond.wait(lock, [this] { return m_cancel || m_ready.size() < m_ringSize; });
+            if (m_cancel) break;
+        }
+
+        SDL_Surface* surface = decode(i);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_cancel) {
+            if (surface) SDL_DestroySurface(surface);
+            break;
+        }
+        m_ready.push_back({ i, surface });
+        m_cond.notify_all();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_workerDone = true;
+    m_cond.notify_all();
+}
+
+bool FrameStreamer::nextFrame(int& index, SDL_Surface*& surface) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cond.wait(lock, [this] { return !m_ready.empty() || m_workerDone; });
+    if (m_ready.empty()) return false;
+
+    index = m_ready.front().index;
+    surface = m_ready.front().surface;
+    m_ready.pop_front();
+    m_cond.notify_all();
+    return true;
+}
+
+int FrameStreamer::play(SDL_Renderer* renderer, const PlaybackOptions& options) {
+    if (!renderer) {
+        stop();
+        return 0;
+    }
+
+    // 双缓冲：两张流式纹理轮换更新，避免每帧创建/销毁纹理
+    SDL_Texture* textures[2] = { nullptr, nullptr };
+    int texW = 0, texH = 0;
+    int current = 0;
+    int shown = 0;
+
+    const uint64_t intervalNs = uint64_t(options.frameIntervalMs) * 1000000ull;
+    const uint64_t startNs = SDL_GetTicksNS();
+
+    int index = 0;
+    SDL_Surface* surface = nullptr;
+    while (nextFrame(index, surface)) {
+        if (options.shouldStop && options.shouldStop()) {
+            if (surface) SDL_DestroySurface(surface);
+            break;
+        }
+
+        uint64_t deadline = startNs + uint64_t(index) * intervalNs;
+        uint64_t now = SDL_GetTicksNS();
+
+        // 已经落后超过一帧：丢弃这一帧以追上时钟
+        if (now > deadline + intervalNs) {
+            ++m_dropped;
+            if (surface) SDL_DestroySurface(surface);
+            continue;
+        }
+
+        if (surface) {
+            if (surface->format != SDL_PIXELFORMAT_ARGB8888) {
+                SDL_Surface* converted = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_ARGB8888);
+                SDL_DestroySurface(surface);
+                surface = converted;
+            }
+        }
+
+        if (surface) {
+            if (surface->w != texW || surface->h != texH) {
+                for (auto& t : textures) {
+                    if (t) SDL_DestroyTexture(t);
+                    t = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, surface->w, surface->h);
+                }
+                texW = surface->w;
+                texH = surface->h;
+            }
+            current ^= 1;
+            if (textures[current]) {
+                SDL_UpdateTexture(textures[current], nullptr, surface->pixels, surface->pitch);
+            }
+            SDL_DestroySurface(surface);
+        }
+
+        now = SDL_GetTicksNS();
+        if (now < deadline) SDL_DelayNS(deadline - now);
+
+        if (textures[current]) {
+            SDL_RenderClear(renderer);
+            if (options.draw) {
+                options.draw(renderer, textures[current]);
+            } else {
+                SDL_RenderTexture(renderer, textures[current], nullptr, nullptr);
+            }
+            SDL_RenderPresent(renderer);
+            ++shown;
+        }
+    }
+
+    stop();
+    for (auto& t : textures) {
+        if (t) SDL_DestroyTexture(t);
+    }
+    if (m_dropped > 0) {
+        std::cout << "[FrameStreamer] Played " << shown << " frames, dropped " << m_dropped << std::endl;
+    }
+    return shown;
+}
@@ -4,12 +4,20 @@
 #include "BattleManager.h"
 #include "EventManager.h"
 #include "FileLoader.h"
+#include "GroupFile.h"
+#include "VirtualFS.h"
 #include "PicLoader.h"
 #include "TextManager.h"
+#include "SaveSlotInfo.h"
+#include "SaveContainer.h"
 #include <iostream>
 #include <fstream>
 #include <algorithm>
 #include <random>
+#include <ctime>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
 #include <direct.h> // For _getcwd on Windows
 #include <io.h>     // For access
 #define getcwd _getcwd
@@ -24,6 +32,25 @@ namespace {
         }
         s.erase(i);
     }
+
+    // 存档目录: 从当前目录向上找 ranger.grp，转成绝对路径 (绕过 FileLoader 的资源路径前缀)
+    std::string FindSavePath() {
+        std::string savePrefix = "../save/";
+        if (access((savePrefix + "ranger.grp").c_str(), 0) != 0) {
+            savePrefix = "../../save/";
+            if (access((savePrefix + "ranger.grp").c_str(), 0) != 0) {
+                savePrefix = "../../../save/";
+                 if (access((savePrefix + "ranger.grp").c_str(), 0) != 0) {
+                     savePrefix = "save/"; // Try current dir
+                 }
+            }
+        }
+        char absPath[1024];
+        if (_fullpath(absPath, savePrefix.c_str(), 1024) != NULL) {
+            savePrefix = std::string(absPath) + "\\";
+        }
+        return savePrefix;
+    }
 }
 
 GameManager& GameManager::getInstance() {
@@ -97,43 +124,10 @@ bool GameManager::Init() {
         return false;
     }
 
-    // Load MMap Data
-    auto loadMMapLayer = [&](const std::string& filename, std::vector<int16_t>& target) {
-        std::vector<uint8_t> data = FileLoader::loadFile(filename);
-        if (data.size() == 480 * 480 * 2) {
-            target.resize(480 * 480);
-            memcpy(target.data(), data.data(), data.size());
-        } else {
-            std::cerr << "Failed to load MMap layer: " << filename << " Size: " << data.size() << std::endl;
-            // Fallback to empty
-            target.resize(480 * 480, 0);
-        }
-    };
-
-    loadMMapLayer("resource/earth.002", m_earth);
-    loadMMapLayer("resource/surface.002", m_surface);
-    loadMMapLayer("resource/building.002", m_building);
-    loadMMapLayer("resource/buildx.002", m_buildX);
-    loadMMapLayer("resource/buildy.002", m_buildY);
-    m_entrance.resize(480 * 480, -1);
+    // 大地图图层由 SceneManager::Init 载入 (WorldMap)
 
     // Find Save Directory
-    std::string savePrefix = "../save/";
-    if (access((savePrefix + "ranger.grp").c_str(), 0) != 0) {
-        savePrefix = "../../save/";
-        if (access((savePrefix + "ranger.grp").c_str(), 0) != 0) {
-            savePrefix = "../../../save/";
-             if (access((savePrefix + "ranger.grp").c_str(), 0) != 0) {
-                 savePrefix = "save/"; // Try current dir
-             }
-        }
-    }
-    
-    // Convert to absolute path to bypass FileLoader's resource prefixing
-    char absPath[1024];
-    if (_fullpath(absPath, savePrefix.c_str(), 1024) != NULL) {
-        savePrefix = std::string(absPath) + "\\";
-    }
+    std::string savePrefix = FindSavePath();
     
     // Store save path for later use (e.g. InitNewGame)
     m_savePath = savePrefix;
@@ -230,6 +224,7 @@ void GameManager::loadData(const std::string& savePrefix) {
     int MagicOffset = idxPtr[3];
     int WeiShopOffset = idxPtr[4];
     int TotalLen = idxPtr[5];
+    m_saveLayout = { RoleOffset, ItemOffset, SceneOffset, MagicOffset, WeiShopOffset, TotalLen };
     
     std::cout << "Ranger IDX Offsets: Role=" << RoleOffset 
               << ", Item=" << ItemOffset 
@@ -312,12 +307,7 @@ void GameManager::loadData(const std::string& savePrefix) {
         int roleDataSize = ItemOffset - RoleOffset;
         const int bytesPerRole = static_cast<int>(ROLE_DATA_SIZE * sizeof(int16));
         int numRoles = (bytesPerRole > 0) ? (roleDataSize / bytesPerRole) : 0;
-        m_roles.resize(numRoles);
-        
-        const int16_t* roleSrc = reinterpret_cast<const int16_t*>(dataPtr + RoleOffset);
-        for (int i = 0; i < numRoles; ++i) {
-            m_roles[i].loadFromBuffer(roleSrc + static_cast<size_t>(i) * ROLE_DATA_SIZE, ROLE_DATA_SIZE);
-        }
+        m_roles.assign(dataPtr + RoleOffset, numRoles);
         std::cout << "Loaded " << numRoles << " roles from ranger.grp" << std::endl;
     }
     
@@ -327,12 +317,7 @@ void GameManager::loadData(const std::string& savePrefix) {
         int itemDataSize = SceneOffset - ItemOffset;
         const int bytesPerItem = static_cast<int>(ITEM_DATA_SIZE * sizeof(int16));
         int numItems = (bytesPerItem > 0) ? (itemDataSize / bytesPerItem) : 0;
-        m_items.resize(numItems);
-        
-        const int16_t* itemSrc = reinterpret_cast<const int16_t*>(dataPtr + ItemOffset);
-        for (int i = 0; i < numItems; ++i) {
-            m_items[i].loadFromBuffer(itemSrc + static_cast<size_t>(i) * ITEM_DATA_SIZE, ITEM_DATA_SIZE);
-        }
+        m_items.assign(dataPtr + ItemOffset, numItems);
         std::cout << "Loaded " << numItems << " items from ranger.grp" << std::endl;
     }
     
@@ -342,12 +327,7 @@ void GameManager::loadData(const std::string& savePrefix) {
         int magicDataSize = WeiShopOffset - MagicOffset;
         const int bytesPerMagic = static_cast<int>(MAGIC_DATA_SIZE * sizeof(int16));
         int numMagics = (bytesPerMagic > 0) ? (magicDataSize / bytesPerMagic) : 0;
-        m_magics.resize(numMagics);
-        
-        const int16_t* magicSrc = reinterpret_cast<const int16_t*>(dataPtr + MagicOffset);
-        for (int i = 0; i < numMagics; ++i) {
-            m_magics[i].loadFromBuffer(magicSrc + static_cast<size_t>(i) * MAGIC_DATA_SIZE, MAGIC_DATA_SIZE);
-        }
+        m_magics.assign(dataPtr + MagicOffset, numMagics);
         std::cout << "Loaded " << numMagics << " magics from ranger.grp" << std::endl;
     }
     
@@ -359,13 +339,9 @@ void GameManager::loadData(const std::string& savePrefix) {
          int sceneDataSize = MagicOffset - SceneOffset;
          const int bytesPerScene = static_cast<int>(SCENE_DATA_SIZE * sizeof(int16));
          int numScenes = (bytesPerScene > 0) ? (sceneDataSize / bytesPerScene) : 0;
-         std::vector<Scene> scenes(numScenes);
-         
-         const int16_t* sceneSrc = reinterpret_cast<const int16_t*>(dataPtr + SceneOffset);
-         for (int i = 0; i < numScenes; ++i) {
-             scenes[i].loadFromBuffer(sceneSrc + static_cast<size_t>(i) * SCENE_DATA_SIZE, SCENE_DATA_SIZE);
-         }
-         SceneManager::getInstance().SetScenes(scenes);
+         SceneTable scenes;
+         scenes.assign(dataPtr + SceneOffset, numScenes);
+         SceneManager::getInstance().SetScenes(std::move(scenes));
          std::cout << "Loaded " << numScenes << " scenes from ranger.grp. Data Size: " << sceneDataSize << " bytes." << std::endl;
     }
 
@@ -431,354 +407,491 @@ int GameManager::getNextLevelExp(int level) {
     if (idx >= (int)m_levelUpList.size()) return -1;
     return (int)m_levelUpList[idx];
 }
-void GameManager::SaveGame(int slot) {
-    std::string filename = (slot == 0) ? "ranger" : "R" + std::to_string(slot);
-    std::string grpPath = m_savePath + filename + ".grp";
-    std::string idxPath = m_savePath + "ranger.idx";
+namespace {
+    // 一次后台存档的全部内容 (主线程拍快照，写盘线程只读它)
+    struct PendingSave {
+        int slot;
+        std::string grpPath;
+        SaveImageWriter image;
+        SaveSlotInfo info;
+        PagedFile::Snapshot map;
+        PagedFile::Snapshot events;
+        bool compressed = false;
+        bool mapWritten = false;
+        bool eventsWritten = false;
+    };
 
-    std::ifstream idxFile(idxPath, std::ios::binary);
-    if (!idxFile) {
-        std::cerr << "SaveGame: Cannot open " << idxPath << std::endl;
-        return;
+    SaveImageWriter BuildSaveImage(const SaveLayout& layout, const std::vector<int16_t>& header,
+                                   const RoleTable& roles, const ItemTable& items,
+                                   const SceneTable& scenes, const MagicTable& magics,
+                                   const std::vector<uint8_t>& shopRaw) {
+        SaveImageWriter image(layout);
+        image.putHeader(header);
+        image.putTable(layout.roleOffset, layout.itemOffset, roles);
+        image.putTable(layout.itemOffset, layout.sceneOffset, items);
+        image.putTable(layout.sceneOffset, layout.magicOffset, scenes);
+        image.putTable(layout.magicOffset, layout.shopOffset, magics);
+        // Shops (WeiShop): preserved raw bytes, padded/truncated to the section
+        image.putBytes(layout.shopOffset, layout.totalLength, shopRaw);
+        return image;
+    }
+
+    // 存档菜单读的说明文件 R*.inf。header 是存档头部: [1] 场景, [2][3] 坐标, [11..] 队伍 (-1 为空)
+    SaveSlotInfo BuildSlotInfo(const std::vector<int16_t>& header, const RoleTable& roles,
+                               const SceneTable& scenes) {
+        SaveSlotInfo info;
+        if (header.size() < 11 + MAX_TEAM_SIZE) return info;
+        info.sceneId = (header[1] < 0) ? static_cast<int16_t>(-1) : header[1];
+        if (info.sceneId >= 0 && info.sceneId < static_cast<int>(scenes.size())) {
+            info.sceneName = scenes[info.sceneId].getName();
+        }
+        info.mapX = header[2];
+        info.mapY = header[3];
+        for (int i = 0; i < MAX_TEAM_SIZE && i < SaveSlotInfo::MAX_TEAM; ++i) {
+            if (header[11 + i] >= 0) info.team.push_back(header[11 + i]);
+        }
+        if (!info.team.empty() && info.team[0] < static_cast<int>(roles.size())) {
+            const Role& lead = roles[info.team[0]];
+            info.leadName = lead.getName();
+            info.leadLevel = lead.getLevel();
+        }
+        info.savedAt = static_cast<int64_t>(std::time(nullptr));
+        return info;
     }
 
-    int32_t RoleOffset, ItemOffset, SceneOffset, MagicOffset, WeiShopOffset, TotalLen;
-    idxFile.read((char*)&RoleOffset, 4);
-    idxFile.read((char*)&ItemOffset, 4);
-    idxFile.read((char*)&SceneOffset, 4);
-    idxFile.read((char*)&MagicOffset, 4);
-    idxFile.read((char*)&WeiShopOffset, 4);
-    idxFile.read((char*)&TotalLen, 4);
-    idxFile.close();
-
-    std::ofstream grpFile(grpPath, std::ios::binary);
-    if (!grpFile) {
-        std::cerr << "SaveGame: Cannot create " << grpPath << std::endl;
-        return;
+    // 写 R*.grp，成功后写 R*.inf (写不出来不算存档失败，删掉旧的免得描述错存档)
+    bool WriteSaveImage(const SaveImageWriter& image, const SaveSlotInfo& info, const std::string& grpPath, bool compressed) {
+        if (!image.writeTo(grpPath, compressed)) return false;
+        std::string infoPath = SaveSlotInfo::pathFor(grpPath);
+        if (!info.writeTo(infoPath)) {
+            std::cerr << "SaveGame: Could not write " << infoPath << std::endl;
+            std::remove(infoPath.c_str());
+        }
+        return true;
     }
+}
 
-    auto write16 = [&](int16_t val) {
-        grpFile.write(reinterpret_cast<const char*>(&val), 2);
-    };
-
-    int16_t whereVal = (m_currentSceneId < 0) ? static_cast<int16_t>(-1) : static_cast<int16_t>(m_currentSceneId);
-
-    write16(m_inShip);
-    write16(whereVal);
-    write16(static_cast<int16_t>(m_mainMapX));
-    write16(static_cast<int16_t>(m_mainMapY));
-    write16(static_cast<int16_t>(m_mainMapFace));
-    write16(m_shipX);
-    write16(m_shipY);
-    write16(m_time);
-    write16(m_timeEvent);
-    write16(m_randomEvent);
-    write16(m_subMapFace);
+std::vector<int16_t> GameManager::BuildSaveHeader() const {
+    std::vector<int16_t> header;
+    header.reserve(11 + MAX_TEAM_SIZE + MAX_ITEM_AMOUNT * 2);
+    header.push_back(m_inShip);
+    header.push_back((m_currentSceneId < 0) ? static_cast<int16_t>(-1) : static_cast<int16_t>(m_currentSceneId));
+    header.push_back(static_cast<int16_t>(m_mainMapX));
+    header.push_back(static_cast<int16_t>(m_mainMapY));
+    header.push_back(static_cast<int16_t>(m_mainMapFace));
+    header.push_back(m_shipX);
+    header.push_back(m_shipY);
+    header.push_back(m_time);
+    header.push_back(m_timeEvent);
+    header.push_back(m_randomEvent);
+    header.push_back(m_subMapFace);
 
     for (int i = 0; i < MAX_TEAM_SIZE; ++i) {
-        int16_t value = 0;
-        if (i < static_cast<int>(m_teamList.size())) {
-            value = static_cast<int16_t>(m_teamList[i]);
-        }
-        write16(value);
+        header.push_back(i < static_cast<int>(m_teamList.size()) ? static_cast<int16_t>(m_teamList[i]) : 0);
     }
 
     int inventoryCount = static_cast<int>(m_inventory.size());
     for (int i = 0; i < MAX_ITEM_AMOUNT; ++i) {
-        int16_t id = 0;
-        int16_t amount = 0;
-        if (i < inventoryCount) {
-            id = m_inventory[i].id;
-            amount = m_inventory[i].amount;
-        }
-        write16(id);
-        write16(amount);
-    }
-
-    std::streampos headerEnd = grpFile.tellp();
-    if (headerEnd < RoleOffset) {
-        int padSize = static_cast<int>(RoleOffset - headerEnd);
-        std::vector<char> padding(padSize, 0);
-        grpFile.write(padding.data(), padSize);
-    } else if (headerEnd > RoleOffset) {
-        std::cerr << "SaveGame: Header exceeds RoleOffset, truncating to RoleOffset." << std::endl;
-        grpFile.seekp(RoleOffset, std::ios::beg);
-    }
-
-    // 1. Write Roles
-    int roleBytesToWrite = ItemOffset - RoleOffset;
-    int roleBytesWritten = 0;
-    for (const auto& role : m_roles) {
-        if (roleBytesWritten + ROLE_DATA_SIZE * 2 <= roleBytesToWrite) {
-            grpFile.write((char*)role.getRawData(), ROLE_DATA_SIZE * 2);
-            roleBytesWritten += ROLE_DATA_SIZE * 2;
-        } else break;
-    }
-    while (roleBytesWritten < roleBytesToWrite) {
-        char zero = 0;
-        grpFile.write(&zero, 1);
-        roleBytesWritten++;
-    }
-
-    // 2. Write Items
-    int itemBytesToWrite = SceneOffset - ItemOffset;
-    int itemBytesWritten = 0;
-    for (const auto& item : m_items) {
-        if (itemBytesWritten + ITEM_DATA_SIZE * 2 <= itemBytesToWrite) {
-            grpFile.write((char*)item.getRawData(), ITEM_DATA_SIZE * 2);
-            itemBytesWritten += ITEM_DATA_SIZE * 2;
-        } else break;
-    }
-    while (itemBytesWritten < itemBytesToWrite) {
-        char zero = 0;
-        grpFile.write(&zero, 1);
-        itemBytesWritten++;
-    }
-
-    // 3. Write Scenes
-    int sceneBytesToWrite = MagicOffset - SceneOffset;
-    int sceneBytesWritten = 0;
-    const auto& scenes = SceneManager::getInstance().getScenes();
-    for (const auto& scene : scenes) {
-        if (sceneBytesWritten + SCENE_DATA_SIZE * 2 <= sceneBytesToWrite) {
-            grpFile.write((char*)scene.getRawData(), SCENE_DATA_SIZE * 2);
-            sceneBytesWritten += SCENE_DATA_SIZE * 2;
-        } else break;
-    }
-    while (sceneBytesWritten < sceneBytesToWrite) {
-        char zero = 0;
-        grpFile.write(&zero, 1);
-        sceneBytesWritten++;
-    }
-
-    // 4. Write Magics
-    int magicBytesToWrite = WeiShopOffset - MagicOffset;
-    int magicBytesWritten = 0;
-    for (const auto& magic : m_magics) {
-        if (magicBytesWritten + MAGIC_DATA_SIZE * 2 <= magicBytesToWrite) {
-            grpFile.write((char*)magic.getRawData(), MAGIC_DATA_SIZE * 2);
-            magicBytesWritten += MAGIC_DATA_SIZE * 2;
-        } else break;
-    }
-    while (magicBytesWritten < magicBytesToWrite) {
-        char zero = 0;
-        grpFile.write(&zero, 1);
-        magicBytesWritten++;
-    }
-
-    // 5. Write Shops (WeiShop)
-    int shopBytesToWrite = TotalLen - WeiShopOffset;
-    if (shopBytesToWrite > 0) {
-        if (!m_shopRaw.empty()) {
-            // Write preserved shop data, pad/truncate to exact size
-            if ((int)m_shopRaw.size() >= shopBytesToWrite) {
-                grpFile.write(reinterpret_cast<const char*>(m_shopRaw.data()), shopBytesToWrite);
-            } else {
-                grpFile.write(reinterpret_cast<const char*>(m_shopRaw.data()), (std::streamsize)m_shopRaw.size());
-                int pad = shopBytesToWrite - (int)m_shopRaw.size();
-                std::vector<char> zeros(pad, 0);
-                grpFile.write(zeros.data(), pad);
-            }
-        } else {
-            std::vector<char> zeros(shopBytesToWrite, 0);
-            grpFile.write(zeros.data(), shopBytesToWrite);
-        }
+        header.push_back(i < inventoryCount ? m_inventory[i].id : 0);
+        header.push_back(i < inventoryCount ? m_inventory[i].amount : 0);
     }
+    return header;
+}
 
-    grpFile.close();
+void GameManager::ApplySaveHeader(const std::vector<int16_t>& header) {
+    size_t at = 0;
+    auto next = [&]() -> int16_t { return at < header.size() ? header[at++] : 0; };
+
+    m_inShip = next();
+    int16_t where = next();
+    m_currentSceneId = (where < 0) ? -1 : where;
+    m_mainMapX = next();
+    m_mainMapY = next();
+    m_mainMapFace = next();
+    m_shipX = next();
+    m_shipY = next();
+    m_time = next();
+    m_timeEvent = next();
+    m_randomEvent = next();
+    m_subMapFace = next();
+    setMainMapPosition(m_mainMapX, m_mainMapY);
+    resetWalkFrame();
 
-    std::string sFilename = (slot == 0) ? "allsin.grp" : "S" + std::to_string(slot) + ".grp";
-    std::string dFilename = (slot == 0) ? "alldef.grp" : "D" + std::to_string(slot) + ".grp";
-    
-    SceneManager::getInstance().SaveMapData(m_savePath + sFilename);
-    SceneManager::getInstance().SaveEventData(m_savePath + dFilename);
-    
-    std::cout << "Game Saved to Slot " << slot << std::endl;
-}
+    m_teamList.assign(MAX_TEAM_SIZE, -1);
+    for (int i = 0; i < MAX_TEAM_SIZE; ++i) m_teamList[i] = next();
 
-void GameManager::reSetEntrance() {
-    // Reset entrance array
-    std::fill(m_entrance.begin(), m_entrance.end(), -1);
-    
-    const auto& scenes = SceneManager::getInstance().getScenes();
-    for (size_t i = 0; i < scenes.size(); ++i) {
-        const auto& scene = scenes[i];
-        
-        // Check MainEntrance 1
-        int mx1 = scene.getMainEntranceX1();
-        int my1 = scene.getMainEntranceY1();
-        if (mx1 >= 0 && mx1 < 480 && my1 >= 0 && my1 < 480) {
-            m_entrance[mx1 * 480 + my1] = (int16_t)i;
-        }
-        
-        // Check MainEntrance 2
-        int mx2 = scene.getMainEntranceX2();
-        int my2 = scene.getMainEntranceY2();
-        if (mx2 >= 0 && mx2 < 480 && my2 >= 0 && my2 < 480) {
-            m_entrance[mx2 * 480 + my2] = (int16_t)i;
-        }
+    m_inventory.resize(MAX_ITEM_AMOUNT);
+    for (int i = 0; i < MAX_ITEM_AMOUNT; ++i) {
+        m_inventory[i].id = next();
+        m_inventory[i].amount = next();
     }
-    std::cout << "[GameManager] Entrance map reset." << std::endl;
 }
 
-bool GameManager::LoadGame(int slot) {
+bool GameManager::SaveGame(int slot) {
+    // 上一次存档还在写时先等它完成，保证各存档按顺序落盘
+    m_saveWorker.wait();
+
     std::string filename = (slot == 0) ? "ranger" : "R" + std::to_string(slot);
     std::string grpPath = m_savePath + filename + ".grp";
-    std::string idxPath = m_savePath + "ranger.idx";
 
-    std::ifstream idxFile(idxPath, std::ios::binary);
-    if (!idxFile) {
-        std::cerr << "LoadGame: Cannot open " << idxPath << std::endl;
+    // 偏移在读档时已读过，只在从未读过 (或无效) 时再读 ranger.idx
+    if (!m_saveLayout.valid() && !SaveLayout::load(m_savePath + "ranger.idx", m_saveLayout)) {
+        std::cerr << "SaveGame: No valid ranger.idx, save aborted" << std::endl;
         return false;
     }
 
-    int32_t RoleOffset, ItemOffset, SceneOffset, MagicOffset, WeiShopOffset, TotalLen;
-    idxFile.read((char*)&RoleOffset, 4);
-    idxFile.read((char*)&ItemOffset, 4);
-    idxFile.read((char*)&SceneOffset, 4);
-    idxFile.read((char*)&MagicOffset, 4);
-    idxFile.read((char*)&WeiShopOffset, 4);
-    idxFile.read((char*)&TotalLen, 4);
-    idxFile.close();
-    
-    std::cout << "[LoadGame] Offsets: Role=" << RoleOffset << " Item=" << ItemOffset 
-              << " Scene=" << SceneOffset << " Magic=" << MagicOffset << std::endl;
+    // 快照: 整个 R*.grp 在内存中拼好，S*/D*.grp 只复制 dirty 场景；写盘交给后台线程
+    SceneManager& sm = SceneManager::getInstance();
+    std::vector<int16_t> header = BuildSaveHeader();
+    SaveImageWriter image = BuildSaveImage(m_saveLayout, header, m_roles, m_items, sm.getScenes(), m_magics, m_shopRaw);
 
-    std::ifstream grpFile(grpPath, std::ios::binary);
-    if (!grpFile) {
-        if (slot == 0) {
-            grpPath = m_savePath + "Ranger.grp";
-            grpFile.open(grpPath, std::ios::binary);
-        }
-        if (!grpFile) {
-            std::cerr << "LoadGame: Cannot open " << grpPath << std::endl;
-            return false;
-        }
+    SaveSlotInfo info = BuildSlotInfo(header, m_roles, sm.getScenes());
+    const std::vector<uint16_t>& thumb = UIManager::getInstance().GetSaveThumbnail();
+    if (!thumb.empty()) {
+        info.thumbWidth = UIManager::SAVE_THUMB_W;
+        info.thumbHeight = UIManager::SAVE_THUMB_H;
+        info.thumbnail = thumb;
     }
-    std::cout << "[LoadGame] Opened " << grpPath << std::endl;
 
-    auto read16 = [&](int16_t& val) {
-        grpFile.read((char*)&val, 2);
-    };
+    std::string sFilename = (slot == 0) ? "allsin.grp" : "S" + std::to_string(slot) + ".grp";
+    std::string dFilename = (slot == 0) ? "alldef.grp" : "D" + std::to_string(slot) + ".grp";
 
-    read16(m_inShip);
-    int16_t tempWhere;
-    read16(tempWhere);
-    if (tempWhere < 0) {
-        m_currentSceneId = -1;
-    } else {
-        m_currentSceneId = tempWhere;
-    }
+    auto save = std::make_shared<PendingSave>(PendingSave{
+        slot, grpPath, std::move(image), std::move(info),
+        sm.SnapshotMapData(m_savePath + sFilename),
+        sm.SnapshotEventData(m_savePath + dFilename), m_compressSaves });
+
+    m_saveWorker.submit(
+        [save](std::string& error) {
+            bool grpWritten = WriteSaveImage(save->image, save->info, save->grpPath, save->compressed);
+            // 没有打开的 SData/DData 时没有东西要写
+            save->mapWritten = save->map.count == 0 || PagedFile::writeSnapshot(save->map);
+            save->eventsWritten = save->events.count == 0 || PagedFile::writeSnapshot(save->events);
+            if (!grpWritten) error += save->grpPath + " ";
+            if (!save->mapWritten) error += save->map.path + " ";
+            if (!save->eventsWritten) error += save->events.path + " ";
+            return grpWritten && save->mapWritten && save->eventsWritten;
+        },
+        [save](bool ok, const std::string& error) {
+            // 写失败的场景保持 dirty，下次存档会再写
+            SceneManager& scenes = SceneManager::getInstance();
+            scenes.CommitMapData(save->map, save->mapWritten);
+            scenes.CommitEventData(save->events, save->eventsWritten);
+            if (ok) {
+                std::cout << "Game Saved to Slot " << save->slot << std::endl;
+                UIManager::getInstance().SetStatusMessage("進度已保存");
+            } else {
+                std::cerr << "SaveGame: Slot " << save->slot << " failed: " << error << std::endl;
+                UIManager::getInstance().SetStatusMessage("保存失敗", 4000);
+            }
+        });
+    return true;
+}
 
-    read16((int16_t&)m_mainMapX);
-    read16((int16_t&)m_mainMapY);
-    read16((int16_t&)m_mainMapFace);
-    read16(m_shipX);
-    read16(m_shipY);
-    read16(m_time);
-    read16(m_timeEvent);
-    read16(m_randomEvent);
-    read16(m_subMapFace);
+bool GameManager::CaptureState(QuickSaveState& state, const QuickSaveState* previous, bool deferSceneReads) const {
+    state.takenAtMs = SDL_GetTicks();
+    state.header = BuildSaveHeader();
+    state.roles = m_roles;
+    state.items = m_items;
+    state.scenes = SceneManager::getInstance().getScenes();
+    state.magics = m_magics;
+    state.shopRaw = m_shopRaw;
+    state.x50 = m_x50;
+    state.savedWorldX = m_savedWorldX;
+    state.savedWorldY = m_savedWorldY;
+
+    // 没改过的场景与上一份快照共享，第一次之后只复制改动的场景
+    SceneManager& sm = SceneManager::getInstance();
+    return sm.CaptureMapData(state.map, previous ? &previous->map : nullptr, deferSceneReads) &&
+           sm.CaptureEventData(state.events, previous ? &previous->events : nullptr, deferSceneReads);
+}
 
-    std::cout << "[LoadGame] Header loaded. Scene=" << m_currentSceneId << " Pos=(" << m_mainMapX << "," << m_mainMapY << ")" << std::endl;
-    setMainMapPosition(m_mainMapX, m_mainMapY);
-    resetWalkFrame();
+uint64_t GameManager::CaptureBytes(const QuickSaveState* previous, bool deferSceneReads) const {
+    const SceneManager& sm = SceneManager::getInstance();
+    uint64_t bytes = (m_roles.size() * ROLE_DATA_SIZE + m_items.size() * ITEM_DATA_SIZE +
+                      sm.getScenes().size() * SCENE_DATA_SIZE + m_magics.size() * MAGIC_DATA_SIZE + m_x50.size()) *
+                     sizeof(int16_t);
+    bytes += m_shopRaw.size();
+    return bytes + sm.CaptureBytes(previous ? &previous->map : nullptr, previous ? &previous->events : nullptr, deferSceneReads);
+}
 
-    m_teamList.resize(MAX_TEAM_SIZE);
-    for(int i=0; i<MAX_TEAM_SIZE; ++i) {
-        read16((int16_t&)m_teamList[i]);
+bool GameManager::QuickSave() {
+    QuickSaveState state;
+    std::shared_ptr<const QuickSaveState> previous = m_quickSaves.latest();
+    if (!CaptureState(state, previous.get())) {
+        std::cerr << "QuickSave: Could not copy SData/DData" << std::endl;
+        UIManager::getInstance().SetStatusMessage("快速存檔失敗", 4000);
+        return false;
     }
+    m_quickSaves.push(std::move(state));
+    std::cout << "[QuickSave] " << m_quickSaves.size() << "/" << m_quickSaves.capacity() << " in memory" << std::endl;
+    UIManager::getInstance().SetStatusMessage("快速存檔");
+    return true;
+}
 
-    m_inventory.resize(MAX_ITEM_AMOUNT);
-    for(int i=0; i<MAX_ITEM_AMOUNT; ++i) {
-        read16(m_inventory[i].id);
-        read16(m_inventory[i].amount);
+bool GameManager::QuickLoad(size_t age) {
+    std::shared_ptr<const QuickSaveState> state = m_quickSaves.at(age);
+    if (!state) {
+        UIManager::getInstance().SetStatusMessage("沒有快速存檔");
+        return false;
     }
-    
-    std::cout << "[LoadGame] Loading Roles..." << std::endl;
-    grpFile.seekg(RoleOffset, std::ios::beg);
-    int roleSize = (ItemOffset - RoleOffset) / (ROLE_DATA_SIZE * 2);
-    if (roleSize < 0 || roleSize > 10000) {
-        std::cerr << "[LoadGame] ERROR: Invalid roleSize " << roleSize << std::endl;
+    // 场景数据先恢复: 不匹配 (例如 SData 场景数变了) 时游戏状态保持不变
+    SceneManager& sm = SceneManager::getInstance();
+    if (!sm.RestoreSaveData(state->map, state->events)) {
+        UIManager::getInstance().SetStatusMessage("快速讀檔失敗", 4000);
         return false;
     }
-    m_roles.resize(roleSize);
-    for(int i=0; i<roleSize; ++i) {
-        std::vector<int16_t> buffer(ROLE_DATA_SIZE);
-        grpFile.read((char*)buffer.data(), ROLE_DATA_SIZE * 2);
-        m_roles[i].setDataVector(buffer);
+
+    ApplySaveHeader(state->header);
+    m_roles = state->roles;
+    m_items = state->items;
+    m_magics = state->magics;
+    m_shopRaw = state->shopRaw;
+    m_x50 = state->x50;
+    m_savedWorldX = state->savedWorldX;
+    m_savedWorldY = state->savedWorldY;
+    sm.SetScenes(state->scenes);
+
+    sm.SetCurrentScene(m_currentSceneId);
+    if (m_currentSceneId >= 0) {
+        sm.RefreshEventLayer(m_currentSceneId);
     }
+    m_autoSave.reset(SDL_GetTicks());
+    UIManager::getInstance().SetStatusMessage("快速讀檔");
+    return true;
+}
+
+bool GameManager::FlushQuickSave(size_t age, int slot) {
+    std::shared_ptr<const QuickSaveState> state = m_quickSaves.at(age);
+    if (!state) return false;
+    m_saveWorker.wait();
+
+    return SubmitStateWrite(state, slot, [slot](bool ok, const std::string& error, double, uint64_t) {
+        if (ok) {
+            std::cout << "Quicksave written to Slot " << slot << std::endl;
+            UIManager::getInstance().SetStatusMessage("進度已保存");
+        } else {
+            std::cerr << "FlushQuickSave: Slot " << slot << " failed: " << error << std::endl;
+            UIManager::getInstance().SetStatusMessage("保存失敗", 4000);
+        }
+    });
+}
 
-    std::cout << "[LoadGame] Loading Items..." << std::endl;
-    grpFile.seekg(ItemOffset, std::ios::beg);
-    int itemSize = (SceneOffset - ItemOffset) / (ITEM_DATA_SIZE * 2);
-    if (itemSize < 0 || itemSize > 10000) {
-        std::cerr << "[LoadGame] ERROR: Invalid itemSize " << itemSize << std::endl;
+bool GameManager::IsLiveSlot(int slot) const {
+    std::string sFilename = (slot == 0) ? "allsin.grp" : "S" + std::to_string(slot) + ".grp";
+    std::string dFilename = (slot == 0) ? "alldef.grp" : "D" + std::to_string(slot) + ".grp";
+    const SceneManager& sm = SceneManager::getInstance();
+    // 同一个文件可以有不同的写法 (相对/绝对路径、大小写、链接)，按文件本身比较，与 PagedFile::snapshot 相同
+    auto same = [](const std::string& a, const std::string& b) {
+        std::error_code ec;
+        return !b.empty() && std::filesystem::equivalent(a, b, ec);
+    };
+    return same(m_savePath + sFilename, sm.MapSourcePath()) || same(m_savePath + dFilename, sm.EventSourcePath());
+}
+
+bool GameManager::SubmitStateWrite(const std::shared_ptr<const QuickSaveState>& state, int slot, StateWriteDone done) {
+    if (!m_saveLayout.valid() && !SaveLayout::load(m_savePath + "ranger.idx", m_saveLayout)) {
+        std::cerr << "SubmitStateWrite: No valid ranger.idx" << std::endl;
         return false;
     }
-    m_items.resize(itemSize);
-    for(int i=0; i<itemSize; ++i) {
-        std::vector<int16_t> buffer(ITEM_DATA_SIZE);
-        grpFile.read((char*)buffer.data(), ITEM_DATA_SIZE * 2);
-        m_items[i].setDataVector(buffer);
-    }
-
-    std::cout << "[LoadGame] Loading Scenes..." << std::endl;
-    grpFile.seekg(SceneOffset, std::ios::beg);
-    int sceneSize = (MagicOffset - SceneOffset) / (SCENE_DATA_SIZE * 2);
-    if (sceneSize < 0 || sceneSize > 10000) {
-         std::cerr << "[LoadGame] ERROR: Invalid sceneSize " << sceneSize << std::endl;
-         return false;
-    }
-    std::vector<Scene> scenes(sceneSize);
-    for(int i=0; i<sceneSize; ++i) {
-        std::vector<int16_t> buffer(SCENE_DATA_SIZE);
-        grpFile.read((char*)buffer.data(), SCENE_DATA_SIZE * 2);
-        scenes[i].setDataVector(buffer);
-    }
-    SceneManager::getInstance().SetScenes(scenes);
-
-    std::cout << "[LoadGame] Loading Magics..." << std::endl;
-    grpFile.seekg(MagicOffset, std::ios::beg);
-    int magicSize = (WeiShopOffset - MagicOffset) / (MAGIC_DATA_SIZE * 2);
-    if (magicSize < 0 || magicSize > 10000) {
-        std::cerr << "[LoadGame] ERROR: Invalid magicSize " << magicSize << std::endl;
+    // 正在分页读取的文件不能整份换掉 (未驻留的场景会读到快照的内容)，这时请正常存档
+    if (IsLiveSlot(slot)) {
+        std::cerr << "SubmitStateWrite: Slot " << slot << " is the one being played, use SaveGame" << std::endl;
         return false;
     }
-    m_magics.resize(magicSize);
-    for(int i=0; i<magicSize; ++i) {
-        std::vector<int16_t> buffer(MAGIC_DATA_SIZE);
-        grpFile.read((char*)buffer.data(), MAGIC_DATA_SIZE * 2);
-        m_magics[i].setDataVector(buffer);
+    std::string filename = (slot == 0) ? "ranger" : "R" + std::to_string(slot);
+    std::string sFilename = (slot == 0) ? "allsin.grp" : "S" + std::to_string(slot) + ".grp";
+    std::string dFilename = (slot == 0) ? "alldef.grp" : "D" + std::to_string(slot) + ".grp";
+    std::string grpPath = m_savePath + filename + ".grp";
+    std::string sPath = m_savePath + sFilename;
+    std::string dPath = m_savePath + dFilename;
+
+    SaveSlotInfo info = BuildSlotInfo(state->header, state->roles, state->scenes);
+    auto image = std::make_shared<SaveImageWriter>(BuildSaveImage(m_saveLayout, state->header, state->roles,
+                                                                  state->items, state->scenes, state->magics,
+                                                                  state->shopRaw));
+    const bool compressed = m_compressSaves;
+    auto timing = std::make_shared<std::pair<double, uint64_t>>(0.0, 0); // write ms, raw bytes
+    m_saveWorker.submit(
+        [state, image, info, grpPath, sPath, dPath, compressed, timing](std::string& error) {
+            auto start = std::chrono::steady_clock::now();
+            // 场景文件在写盘线程上由共享的记录拼出
+            bool grpWritten = WriteSaveImage(*image, info, grpPath, compressed);
+            bool mapWritten = state->map.records.empty() ||
+                              PagedFile::writeSnapshot(PagedFile::snapshotOf(state->map, sPath, compressed));
+            bool eventsWritten = state->events.records.empty() ||
+                                 PagedFile::writeSnapshot(PagedFile::snapshotOf(state->events, dPath, compressed));
+            if (!grpWritten) error += grpPath + " ";
+            if (!mapWritten) error += sPath + " ";
+            if (!eventsWritten) error += dPath + " ";
+            timing->first = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            timing->second = image->bytes().size() + state->map.records.size() * state->map.recordSize +
+                             state->events.records.size() * state->events.recordSize;
+            return grpWritten && mapWritten && eventsWritten;
+        },
+        [done, timing](bool ok, const std::string& error) { done(ok, error, timing->first, timing->second); });
+    return true;
+}
+
+void GameManager::SetAutoSaveConfig(const AutoSaveConfig& config) {
+    m_autoSave.setConfig(config);
+    m_autoSave.reset(SDL_GetTicks());
+}
+
+int GameManager::LatestAutoSaveSlot() const {
+    const AutoSaveConfig& config = m_autoSave.config();
+    int latest = config.firstSlot;
+    int64_t latestAt = -1;
+    for (int i = 0; i < config.slotCount; ++i) {
+        SaveSlotInfo info;
+        if (ReadSaveSlotInfo(config.firstSlot + i, info) && info.savedAt > latestAt) {
+            latest = config.firstSlot + i;
+            latestAt = info.savedAt;
+        }
     }
+    return latest;
+}
 
-    // Preserve Shops (WeiShop) raw bytes for exact re-write on save
-    {
-        int shopBytesToRead = TotalLen - WeiShopOffset;
-        if (shopBytesToRead > 0) {
-            m_shopRaw.resize(shopBytesToRead);
-            grpFile.seekg(WeiShopOffset, std::ios::beg);
-            grpFile.read(reinterpret_cast<char*>(m_shopRaw.data()), shopBytesToRead);
+void GameManager::UpdateAutoSave() {
+    // 只在行走中存: 战斗、菜单、事件脚本都在各自的循环里，回到这里时已经结束
+    if (m_currentState != GameState::Roaming) return;
+    const uint64_t now = SDL_GetTicks();
+    // 主线程只复制内存中的数据，未驻留的场景由写盘线程读
+    const uint64_t bytes = CaptureBytes(m_lastAutoSave.get(), true);
+    AutoSaveScheduler::Trigger trigger = m_autoSave.poll(now, m_saveWorker.busy(), bytes);
+    if (trigger == AutoSaveScheduler::Trigger::None) return;
+
+    // 跳过正在分页读取的存档位 (例如刚读的就是自动档)
+    int slot = -1;
+    for (int i = 0; i < m_autoSave.config().slotCount && slot < 0; ++i) {
+        if (!IsLiveSlot(m_autoSave.slotAt(i))) slot = m_autoSave.slotAt(i);
+    }
+    if (slot < 0) return;
+
+    auto start = std::chrono::steady_clock::now();
+    QuickSaveState state;
+    if (!CaptureState(state, m_lastAutoSave.get(), true)) {
+        std::cerr << "[AutoSave] Could not copy SData/DData" << std::endl;
+        m_autoSave.reset(now);
+        return;
+    }
+    auto shared = std::make_shared<const QuickSaveState>(std::move(state));
+    const bool submitted = SubmitStateWrite(shared, slot, [this, slot](bool ok, const std::string& error, double ms, uint64_t bytes) {
+        m_autoSave.recordWrite(SDL_GetTicks(), ok, ms, bytes);
+        AutoSaveScheduler::Stats stats = m_autoSave.stats(SDL_GetTicks());
+        if (ok) {
+            std::cout << "[AutoSave] Slot " << slot << ": snapshot " << stats.lastSnapshotMs << " ms ("
+                      << stats.lastSnapshotBytes / 1024 << " KB), write " << ms << " ms, "
+                      << bytes / 1024 << " KB (" << stats.writeMsLastMinute << " ms / " << stats.bytesLastMinute / 1024
+                      << " KB in the last minute)" << std::endl;
         } else {
-            m_shopRaw.clear();
+            std::cerr << "[AutoSave] Slot " << slot << " failed: " << error << std::endl;
         }
+    });
+    double snapshotMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (!submitted) {
+        m_autoSave.reset(now);
+        return;
     }
+    m_lastAutoSave = shared;
+    m_autoSave.recordSnapshot(now, slot, snapshotMs, bytes);
+}
 
-    grpFile.close();
-    std::cout << "[LoadGame] ranger.grp loaded successfully." << std::endl;
+void GameManager::SetSaveCompression(bool compressed) {
+    m_compressSaves = compressed;
+    SceneManager::getInstance().SetSaveCompression(compressed);
+}
 
+bool GameManager::ExportRawSave(int slot, const std::string& dstDir) const {
+    std::string filename = (slot == 0) ? "ranger" : "R" + std::to_string(slot);
     std::string sFilename = (slot == 0) ? "allsin.grp" : "S" + std::to_string(slot) + ".grp";
     std::string dFilename = (slot == 0) ? "alldef.grp" : "D" + std::to_string(slot) + ".grp";
-    
-    std::cout << "[LoadGame] Loading Maps: " << sFilename << " & " << dFilename << std::endl;
+    std::string dir = dstDir;
+    if (!dir.empty() && dir.back() != '/' && dir.back() != '\\') dir += '/';
+    // 命令行导出在 Init() 之前调用，这时还没有找过存档目录
+    const std::string savePath = m_savePath.empty() ? FindSavePath() : m_savePath;
+
+    // 场景图/事件可能还有未合并的日志 (--journal-saves)，经 PagedFile 叠加后写出
+    bool ok = true;
+    auto report = [&](bool written, const std::string& name) {
+        if (written) return;
+        std::cerr << "ExportRawSave: " << savePath + name << " failed" << std::endl;
+        ok = false;
+    };
+    report(SaveContainer::exportRaw(savePath + filename + ".grp", dir + filename + ".grp"), filename + ".grp");
+    report(SceneManager::ExportMapData(savePath + sFilename, dir + sFilename), sFilename);
+    report(SceneManager::ExportEventData(savePath + dFilename, dir + dFilename), dFilename);
+    if (ok) std::cout << "[ExportRawSave] Slot " << slot << " written to " << dir << std::endl;
+    return ok;
+}
+
+bool GameManager::ReadSaveSlotInfo(int slot, SaveSlotInfo& out, bool withThumbnail) const {
+    std::string filename = (slot == 0) ? "ranger" : "R" + std::to_string(slot);
+    return SaveSlotInfo::read(SaveSlotInfo::pathFor(m_savePath + filename + ".grp"), out, withThumbnail);
+}
+
+void GameManager::reSetEntrance() {
+    SceneManager::getInstance().ResetEntrance();
+    std::cout << "[GameManager] Entrance map reset." << std::endl;
+}
+
+bool GameManager::LoadGame(int slot) {
+    // 不能在存档写到一半时读它
+    m_saveWorker.wait();
+
+    std::string filename = (slot == 0) ? "ranger" : "R" + std::to_string(slot);
+    std::string grpPath = m_savePath + filename + ".grp";
 
-    if (!SceneManager::getInstance().LoadMapData(m_savePath + sFilename)) {
-        if (slot == 0) SceneManager::getInstance().LoadMapData(m_savePath + "allsin.grp");
+    SaveLayout layout;
+    if (!SaveLayout::load(m_savePath + "ranger.idx", layout)) {
+        std::cerr << "LoadGame: No valid ranger.idx" << std::endl;
+        return false;
     }
-    if (!SceneManager::getInstance().LoadEventData(m_savePath + dFilename)) {
-        if (slot == 0) SceneManager::getInstance().LoadEventData(m_savePath + "alldef.grp");
+
+    // 整个存档一次读入 (压缩存档同时解压)，之后按偏移整段拷贝
+    std::vector<uint8_t> grpBytes;
+    if (!SaveContainer::readFile(grpPath, grpBytes)) {
+        bool found = false;
+        if (slot == 0) {
+            grpPath = m_savePath + "Ranger.grp";
+            found = SaveContainer::readFile(grpPath, grpBytes);
+        }
+        if (!found) {
+            std::cerr << "LoadGame: Cannot open " << grpPath << std::endl;
+            return false;
+        }
     }
-    
+    if (grpBytes.size() < static_cast<size_t>(layout.totalLength)) {
+        std::cerr << "[LoadGame] Warning: " << grpPath << " is " << grpBytes.size()
+                  << " bytes, ranger.idx expects " << layout.totalLength << std::endl;
+    }
+    // 先打开场景图和事件: 打不开时返回 false，角色/物品等还是原来的进度
+    std::string sFilename = (slot == 0) ? "allsin.grp" : "S" + std::to_string(slot) + ".grp";
+    std::string dFilename = (slot == 0) ? "alldef.grp" : "D" + std::to_string(slot) + ".grp";
+    std::cout << "[LoadGame] Loading Maps: " << sFilename << " & " << dFilename << std::endl;
+
+    if (!SceneManager::getInstance().LoadSaveData(m_savePath + sFilename, m_savePath + dFilename)) {
+        std::cerr << "LoadGame: Cannot open " << m_savePath + sFilename << " / " << dFilename << std::endl;
+        return false;
+    }
+
+    m_saveLayout = layout;
+    SaveImageReader image(layout, std::move(grpBytes));
+
+    ApplySaveHeader(image.header());
+    image.getTable(layout.roleOffset, layout.itemOffset, m_roles);
+    image.getTable(layout.itemOffset, layout.sceneOffset, m_items);
+    SceneTable scenes;
+    size_t sceneCount = image.getTable(layout.sceneOffset, layout.magicOffset, scenes);
+    SceneManager::getInstance().SetScenes(std::move(scenes));
+    image.getTable(layout.magicOffset, layout.shopOffset, m_magics);
+    // Preserve Shops (WeiShop) raw bytes for exact re-write on save
+    m_shopRaw = image.getBytes(layout.shopOffset, layout.totalLength);
+
+    std::cout << "[LoadGame] " << grpPath << ": Scene=" << m_currentSceneId << " Pos=(" << m_mainMapX << ","
+              << m_mainMapY << ") Roles=" << m_roles.size() << " Items=" << m_items.size()
+              << " Scenes=" << sceneCount << " Magics=" << m_magics.size() << std::endl;
+
     SceneManager::getInstance().SetCurrentScene(m_currentSceneId);
 
     // Force Refresh Layer 3 after everything is loaded
@@ -786,6 +899,10 @@ bool GameManager::LoadGame(int slot) {
         SceneManager::getInstance().RefreshEventLayer(m_currentSceneId);
     }
     
+    // 场景数据重新打开了，下一份自动存档不能再和上一份共享
+    m_lastAutoSave.reset();
+    m_autoSave.reset(SDL_GetTicks());
+
     std::cout << "Game Loaded from Slot " << slot << std::endl;
     return true;
 }
@@ -841,6 +958,8 @@ void GameManager::InitNewGame() {
     }
     
     SceneManager::getInstance().SetCurrentScene(m_currentSceneId);
+    m_lastAutoSave.reset();
+    m_autoSave.reset(SDL_GetTicks());
     
     // Sync Camera to Player
     setMainMapPosition(m_mainMapX, m_mainMapY);
@@ -908,6 +1027,11 @@ void GameManager::Run() {
         }
         
         // Present is called in Update functions
+        UIManager::getInstance().TrimSystemGraphics();
+        if (m_devMode) PollHotReload();
+        m_saveWorker.poll();
+        UpdateAutoSave();
+        if (SDL_GetTicks() - m_lastMemorySampleMs >= 1000) CollectMemoryStats();
         SDL_Delay(10);
     }
     std::cout << "Exiting Game Loop..." << std::endl;
@@ -915,6 +1039,16 @@ void GameManager::Run() {
 
 void GameManager::Quit() {
     m_isRunning = false;
+
+    // 退出前写完后台存档，并把存档日志合并回原版可读的文件
+    m_saveWorker.wait();
+    SceneManager::getInstance().CompactSaveData();
+
+    // 释放资源前采样最后一次，峰值一并写出
+    CollectMemoryStats();
+    if (m_memoryStats.writeCsv("memory_stats.csv")) {
+        std::cout << "[GameManager] Memory stats written to memory_stats.csv" << std::endl;
+    }
     
     // Cleanup Subsystems
     // SceneManager::getInstance().Cleanup(); // SceneManager does not have Cleanup
@@ -1094,6 +1228,7 @@ void GameManager::UpdateRoaming() {
                         m_currentSceneId = -1;
                         SceneManager::getInstance().SetCurrentScene(-1);
                         SceneManager::getInstance().ResetEntrance();
+                        m_autoSave.onSceneChange(SDL_GetTicks());
                         
                         m_mainMapX = m_savedWorldX;
                         m_mainMapY = m_savedWorldY;
@@ -1152,6 +1287,18 @@ void GameManager::UpdateRoaming() {
                     }
                     break;
 
+                case SDLK_F5:
+                    QuickSave();
+                    break;
+
+                case SDLK_F8:
+                    QuickLoad();
+                    break;
+
+                case SDLK_F9:
+                    PrintMemoryReport();
+                    break;
+
                 case SDLK_ESCAPE:
                     m_currentState = GameState::SystemMenu;
                     break;
@@ -1209,41 +1356,21 @@ void GameManager::UpdateRoaming() {
         SceneManager::getInstance().DrawScene(m_renderer, m_cameraX, m_cameraY);
         RenderScreenTo(m_renderer);
     }
+    UIManager::getInstance().DrawStatusMessage();
     SDL_RenderPresent(m_renderer);
 }
 
 bool GameManager::CanWalkWorld(int x, int y) {
     if (x < 0 || x >= 480 || y < 0 || y >= 480) return false;
 
-    SceneManager& sm = SceneManager::getInstance();
-    int16_t buildx = sm.GetWorldBuildX(x, y);
-    int16_t surface = sm.GetWorldSurface(x, y);
-    int16_t earth = sm.GetWorldEarth(x, y);
-
-    bool canwalk = (buildx == 0);
-
-    if (x <= 0 || x >= 479 || y <= 0 || y >= 479 ||
-        (surface >= 1692 && surface <= 1700)) {
-        canwalk = false;
-    }
-
-    if (earth == 838 || (earth >= 612 && earth <= 670)) {
-        canwalk = false;
-    }
+    // 可走/水面在载入大地图时已按 Pascal CanWalk 的规则算好
+    const WorldTile* tile = SceneManager::getInstance().GetWorldMap().tile(x, y);
+    if (!tile) return false;
 
-    if ((earth >= 358 && earth <= 362) ||
-        (earth >= 506 && earth <= 670) ||
-        (earth >= 1016 && earth <= 1022)) {
+    if (tile->flags & WorldMap::WATER) {
         if (m_inShip != 1) {
             m_inShip = 1;
         }
-        if (earth == 838 || (earth >= 612 && earth <= 670)) {
-            canwalk = false;
-        } else if (surface >= 1746 && surface <= 1788) {
-            canwalk = false;
-        } else {
-            canwalk = true;
-        }
     } else {
         if (m_inShip == 1) {
             m_shipY = static_cast<int16_t>(m_mainMapX);
@@ -1253,14 +1380,7 @@ bool GameManager::CanWalkWorld(int x, int y) {
         m_inShip = 0;
     }
 
-    int surfaceHalf = surface / 2;
-    if ((surfaceHalf >= 863 && surfaceHalf <= 872) ||
-        (surfaceHalf >= 852 && surfaceHalf <= 854) ||
-        (surfaceHalf >= 858 && surfaceHalf <= 860)) {
-        canwalk = true;
-    }
-
-    return canwalk;
+    return (tile->flags & WorldMap::WALKABLE) != 0;
 }
 
 bool GameManager::CheckWorldEntrance() {
@@ -1381,9 +1501,116 @@ Magic& GameManager::getMagic(int index) {
     return m_magics[index];
 }
 
+void GameManager::FreeHeads() {
+    for (auto& head : m_heads) {
+        PicLoader::freePic(head);
+    }
+    m_heads.clear();
+    m_headCache.close();
+}
+
+void GameManager::EnableDevMode() {
+    // 只监视目录层 (资源包无法原地修改)
+    const VirtualFS& vfs = FileLoader::virtualFS();
+    std::vector<std::string> roots;
+    for (size_t i = 0; i < vfs.layerCount(); ++i) {
+        if (!vfs.layerIsPack(static_cast<int>(i))) roots.push_back(vfs.layerRoot(static_cast<int>(i)));
+    }
+    m_devMode = m_resourceWatcher.start(roots);
+    std::cout << "[GameManager] Dev mode " << (m_devMode ? "enabled, hot reload is on" : "unavailable (no resource dir to watch)") << std::endl;
+
+    // kys.pak 在 resource 目录之上: 包里有的文件改了散文件也不会生效
+    for (size_t i = 0; i < vfs.layerCount(); ++i) {
+        size_t hidden = vfs.layerShadowedFiles(static_cast<int>(i));
+        if (m_devMode && vfs.layerIsPack(static_cast<int>(i)) && hidden > 0) {
+            std::cerr << "[GameManager] Warning: " << vfs.layerRoot(static_cast<int>(i)) << " hides " << hidden
+                      << " loose files below it; edits to those are not used. Rebuild or remove the pack while editing."
+                      << std::endl;
+        }
+    }
+}
+
+void GameManager::PollHotReload() {
+    std::vector<std::string> changed;
+    m_resourceWatcher.poll(changed);
+    if (changed.empty()) return;
+
+    // grp 句柄和 .pic 缓存先失效，各管理器重新打开时才能读到新内容 (贴图缓存按 大小/修改时间 自动重建)
+    GroupFile::clearCache();
+    PicLoader::clearCache();
+
+    for (const auto& name : changed) {
+        const VirtualFS::Entry* top = FileLoader::virtualFS().find(name);
+        if (top && top->path.empty()) {
+            std::cout << "[HotReload] " << name << " changed, but " << FileLoader::virtualFS().layerRoot(top->layer)
+                      << " provides it; not reloaded" << std::endl;
+            continue;
+        }
+        bool handled = false;
+        handled |= SceneManager::getInstance().ReloadResource(name);
+        handled |= EventManager::getInstance().ReloadResource(name);
+        handled |= BattleManager::getInstance().ReloadResource(name);
+        handled |= UIManager::getInstance().ReloadResource(name);
+        if (name == "heads.pic") {
+            FreeHeads();
+            handled = true;
+        }
+        std::cout << "[HotReload] " << name << (handled ? " reloaded" : " changed, no live reload for it") << std::endl;
+    }
+}
+
+void GameManager::CollectMemoryStats() {
+    m_lastMemorySampleMs = SDL_GetTicks();
+    m_memoryStats.begin();
+
+    const char* owner = "GameManager";
+    m_memoryStats.add(owner, "roles", m_roles.memoryBytes(), m_roles.size());
+    m_memoryStats.add(owner, "items", m_items.memoryBytes(), m_items.size());
+    m_memoryStats.add(owner, "magics", m_magics.memoryBytes(), m_magics.size());
+
+    uint64_t headBytes = m_heads.capacity() * sizeof(PicImage), headCount = 0;
+    for (const auto& head : m_heads) {
+        if (!head.surface) continue;
+        headBytes += static_cast<uint64_t>(head.surface->h) * head.surface->pitch;
+        ++headCount;
+    }
+    m_memoryStats.add(owner, "heads", headBytes, headCount);
+    m_memoryStats.add(owner, "heads.kcc", m_headCache.sizeBytes(), m_headCache.count(), m_headCache.isMapped());
+
+    m_memoryStats.add(owner, "x50", m_x50.capacity() * sizeof(int16_t));
+    m_memoryStats.add(owner, "inventory", m_inventory.capacity() * sizeof(InventoryItem), m_inventory.size());
+    m_memoryStats.add(owner, "shop", m_shopRaw.capacity() + m_setNum.capacity() * sizeof(m_setNum[0]) +
+                      m_levelUpList.capacity() * sizeof(int16_t));
+
+    uint64_t screenBytes = m_screenSurface ? static_cast<uint64_t>(m_screenSurface->h) * m_screenSurface->pitch : 0;
+    m_memoryStats.add(owner, "screen_surface", screenBytes, m_screenSurface ? 1 : 0);
+    float w = 0, h = 0;
+    uint64_t screenTexBytes = 0;
+    if (m_screenTexture && SDL_GetTextureSize(m_screenTexture, &w, &h)) {
+        screenTexBytes = static_cast<uint64_t>(w) * static_cast<uint64_t>(h) * 4;
+    }
+    m_memoryStats.add(owner, "screen_texture", screenTexBytes, m_screenTexture ? 1 : 0, false, true);
+
+    SceneManager::getInstance().ReportMemory(m_memoryStats);
+    EventManager::getInstance().ReportMemory(m_memoryStats);
+    BattleManager::getInstance().ReportMemory(m_memoryStats);
+    UIManager::getInstance().ReportMemory(m_memoryStats);
+}
+
+void GameManager::PrintMemoryReport() {
+    CollectMemoryStats();
+    m_memoryStats.print(std::cout);
+}
+
 PicImage* GameManager::getHead(int index) {
     if (m_heads.empty()) {
-        int count = PicLoader::getPicCount("resource/Heads.Pic");
+        // 首次调用时打开 (或生成) 预解码缓存，之后不再逐张解 PNG
+        int count = 0;
+        if (m_headCache.openPic("resource/Heads.Pic", "heads.kcc")) {
+            count = static_cast<int>(m_headCache.count());
+        } else {
+            count = PicLoader::getPicCount("resource/Heads.Pic");
+        }
         if (count > 0) {
             m_heads.resize(count);
         }
@@ -1391,7 +1618,15 @@ PicImage* GameManager::getHead(int index) {
 
     if (index >= 0 && index < m_heads.size()) {
         if (m_heads[index].surface == nullptr) {
-            m_heads[index] = PicLoader::loadPic("resource/Heads.Pic", index);
+            SpriteCache::Sprite sp;
+            if (m_headCache.get(index, sp)) {
+                m_heads[index].x = sp.x;
+                m_heads[index].y = sp.y;
+                m_heads[index].black = sp.black;
+                m_heads[index].surface = m_headCache.createSurface(index);
+            } else {
+                m_heads[index] = PicLoader::loadPic("resource/Heads.Pic", index);
+            }
         }
         return &m_heads[index];
     }
@@ -1413,6 +1648,7 @@ void GameManager::setMainMapPosition(int x, int y) {
 void GameManager::enterScene(int sceneId) {
     m_currentSceneId = sceneId;
     SceneManager::getInstance().SetCurrentScene(sceneId);
+    m_autoSave.onSceneChange(SDL_GetTicks());
 }
 
 void GameManager::AddItem(int itemId, int amount) {
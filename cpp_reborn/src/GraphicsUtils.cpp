@@ -1,21 +1,24 @@
 #include "GraphicsUtils.h"
+#include "FileLoader.h"
 #include <fstream>
 #include <iostream>
 #include <cstring>
+#include <algorithm>
 
 std::vector<uint8_t> GraphicsUtils::m_fullPaletteData;
 std::vector<uint32_t> GraphicsUtils::m_currentPaletteRGBA;
 
 void GraphicsUtils::loadPalette(const std::string& filename) {
-    std::ifstream file(filename, std::ios::binary);
-    if (!file) {
+    // 经由 FileLoader 读取，资源包 (kys.pak) 存在时优先从包内取
+    MappedFile file = FileLoader::mapFile(filename);
+    if (file.empty()) {
         std::cerr << "Failed to load palette: " << filename << std::endl;
         return;
     }
     
     // Palette file is expected to be 4 * 768 bytes (4 sets of 256 colors * 3 channels)
-    m_fullPaletteData.resize(4 * 768);
-    file.read(reinterpret_cast<char*>(m_fullPaletteData.data()), m_fullPaletteData.size());
+    m_fullPaletteData.assign(4 * 768, 0);
+    std::memcpy(m_fullPaletteData.data(), file.data(), std::min(file.size(), m_fullPaletteData.size()));
     
     // Initialize current palette with the first set
     resetPalette(0);
@@ -228,3 +231,65 @@ void GraphicsUtils::DrawRLE8(SDL_Surface* dest, int x, int y, const uint8_t* raw
         }
     }
 }
+
+void GraphicsUtils::DrawIndexed8(SDL_Surface* dest, int x, int y, int w, int h, int xs, int ys, int stride,
+                                 const uint8_t* pixels, const uint8_t* mask, int shadow, float scale) {
+    if (!dest || !pixels || !mask || w <= 0 || h <= 0) return;
+    if (m_currentPaletteRGBA.empty()) return;
+
+    int startX = x - (int)(xs * scale);
+    int startY = y - (int)(ys * scale);
+
+    // 阴影色每次调用只算一遍，而不是逐像素计算
+    const uint32_t* palette = m_currentPaletteRGBA.data();
+    uint32_t shadowPalette[256];
+    if (shadow != 0 && !m_fullPaletteData.empty()) {
+        int mul = 4 + shadow;
+        if (mul < 0) mul = 0;
+        for (int i = 0; i < 256; ++i) {
+            shadowPalette[i] = mapRGB(m_fullPaletteData[i * 3 + 0] * mul,
+                                      m_fullPaletteData[i * 3 + 1] * mul,
+                                      m_fullPaletteData[i * 3 + 2] * mul);
+        }
+        palette = shadowPalette;
+    }
+
+    uint32_t* destPixels = (uint32_t*)dest->pixels;
+    int destPitch = dest->pitch / 4;
+
+    if (scale == 1.0f) {
+        // 常见路径：逐行裁剪后直接写
+        int x0 = std::max(0, -startX);
+        int x1 = std::min(w, dest->w - startX);
+        int y0 = std::max(0, -startY);
+        int y1 = std::min(h, dest->h - startY);
+        for (int iy = y0; iy < y1; ++iy) {
+            const uint8_t* src = pixels + (size_t)iy * stride;
+            const uint8_t* m = mask + (size_t)iy * stride;
+            uint32_t* row = destPixels + (size_t)(startY + iy) * destPitch + startX;
+            for (int ix = x0; ix < x1; ++ix) {
+                if (m[ix]) row[ix] = palette[src[ix]];
+            }
+        }
+        return;
+    }
+
+    // 缩放路径：与 DrawRLE8 相同的最近邻块划分
+    for (int iy = 0; iy < h; ++iy) {
+        int py = startY + (int)(iy * scale);
+        int blockH = std::max(1, (int)((iy + 1) * scale) - (int)(iy * scale));
+        const uint8_t* src = pixels + (size_t)iy * stride;
+        const uint8_t* m = mask + (size_t)iy * stride;
+        for (int ix = 0; ix < w; ++ix) {
+            if (!m[ix]) continue;
+            int px = startX + (int)(ix * scale);
+            int blockW = std::max(1, (int)((ix + 1) * scale) - (int)(ix * scale));
+            uint32_t color = palette[src[ix]];
+            for (int by = 0; by < blockH; ++by) {
+                for (int bx = 0; bx < blockW; ++bx) {
+                    DrawPixel(dest, px + bx, py + by, color);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,116 @@
+#include "GroupFile.h"
+#include "FileLoader.h"
+#include <map>
+#include <mutex>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace {
+    std::mutex g_cacheMutex;
+    std::map<std::pair<std::string, std::string>, std::shared_ptr<const GroupFile>> g_cache;
+}
+
+GroupFile::GroupFile(MappedFile grp, std::vector<int32_t> offsets, std::map<int, MappedFile> overrides)
+    : m_grp(std::move(grp)), m_offsets(std::move(offsets)), m_overrides(std::move(overrides)) {
+    // 防御损坏的索引：偏移不得超过 grp 大小，也不得倒退
+    int32_t limit = static_cast<int32_t>(m_grp.size());
+    int32_t prev = 0;
+    for (auto& off : m_offsets) {
+        if (off > limit) off = limit;
+        if (off < prev) off = prev;
+        prev = off;
+    }
+
+    m_count = m_offsets.size();
+    if (!m_overrides.empty()) {
+        m_count = std::max(m_count, static_cast<size_t>(m_overrides.rbegin()->first) + 1);
+    }
+}
+
+std::shared_ptr<const GroupFile> GroupFile::open(const std::string& grpName, const std::string& idxName) {
+    std::string grpPath = FileLoader::getResourcePath(grpName);
+    std::string idxPath = FileLoader::getResourcePath(idxName);
+    auto key = std::make_pair(grpPath, idxPath);
+
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    auto it = g_cache.find(key);
+    if (it != g_cache.end()) return it->second;
+
+    // mapFile 优先取资源包中的条目
+    MappedFile idx = FileLoader::mapFile(idxName);
+    if (idx.empty()) {
+        std::cerr << "[GroupFile] Failed to open index file: " << idxPath << std::endl;
+        return nullptr;
+    }
+    MappedFile grp = FileLoader::mapFile(grpName);
+    if (grp.empty()) {
+        std::cerr << "[GroupFile] Failed to open group file: " << grpPath << std::endl;
+        return nullptr;
+    }
+
+    auto view = idx.as<int32_t>();
+    auto overrides = FileLoader::findRecordOverrides(grpName);
+    if (!overrides.empty()) {
+        std::cout << "[GroupFile] " << grpName << ": " << overrides.size() << " record override(s)" << std::endl;
+    }
+    auto file = std::make_shared<const GroupFile>(std::move(grp), std::vector<int32_t>(view.begin(), view.end()),
+                                                  std::move(overrides));
+    g_cache[key] = file;
+    return file;
+}
+
+void GroupFile::clearCache() {
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    g_cache.clear();
+}
+
+size_t GroupFile::recordSize(int index) const {
+    auto ov = m_overrides.find(index);
+    if (ov != m_overrides.end()) return ov->second.size();
+    if (index < 0 || index >= static_cast<int>(m_offsets.size())) return 0;
+    int32_t start = (index == 0) ? 0 : m_offsets[index - 1];
+    return static_cast<size_t>(m_offsets[index] - start);
+}
+
+size_t GroupFile::recordOffset(int index) const {
+    if (index <= 0 || m_offsets.empty()) return 0;
+    if (index > static_cast<int>(m_offsets.size())) index = static_cast<int>(m_offsets.size());
+    return static_cast<size_t>(m_offsets[index - 1]);
+}
+
+MappedFile GroupFile::record(int index) const {
+    auto ov = m_overrides.find(index);
+    if (ov != m_overrides.end()) return ov->second;
+    size_t size = recordSize(index);
+    if (size == 0) return {};
+    return m_grp.slice(recordOffset(index), size);
+}
+
+MappedFile GroupFile::recordFrom(int index, size_t length) const {
+    auto ov = m_overrides.find(index);
+    if (ov != m_overrides.end()) return ov->second.slice(0, length);
+    if (index < 0 || index >= static_cast<int>(m_offsets.size())) return {};
+    return m_grp.slice(recordOffset(index), length);
+}
+
+void GroupFile::flatten(MappedFile& grp, MappedFile& idx) const {
+    std::vector<int32_t> ends;
+    if (m_overrides.empty()) {
+        grp = m_grp;
+        ends = m_offsets;
+    } else {
+        std::vector<uint8_t> merged;
+        ends.reserve(m_count);
+        for (size_t i = 0; i < m_count; ++i) {
+            MappedFile rec = record(static_cast<int>(i));
+            merged.insert(merged.end(), rec.begin(), rec.end());
+            ends.push_back(static_cast<int32_t>(merged.size()));
+        }
+        grp = MappedFile::fromBuffer(std::move(merged));
+    }
+
+    std::vector<uint8_t> idxBytes(ends.size() * sizeof(int32_t));
+    if (!ends.empty()) std::memcpy(idxBytes.data(), ends.data(), idxBytes.size());
+    idx = MappedFile::fromBuffer(std::move(idxBytes));
+}
@@ -0,0 +1,117 @@
+#include "LzCodec.h"
+#include <cstring>
+
+namespace {
+    const int HASH_BITS = 16;
+    const size_t MIN_MATCH = 4;
+    const size_t MAX_OFFSET = 65535;
+
+    inline uint32_t Read32(const uint8_t* p) {
+        uint32_t v;
+        std::memcpy(&v, p, 4);
+        return v;
+    }
+
+    inline uint32_t Hash(uint32_t v) {
+        return (v * 2654435761u) >> (32 - HASH_BITS);
+    }
+
+    void WriteLength(std::vector<uint8_t>& out, size_t len) {
+        while (len >= 255) {
+            out.push_back(255);
+            len -= 255;
+        }
+        out.push_back(static_cast<uint8_t>(len));
+    }
+
+    void EmitSequence(std::vector<uint8_t>& out, const uint8_t* lit, size_t litLen, size_t offset, size_t matchLen) {
+        size_t mlCode = matchLen ? matchLen - MIN_MATCH : 0;
+        uint8_t token = static_cast<uint8_t>(((litLen < 15 ? litLen : 15) << 4) | (mlCode < 15 ? mlCode : 15));
+        out.push_back(token);
+        if (litLen >= 15) WriteLength(out, litLen - 15);
+        out.insert(out.end(), lit, lit + litLen);
+        if (!matchLen) return;
+        out.push_back(static_cast<uint8_t>(offset & 0xFF));
+        out.push_back(static_cast<uint8_t>(offset >> 8));
+        if (mlCode >= 15) WriteLength(out, mlCode - 15);
+    }
+
+    bool ReadLength(const uint8_t*& ip, const uint8_t* end, size_t& len) {
+        uint8_t b;
+        do {
+            if (ip >= end) return false;
+            b = *ip++;
+            len += b;
+        } while (b == 255);
+        return true;
+    }
+}
+
+std::vector<uint8_t> LzCodec::compress(const uint8_t* src, size_t size) {
+    std::vector<uint8_t> out;
+    out.reserve(size / 2 + 16);
+
+    std::vector<int64_t> table(size_t(1) << HASH_BITS, -1);
+    size_t ip = 0;
+    size_t anchor = 0;
+
+    while (ip + MIN_MATCH <= size) {
+        uint32_t seq = Read32(src + ip);
+        uint32_t h = Hash(seq);
+        int64_t cand = table[h];
+        table[h] = static_cast<int64_t>(ip);
+
+        if (cand >= 0 && ip - static_cast<size_t>(cand) <= MAX_OFFSET && Read32(src + cand) == seq) {
+            size_t ref = static_cast<size_t>(cand);
+            size_t len = MIN_MATCH;
+            while (ip + len < size && src[ref + len] == src[ip + len]) ++len;
+
+            EmitSequence(out, src + anchor, ip - anchor, ip - ref, len);
+            ip += len;
+            anchor = ip;
+        } else {
+            ++ip;
+        }
+    }
+
+    // 结尾的字面量序列 (总是存在，哪怕长度为 0，作为结束标记)
+    EmitSequence(out, src + anchor, size - anchor, 0, 0);
+    return out;
+}
+
+bool LzCodec::decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t rawSize) {
+    const uint8_t* ip = src;
+    const uint8_t* end = src + srcSize;
+    uint8_t* op = dst;
+    uint8_t* opEnd = dst + rawSize;
+
+    while (ip < end) {
+        uint8_t token = *ip++;
+
+        size_t litLen = token >> 4;
+        if (litLen == 15 && !ReadLength(ip, end, litLen)) return false;
+        if (litLen > static_cast<size_t>(end - ip) || litLen > static_cast<size_t>(opEnd - op)) return false;
+        std::memcpy(op, ip, litLen);
+        ip += litLen;
+        op += litLen;
+
+        if (ip >= end) break; // 最后一个序列
+
+        if (end - ip < 2) return false;
+        size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > static_cast<size_t>(op - dst)) return false;
+
+        size_t matchLen = token & 0x0F;
+        if (matchLen == 15 && !ReadLength(ip, end, matchLen)) return false;
+        matchLen += MIN_MATCH;
+        if (matchLen > static_cast<size_t>(opEnd - op)) return false;
+
+        // 重叠拷贝需要逐字节
+        const uint8_t* ref = op - offset;
+        for (size_t i = 0; i < matchLen; ++i) op[i] = ref[i];
+        op += matchLen;
+    }
+
+    return op == opEnd;
+}
@@ -0,0 +1,136 @@
+#include "MappedFile.h"
+#include <fstream>
+#include <iostream>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define KYS_HAS_MMAP 1
+#endif
+
+struct MappedFile::Region {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    bool mapped = false;
+    std::vector<uint8_t> heap;
+#if defined(_WIN32)
+    HANDLE mapping = nullptr;
+#endif
+
+    ~Region() {
+        if (!mapped || !data) return;
+#if defined(_WIN32)
+        UnmapViewOfFile(data);
+        if (mapping) CloseHandle(mapping);
+#elif defined(KYS_HAS_MMAP)
+        munmap(const_cast<uint8_t*>(data), size);
+#endif
+    }
+};
+
+namespace {
+    // 退路：整体读入堆内存
+    bool ReadWhole(const std::string& path, std::vector<uint8_t>& out) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) return false;
+        std::streamsize size = file.tellg();
+        if (size <= 0) return false;
+        file.seekg(0, std::ios::beg);
+        out.resize(static_cast<size_t>(size));
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(out.data()), size));
+    }
+}
+
+MappedFile MappedFile::open(const std::string& path) {
+    auto region = std::make_shared<Region>();
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file != INVALID_HANDLE_VALUE) {
+        LARGE_INTEGER size;
+        if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping) {
+                void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                if (view) {
+                    region->data = static_cast<const uint8_t*>(view);
+                    region->size = static_cast<size_t>(size.QuadPart);
+                    region->mapped = true;
+                    region->mapping = mapping;
+                } else {
+                    CloseHandle(mapping);
+                }
+            }
+        }
+        CloseHandle(file);
+    }
+#elif defined(KYS_HAS_MMAP)
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED) {
+                region->data = static_cast<const uint8_t*>(addr);
+                region->size = static_cast<size_t>(st.st_size);
+                region->mapped = true;
+            }
+        }
+        ::close(fd);
+    }
+#endif
+
+    if (!region->mapped) {
+        if (!ReadWhole(path, region->heap)) return {};
+        region->data = region->heap.data();
+        region->size = region->heap.size();
+    }
+
+    MappedFile result;
+    result.m_data = region->data;
+    result.m_size = region->size;
+    result.m_region = std::move(region);
+    return result;
+}
+
+MappedFile MappedFile::read(const std::string& path) {
+    std::vector<uint8_t> bytes;
+    if (!ReadWhole(path, bytes)) return {};
+    return fromBuffer(std::move(bytes));
+}
+
+MappedFile MappedFile::fromBuffer(std::vector<uint8_t>&& buffer) {
+    if (buffer.empty()) return {};
+    auto region = std::make_shared<Region>();
+    region->heap = std::move(buffer);
+    region->data = region->heap.data();
+    region->size = region->heap.size();
+
+    MappedFile result;
+    result.m_data = region->data;
+    result.m_size = region->size;
+    result.m_region = std::move(region);
+    return result;
+}
+
+bool MappedFile::isMapped() const {
+    return m_region && m_region->mapped;
+}
+
+MappedFile MappedFile::slice(size_t offset, size_t length) const {
+    if (offset >= m_size) return {};
+    if (length > m_size - offset) length = m_size - offset;
+
+    MappedFile result;
+    result.m_region = m_region;
+    result.m_data = m_data + offset;
+    result.m_size = length;
+    return result;
+}
@@ -0,0 +1,79 @@
+#include "MemoryStats.h"
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+    const char* KindName(const MemoryStats::Entry& e) {
+        if (e.gpu) return "texture";
+        if (e.mapped) return "mapped";
+        return "heap";
+    }
+}
+
+void MemoryStats::begin() {
+    for (auto& e : m_entries) {
+        e.bytes = 0;
+        e.count = 0;
+    }
+}
+
+void MemoryStats::add(const std::string& owner, const std::string& asset, uint64_t bytes, uint64_t count,
+                      bool mapped, bool gpu) {
+    auto key = std::make_pair(owner, asset);
+    auto it = m_index.find(key);
+    if (it == m_index.end()) {
+        it = m_index.emplace(key, m_entries.size()).first;
+        Entry e;
+        e.owner = owner;
+        e.asset = asset;
+        m_entries.push_back(e);
+    }
+
+    Entry& e = m_entries[it->second];
+    e.bytes += bytes;
+    e.count += count;
+    e.mapped = mapped;
+    e.gpu = gpu;
+    if (e.bytes > e.peakBytes) e.peakBytes = e.bytes;
+
+    uint64_t total = totalBytes();
+    if (total > m_peakTotal) m_peakTotal = total;
+}
+
+uint64_t MemoryStats::totalBytes() const {
+    uint64_t total = 0;
+    for (const auto& e : m_entries) total += e.bytes;
+    return total;
+}
+
+void MemoryStats::print(std::ostream& os) const {
+    uint64_t heap = 0, mapped = 0, gpu = 0;
+    os << "[MemoryStats] " << std::left << std::setw(16) << "owner" << std::setw(20) << "asset"
+       << std::setw(8) << "kind" << std::right << std::setw(12) << "KB" << std::setw(10) << "count"
+       << std::setw(12) << "peak KB" << std::endl;
+    for (const auto& e : m_entries) {
+        os << "[MemoryStats] " << std::left << std::setw(16) << e.owner << std::setw(20) << e.asset
+           << std::setw(8) << KindName(e) << std::right << std::setw(12) << (e.bytes + 1023) / 1024
+           << std::setw(10) << e.count << std::setw(12) << (e.peakBytes + 1023) / 1024 << std::endl;
+        if (e.gpu) gpu += e.bytes;
+        else if (e.mapped) mapped += e.bytes;
+        else heap += e.bytes;
+    }
+    os << "[MemoryStats] total heap " << heap / 1024 << " KB, mapped " << mapped / 1024
+       << " KB, textures " << gpu / 1024 << " KB, peak " << m_peakTotal / 1024 << " KB" << std::endl;
+}
+
+bool MemoryStats::writeCsv(const std::string& path) const {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        std::cerr << "[MemoryStats] Failed to write " << path << std::endl;
+        return false;
+    }
+    file << "owner,asset,kind,bytes,count,peak_bytes\n";
+    for (const auto& e : m_entries) {
+        file << e.owner << ',' << e.asset << ',' << KindName(e) << ',' << e.bytes << ','
+             << e.count << ',' << e.peakBytes << '\n';
+    }
+    return file.good();
+}
@@ -0,0 +1,671 @@
+#include "PagedFile.h"
+#include "FileLoader.h"
+#include "SaveContainer.h"
+#include "Crc32c.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+
+namespace fs = std::filesystem;
+
+namespace {
+    // <file>.jnl: 头部 + 若干补丁块，每块是一条完整记录
+    //   头部 24 字节: "KJNL", recordSize, count, 源文件 CRC-32C, 源文件大小 (uint64)
+    //   块: "KPCH", 记录编号, 校验和 (FNV-1a), 记录内容
+    // 源文件大小或 CRC 不符 (例如合并后崩溃、文件被替换) 的日志整份忽略。
+    // 不用修改时间: 复制/同步存档目录会改变它，但内容不变，日志仍然有效。
+    constexpr char JOURNAL_MAGIC[4] = { 'K', 'J', 'N', 'L' };
+    constexpr char BLOCK_MAGIC[4] = { 'K', 'P', 'C', 'H' };
+    constexpr uint64_t JOURNAL_HEADER_SIZE = 24;
+    constexpr uint64_t BLOCK_HEADER_SIZE = 12;
+
+    struct JournalHeader {
+        char magic[4];
+        uint32_t recordSize;
+        uint32_t count;
+        uint32_t baseCrc;
+        uint64_t baseSize;
+    };
+    static_assert(sizeof(JournalHeader) == JOURNAL_HEADER_SIZE, "journal header layout");
+
+    std::string JournalPath(const std::string& path) { return path + ".jnl"; }
+
+    // Size and CRC-32C of the file the journal patches; false if it cannot be read
+    bool BaseSignature(const std::string& path, uint64_t& size, uint32_t& crc) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) return false;
+        std::vector<char> buffer(1 << 16);
+        size = 0;
+        crc = 0;
+        while (file) {
+            file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            std::streamsize got = file.gcount();
+            if (got <= 0) break;
+            crc = Crc32c::compute(buffer.data(), static_cast<size_t>(got), crc);
+            size += static_cast<uint64_t>(got);
+        }
+        return file.eof();
+    }
+
+    uint32_t Checksum(const uint8_t* data, size_t size) {
+        uint32_t h = 2166136261u;
+        for (size_t i = 0; i < size; ++i) {
+            h ^= data[i];
+            h *= 16777619u;
+        }
+        return h;
+    }
+}
+
+bool PagedFile::open(const std::string& filename, size_t recordSize, size_t maxResident) {
+    // 先在临时变量里打开并检查新文件，成功后才替换; 失败时当前的文件和日志保持不变
+    Source source;
+    if (!locate(filename, recordSize, source)) return false;
+    open(std::move(source), maxResident);
+    return true;
+}
+
+bool PagedFile::locate(const std::string& filename, size_t recordSize, Source& out) {
+    if (recordSize == 0) return false;
+
+    std::string path;
+    uint64_t fileSize = 0;
+    MappedFile packed = FileLoader::findPacked(filename);
+    if (!packed.empty()) {
+        fileSize = packed.size();
+    } else {
+        path = FileLoader::getResourcePath(filename);
+        std::error_code ec;
+        fileSize = fs::file_size(path, ec);
+        if (ec) {
+            std::cerr << "[PagedFile] Failed to open file: " << path << std::endl;
+            return false;
+        }
+        // 压缩存档: 整份解压到内存后从内存分页
+        if (SaveContainer::isContainerFile(path)) {
+            std::vector<uint8_t> raw;
+            if (!SaveContainer::readFile(path, raw)) return false;
+            path.clear();
+            packed = MappedFile::fromBuffer(std::move(raw));
+            fileSize = packed.size();
+        }
+    }
+
+    if (fileSize % recordSize != 0) {
+        std::cerr << "[PagedFile] Warning: " << filename << " size " << fileSize
+                  << " is not a multiple of " << recordSize << std::endl;
+    }
+    size_t records = static_cast<size_t>(fileSize / recordSize);
+    if (records == 0) {
+        std::cerr << "[PagedFile] No records in " << filename << std::endl;
+        return false;
+    }
+    out.path = std::move(path);
+    out.packed = std::move(packed);
+    out.recordSize = recordSize;
+    out.records = records;
+    return true;
+}
+
+void PagedFile::open(Source&& source, size_t maxResident) {
+    // 换到别的文件之前把旧源文件的日志合并掉，否则它对原版一直是旧内容
+    if (!m_path.empty() && m_journalEnd != 0) {
+        std::error_code ec;
+        if (!fs::equivalent(source.path, m_path, ec) && !compactJournal(m_path, m_recordSize)) {
+            std::cerr << "[PagedFile] Failed to merge the journal of " << m_path << std::endl;
+        }
+    }
+    close();
+    m_path = std::move(source.path);
+    m_packed = std::move(source.packed);
+    m_recordSize = source.recordSize;
+    m_maxResident = maxResident > 0 ? maxResident : 1;
+    ++m_openSerial;
+    m_pages.resize(source.records);
+    m_journalOffsets.assign(source.records, 0);
+    resize(source.records);
+    if (!m_path.empty()) loadJournal();
+}
+
+namespace {
+    // Validates <basePath>.jnl and collects the payload offset of the latest block per record.
+    // Returns the end of the last whole block (0: no usable journal); a torn tail is cut off.
+    uint64_t ReadJournal(const std::string& basePath, size_t recordSize, size_t count, std::vector<uint64_t>& offsets,
+                         size_t* blockCount) {
+        const std::string path = JournalPath(basePath);
+        std::ifstream file(path, std::ios::binary);
+        if (!file) return 0;
+
+        JournalHeader header{};
+        uint64_t baseSize = 0;
+        uint32_t baseCrc = 0;
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+            std::memcmp(header.magic, JOURNAL_MAGIC, 4) != 0 ||
+            header.recordSize != recordSize || header.count != count ||
+            !BaseSignature(basePath, baseSize, baseCrc) || header.baseSize != baseSize || header.baseCrc != baseCrc) {
+            // 不属于当前源文件的日志: 不使用，下次存档时重写
+            std::cerr << "[PagedFile] Ignoring stale journal " << path << std::endl;
+            return 0;
+        }
+
+        offsets.assign(count, 0);
+        std::vector<uint8_t> payload(recordSize);
+        uint64_t offset = JOURNAL_HEADER_SIZE;
+        size_t blocks = 0;
+        for (;;) {
+            char magic[4];
+            uint32_t index = 0, checksum = 0;
+            if (!file.read(magic, 4) || !file.read(reinterpret_cast<char*>(&index), 4) ||
+                !file.read(reinterpret_cast<char*>(&checksum), 4) ||
+                !file.read(reinterpret_cast<char*>(payload.data()), recordSize)) {
+                break;
+            }
+            if (std::memcmp(magic, BLOCK_MAGIC, 4) != 0 || index >= count ||
+                Checksum(payload.data(), recordSize) != checksum) {
+                break;
+            }
+            offsets[index] = offset + BLOCK_HEADER_SIZE;
+            offset += BLOCK_HEADER_SIZE + recordSize;
+            ++blocks;
+        }
+        file.close();
+
+        // 写到一半的尾块截掉，之后从这里继续追加
+        std::error_code ec;
+        if (fs::file_size(path, ec) > offset) {
+            std::cerr << "[PagedFile] Dropping torn tail of " << path << std::endl;
+            fs::resize_file(path, offset, ec);
+        }
+        if (blockCount) *blockCount = blocks;
+        return offset;
+    }
+}
+
+void PagedFile::loadJournal() {
+    size_t blocks = 0;
+    m_journalEnd = ReadJournal(m_path, m_recordSize, m_pages.size(), m_journalOffsets, &blocks);
+    if (m_journalEnd == 0) {
+        m_journalOffsets.assign(m_pages.size(), 0);
+        return;
+    }
+    std::cout << "[PagedFile] Applied " << blocks << " journal blocks from " << JournalPath(m_path) << std::endl;
+}
+
+bool PagedFile::compactJournal(const std::string& path, size_t recordSize) {
+    std::error_code ec;
+    if (recordSize == 0 || !fs::exists(JournalPath(path), ec)) return true;
+    uint64_t fileSize = fs::file_size(path, ec);
+    if (ec) return false;
+    const size_t count = static_cast<size_t>(fileSize / recordSize);
+
+    std::vector<uint64_t> offsets;
+    if (count == 0 || ReadJournal(path, recordSize, count, offsets, nullptr) == 0) {
+        // 无效的日志不会再被使用
+        fs::remove(JournalPath(path), ec);
+        return true;
+    }
+    std::vector<uint8_t> image(static_cast<size_t>(fileSize)); // trailing bytes kept as they are
+    std::ifstream source(path, std::ios::binary);
+    if (!source || !source.read(reinterpret_cast<char*>(image.data()), image.size())) return false;
+    source.close();
+    std::ifstream journal(JournalPath(path), std::ios::binary);
+    for (size_t i = 0; i < count; ++i) {
+        if (offsets[i] == 0) continue;
+        journal.seekg(static_cast<std::streamoff>(offsets[i]), std::ios::beg);
+        if (!journal.read(reinterpret_cast<char*>(image.data() + i * recordSize), recordSize)) return false;
+    }
+    journal.close();
+    if (!FileLoader::saveFileAtomic(path, image.data(), image.size())) return false;
+    fs::remove(JournalPath(path), ec);
+    std::cout << "[PagedFile] Merged journal into " << path << std::endl;
+    return true;
+}
+
+size_t PagedFile::journalRecords() const {
+    size_t n = 0;
+    for (uint64_t offset : m_journalOffsets) {
+        if (offset != 0) ++n;
+    }
+    return n;
+}
+
+void PagedFile::close() {
+    m_path.clear();
+    m_packed = MappedFile();
+    m_pages.clear();
+    resize(0);
+    m_recordSize = 0;
+    m_tick = 0;
+    m_journalOffsets.clear();
+    m_journalEnd = 0;
+}
+
+size_t PagedFile::residentCount() const {
+    size_t n = 0;
+    for (const auto& p : m_pages) {
+        if (p.resident) ++n;
+    }
+    return n;
+}
+
+uint64_t PagedFile::residentBytes() const {
+    uint64_t total = 0;
+    for (size_t i = 0; i < m_pages.size(); ++i) {
+        if (m_pages[i].resident) total += payloadBytes(i);
+    }
+    return total;
+}
+
+bool PagedFile::readRecord(size_t index, uint8_t* out) const {
+    uint64_t offset = static_cast<uint64_t>(index) * m_recordSize;
+    if (m_journalOffsets[index] != 0) {
+        std::ifstream journal(JournalPath(m_path), std::ios::binary);
+        // 没有日志: 写盘线程已把它合并进源文件 (见 Snapshot::compactSource)
+        if (journal) {
+            journal.seekg(static_cast<std::streamoff>(m_journalOffsets[index]), std::ios::beg);
+            return static_cast<bool>(journal.read(reinterpret_cast<char*>(out), m_recordSize));
+        }
+    }
+    if (!m_packed.empty()) {
+        std::memcpy(out, m_packed.data() + offset, m_recordSize);
+        return true;
+    }
+    std::ifstream file(m_path, std::ios::binary);
+    if (!file) return false;
+    file.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(out), m_recordSize));
+}
+
+bool PagedFile::pageIn(size_t index) {
+    if (index >= m_pages.size()) return false;
+    evictIfNeeded();
+
+    std::vector<uint8_t> raw(m_recordSize);
+    if (!readRecord(index, raw.data())) {
+        std::cerr << "[PagedFile] Failed to read record " << index << " from " << m_path << std::endl;
+        return false;
+    }
+    decode(index, raw.data());
+    ++m_stats.pageIns;
+
+    Page& page = m_pages[index];
+    page.resident = true;
+    page.lastUse = ++m_tick;
+    return true;
+}
+
+void PagedFile::evictIfNeeded() {
+    size_t resident = residentCount();
+    while (resident >= m_maxResident) {
+        // 只淘汰干净的记录；全部是 dirty 时允许暂时超出上限
+        size_t oldest = m_pages.size();
+        for (size_t i = 0; i < m_pages.size(); ++i) {
+            const Page& p = m_pages[i];
+            if (p.resident && !p.dirty && (oldest == m_pages.size() || p.lastUse < m_pages[oldest].lastUse)) oldest = i;
+        }
+        if (oldest == m_pages.size()) return;
+        release(oldest);
+        m_pages[oldest].resident = false;
+        ++m_stats.evictions;
+        --resident;
+    }
+}
+
+bool PagedFile::save(const std::string& path) {
+    if (m_pages.empty()) return false;
+    Snapshot snap = snapshot(path);
+    bool ok = writeSnapshot(snap);
+    commit(snap, ok);
+    return ok;
+}
+
+bool PagedFile::compact() {
+    if (m_pages.empty() || m_path.empty() || m_journalEnd == 0) return true;
+    Snapshot snap = snapshotAs(m_path, Snapshot::Kind::FullImage);
+    bool ok = writeSnapshot(snap);
+    commit(snap, ok);
+    return ok;
+}
+
+PagedFile::Snapshot PagedFile::snapshot(const std::string& path) const {
+    std::error_code ec;
+    bool sameFile = !m_path.empty() && fs::exists(path, ec) && fs::equivalent(path, m_path, ec);
+    if (!sameFile || m_compressed) return snapshotAs(path, Snapshot::Kind::FullImage);
+
+    size_t dirty = 0;
+    for (const auto& p : m_pages) {
+        if (p.dirty) ++dirty;
+    }
+    if (m_writeMode == WriteMode::InPlace) {
+        // 有日志时先合并，原地写会让日志失效
+        return snapshotAs(path, m_journalEnd == 0 ? Snapshot::Kind::InPlace : Snapshot::Kind::FullImage);
+    }
+
+    uint64_t journalSize = std::max(m_journalEnd, JOURNAL_HEADER_SIZE) + dirty * (BLOCK_HEADER_SIZE + m_recordSize);
+    uint64_t fileSize = static_cast<uint64_t>(m_pages.size()) * m_recordSize;
+    bool tooLarge = static_cast<double>(journalSize) > m_compactRatio * static_cast<double>(fileSize);
+    return snapshotAs(path, tooLarge ? Snapshot::Kind::FullImage : Snapshot::Kind::Journal);
+}
+
+PagedFile::Snapshot PagedFile::snapshotAs(const std::string& path, Snapshot::Kind kind) const {
+    Snapshot snap;
+    snap.path = path;
+    snap.kind = kind;
+    snap.recordSize = m_recordSize;
+    snap.count = m_pages.size();
+    snap.openSerial = m_openSerial;
+    snap.journalEnd = m_journalEnd;
+    if (kind == Snapshot::Kind::FullImage && m_compressed) {
+        snap.compressed = true;
+        snap.unpacked = std::make_shared<std::vector<uint8_t>>();
+    }
+    if (m_pages.empty()) return snap;
+
+    if (kind == Snapshot::Kind::FullImage) {
+        // 未驻留 / 干净的记录与源文件 (加日志) 相同，由写盘线程复制
+        if (!m_packed.empty()) {
+            snap.base.assign(m_packed.data(), m_packed.data() + std::min<size_t>(m_packed.size(), snap.count * m_recordSize));
+        } else {
+            snap.sourcePath = m_path;
+        }
+        if (m_journalEnd != 0) {
+            std::error_code ec;
+            snap.compactSource = !fs::equivalent(path, m_path, ec);
+            snap.journalPath = JournalPath(m_path);
+            for (size_t i = 0; i < m_journalOffsets.size(); ++i) {
+                if (m_journalOffsets[i] != 0) snap.journalBlocks.emplace_back(i, m_journalOffsets[i]);
+            }
+        }
+    }
+
+    // 只需带上 dirty 记录
+    for (size_t i = 0; i < m_pages.size(); ++i) {
+        if (!m_pages[i].dirty) continue;
+        snap.indices.push_back(i);
+        snap.versions.push_back(m_pages[i].version);
+    }
+    snap.records.resize(snap.indices.size() * m_recordSize);
+    for (size_t k = 0; k < snap.indices.size(); ++k) {
+        encode(snap.indices[k], snap.records.data() + k * m_recordSize);
+    }
+    return snap;
+}
+
+bool PagedFile::writeSnapshot(const Snapshot& snap) {
+    if (snap.count == 0 || snap.recordSize == 0) return false;
+
+    if (snap.kind == Snapshot::Kind::InPlace) {
+        // 写回: 改动过的记录覆盖进整份文件，再原子替换 (与 R*.grp 相同)。
+        // 直接在原文件上覆盖的话，写到一半崩溃会留下半条场景/事件记录。
+        if (snap.indices.empty()) return true;
+        std::error_code ec;
+        uint64_t fileSize = fs::file_size(snap.path, ec);
+        std::vector<uint8_t> image(ec ? 0 : static_cast<size_t>(fileSize)); // trailing bytes kept as they are
+        std::ifstream source(snap.path, std::ios::binary);
+        if (ec || image.size() < snap.count * snap.recordSize || !source ||
+            !source.read(reinterpret_cast<char*>(image.data()), image.size())) {
+            std::cerr << "[PagedFile] Failed to read " << snap.path << " for an in-place save" << std::endl;
+            return false;
+        }
+        source.close();
+        for (size_t k = 0; k < snap.indices.size(); ++k) {
+            std::memcpy(image.data() + snap.indices[k] * snap.recordSize, snap.records.data() + k * snap.recordSize, snap.recordSize);
+        }
+        return FileLoader::saveFileAtomic(snap.path, image.data(), image.size());
+    }
+
+    if (snap.kind == Snapshot::Kind::Journal) {
+        // 追加补丁块: 顺序写，最后 fsync
+        if (snap.indices.empty()) return true;
+        std::vector<uint8_t> blocks;
+        if (snap.journalEnd == 0) {
+            JournalHeader header{};
+            std::memcpy(header.magic, JOURNAL_MAGIC, 4);
+            header.recordSize = static_cast<uint32_t>(snap.recordSize);
+            header.count = static_cast<uint32_t>(snap.count);
+            if (!BaseSignature(snap.path, header.baseSize, header.baseCrc)) {
+                std::cerr << "[PagedFile] Failed to read " << snap.path << " for its journal" << std::endl;
+                return false;
+            }
+            const uint8_t* h = reinterpret_cast<const uint8_t*>(&header);
+            blocks.insert(blocks.end(), h, h + sizeof(header));
+        }
+        for (size_t k = 0; k < snap.indices.size(); ++k) {
+            const uint8_t* payload = snap.records.data() + k * snap.recordSize;
+            uint32_t index = static_cast<uint32_t>(snap.indices[k]);
+            uint32_t checksum = Checksum(payload, snap.recordSize);
+            blocks.insert(blocks.end(), BLOCK_MAGIC, BLOCK_MAGIC + 4);
+            blocks.insert(blocks.end(), reinterpret_cast<const uint8_t*>(&index), reinterpret_cast<const uint8_t*>(&index) + 4);
+            blocks.insert(blocks.end(), reinterpret_cast<const uint8_t*>(&checksum), reinterpret_cast<const uint8_t*>(&checksum) + 4);
+            blocks.insert(blocks.end(), payload, payload + snap.recordSize);
+        }
+        if (!FileLoader::appendFileSynced(JournalPath(snap.path), snap.journalEnd, blocks.data(), blocks.size())) {
+            std::cerr << "[PagedFile] Failed to append to " << JournalPath(snap.path) << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // 完整文件: 源文件打底，叠加日志，再覆盖 dirty 记录；整份拼好后原子写出
+    std::vector<uint8_t> image(snap.count * snap.recordSize);
+    if (!snap.base.empty()) {
+        std::memcpy(image.data(), snap.base.data(), std::min(snap.base.size(), image.size()));
+    } else {
+        std::ifstream source(snap.sourcePath, std::ios::binary);
+        if (!source || !source.read(reinterpret_cast<char*>(image.data()), image.size())) {
+            std::cerr << "[PagedFile] Failed to read " << snap.sourcePath << " while saving " << snap.path << std::endl;
+            return false;
+        }
+    }
+    if (!snap.journalBlocks.empty()) {
+        std::ifstream journal(snap.journalPath, std::ios::binary);
+        for (const auto& block : snap.journalBlocks) {
+            journal.seekg(static_cast<std::streamoff>(block.second), std::ios::beg);
+            if (!journal.read(reinterpret_cast<char*>(image.data() + block.first * snap.recordSize), snap.recordSize)) {
+                std::cerr << "[PagedFile] Failed to read " << snap.journalPath << " while saving " << snap.path << std::endl;
+                return false;
+            }
+        }
+    }
+    for (size_t k = 0; k < snap.indices.size(); ++k) {
+        std::memcpy(image.data() + snap.indices[k] * snap.recordSize, snap.records.data() + k * snap.recordSize, snap.recordSize);
+    }
+    if (!SaveContainer::writeFile(snap.path, image.data(), image.size(), snap.compressed)) return false;
+    if (snap.compressed && snap.unpacked) *snap.unpacked = std::move(image);
+
+    // 目标的旧日志已并入 (或不属于新文件)；即使删除前崩溃，源文件 CRC 不符也会被忽略
+    std::error_code ec;
+    fs::remove(JournalPath(snap.path), ec);
+
+    // commit() 之后改从新文件分页，旧源文件的日志不会再有人合并
+    if (snap.compactSource && !compactJournal(snap.sourcePath, snap.recordSize)) {
+        std::cerr << "[PagedFile] Failed to merge the journal of " << snap.sourcePath << std::endl;
+    }
+    return true;
+}
+
+void PagedFile::commit(const Snapshot& snap, bool written) {
+    if (!written || snap.openSerial != m_openSerial || snap.count != m_pages.size()) return;
+
+    if (snap.kind == Snapshot::Kind::FullImage) {
+        // 新文件已是最新内容，之后从它分页
+        if (m_journalEnd != 0) ++m_stats.compactions;
+        if (snap.compressed && snap.unpacked && !snap.unpacked->empty()) {
+            // 容器不能按偏移读，改从写出的内存映像分页
+            m_path.clear();
+            m_packed = MappedFile::fromBuffer(std::move(*snap.unpacked));
+        } else {
+            m_path = snap.path;
+            m_packed = MappedFile();
+        }
+        m_journalOffsets.assign(m_pages.size(), 0);
+        m_journalEnd = 0;
+    } else if (snap.kind == Snapshot::Kind::Journal && !snap.indices.empty()) {
+        uint64_t offset = snap.journalEnd == 0 ? JOURNAL_HEADER_SIZE : snap.journalEnd;
+        for (size_t index : snap.indices) {
+            m_journalOffsets[index] = offset + BLOCK_HEADER_SIZE;
+            offset += BLOCK_HEADER_SIZE + m_recordSize;
+        }
+        m_journalEnd = offset;
+    }
+
+    for (size_t k = 0; k < snap.indices.size(); ++k) {
+        Page& page = m_pages[snap.indices[k]];
+        // 写盘期间又改过的记录保持 dirty
+        if (!page.dirty || page.version != snap.versions[k]) continue;
+        page.dirty = false;
+        onWritten(snap.indices[k]);
+        if (snap.kind != Snapshot::Kind::FullImage) ++m_stats.writeBacks;
+    }
+}
+
+bool PagedFile::capture(Image& out, const Image* previous, bool deferReads) const {
+    const bool share = previous && previous->openSerial == m_openSerial && previous->recordSize == m_recordSize &&
+                       previous->records.size() == m_pages.size();
+    Image image;
+    image.openSerial = m_openSerial;
+    image.recordSize = m_recordSize;
+    image.records.resize(m_pages.size());
+    image.versions.resize(m_pages.size());
+    if (deferReads) {
+        image.sourcePath = m_path;
+        image.packed = m_packed;
+        if (m_journalEnd != 0) {
+            image.journalPath = JournalPath(m_path);
+            image.journalOffsets = m_journalOffsets;
+        }
+    }
+    for (size_t i = 0; i < m_pages.size(); ++i) {
+        const Page& page = m_pages[i];
+        image.versions[i] = page.version;
+        if (share && previous->versions[i] == page.version && previous->records[i]) {
+            image.records[i] = previous->records[i];
+            continue;
+        }
+        if (deferReads && !page.resident) continue; // 干净，写盘线程从源文件读
+        auto record = std::make_shared<std::vector<uint8_t>>(m_recordSize);
+        if (page.resident) {
+            encode(i, record->data());
+        } else if (!readRecord(i, record->data())) {
+            std::cerr << "[PagedFile] Failed to read record " << i << " from " << m_path << std::endl;
+            return false;
+        }
+        image.records[i] = std::move(record);
+    }
+    out = std::move(image);
+    return true;
+}
+
+uint64_t PagedFile::captureBytes(const Image* previous, bool deferReads) const {
+    const bool share = previous && previous->openSerial == m_openSerial && previous->recordSize == m_recordSize &&
+                       previous->records.size() == m_pages.size();
+    uint64_t bytes = 0;
+    for (size_t i = 0; i < m_pages.size(); ++i) {
+        if (share && previous->versions[i] == m_pages[i].version && previous->records[i]) continue;
+        if (deferReads && !m_pages[i].resident) continue;
+        bytes += m_recordSize;
+    }
+    return bytes;
+}
+
+int PagedFile::restore(const Image& image) {
+    if (image.recordSize != m_recordSize || image.records.size() != m_pages.size()) return -1;
+
+    const bool sameOpen = image.openSerial == m_openSerial;
+    std::vector<uint8_t> current(m_recordSize);
+    int replaced = 0;
+    for (size_t i = 0; i < m_pages.size(); ++i) {
+        if (!image.records[i]) continue;
+        if (sameOpen && image.versions[i] == m_pages[i].version) continue;
+        const uint8_t* raw = image.records[i]->data();
+        if (m_pages[i].resident) {
+            // 驻留记录比较一下内容 (不读盘)；未驻留的直接替换
+            encode(i, current.data());
+            if (std::memcmp(current.data(), raw, m_recordSize) == 0) continue;
+        } else {
+            evictIfNeeded();
+            m_pages[i].resident = true;
+        }
+        decode(i, raw);
+        m_pages[i].lastUse = ++m_tick;
+        markDirty(i);
+        ++replaced;
+    }
+    return replaced;
+}
+
+bool PagedFile::exportRaw(const std::string& src, const std::string& dst, size_t recordSize) {
+    // 只打开不读入: 延后读取的快照在写出时按 源文件 + 日志 拼好
+    RawPagedFile pages;
+    if (!pages.open(src, recordSize, 1)) return false;
+    Image image;
+    if (!pages.capture(image, nullptr, true)) return false;
+    return writeSnapshot(snapshotOf(image, dst));
+}
+
+PagedFile::Snapshot PagedFile::snapshotOf(const Image& image, const std::string& path, bool compressed) {
+    Snapshot snap;
+    snap.path = path;
+    snap.kind = Snapshot::Kind::FullImage;
+    snap.compressed = compressed;
+    snap.recordSize = image.recordSize;
+    snap.count = image.records.size();
+    snap.base.resize(snap.count * snap.recordSize);
+
+    std::ifstream source, journal;
+    for (size_t i = 0; i < snap.count; ++i) {
+        uint8_t* out = snap.base.data() + i * snap.recordSize;
+        if (image.records[i]) {
+            std::memcpy(out, image.records[i]->data(), snap.recordSize);
+            continue;
+        }
+        // 延后读取的干净记录: 与拍快照时的源文件 (加日志) 相同
+        const uint64_t offset = static_cast<uint64_t>(i) * snap.recordSize;
+        bool read = false;
+        if (i < image.journalOffsets.size() && image.journalOffsets[i] != 0) {
+            if (!journal.is_open()) journal.open(image.journalPath, std::ios::binary);
+            // 日志已被合并进源文件时改从源文件读 (见 compactJournal)
+            if (journal.is_open()) {
+                journal.seekg(static_cast<std::streamoff>(image.journalOffsets[i]), std::ios::beg);
+                read = static_cast<bool>(journal.read(reinterpret_cast<char*>(out), snap.recordSize));
+                if (!read) journal.clear();
+            }
+        }
+        if (!read && !image.packed.empty()) {
+            if (offset + snap.recordSize <= image.packed.size()) {
+                std::memcpy(out, image.packed.data() + offset, snap.recordSize);
+                read = true;
+            }
+        } else if (!read && !image.sourcePath.empty()) {
+            if (!source.is_open()) source.open(image.sourcePath, std::ios::binary);
+            source.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+            read = static_cast<bool>(source.read(reinterpret_cast<char*>(out), snap.recordSize));
+            if (!read) source.clear();
+        }
+        if (!read && (!image.sourcePath.empty() || !image.packed.empty())) {
+            std::cerr << "[PagedFile] Failed to read record " << i << " for " << path << std::endl;
+            snap.count = 0;
+            return snap;
+        }
+    }
+    return snap;
+}
+
+void RawPagedFile::resize(size_t count) {
+    m_data.clear();
+    m_data.resize(count);
+}
+
+void RawPagedFile::decode(size_t index, const uint8_t* raw) {
+    m_data[index].assign(raw, raw + recordSize());
+}
+
+void RawPagedFile::encode(size_t index, uint8_t* out) const {
+    std::memcpy(out, m_data[index].data(), recordSize());
+}
+
+void RawPagedFile::release(size_t index) {
+    std::vector<uint8_t>().swap(m_data[index]);
+}
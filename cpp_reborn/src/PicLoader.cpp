@@ -1,76 +1,79 @@
 #include "PicLoader.h"
 #include <SDL3_image/SDL_image.h>
-#include <fstream>
+#include <cstring>
 #include <iostream>
+#include <map>
+#include <mutex>
 #include "FileLoader.h"
 
+namespace {
+    std::mutex g_cacheMutex;
+    std::map<std::string, MappedFile> g_cache;
+
+    // 资源包里压缩的条目每次 mapFile 都要整条解压，按资源路径缓存一次
+    MappedFile MapPic(const std::string& filename) {
+        std::string key = FileLoader::getResourcePath(filename);
+        std::lock_guard<std::mutex> lock(g_cacheMutex);
+        auto it = g_cache.find(key);
+        if (it != g_cache.end()) return it->second;
+        MappedFile file = FileLoader::mapFile(filename);
+        if (!file.empty()) g_cache[key] = file;
+        return file;
+    }
+}
+
+void PicLoader::clearCache() {
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    g_cache.clear();
+}
+
 int PicLoader::getPicCount(const std::string& filename) {
-    std::string path = FileLoader::getResourcePath(filename);
-    std::ifstream file(path, std::ios::binary);
-    
-    if (!file.is_open()) {
+    MappedFile file = MapPic(filename);
+    if (file.size() < 4) {
         return 0;
     }
 
     int32_t count = 0;
-    file.read(reinterpret_cast<char*>(&count), 4);
+    std::memcpy(&count, file.data(), 4);
     return count;
 }
 
 PicImage PicLoader::loadPic(const std::string& filename, int num) {
     PicImage result;
     
-    // Ensure filename has resource path if needed
-    // Assuming FileLoader::getResourcePath handles prefixing if not present
-    // But usually we pass "resource/heads.pic" directly or "heads.pic"
-    // Let's assume the caller passes the correct relative path, and getResourcePath ensures it's found relative to executable or root.
-    std::string path = FileLoader::getResourcePath(filename);
-    std::ifstream file(path, std::ios::binary);
-    
-    if (!file.is_open()) {
-        std::cerr << "PicLoader: Failed to open file: " << path << std::endl;
+    // mapFile resolves the resource path (and prefers kys.pak), the file is used in place
+    MappedFile file = MapPic(filename);
+    if (file.size() < 4) {
+        std::cerr << "PicLoader: Failed to open file: " << filename << std::endl;
         return result;
     }
 
+    auto readInt = [&](size_t pos, int32_t& value) -> bool {
+        if (pos + 4 > file.size()) return false;
+        std::memcpy(&value, file.data() + pos, 4);
+        return true;
+    };
+
     // Read Count (Number of images)
-    int32_t count = 0;
-    file.read(reinterpret_cast<char*>(&count), 4);
-    
-    // Check if num is within valid range (assuming 0-indexed)
-    // Note: In Pascal, sometimes indices are 1-based, but here the logic implies:
-    // offsets table size is (Count+1)*4.
-    // offsets[0] is Count.
-    // offsets[1] is end of image 0.
-    // offsets[num+1] is end of image num.
-    // So if num = count, we read offset[count+1] which is out of bounds if table is size (Count+1).
-    // So valid num is 0 to Count - 1.
-    
-    // However, if count is just a header value and the table follows...
-    // Let's assume num is 0-indexed and must be < count?
     // Pascal: fileread(f, Count, 4); ... fileseek(f, (num + 1) * 4, 0);
-    // If num >= Count, we might be reading past the index table.
-    // But typically Count is the number of images.
-    
-    // Safety check?
-    // If num is very large, seeking might fail.
+    // offsets[num+1] is end of image num, valid num is 0 to Count - 1.
+    int32_t count = 0;
+    readInt(0, count);
     
     int32_t endOffset = 0;
     int32_t startOffset = 0;
 
     // Read End Offset (at (num + 1) * 4)
-    file.seekg((num + 1) * 4, std::ios::beg);
-    if (file.fail()) {
-        std::cerr << "PicLoader: Invalid index " << num << " for file " << path << std::endl;
+    if (num < 0 || !readInt(static_cast<size_t>(num + 1) * 4, endOffset)) {
+        std::cerr << "PicLoader: Invalid index " << num << " for file " << filename << std::endl;
         return result;
     }
-    file.read(reinterpret_cast<char*>(&endOffset), 4);
 
     if (num == 0) {
         startOffset = (count + 1) * 4;
     } else {
         // Read Start Offset (at num * 4)
-        file.seekg(num * 4, std::ios::beg);
-        file.read(reinterpret_cast<char*>(&startOffset), 4);
+        readInt(static_cast<size_t>(num) * 4, startOffset);
     }
 
     // Calculate Data Length (minus 12 byte header)
@@ -80,40 +83,30 @@ PicImage PicLoader::loadPic(const std::string& filename, int num) {
         return result;
     }
 
-    // Seek to Start Offset
-    file.seekg(startOffset, std::ios::beg);
-    if (file.fail()) {
+    if (startOffset < 0 || static_cast<size_t>(startOffset) + 12 + dataLen > file.size()) {
          std::cerr << "PicLoader: Invalid data offset for index " << num << std::endl;
          return result;
     }
 
     // Read Header (x, y, black)
     int32_t x = 0, y = 0, black = 0;
-    file.read(reinterpret_cast<char*>(&x), 4);
-    file.read(reinterpret_cast<char*>(&y), 4);
-    file.read(reinterpret_cast<char*>(&black), 4);
+    readInt(startOffset, x);
+    readInt(startOffset + 4, y);
+    readInt(startOffset + 8, black);
     
     result.x = x;
     result.y = y;
     result.black = black;
 
-    // Read Image Data
-    std::vector<uint8_t> buffer(dataLen);
-    file.read(reinterpret_cast<char*>(buffer.data()), dataLen);
-    if (file.gcount() != dataLen) {
-        std::cerr << "PicLoader: Failed to read full image data" << std::endl;
-        return result;
-    }
-
-    // Load Image from Memory
-    SDL_IOStream* io = SDL_IOFromMem(buffer.data(), dataLen);
+    // Load Image directly from the mapped bytes
+    SDL_IOStream* io = SDL_IOFromConstMem(file.data() + startOffset + 12, dataLen);
     if (io) {
         result.surface = IMG_Load_IO(io, true); // true = closes IO automatically
         if (!result.surface) {
              std::cerr << "PicLoader: IMG_Load_IO failed: " << SDL_GetError() << std::endl;
         }
     } else {
-        std::cerr << "PicLoader: SDL_IOFromMem failed" << std::endl;
+        std::cerr << "PicLoader: SDL_IOFromConstMem failed" << std::endl;
     }
 
     return result;
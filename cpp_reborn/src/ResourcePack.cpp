@@ -0,0 +1,239 @@
+#include "ResourcePack.h"
+#include "LzCodec.h"
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+#include <set>
+#include <filesystem>
+
+const char ResourcePack::MAGIC[8] = { 'K', 'Y', 'S', 'P', 'A', 'C', 'K', '\0' };
+
+namespace {
+    uint32_t NextPow2(uint32_t v) {
+        uint32_t p = 1;
+        while (p < v) p <<= 1;
+        return p;
+    }
+
+    void PadTo(std::ofstream& out, uint64_t& pos, uint32_t alignment) {
+        static const char zeros[16] = {0};
+        uint64_t pad = (alignment - (pos % alignment)) % alignment;
+        out.write(zeros, static_cast<std::streamsize>(pad));
+        pos += pad;
+    }
+}
+
+std::string ResourcePack::normalizeName(const std::string& name) {
+    std::string out;
+    out.reserve(name.size());
+    for (char c : name) {
+        if (c == '\\') c = '/';
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+        out += c;
+    }
+    while (out.compare(0, 2, "./") == 0) out.erase(0, 2);
+    return out;
+}
+
+uint64_t ResourcePack::hashName(const std::string& normalizedName) {
+    uint64_t h = 14695981039346656037ull;
+    for (unsigned char c : normalizedName) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+bool ResourcePack::open(const std::string& path) {
+    close();
+
+    MappedFile file = MappedFile::open(path);
+    if (file.size() < sizeof(PackHeader)) return false;
+
+    PackHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) {
+        std::cerr << "[ResourcePack] Not a valid pack: " << path << std::endl;
+        return false;
+    }
+
+    uint64_t entriesSize = uint64_t(header.entryCount) * sizeof(PackEntry);
+    uint64_t slotsSize = uint64_t(header.slotCount) * sizeof(uint32_t);
+    if (header.dirOffset > file.size() || header.dirSize > file.size() - header.dirOffset ||
+        entriesSize + slotsSize > header.dirSize ||
+        header.slotCount == 0 || (header.slotCount & (header.slotCount - 1)) != 0) {
+        std::cerr << "[ResourcePack] Corrupt directory: " << path << std::endl;
+        return false;
+    }
+
+    const uint8_t* dir = file.data() + header.dirOffset;
+    m_entries = reinterpret_cast<const PackEntry*>(dir);
+    m_slots = reinterpret_cast<const uint32_t*>(dir + entriesSize);
+    m_names = reinterpret_cast<const char*>(dir + entriesSize + slotsSize);
+    m_namesSize = static_cast<size_t>(header.dirSize - entriesSize - slotsSize);
+    m_entryCount = header.entryCount;
+    m_slotCount = header.slotCount;
+    m_file = std::move(file);
+
+    std::cout << "[ResourcePack] Opened " << path << " (" << m_entryCount << " entries"
+              << (m_file.isMapped() ? ", mapped" : "") << ")" << std::endl;
+    return true;
+}
+
+void ResourcePack::close() {
+    m_file = MappedFile();
+    m_entries = nullptr;
+    m_slots = nullptr;
+    m_names = nullptr;
+    m_namesSize = 0;
+    m_entryCount = 0;
+    m_slotCount = 0;
+}
+
+const ResourcePack::PackEntry* ResourcePack::findEntry(const std::string& name) const {
+    if (!isOpen()) return nullptr;
+
+    std::string key = normalizeName(name);
+    uint64_t h = hashName(key);
+    uint32_t mask = m_slotCount - 1;
+    for (uint32_t probe = 0; probe < m_slotCount; ++probe) {
+        uint32_t slot = m_slots[(static_cast<uint32_t>(h) + probe) & mask];
+        if (slot == 0) return nullptr;
+        if (slot > m_entryCount) return nullptr;
+
+        const PackEntry* e = &m_entries[slot - 1];
+        if (e->hash == h && e->nameLength == key.size() &&
+            uint64_t(e->nameOffset) + e->nameLength <= m_namesSize &&
+            std::memcmp(m_names + e->nameOffset, key.data(), key.size()) == 0) {
+            return e;
+        }
+    }
+    return nullptr;
+}
+
+uint64_t ResourcePack::entrySize(const std::string& name) const {
+    const PackEntry* e = findEntry(name);
+    return e ? e->size : 0;
+}
+
+std::string ResourcePack::entryName(size_t index) const {
+    if (index >= m_entryCount) return "";
+    const PackEntry& e = m_entries[index];
+    if (uint64_t(e.nameOffset) + e.nameLength > m_namesSize) return "";
+    return std::string(m_names + e.nameOffset, e.nameLength);
+}
+
+MappedFile ResourcePack::find(const std::string& name) const {
+    const PackEntry* e = findEntry(name);
+    if (!e) return {};
+    if (e->offset > m_file.size() || e->storedSize > m_file.size() - e->offset) {
+        std::cerr << "[ResourcePack] Entry out of range: " << name << std::endl;
+        return {};
+    }
+
+    MappedFile stored = m_file.slice(static_cast<size_t>(e->offset), static_cast<size_t>(e->storedSize));
+    if (!(e->flags & FLAG_LZ)) return stored;
+
+    std::vector<uint8_t> raw(static_cast<size_t>(e->size));
+    if (!LzCodec::decompress(stored.data(), stored.size(), raw.data(), raw.size())) {
+        std::cerr << "[ResourcePack] Failed to decompress: " << name << std::endl;
+        return {};
+    }
+    return MappedFile::fromBuffer(std::move(raw));
+}
+
+bool ResourcePack::write(const std::string& outPath, const std::vector<BuildInput>& inputs, bool compress) {
+    std::ofstream out(outPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "[ResourcePack] Failed to open for writing: " << outPath << std::endl;
+        return false;
+    }
+
+    PackHeader header;
+    std::memset(&header, 0, sizeof(header));
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    uint64_t pos = sizeof(header);
+
+    std::vector<PackEntry> entries;
+    std::string names;
+    std::set<std::string> seen;
+
+    // 失败时删掉写了一半的包，否则 FileLoader 会优先使用它
+    auto fail = [&]() {
+        out.close();
+        std::error_code ec;
+        std::filesystem::remove(outPath, ec);
+        return false;
+    };
+
+    for (const auto& input : inputs) {
+        std::string key = normalizeName(input.name);
+        if (!seen.insert(key).second) {
+            std::cerr << "[ResourcePack] Duplicate entry (names differ only by case or separator): " << key << std::endl;
+            return fail();
+        }
+
+        // MappedFile::open 对读不了的文件和空文件都返回空; 只有真正的空文件可以打成空条目
+        MappedFile src = MappedFile::open(input.path);
+        if (src.empty()) {
+            std::error_code ec;
+            if (std::filesystem::file_size(input.path, ec) != 0 || ec) {
+                std::cerr << "[ResourcePack] Cannot read " << input.path << std::endl;
+                return fail();
+            }
+        }
+        std::vector<uint8_t> packed;
+        bool useLz = false;
+        if (compress && src.size() >= 64) {
+            packed = LzCodec::compress(src.data(), src.size());
+            useLz = packed.size() <= src.size() - src.size() / 8;
+        }
+
+        PadTo(out, pos, ALIGNMENT);
+
+        PackEntry e;
+        std::memset(&e, 0, sizeof(e));
+        e.hash = hashName(key);
+        e.offset = pos;
+        e.size = src.size();
+        e.flags = useLz ? FLAG_LZ : 0;
+        e.storedSize = useLz ? packed.size() : src.size();
+        e.nameOffset = static_cast<uint32_t>(names.size());
+        e.nameLength = static_cast<uint32_t>(key.size());
+        names += key;
+
+        if (useLz) {
+            out.write(reinterpret_cast<const char*>(packed.data()), static_cast<std::streamsize>(packed.size()));
+        } else if (!src.empty()) {
+            out.write(reinterpret_cast<const char*>(src.data()), static_cast<std::streamsize>(src.size()));
+        }
+        pos += e.storedSize;
+        entries.push_back(e);
+    }
+
+    // 开放寻址哈希表，装载率 <= 50%
+    uint32_t slotCount = NextPow2(std::max<uint32_t>(16, static_cast<uint32_t>(entries.size()) * 2));
+    std::vector<uint32_t> slots(slotCount, 0);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        uint32_t s = static_cast<uint32_t>(entries[i].hash) & (slotCount - 1);
+        while (slots[s] != 0) s = (s + 1) & (slotCount - 1);
+        slots[s] = static_cast<uint32_t>(i + 1);
+    }
+
+    PadTo(out, pos, ALIGNMENT);
+    header.dirOffset = pos;
+    out.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(PackEntry)));
+    out.write(reinterpret_cast<const char*>(slots.data()), static_cast<std::streamsize>(slots.size() * sizeof(uint32_t)));
+    out.write(names.data(), static_cast<std::streamsize>(names.size()));
+    header.dirSize = entries.size() * sizeof(PackEntry) + slots.size() * sizeof(uint32_t) + names.size();
+
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.entryCount = static_cast<uint32_t>(entries.size());
+    header.slotCount = slotCount;
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!out.good()) return fail();
+    return true;
+}
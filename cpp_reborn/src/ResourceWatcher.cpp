@@ -0,0 +1,157 @@
+#include "ResourceWatcher.h"
+#include "ResourcePack.h"
+#include <filesystem>
+#include <chrono>
+#include <iostream>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+    uint64_t NowMs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+}
+
+ResourceWatcher::~ResourceWatcher() {
+    stop();
+}
+
+bool ResourceWatcher::start(const std::vector<std::string>& roots, uint32_t settleMs) {
+    stop();
+    m_settleMs = settleMs;
+
+    std::error_code ec;
+    for (const auto& root : roots) {
+        if (fs::is_directory(root, ec)) m_roots.push_back(root);
+    }
+    if (m_roots.empty()) return false;
+
+#ifdef __linux__
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd >= 0) {
+        for (size_t r = 0; r < m_roots.size(); ++r) {
+            addWatch(r, "");
+            for (fs::recursive_directory_iterator it(m_roots[r], ec), end; it != end; it.increment(ec)) {
+                if (ec) break;
+                if (it->is_directory(ec)) {
+                    addWatch(r, it->path().lexically_relative(m_roots[r]).generic_string() + "/");
+                }
+            }
+        }
+        std::cout << "[ResourceWatcher] inotify watching " << m_watchDirs.size() << " directories" << std::endl;
+        m_running = true;
+        return true;
+    }
+    std::cerr << "[ResourceWatcher] inotify unavailable, falling back to polling" << std::endl;
+#endif
+
+    scanSnapshot(m_snapshot);
+    m_lastScanMs = NowMs();
+    std::cout << "[ResourceWatcher] Polling " << m_snapshot.size() << " files" << std::endl;
+    m_running = true;
+    return true;
+}
+
+#ifdef __linux__
+void ResourceWatcher::addWatch(size_t root, const std::string& rel) {
+    fs::path dir = fs::path(m_roots[root]) / rel;
+    int wd = inotify_add_watch(m_fd, dir.string().c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+    if (wd >= 0) m_watchDirs[wd] = { root, rel };
+}
+#endif
+
+void ResourceWatcher::stop() {
+#ifdef __linux__
+    if (m_fd >= 0) {
+        close(m_fd);
+        m_fd = -1;
+    }
+    m_watchDirs.clear();
+#endif
+    m_roots.clear();
+    m_pending.clear();
+    m_snapshot.clear();
+    m_running = false;
+}
+
+void ResourceWatcher::scanSnapshot(std::map<std::string, std::pair<int64_t, uint64_t>>& out) const {
+    std::error_code ec;
+    for (const auto& root : m_roots) {
+        for (fs::recursive_directory_iterator it(root, ec), end; it != end; it.increment(ec)) {
+            if (ec) break;
+            if (!it->is_regular_file(ec)) continue;
+            auto mtime = fs::last_write_time(it->path(), ec);
+            uint64_t size = it->file_size(ec);
+            std::string name = ResourcePack::normalizeName(it->path().lexically_relative(root).generic_string());
+            out[name] = { static_cast<int64_t>(mtime.time_since_epoch().count()), size };
+        }
+    }
+}
+
+void ResourceWatcher::collect(uint64_t nowMs) {
+#ifdef __linux__
+    if (m_fd >= 0) {
+        alignas(inotify_event) char buf[4096];
+        for (;;) {
+            ssize_t len = read(m_fd, buf, sizeof(buf));
+            if (len <= 0) break;
+            for (char* p = buf; p < buf + len;) {
+                const inotify_event* ev = reinterpret_cast<const inotify_event*>(p);
+                p += sizeof(inotify_event) + ev->len;
+                if (ev->len == 0) continue;
+
+                auto dir = m_watchDirs.find(ev->wd);
+                if (dir == m_watchDirs.end()) continue;
+                std::string rel = dir->second.rel + ev->name;
+
+                if (ev->mask & IN_ISDIR) {
+                    // 新建的子目录也要监视
+                    if (ev->mask & (IN_CREATE | IN_MOVED_TO)) addWatch(dir->second.root, rel + "/");
+                    continue;
+                }
+                // IN_CREATE 之后一定还有 IN_CLOSE_WRITE，只在写完时记录
+                if (ev->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+                    m_pending[ResourcePack::normalizeName(rel)] = nowMs;
+                }
+            }
+        }
+        return;
+    }
+#endif
+
+    if (nowMs - m_lastScanMs < 1000) return;
+    m_lastScanMs = nowMs;
+
+    std::map<std::string, std::pair<int64_t, uint64_t>> current;
+    scanSnapshot(current);
+    for (const auto& kv : current) {
+        auto old = m_snapshot.find(kv.first);
+        if (old == m_snapshot.end() || old->second != kv.second) {
+            m_pending[kv.first] = nowMs;
+        }
+    }
+    m_snapshot.swap(current);
+}
+
+void ResourceWatcher::poll(std::vector<std::string>& changed) {
+    if (!m_running) return;
+    uint64_t now = NowMs();
+    collect(now);
+
+    for (auto it = m_pending.begin(); it != m_pending.end();) {
+        if (now - it->second >= m_settleMs) {
+            changed.push_back(it->first);
+            it = m_pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
@@ -0,0 +1,195 @@
+#include "SaveContainer.h"
+#include "LzCodec.h"
+#include "Crc32c.h"
+#include "FileLoader.h"
+#include <fstream>
+#include <filesystem>
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+
+namespace {
+    const char MAGIC[4] = { 'K', 'S', 'A', 'V' };
+    const uint16_t VERSION = 1;
+    const size_t HEADER_SIZE = 32;
+    const size_t ENTRY_SIZE = 8;
+    const uint32_t STORED_RAW = 0x80000000u;
+
+    struct Header {
+        char magic[4];
+        uint16_t version;
+        uint16_t reserved0;
+        uint32_t blockSize;
+        uint32_t blockCount;
+        uint64_t rawSize;
+        uint32_t headerCrc;
+        uint32_t reserved1;
+    };
+    static_assert(sizeof(Header) == HEADER_SIZE, "container header layout");
+
+    const size_t CRC_COVERED = 24; // header bytes before headerCrc
+
+    uint32_t HeaderCrc(const uint8_t* header, const uint8_t* table, size_t tableBytes) {
+        return Crc32c::compute(table, tableBytes, Crc32c::compute(header, CRC_COVERED));
+    }
+}
+
+bool SaveContainer::isContainer(const uint8_t* data, size_t size) {
+    return data && size >= HEADER_SIZE && std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+bool SaveContainer::isContainerFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    uint8_t head[HEADER_SIZE] = {};
+    return file.read(reinterpret_cast<char*>(head), HEADER_SIZE) && isContainer(head, HEADER_SIZE);
+}
+
+std::vector<uint8_t> SaveContainer::pack(const uint8_t* raw, size_t size, uint32_t blockSize) {
+    if (blockSize == 0 || blockSize >= STORED_RAW) blockSize = DEFAULT_BLOCK_SIZE;
+    const uint32_t blockCount = static_cast<uint32_t>((size + blockSize - 1) / blockSize);
+    const size_t tableBytes = static_cast<size_t>(blockCount) * ENTRY_SIZE;
+
+    std::vector<uint8_t> out(HEADER_SIZE + tableBytes);
+    out.reserve(HEADER_SIZE + tableBytes + size / 4);
+    for (uint32_t b = 0; b < blockCount; ++b) {
+        const uint8_t* block = raw + static_cast<size_t>(b) * blockSize;
+        const size_t length = std::min<size_t>(blockSize, size - static_cast<size_t>(b) * blockSize);
+
+        std::vector<uint8_t> packed = LzCodec::compress(block, length);
+        uint32_t stored;
+        if (packed.size() < length) {
+            stored = static_cast<uint32_t>(packed.size());
+            out.insert(out.end(), packed.begin(), packed.end());
+        } else {
+            stored = static_cast<uint32_t>(length) | STORED_RAW;
+            out.insert(out.end(), block, block + length);
+        }
+        uint32_t crc = Crc32c::compute(block, length);
+        std::memcpy(out.data() + HEADER_SIZE + b * ENTRY_SIZE, &stored, 4);
+        std::memcpy(out.data() + HEADER_SIZE + b * ENTRY_SIZE + 4, &crc, 4);
+    }
+
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.blockSize = blockSize;
+    header.blockCount = blockCount;
+    header.rawSize = size;
+    std::memcpy(out.data(), &header, HEADER_SIZE);
+    header.headerCrc = HeaderCrc(out.data(), out.data() + HEADER_SIZE, tableBytes);
+    std::memcpy(out.data(), &header, HEADER_SIZE);
+    return out;
+}
+
+bool SaveContainer::unpack(const uint8_t* data, size_t size, std::vector<uint8_t>& raw) {
+    if (!isContainer(data, size)) {
+        std::cerr << "[SaveContainer] Not a save container" << std::endl;
+        return false;
+    }
+    Header header;
+    std::memcpy(&header, data, HEADER_SIZE);
+    if (header.version != VERSION || header.blockSize == 0 || header.blockSize >= STORED_RAW) {
+        std::cerr << "[SaveContainer] Unsupported container version " << header.version << std::endl;
+        return false;
+    }
+    const uint64_t expectedBlocks = (header.rawSize + header.blockSize - 1) / header.blockSize;
+    const uint64_t tableBytes = static_cast<uint64_t>(header.blockCount) * ENTRY_SIZE;
+    if (header.blockCount != expectedBlocks || HEADER_SIZE + tableBytes > size) {
+        std::cerr << "[SaveContainer] Truncated block table" << std::endl;
+        return false;
+    }
+    const uint8_t* table = data + HEADER_SIZE;
+    if (HeaderCrc(data, table, static_cast<size_t>(tableBytes)) != header.headerCrc) {
+        std::cerr << "[SaveContainer] Header checksum mismatch" << std::endl;
+        return false;
+    }
+
+    std::vector<uint8_t> out(static_cast<size_t>(header.rawSize));
+    size_t at = HEADER_SIZE + static_cast<size_t>(tableBytes);
+    for (uint32_t b = 0; b < header.blockCount; ++b) {
+        uint32_t stored, crc;
+        std::memcpy(&stored, table + b * ENTRY_SIZE, 4);
+        std::memcpy(&crc, table + b * ENTRY_SIZE + 4, 4);
+        const bool isRaw = (stored & STORED_RAW) != 0;
+        const size_t storedSize = stored & ~STORED_RAW;
+        const size_t offset = static_cast<size_t>(b) * header.blockSize;
+        const size_t length = std::min<size_t>(header.blockSize, out.size() - offset);
+        uint8_t* dst = out.data() + offset;
+
+        if (storedSize > size - at) {
+            std::cerr << "[SaveContainer] Block " << b << " is truncated" << std::endl;
+            return false;
+        }
+        if (isRaw) {
+            if (storedSize != length) {
+                std::cerr << "[SaveContainer] Block " << b << " has the wrong size" << std::endl;
+                return false;
+            }
+            std::memcpy(dst, data + at, length);
+        } else if (!LzCodec::decompress(data + at, storedSize, dst, length)) {
+            std::cerr << "[SaveContainer] Block " << b << " does not decompress" << std::endl;
+            return false;
+        }
+        if (Crc32c::compute(dst, length) != crc) {
+            std::cerr << "[SaveContainer] Block " << b << " checksum mismatch" << std::endl;
+            return false;
+        }
+        at += storedSize;
+    }
+    raw = std::move(out);
+    return true;
+}
+
+bool SaveContainer::readFile(const std::string& path, std::vector<uint8_t>& raw) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+    std::streamsize size = file.tellg();
+    if (size < 0) return false;
+    std::vector<uint8_t> bytes(static_cast<size_t>(size));
+    file.seekg(0, std::ios::beg);
+    if (size > 0 && !file.read(reinterpret_cast<char*>(bytes.data()), size)) return false;
+
+    if (!isContainer(bytes.data(), bytes.size())) {
+        raw = std::move(bytes);
+        return true;
+    }
+    if (!unpack(bytes.data(), bytes.size(), raw)) {
+        std::cerr << "[SaveContainer] Damaged save: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+MappedFile SaveContainer::mapFile(const std::string& path, bool* compressed) {
+    MappedFile file = MappedFile::open(path);
+    const bool packed = isContainer(file.data(), file.size());
+    if (compressed) *compressed = packed;
+    if (!packed) return file;
+    std::vector<uint8_t> raw;
+    if (!unpack(file.data(), file.size(), raw)) {
+        std::cerr << "[SaveContainer] Damaged save: " << path << std::endl;
+        return MappedFile();
+    }
+    return MappedFile::fromBuffer(std::move(raw));
+}
+
+bool SaveContainer::writeFile(const std::string& path, const uint8_t* raw, size_t size, bool compressed) {
+    if (!compressed) return FileLoader::saveFileAtomic(path, raw, size);
+    std::vector<uint8_t> packed = pack(raw, size);
+    return FileLoader::saveFileAtomic(path, packed.data(), packed.size());
+}
+
+bool SaveContainer::exportRaw(const std::string& src, const std::string& dst) {
+    // 还有未合并的日志 (--journal-saves) 时文件本身是旧内容，须经 PagedFile::exportRaw 导出
+    std::error_code ec;
+    if (std::filesystem::exists(src + ".jnl", ec)) {
+        std::cerr << "[SaveContainer] " << src << " has a pending journal, not exported" << std::endl;
+        return false;
+    }
+    std::vector<uint8_t> raw;
+    if (!readFile(src, raw)) {
+        std::cerr << "[SaveContainer] Cannot read " << src << std::endl;
+        return false;
+    }
+    return FileLoader::saveFileAtomic(dst, raw.data(), raw.size());
+}
@@ -0,0 +1,76 @@
+#include "SaveImage.h"
+#include "SaveContainer.h"
+#include <fstream>
+#include <iostream>
+
+bool SaveLayout::load(const std::string& idxPath, SaveLayout& out) {
+    std::ifstream file(idxPath, std::ios::binary);
+    if (!file) {
+        std::cerr << "[SaveImage] Cannot open " << idxPath << std::endl;
+        return false;
+    }
+
+    int32_t offsets[6] = {};
+    if (!file.read(reinterpret_cast<char*>(offsets), sizeof(offsets))) {
+        std::cerr << "[SaveImage] " << idxPath << " is too short" << std::endl;
+        return false;
+    }
+
+    SaveLayout layout;
+    layout.roleOffset = offsets[0];
+    layout.itemOffset = offsets[1];
+    layout.sceneOffset = offsets[2];
+    layout.magicOffset = offsets[3];
+    layout.shopOffset = offsets[4];
+    layout.totalLength = offsets[5];
+    if (!layout.valid()) {
+        std::cerr << "[SaveImage] Invalid offsets in " << idxPath << std::endl;
+        return false;
+    }
+    out = layout;
+    return true;
+}
+
+size_t SaveImageWriter::sectionBytes(int32_t begin, int32_t end) const {
+    if (begin < 0 || end <= begin) return 0;
+    size_t last = std::min(static_cast<size_t>(end), m_bytes.size());
+    return last > static_cast<size_t>(begin) ? last - static_cast<size_t>(begin) : 0;
+}
+
+void SaveImageWriter::putHeader(const std::vector<int16_t>& values) {
+    size_t bytes = std::min(values.size() * sizeof(int16_t), sectionBytes(0, m_layout.roleOffset));
+    if (values.size() * sizeof(int16_t) > bytes) {
+        std::cerr << "[SaveImage] Header exceeds RoleOffset, truncating to RoleOffset." << std::endl;
+    }
+    if (bytes > 0) std::memcpy(m_bytes.data(), values.data(), bytes);
+}
+
+void SaveImageWriter::putBytes(int32_t begin, int32_t end, const std::vector<uint8_t>& bytes) {
+    size_t count = std::min(bytes.size(), sectionBytes(begin, end));
+    if (count > 0) std::memcpy(m_bytes.data() + begin, bytes.data(), count);
+}
+
+bool SaveImageWriter::writeTo(const std::string& path, bool compressed) const {
+    return SaveContainer::writeFile(path, m_bytes.data(), m_bytes.size(), compressed);
+}
+
+size_t SaveImageReader::sectionBytes(int32_t begin, int32_t end, bool presentOnly) const {
+    if (begin < 0 || end <= begin) return 0;
+    size_t last = static_cast<size_t>(end);
+    if (presentOnly) last = std::min(last, m_bytes.size());
+    return last > static_cast<size_t>(begin) ? last - static_cast<size_t>(begin) : 0;
+}
+
+std::vector<int16_t> SaveImageReader::header() const {
+    std::vector<int16_t> values(sectionBytes(0, m_layout.roleOffset, false) / sizeof(int16_t), 0);
+    size_t bytes = std::min(values.size() * sizeof(int16_t), sectionBytes(0, m_layout.roleOffset, true));
+    if (bytes > 0) std::memcpy(values.data(), m_bytes.data(), bytes);
+    return values;
+}
+
+std::vector<uint8_t> SaveImageReader::getBytes(int32_t begin, int32_t end) const {
+    std::vector<uint8_t> bytes(sectionBytes(begin, end, false), 0);
+    size_t present = sectionBytes(begin, end, true);
+    if (present > 0) std::memcpy(bytes.data(), m_bytes.data() + begin, present);
+    return bytes;
+}
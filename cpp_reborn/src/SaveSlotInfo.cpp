@@ -0,0 +1,153 @@
+#include "SaveSlotInfo.h"
+#include "FileLoader.h"
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+
+namespace {
+    // 头部各字段的偏移 (小端，与存档相同)
+    const size_t OFF_MAGIC = 0;
+    const size_t OFF_VERSION = 4;
+    const size_t OFF_HEADER_SIZE = 6;
+    const size_t OFF_SCENE = 8;
+    const size_t OFF_MAP_X = 10;
+    const size_t OFF_MAP_Y = 12;
+    const size_t OFF_LEVEL = 14;
+    const size_t OFF_TEAM_COUNT = 16;
+    const size_t OFF_TEAM = 18;         // MAX_TEAM int16
+    const size_t OFF_THUMB_W = 30;
+    const size_t OFF_THUMB_H = 32;
+    const size_t OFF_SAVED_AT = 36;
+    const size_t OFF_SCENE_NAME = 44;   // NAME_BYTES
+    const size_t OFF_LEAD_NAME = 60;    // NAME_BYTES
+    const char MAGIC[4] = { 'K', 'S', 'L', 'T' };
+
+    template <typename T>
+    void put(std::vector<uint8_t>& out, size_t at, T value) {
+        std::memcpy(out.data() + at, &value, sizeof(T));
+    }
+    template <typename T>
+    T get(const uint8_t* data, size_t at) {
+        T value;
+        std::memcpy(&value, data + at, sizeof(T));
+        return value;
+    }
+    void putName(std::vector<uint8_t>& out, size_t at, const std::string& name) {
+        size_t n = std::min(name.size(), SaveSlotInfo::NAME_BYTES);
+        std::memcpy(out.data() + at, name.data(), n);
+    }
+    std::string getName(const uint8_t* data, size_t at) {
+        const char* p = reinterpret_cast<const char*>(data + at);
+        size_t n = 0;
+        while (n < SaveSlotInfo::NAME_BYTES && p[n] != '\0') ++n;
+        return std::string(p, n);
+    }
+}
+
+std::string SaveSlotInfo::pathFor(const std::string& grpPath) {
+    size_t dot = grpPath.find_last_of('.');
+    size_t slash = grpPath.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return grpPath + ".inf";
+    return grpPath.substr(0, dot) + ".inf";
+}
+
+std::vector<uint8_t> SaveSlotInfo::serialize() const {
+    const size_t pixels = static_cast<size_t>(thumbWidth) * thumbHeight;
+    const bool hasThumb = pixels > 0 && thumbnail.size() == pixels;
+
+    std::vector<uint8_t> out(HEADER_SIZE + (hasThumb ? pixels * sizeof(uint16_t) : 0), 0);
+    std::memcpy(out.data() + OFF_MAGIC, MAGIC, sizeof(MAGIC));
+    put<uint16_t>(out, OFF_VERSION, VERSION);
+    put<uint16_t>(out, OFF_HEADER_SIZE, static_cast<uint16_t>(HEADER_SIZE));
+    put<int16_t>(out, OFF_SCENE, sceneId);
+    put<int16_t>(out, OFF_MAP_X, mapX);
+    put<int16_t>(out, OFF_MAP_Y, mapY);
+    put<int16_t>(out, OFF_LEVEL, leadLevel);
+    int teamCount = std::min(static_cast<int>(team.size()), MAX_TEAM);
+    put<int16_t>(out, OFF_TEAM_COUNT, static_cast<int16_t>(teamCount));
+    for (int i = 0; i < teamCount; ++i) put<int16_t>(out, OFF_TEAM + i * 2, team[i]);
+    put<uint16_t>(out, OFF_THUMB_W, hasThumb ? thumbWidth : 0);
+    put<uint16_t>(out, OFF_THUMB_H, hasThumb ? thumbHeight : 0);
+    put<int64_t>(out, OFF_SAVED_AT, savedAt);
+    putName(out, OFF_SCENE_NAME, sceneName);
+    putName(out, OFF_LEAD_NAME, leadName);
+    if (hasThumb) std::memcpy(out.data() + HEADER_SIZE, thumbnail.data(), pixels * sizeof(uint16_t));
+    return out;
+}
+
+bool SaveSlotInfo::parse(const uint8_t* data, size_t size, SaveSlotInfo& out, bool withThumbnail) {
+    if (!data || size < HEADER_SIZE) return false;
+    if (std::memcmp(data + OFF_MAGIC, MAGIC, sizeof(MAGIC)) != 0) return false;
+    if (get<uint16_t>(data, OFF_VERSION) != VERSION) return false;
+    // 以后的版本可以加长头部，缩略图总在头部之后
+    size_t headerSize = get<uint16_t>(data, OFF_HEADER_SIZE);
+    if (headerSize < HEADER_SIZE) return false;
+
+    SaveSlotInfo info;
+    info.sceneId = get<int16_t>(data, OFF_SCENE);
+    info.mapX = get<int16_t>(data, OFF_MAP_X);
+    info.mapY = get<int16_t>(data, OFF_MAP_Y);
+    info.leadLevel = get<int16_t>(data, OFF_LEVEL);
+    int teamCount = get<int16_t>(data, OFF_TEAM_COUNT);
+    if (teamCount < 0 || teamCount > MAX_TEAM) return false;
+    for (int i = 0; i < teamCount; ++i) info.team.push_back(get<int16_t>(data, OFF_TEAM + i * 2));
+    info.thumbWidth = get<uint16_t>(data, OFF_THUMB_W);
+    info.thumbHeight = get<uint16_t>(data, OFF_THUMB_H);
+    info.savedAt = get<int64_t>(data, OFF_SAVED_AT);
+    info.sceneName = getName(data, OFF_SCENE_NAME);
+    info.leadName = getName(data, OFF_LEAD_NAME);
+
+    if (withThumbnail) {
+        size_t pixels = static_cast<size_t>(info.thumbWidth) * info.thumbHeight;
+        if (pixels > 0 && size >= headerSize + pixels * sizeof(uint16_t)) {
+            info.thumbnail.resize(pixels);
+            std::memcpy(info.thumbnail.data(), data + headerSize, pixels * sizeof(uint16_t));
+        }
+    }
+    out = std::move(info);
+    return true;
+}
+
+bool SaveSlotInfo::writeTo(const std::string& path) const {
+    std::vector<uint8_t> bytes = serialize();
+    return FileLoader::saveFileAtomic(path, bytes.data(), bytes.size());
+}
+
+bool SaveSlotInfo::read(const std::string& path, SaveSlotInfo& out, bool withThumbnail) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    std::vector<uint8_t> data(HEADER_SIZE);
+    if (!file.read(reinterpret_cast<char*>(data.data()), HEADER_SIZE)) {
+        std::cerr << "[SaveSlotInfo] " << path << " is too short" << std::endl;
+        return false;
+    }
+    if (withThumbnail) {
+        data.insert(data.end(), std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    if (!parse(data.data(), data.size(), out, withThumbnail)) {
+        std::cerr << "[SaveSlotInfo] " << path << " is not a slot info file" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::vector<uint16_t> SaveSlotInfo::downscale(const uint32_t* pixels, int width, int height, int pitchBytes,
+                                              int outW, int outH) {
+    std::vector<uint16_t> out;
+    if (!pixels || width <= 0 || height <= 0 || outW <= 0 || outH <= 0) return out;
+    out.resize(static_cast<size_t>(outW) * outH);
+    const uint8_t* base = reinterpret_cast<const uint8_t*>(pixels);
+    for (int y = 0; y < outH; ++y) {
+        const uint32_t* row = reinterpret_cast<const uint32_t*>(base + static_cast<size_t>(y * height / outH) * pitchBytes);
+        for (int x = 0; x < outW; ++x) {
+            uint32_t c = row[x * width / outW];
+            uint16_t r = (c >> 19) & 0x1F;
+            uint16_t g = (c >> 10) & 0x3F;
+            uint16_t b = (c >> 3) & 0x1F;
+            out[static_cast<size_t>(y) * outW + x] = static_cast<uint16_t>((r << 11) | (g << 5) | b);
+        }
+    }
+    return out;
+}
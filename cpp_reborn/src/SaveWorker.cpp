@@ -0,0 +1,73 @@
+#include "SaveWorker.h"
+#include <iostream>
+
+SaveWorker::~SaveWorker() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cond.notify_all();
+    if (m_worker.joinable()) m_worker.join();
+}
+
+void SaveWorker::submit(WriteFunc write, DoneFunc done) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Job job;
+        job.write = std::move(write);
+        job.done = std::move(done);
+        m_pending.push_back(std::move(job));
+        // 第一次提交时才启动线程
+        if (!m_worker.joinable()) m_worker = std::thread(&SaveWorker::workerLoop, this);
+    }
+    m_cond.notify_all();
+}
+
+void SaveWorker::workerLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        // 退出前写完队列里剩下的存档
+        m_cond.wait(lock, [this]() { return m_stop || !m_pending.empty(); });
+        if (m_pending.empty()) return;
+
+        WriteFunc write = m_pending.front().write;
+        lock.unlock();
+        std::string error;
+        bool ok = false;
+        if (write) ok = write(error);
+        lock.lock();
+
+        Job job = std::move(m_pending.front());
+        m_pending.pop_front();
+        job.ok = ok;
+        job.error = error;
+        if (!ok) std::cerr << "[SaveWorker] Save failed: " << error << std::endl;
+        m_finished.push_back(std::move(job));
+        m_cond.notify_all();
+    }
+}
+
+int SaveWorker::poll() {
+    std::deque<Job> finished;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        finished.swap(m_finished);
+    }
+    for (auto& job : finished) {
+        if (job.done) job.done(job.ok, job.error);
+    }
+    return static_cast<int>(finished.size());
+}
+
+void SaveWorker::wait() {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cond.wait(lock, [this]() { return m_pending.empty(); });
+    }
+    poll();
+}
+
+bool SaveWorker::busy() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_pending.empty() || !m_finished.empty();
+}
@@ -22,17 +22,7 @@ bool SceneManager::Init() {
         // Don't fail completely, maybe resources are missing but we can still load map logic
     }
     // 5. 加载战斗地图资源 (WarMap) - wmp/wdx
-    m_wmpPicData = FileLoader::loadFile("resource/wmp");
-    auto wIdxBytes = FileLoader::loadFile("resource/wdx");
-    
-    if (!m_wmpPicData.empty() && !wIdxBytes.empty()) {
-        size_t count = wIdxBytes.size() / 4;
-        m_wmpIdxData.resize(count);
-        memcpy(m_wmpIdxData.data(), wIdxBytes.data(), wIdxBytes.size());
-        std::cout << "[SceneManager] Loaded WarMap (wmp/wdx). Pic Data: " << m_wmpPicData.size() << " bytes, Idx Count: " << count << std::endl;
-    } else {
-        std::cerr << "[SceneManager] Failed to load WarMap (wmp/wdx)" << std::endl;
-    }
+    LoadWarMapSprites();
     
     // 6. Load World Map Layout (EARTH.002)
     LoadWorldMap();
@@ -41,71 +31,34 @@ bool SceneManager::Init() {
 }
 
 bool SceneManager::LoadWorldMap() {
-    auto loadLayer = [](const std::string& filename) -> std::vector<int16_t> {
-        auto data = FileLoader::loadFile(filename);
-        if (data.empty()) {
-            auto alt = FileLoader::loadFile("resource/" + filename);
-            if (alt.empty()) {
-                return {};
-            }
-            data.swap(alt);
-        }
-        if (data.size() != 480 * 480 * 2) {
-            std::cerr << "[LoadWorldMap] Warning: " << filename
-                      << " size mismatch, expect " << (480 * 480 * 2)
-                      << " bytes, got " << data.size() << std::endl;
-        }
-        std::vector<int16_t> layer(data.size() / 2);
-        memcpy(layer.data(), data.data(), data.size());
-        return layer;
-    };
-
-    m_worldEarth    = loadLayer("EARTH.002");
-    m_worldSurface  = loadLayer("surface.002");
-    m_worldBuilding = loadLayer("building.002");
-    m_worldBuildX   = loadLayer("buildx.002");
-    m_worldBuildY   = loadLayer("buildy.002");
-
-    if (m_worldEarth.empty()) {
-        std::cerr << "[LoadWorldMap] Failed to load EARTH.002" << std::endl;
-        return false;
-    }
-
-    if (m_worldSurface.empty() || m_worldBuilding.empty() ||
-        m_worldBuildX.empty() || m_worldBuildY.empty()) {
-        std::cerr << "[LoadWorldMap] Warning: some world layers missing. "
-                  << "Surface=" << m_worldSurface.size()
-                  << " Building=" << m_worldBuilding.size()
-                  << " BuildX=" << m_worldBuildX.size()
-                  << " BuildY=" << m_worldBuildY.size() << std::endl;
-    } else {
-        std::cout << "[LoadWorldMap] World layers loaded. "
-                  << "Earth=" << m_worldEarth.size()
-                  << " Surface=" << m_worldSurface.size()
-                  << " Building=" << m_worldBuilding.size()
-                  << " BuildX=" << m_worldBuildX.size()
-                  << " BuildY=" << m_worldBuildY.size() << std::endl;
-    }
-
+    if (!m_worldMap.load()) return false;
+    ResetEntrance();
     return true;
 }
 
 bool SceneManager::LoadResources() {
+    // 1. 场景图块 (smp/sdx) 缺失时视为失败，其余资源缺失只打印警告
+    bool ok = LoadSceneTiles();
+    LoadMmapSprites();
+    LoadScenePics();
+    LoadCloudSprites();
+    LoadPalette();
+    return ok;
+}
 
-
+bool SceneManager::LoadSceneTiles() {
     // 1. 加载场景图块资源 (SceneMap) - smp/sdx
-    m_smpPicData = FileLoader::loadFile("resource/smp");
-    auto idxBytes = FileLoader::loadFile("resource/sdx");
+    m_smpPicData = FileLoader::mapFile("resource/smp");
+    m_smpIdxData = FileLoader::mapFile("resource/sdx").as<int32_t>();
     
-    if (!m_smpPicData.empty() && !idxBytes.empty()) {
-        size_t count = idxBytes.size() / 4;
-        m_smpIdxData.resize(count);
-        memcpy(m_smpIdxData.data(), idxBytes.data(), idxBytes.size());
+    if (!m_smpPicData.empty() && !m_smpIdxData.empty()) {
+        size_t count = m_smpIdxData.size();
         std::cout << "[SceneManager] Loaded SceneMap (smp/sdx) with " << count << " tiles." << std::endl;
+        m_smpSprites.openRLE("resource/smp", "resource/sdx", "smp.kcc");
         
         // Debug: Print first few offsets to verify loading
         std::cout << "  First 5 Offsets: ";
-        for(int i=0; i<5 && i<count; ++i) std::cout << m_smpIdxData[i] << " ";
+        for(size_t i=0; i<5 && i<count; ++i) std::cout << m_smpIdxData[i] << " ";
         std::cout << std::endl;
         
         // Check offset for Player Sprite (approx 2501)
@@ -117,23 +70,54 @@ bool SceneManager::LoadResources() {
         std::cerr << "Failed to load SceneMap (smp/sdx)" << std::endl;
         return false; 
     }
-    
+    return true;
+}
+
+bool SceneManager::LoadMmapSprites() {
     // 2. 加载大地图贴图资源 (MaxMap) - mmap.grp/mmap.idx
-    m_mmpPicData = FileLoader::loadFile("resource/mmap.grp");
-    auto mmapIdxBytes = FileLoader::loadFile("resource/mmap.idx");
+    m_mmpPicData = FileLoader::mapFile("resource/mmap.grp");
+    m_mmpIdxData = FileLoader::mapFile("resource/mmap.idx").as<int32_t>();
     
-    if (!m_mmpPicData.empty() && !mmapIdxBytes.empty()) {
-        size_t count = mmapIdxBytes.size() / 4;
-        m_mmpIdxData.resize(count);
-        memcpy(m_mmpIdxData.data(), mmapIdxBytes.data(), mmapIdxBytes.size());
+    if (!m_mmpPicData.empty() && !m_mmpIdxData.empty()) {
+        size_t count = m_mmpIdxData.size();
         std::cout << "[SceneManager] Loaded MaxMap (mmp/midx) with " << count << " sprites." << std::endl;
+        m_mmpSprites.openRLE("resource/mmap.grp", "resource/mmap.idx", "mmap.kcc");
     } else {
         std::cerr << "Failed to load MaxMap (mmap.grp/mmap.idx)" << std::endl;
     }
+    return !m_mmpPicData.empty() && !m_mmpIdxData.empty();
+}
+
+void SceneManager::FreeScenePics() {
+    for (auto& pic : m_scenePics) {
+        if (pic.surface) SDL_DestroySurface(pic.surface);
+    }
+    m_scenePics.clear();
+}
+
+bool SceneManager::LoadScenePics() {
+    FreeScenePics();
 
     // 2.5 加载动态场景贴图资源 (Scene.Pic)
-    auto scenePicData = FileLoader::loadFile("resource/Scene.Pic");
-    if (!scenePicData.empty()) {
+    // 优先用预解码缓存，省掉逐张 PNG 解码。缓存按 PicLoader 的编号，
+    // 这里的第 i 张对应其第 i+1 张 (与下方原始解析保持一致)
+    SpriteCache scenePicCache;
+    bool scenePicCached = scenePicCache.openPic("resource/Scene.Pic", "scenepic.kcc");
+    // PNG 解码后即不再需要原始数据，映射即可，函数结束时解除
+    MappedFile scenePicData = scenePicCached ? MappedFile() : FileLoader::mapFile("resource/Scene.Pic");
+    if (scenePicCached) {
+        int count = static_cast<int>(scenePicCache.count());
+        m_scenePics.resize(count);
+        for (int i = 0; i < count; ++i) {
+            SpriteCache::Sprite sp;
+            if (!scenePicCache.get(i + 1, sp)) continue;
+            m_scenePics[i].x = sp.x;
+            m_scenePics[i].y = sp.y;
+            m_scenePics[i].black = sp.black;
+            m_scenePics[i].surface = scenePicCache.createSurface(i + 1);
+        }
+        std::cout << "[SceneManager] Loaded Scene.Pic with " << count << " sprites (cached)." << std::endl;
+    } else if (!scenePicData.empty()) {
         const uint8_t* ptr = scenePicData.data();
         int32_t count;
         memcpy(&count, ptr, 4);
@@ -170,55 +154,124 @@ bool SceneManager::LoadResources() {
     } else {
         std::cerr << "Failed to load Scene.Pic" << std::endl;
     }
+    return !m_scenePics.empty();
+}
 
+bool SceneManager::LoadCloudSprites() {
     // 3. Load Cloud Graphics (cloud.grp/cloud.idx)
-    m_cloudPicData = FileLoader::loadFile("resource/cloud.grp");
-    auto cloudIdxBytes = FileLoader::loadFile("resource/cloud.idx");
+    m_cloudPicData = FileLoader::mapFile("resource/cloud.grp");
+    m_cloudIdxData = FileLoader::mapFile("resource/cloud.idx").as<int32_t>();
     
-    if (!m_cloudPicData.empty() && !cloudIdxBytes.empty()) {
-        size_t count = cloudIdxBytes.size() / 4;
-        m_cloudIdxData.resize(count);
-        memcpy(m_cloudIdxData.data(), cloudIdxBytes.data(), cloudIdxBytes.size());
-    } else {
+    if (m_cloudPicData.empty() || m_cloudIdxData.empty()) {
         std::cerr << "Failed to load cloud.grp/cloud.idx" << std::endl;
+    } else {
+        m_cloudSprites.openRLE("resource/cloud.grp", "resource/cloud.idx", "cloud.kcc");
     }
+    return m_cloudSprites.isOpen() || !m_cloudPicData.empty();
+}
 
+void SceneManager::LoadPalette() {
     // 4. Load Palette (MMAP.COL)
     std::string palPath = FileLoader::getResourcePath("resource/MMAP.COL");
     GraphicsUtils::loadPalette(palPath);
+}
+
+bool SceneManager::LoadWarMapSprites() {
+    m_wmpPicData = FileLoader::mapFile("resource/wmp");
+    m_wmpIdxData = FileLoader::mapFile("resource/wdx").as<int32_t>();
     
-    return true;
+    if (!m_wmpPicData.empty() && !m_wmpIdxData.empty()) {
+        size_t count = m_wmpIdxData.size();
+        std::cout << "[SceneManager] Loaded WarMap (wmp/wdx). Pic Data: " << m_wmpPicData.size() << " bytes, Idx Count: " << count << std::endl;
+    } else {
+        std::cerr << "[SceneManager] Failed to load WarMap (wmp/wdx)" << std::endl;
+    }
+    return !m_wmpPicData.empty() && !m_wmpIdxData.empty();
 }
 
-bool SceneManager::LoadEventData(const std::string& path) {
-    auto data = FileLoader::loadFile(path);
-    if (data.empty()) return false;
+bool SceneManager::ReloadResource(const std::string& name) {
+    // name 为 VirtualFS 规范化的文件名 (小写)；grp 与 idx 任一变化都重载整对
+    if (name == "smp" || name == "sdx") return LoadSceneTiles();
+    if (name == "mmap.grp" || name == "mmap.idx") return LoadMmapSprites();
+    if (name == "scene.pic") return LoadScenePics();
+    if (name == "cloud.grp" || name == "cloud.idx") return LoadCloudSprites();
+    if (name == "wmp" || name == "wdx") return LoadWarMapSprites();
+    if (name == "mmap.col") {
+        LoadPalette();
+        return true;
+    }
+    if (name == "earth.002" || name == "surface.002" || name == "building.002" ||
+        name == "buildx.002" || name == "buildy.002") {
+        return LoadWorldMap();
+    }
+    return false;
+}
 
-    // DData size per scene: 200 events * 11 ints * 2 bytes = 4400 bytes
-    size_t sceneSize = 200 * 11 * 2;
-    if (data.size() % sceneSize != 0) {
-        std::cerr << "Warning: Event data size mismatch. Expected multiple of " << sceneSize << ", got " << data.size() << std::endl;
+void SceneManager::ReportMemory(MemoryStats& stats) const {
+    const char* owner = "SceneManager";
+    stats.add(owner, "smp", m_smpPicData.size(), m_smpIdxData.size(), m_smpPicData.isMapped());
+    stats.add(owner, "sdx", m_smpIdxData.size() * sizeof(int32_t), 0, m_smpIdxData.isMapped());
+    stats.add(owner, "mmap.grp", m_mmpPicData.size(), m_mmpIdxData.size(), m_mmpPicData.isMapped());
+    stats.add(owner, "mmap.idx", m_mmpIdxData.size() * sizeof(int32_t), 0, m_mmpIdxData.isMapped());
+    stats.add(owner, "wmp", m_wmpPicData.size(), m_wmpIdxData.size(), m_wmpPicData.isMapped());
+    stats.add(owner, "wdx", m_wmpIdxData.size() * sizeof(int32_t), 0, m_wmpIdxData.isMapped());
+    stats.add(owner, "cloud.grp", m_cloudPicData.size(), m_cloudIdxData.size(), m_cloudPicData.isMapped());
+    stats.add(owner, "cloud.idx", m_cloudIdxData.size() * sizeof(int32_t), 0, m_cloudIdxData.isMapped());
+    stats.add(owner, "smp.kcc", m_smpSprites.sizeBytes(), m_smpSprites.count(), m_smpSprites.isMapped());
+    stats.add(owner, "mmap.kcc", m_mmpSprites.sizeBytes(), m_mmpSprites.count(), m_mmpSprites.isMapped());
+    stats.add(owner, "cloud.kcc", m_cloudSprites.sizeBytes(), m_cloudSprites.count(), m_cloudSprites.isMapped());
+
+    uint64_t picBytes = 0, picCount = 0;
+    for (const auto& pic : m_scenePics) {
+        if (!pic.surface) continue;
+        picBytes += static_cast<uint64_t>(pic.surface->h) * pic.surface->pitch;
+        ++picCount;
     }
+    stats.add(owner, "scene_pics", picBytes + m_scenePics.capacity() * sizeof(ScenePic), picCount);
 
-    size_t count = data.size() / sceneSize;
-    m_eventData.resize(count);
-    
-    for (size_t i = 0; i < count; ++i) {
-        memcpy(m_eventData[i].data, data.data() + i * sceneSize, sceneSize);
+    stats.add(owner, "map_data", MapStore().residentBytes(), MapStore().residentCount());
+    stats.add(owner, "event_data", m_eventPages.residentBytes(), m_eventPages.residentCount());
+    stats.add(owner, "scenes", m_scenes.memoryBytes(), m_scenes.size());
+    stats.add(owner, "world_map", m_worldMap.memoryBytes(), m_worldMap.isLoaded() ? 1 : 0);
+}
+
+bool SceneManager::LoadEventData(const std::string& path) {
+    // DData size per scene: 200 events * 11 ints * 2 bytes = 4400 bytes
+    // 只打开文件，各场景在第一次访问时才读入
+    PagedFile::Source events;
+    if (!PagedFile::locate(path, sizeof(EventData), events)) return false;
+    OpenEventData(std::move(events), path);
+    return true;
+}
+
+bool SceneManager::LoadSaveData(const std::string& mapPath, const std::string& eventPath) {
+    // 两个文件都检查通过才切换，否则当前的场景图和事件 (包括没存的改动) 都不动
+    PagedFile::Source map, events;
+    if (!PagedFile::locate(mapPath, MAP_RECORD_SIZE, map) || !PagedFile::locate(eventPath, sizeof(EventData), events)) {
+        return false;
     }
+    OpenMapData(std::move(map));
+    OpenEventData(std::move(events), eventPath);
+    return true;
+}
+
+void SceneManager::OpenEventData(PagedFile::Source&& source, const std::string& path) {
+    m_eventPages.open(std::move(source), SCENE_PAGE_LIMIT);
+    size_t count = m_eventPages.count();
 
     // Debug: Check Scene 0 Data immediately after load
-    if (count > 0) {
+    const EventData* scene0 = SceneEvents(0);
+    if (scene0) {
         std::cout << "[LoadEventData] Loaded " << count << " scenes. Checking Scene 0..." << std::endl;
         bool hasActive = false;
         for (int e = 0; e < 200; ++e) {
-             if (m_eventData[0].data[e][0] != 0) {
+             if (scene0->data[e][0] != 0) {
                  hasActive = true;
                  if (e < 5) { // Print first few active events
-                     std::cout << "  Event " << e << " Active=" << m_eventData[0].data[e][0] 
-                               << " X=" << m_eventData[0].data[e][1] 
-                               << " Y=" << m_eventData[0].data[e][2] 
-                               << " Pic=" << m_eventData[0].data[e][5] << std::endl;
+                     std::cout << "  Event " << e << " Active=" << scene0->data[e][0] 
+                               << " X=" << scene0->data[e][1] 
+                               << " Y=" << scene0->data[e][2] 
+                               << " Pic=" << scene0->data[e][5] << std::endl;
                  }
              }
         }
@@ -226,66 +279,107 @@ bool SceneManager::LoadEventData(const std::string& path) {
             std::cerr << "[LoadEventData] WARNING: Scene 0 has NO active events! The file might be empty or zeroed." << std::endl;
             // Hex dump first 32 bytes
             std::cout << "  Raw Hex Dump (First 32 bytes): ";
-            for(int k=0; k<32 && k<data.size(); ++k) {
-                printf("%02X ", data[k]);
+            const uint8_t* raw = reinterpret_cast<const uint8_t*>(scene0->data);
+            for(int k=0; k<32; ++k) {
+                printf("%02X ", raw[k]);
             }
             std::cout << std::endl;
         }
-    }
     
-    // Debug: Check Scene 0, Event 3 (Kong Pili?)
-    if (count > 0) {
+        // Debug: Check Scene 0, Event 3 (Kong Pili?)
         std::cout << "[LoadEventData] Checking Scene 0, Event 3:" << std::endl;
         for(int k=0; k<11; ++k) {
-            std::cout << "  Index " << k << ": " << m_eventData[0].data[3][k] << std::endl;
+            std::cout << "  Index " << k << ": " << scene0->data[3][k] << std::endl;
         }
         // Index 5 is supposed to be Pic. If it's 0, that's why it's invisible.
     }
     
     std::cout << "Loaded " << count << " scenes event data from " << path << std::endl;
-    return true;
 }
 
 bool SceneManager::SaveEventData(const std::string& path) {
-    if (m_eventData.empty()) return false;
-    
-    // DData size per scene: 200 events * 11 ints * 2 bytes = 4400 bytes
-    size_t sceneSize = 200 * 11 * 2;
-    size_t totalSize = m_eventData.size() * sceneSize;
-    
-    std::vector<uint8_t> buffer(totalSize);
-    for (size_t i = 0; i < m_eventData.size(); ++i) {
-        memcpy(buffer.data() + i * sceneSize, m_eventData[i].data, sceneSize);
-    }
-    
-    return FileLoader::saveFile(path, buffer.data(), buffer.size());
+    // 同一文件只写回改动过的场景，另存时整份写出
+    return m_eventPages.save(path);
 }
 
 bool SceneManager::LoadMapData(const std::string& path) {
-    auto data = FileLoader::loadFile(path);
-    if (data.empty()) return false;
-    
     // SData size per scene: 6 layers * 64 * 64 tiles * 2 bytes/tile
-    size_t sceneSize = SCENE_LAYERS * SCENE_MAP_SIZE * SCENE_MAP_SIZE * 2;
-    if (data.size() % sceneSize != 0) {
-        std::cerr << "Warning: Map data size mismatch. Expected multiple of " << sceneSize << ", got " << data.size() << std::endl;
-    }
-    
-    m_mapData.resize(data.size() / 2);
-    memcpy(m_mapData.data(), data.data(), data.size());
+    PagedFile::Source map;
+    if (!PagedFile::locate(path, MAP_RECORD_SIZE, map)) return false;
+    OpenMapData(std::move(map));
     return true;
 }
 
+void SceneManager::OpenMapData(PagedFile::Source&& source) {
+    // 布局只在读入/写出场景时转换，文件始终是原 [layer][x][y] 格式
+    m_scratchSceneId = -1;
+    if (m_sceneLayout == SceneLayout::Interleaved) {
+        m_mapPages.close();
+        m_mapTiles.open(std::move(source), SCENE_PAGE_LIMIT);
+    } else {
+        m_mapTiles.close();
+        m_mapPages.open(std::move(source), SCENE_PAGE_LIMIT);
+    }
+}
+
+bool SceneManager::ExportMapData(const std::string& src, const std::string& dst) {
+    return PagedFile::exportRaw(src, dst, MAP_RECORD_SIZE);
+}
+
+bool SceneManager::ExportEventData(const std::string& src, const std::string& dst) {
+    return PagedFile::exportRaw(src, dst, sizeof(EventData));
+}
+
 bool SceneManager::SaveMapData(const std::string& path) {
-    if (m_mapData.empty()) return false;
-    
-    // Convert int16 vector to bytes
-    size_t byteSize = m_mapData.size() * 2;
-    return FileLoader::saveFile(path, m_mapData.data(), byteSize);
+    return MapStore().save(path);
 }
 
-void SceneManager::SetScenes(const std::vector<Scene>& scenes) {
-    m_scenes = scenes;
+void SceneManager::SetSaveWriteMode(PagedFile::WriteMode mode) {
+    m_eventPages.setWriteMode(mode);
+    m_mapTiles.setWriteMode(mode);
+    m_mapPages.setWriteMode(mode);
+}
+
+void SceneManager::SetSaveCompression(bool compressed) {
+    m_eventPages.setCompressed(compressed);
+    m_mapTiles.setCompressed(compressed);
+    m_mapPages.setCompressed(compressed);
+}
+
+bool SceneManager::CompactSaveData() {
+    bool ok = MapStore().compact();
+    return m_eventPages.compact() && ok;
+}
+
+bool SceneManager::RestoreSaveData(const PagedFile::Image& map, const PagedFile::Image& events) {
+    int mapReplaced = MapStore().restore(map);
+    int eventsReplaced = m_eventPages.restore(events);
+    // Compact 布局展开的场景可能已过时
+    m_scratchSceneId = -1;
+    if (mapReplaced < 0 || eventsReplaced < 0) {
+        std::cerr << "[SceneManager] Quicksave does not match the open SData/DData" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+PagedFile& SceneManager::MapStore() const {
+    if (m_sceneLayout == SceneLayout::Interleaved) return m_mapTiles;
+    return m_mapPages;
+}
+
+const TileLayer* SceneManager::SceneTiles(int sceneId) const {
+    if (sceneId < 0) return nullptr;
+    return m_mapPages.layers(static_cast<size_t>(sceneId));
+}
+
+const SceneManager::EventData* SceneManager::SceneEvents(int sceneId) const {
+    if (sceneId < 0) return nullptr;
+    return reinterpret_cast<const EventData*>(m_eventPages.read(static_cast<size_t>(sceneId)));
+}
+
+void SceneManager::SetScenes(SceneTable scenes) {
+    m_scenes = std::move(scenes);
     std::cout << "SceneManager: Set " << m_scenes.size() << " scenes." << std::endl;
     ResetEntrance();
 }
@@ -295,7 +389,7 @@ void SceneManager::SetCurrentScene(int sceneId) {
 }
 
 Scene* SceneManager::GetScene(int sceneId) {
-    if (sceneId < 0 || sceneId >= m_scenes.size()) return nullptr;
+    if (sceneId < 0 || sceneId >= static_cast<int>(m_scenes.size())) return nullptr;
     return &m_scenes[sceneId];
 }
 
@@ -304,15 +398,50 @@ int16_t SceneManager::GetSceneTile(int sceneId, int layer, int x, int y) const {
         return -1;
     }
     
-    size_t sceneOffset = sceneId * (SCENE_LAYERS * SCENE_MAP_SIZE * SCENE_MAP_SIZE);
-    size_t layerOffset = layer * (SCENE_MAP_SIZE * SCENE_MAP_SIZE);
     // Transposed access: x * 64 + y
-    size_t tileOffset = x * SCENE_MAP_SIZE + y;
-    
-    size_t index = sceneOffset + layerOffset + tileOffset;
-    if (index >= m_mapData.size()) return -1;
-    
-    return m_mapData[index];
+    size_t tile = x * SCENE_MAP_SIZE + y;
+    if (m_sceneLayout == SceneLayout::Interleaved) {
+        const int16_t* record = m_mapTiles.tile(static_cast<size_t>(sceneId), tile);
+        return record ? record[layer] : -1;
+    }
+
+    const TileLayer* layers = SceneTiles(sceneId);
+    if (!layers) return -1;
+    return layers[layer].get(tile);
+}
+
+bool SceneManager::GetSceneTileRecord(int sceneId, int x, int y, SceneTile& out) const {
+    if (x < 0 || x >= SCENE_MAP_SIZE || y < 0 || y >= SCENE_MAP_SIZE) return false;
+    SceneTileView tiles = GetSceneTiles(sceneId);
+    if (!tiles) return false;
+    out = tiles.at(x, y);
+    return true;
+}
+
+SceneTileView SceneManager::GetSceneTiles(int sceneId) const {
+    SceneTileView view;
+    if (sceneId < 0) return view;
+
+    if (m_sceneLayout == SceneLayout::Interleaved) {
+        // 驻留记录本身就是 [tile][layer]
+        view.m_tiles = reinterpret_cast<const SceneTile*>(m_mapTiles.tile(static_cast<size_t>(sceneId), 0));
+        return view;
+    }
+
+    if (m_scratchSceneId != sceneId) {
+        const TileLayer* layers = SceneTiles(sceneId);
+        if (!layers) return view;
+        const size_t count = SCENE_MAP_SIZE * SCENE_MAP_SIZE;
+        std::vector<int16_t> plane(count);
+        m_tileScratch.resize(count);
+        for (int l = 0; l < SCENE_LAYERS; ++l) {
+            layers[l].copyTo(plane.data());
+            for (size_t t = 0; t < count; ++t) m_tileScratch[t].layer[l] = plane[t];
+        }
+        m_scratchSceneId = sceneId;
+    }
+    view.m_tiles = m_tileScratch.data();
+    return view;
 }
 
 void SceneManager::SetSceneTile(int sceneId, int layer, int x, int y, int16_t value) {
@@ -320,87 +449,67 @@ void SceneManager::SetSceneTile(int sceneId, int layer, int x, int y, int16_t va
         return;
     }
     
-    size_t sceneOffset = sceneId * (SCENE_LAYERS * SCENE_MAP_SIZE * SCENE_MAP_SIZE);
-    size_t layerOffset = layer * (SCENE_MAP_SIZE * SCENE_MAP_SIZE);
     // Transposed access: x * 64 + y
-    size_t tileOffset = x * SCENE_MAP_SIZE + y;
-    
-    size_t index = sceneOffset + layerOffset + tileOffset;
-    if (index >= m_mapData.size()) return;
-    
-    m_mapData[index] = value;
+    size_t tile = x * SCENE_MAP_SIZE + y;
+
+    // 值不变时不标记 dirty，也不展开压缩的图层
+    if (m_sceneLayout == SceneLayout::Interleaved) {
+        const int16_t* record = m_mapTiles.tile(static_cast<size_t>(sceneId), tile);
+        if (!record || record[layer] == value) return;
+        m_mapTiles.modifyTile(static_cast<size_t>(sceneId), tile)[layer] = value;
+        return;
+    }
+
+    const TileLayer* layers = SceneTiles(sceneId);
+    if (!layers || layers[layer].get(tile) == value) return;
+    m_mapPages.modifyLayers(static_cast<size_t>(sceneId))[layer].set(tile, value);
+    if (m_scratchSceneId == sceneId) m_tileScratch[tile].layer[layer] = value;
 }
 
 int16_t SceneManager::GetWorldEarth(int x, int y) const {
-    if (x < 0 || x >= m_worldMapWidth || y < 0 || y >= m_worldMapHeight) return 0;
-    size_t idx = static_cast<size_t>(x) * m_worldMapWidth + y;
-    if (idx >= m_worldEarth.size()) return 0;
-    return m_worldEarth[idx];
+    const WorldTile* t = m_worldMap.tile(x, y);
+    return t ? t->earth : 0;
 }
 
 int16_t SceneManager::GetWorldSurface(int x, int y) const {
-    if (x < 0 || x >= m_worldMapWidth || y < 0 || y >= m_worldMapHeight) return 0;
-    size_t idx = static_cast<size_t>(x) * m_worldMapWidth + y;
-    if (idx >= m_worldSurface.size()) return 0;
-    return m_worldSurface[idx];
+    const WorldTile* t = m_worldMap.tile(x, y);
+    return t ? t->surface : 0;
 }
 
 int16_t SceneManager::GetWorldBuildX(int x, int y) const {
-    if (x < 0 || x >= m_worldMapWidth || y < 0 || y >= m_worldMapHeight) return 0;
-    size_t idx = static_cast<size_t>(x) * m_worldMapWidth + y;
-    if (idx >= m_worldBuildX.size()) return 0;
-    return m_worldBuildX[idx];
+    const WorldTile* t = m_worldMap.tile(x, y);
+    return t ? t->buildX : 0;
 }
 
 int16_t SceneManager::GetWorldBuildY(int x, int y) const {
-    if (x < 0 || x >= m_worldMapWidth || y < 0 || y >= m_worldMapHeight) return 0;
-    size_t idx = static_cast<size_t>(x) * m_worldMapWidth + y;
-    if (idx >= m_worldBuildY.size()) return 0;
-    return m_worldBuildY[idx];
+    const WorldTile* t = m_worldMap.tile(x, y);
+    return t ? t->buildY : 0;
 }
 
 void SceneManager::ResetEntrance() {
-    m_worldEntrance.assign(m_worldMapWidth * m_worldMapHeight, -1);
-    for (int i = 0; i < static_cast<int>(m_scenes.size()); ++i) {
-        const Scene& scene = m_scenes[i];
-        int x1 = scene.getMainEntranceX1();
-        int y1 = scene.getMainEntranceY1();
-        if (x1 >= 0 && x1 < m_worldMapWidth && y1 >= 0 && y1 < m_worldMapHeight) {
-            size_t idx = static_cast<size_t>(x1) * m_worldMapWidth + y1;
-            if (idx < m_worldEntrance.size()) {
-                m_worldEntrance[idx] = static_cast<int16_t>(i);
-            }
-        }
-        int x2 = scene.getMainEntranceX2();
-        int y2 = scene.getMainEntranceY2();
-        if (x2 >= 0 && x2 < m_worldMapWidth && y2 >= 0 && y2 < m_worldMapHeight) {
-            size_t idx = static_cast<size_t>(x2) * m_worldMapWidth + y2;
-            if (idx < m_worldEntrance.size()) {
-                m_worldEntrance[idx] = static_cast<int16_t>(i);
-            }
-        }
-    }
+    m_worldMap.resetEntrances(m_scenes);
 }
 
 int16_t SceneManager::GetEntrance(int x, int y) const {
-    if (x < 0 || x >= m_worldMapWidth || y < 0 || y >= m_worldMapHeight) return -1;
-    size_t idx = static_cast<size_t>(x) * m_worldMapWidth + y;
-    if (idx >= m_worldEntrance.size()) return -1;
-    return m_worldEntrance[idx];
+    const WorldTile* t = m_worldMap.tile(x, y);
+    return t ? t->entrance : -1;
 }
 
 int16_t SceneManager::GetEventData(int sceneId, int eventId, int index) const {
-    if (sceneId < 0 || sceneId >= m_eventData.size()) return 0;
     if (eventId < 0 || eventId >= 200) return 0;
     if (index < 0 || index >= 11) return 0;
-    return m_eventData[sceneId].data[eventId][index];
+    const EventData* events = SceneEvents(sceneId);
+    if (!events) return 0;
+    return events->data[eventId][index];
 }
 
 void SceneManager::SetEventData(int sceneId, int eventId, int index, int16_t value) {
-    if (sceneId < 0 || sceneId >= m_eventData.size()) return;
     if (eventId < 0 || eventId >= 200) return;
     if (index < 0 || index >= 11) return;
-    m_eventData[sceneId].data[eventId][index] = value;
+    const EventData* events = SceneEvents(sceneId);
+    if (!events || events->data[eventId][index] == value) return;
+    EventData* page = reinterpret_cast<EventData*>(m_eventPages.write(static_cast<size_t>(sceneId)));
+    page->data[eventId][index] = value;
 }
 
 void SceneManager::GetPositionOnScreen(int mapX, int mapY, int centerX, int centerY, int& outX, int& outY) {
@@ -414,9 +523,12 @@ void SceneManager::GetPositionOnScreen(int mapX, int mapY, int centerX, int cent
 
 bool SceneManager::CanWalk(int x, int y) {
     if (x < 0 || x >= SCENE_MAP_SIZE || y < 0 || y >= SCENE_MAP_SIZE) return false;
+    SceneTileView tiles = GetSceneTiles(m_currentSceneId);
+    if (!tiles) return false;
+    const SceneTile& cell = tiles.at(x, y);
     
     // Layer 1 check (Building/Obstacle)
-    int16_t tile1 = GetSceneTile(m_currentSceneId, 1, x, y);
+    int16_t tile1 = cell.layer[1];
     
     // Logic from KYS:
     // If tile1 > 0, it's an object/building.
@@ -429,7 +541,7 @@ bool SceneManager::CanWalk(int x, int y) {
     if (tile1 != 0) return false;
 
     // Layer 3 check (Events)
-    int16_t eventId = GetSceneTile(m_currentSceneId, 3, x, y);
+    int16_t eventId = cell.layer[3];
     if (eventId > 0) {
         int16_t pic = GetEventData(m_currentSceneId, eventId, 5);
         // If event has a picture, it is blocking (NPC, Chest, Object)
@@ -438,7 +550,7 @@ bool SceneManager::CanWalk(int x, int y) {
     }
     
     // Layer 0 (Ground) checks
-    int16_t tile0 = GetSceneTile(m_currentSceneId, 0, x, y);
+    int16_t tile0 = cell.layer[0];
     // Water checks (simplified)
     // 358-362, 522, 1022, 1324-1330, 1348 are water/unwalkable
     if ((tile0 >= 358 && tile0 <= 362) || tile0 == 522 || tile0 == 1022 || 
@@ -497,32 +609,45 @@ void SceneManager::UpdateEventPosition(int sceneId, int eventId, int oldX, int o
 }
 
 void SceneManager::RefreshEventLayer(int sceneId) {
-    if (sceneId < 0 || (size_t)sceneId >= m_eventData.size()) {
-        std::cerr << "[RefreshEventLayer] Invalid sceneId or eventData empty. Id: " << sceneId << " Size: " << m_eventData.size() << std::endl;
+    if (sceneId < 0 || (size_t)sceneId >= m_eventPages.count()) {
+        std::cerr << "[RefreshEventLayer] Invalid sceneId or eventData empty. Id: " << sceneId << " Size: " << m_eventPages.count() << std::endl;
         return;
     }
 
     std::cout << "[RefreshEventLayer] Refreshing Scene " << sceneId << "..." << std::endl;
     int count = 0;
 
+    // 先在本地拼出新的 Layer 3，再只写回不同的格子：
+    // 内容不变时场景保持干净，压缩的事件层也不会被展开
+    static int16_t eventLayer[SCENE_MAP_SIZE][SCENE_MAP_SIZE];
+
     // 1. 清空该场景的 Layer 3 (事件层)
     for (int x = 0; x < SCENE_MAP_SIZE; ++x) {
         for (int y = 0; y < SCENE_MAP_SIZE; ++y) {
-            SetSceneTile(sceneId, 3, x, y, -1); // -1 表示该位置无事件
+            eventLayer[x][y] = -1; // -1 表示该位置无事件
         }
     }
 
-    // 2. 根据 DData (m_eventData) 重新填充 Layer 3
+    // 2. 根据 DData (m_eventPages) 重新填充 Layer 3
     for (int e = 0; e < 200; ++e) {
         // DData 结构: Index 10 is X, Index 9 is Y
         int16_t x = GetEventData(sceneId, e, 10);
         int16_t y = GetEventData(sceneId, e, 9);
         
         if (x > 0 && x < SCENE_MAP_SIZE && y >= 0 && y < SCENE_MAP_SIZE) {
-            SetSceneTile(sceneId, 3, x, y, (int16_t)e);
+            eventLayer[x][y] = (int16_t)e;
             count++;
         }
     }
+
+    SceneTileView tiles = GetSceneTiles(sceneId);
+    if (!tiles) return;
+    for (int x = 0; x < SCENE_MAP_SIZE; ++x) {
+        const SceneTile* row = tiles.row(x);
+        for (int y = 0; y < SCENE_MAP_SIZE; ++y) {
+            if (row[y].layer[3] != eventLayer[x][y]) SetSceneTile(sceneId, 3, x, y, eventLayer[x][y]);
+        }
+    }
     std::cout << "[RefreshEventLayer] Refreshed " << count << " events." << std::endl;
 }
 
@@ -545,10 +670,10 @@ void SceneManager::DrawClouds(SDL_Renderer* renderer, int centerX, int centerY)
             // Draw using RLE
             // Note: This draws opaque clouds. Alpha blending would require a custom blender.
             // For now, satisfy the "draw" requirement.
-            if (cloud.picNum >= 0 && cloud.picNum < m_cloudIdxData.size()) {
+            if (cloud.picNum >= 0 && cloud.picNum < static_cast<int>(m_cloudIdxData.size())) {
                 int offset = m_cloudIdxData[cloud.picNum];
-                if (offset > 0 && offset < m_cloudPicData.size()) {
-                     GraphicsUtils::DrawRLE8(screen, sx, sy, &m_cloudPicData[offset], m_cloudPicData.size() - offset);
+                if (offset > 0 && offset < static_cast<int>(m_cloudPicData.size())) {
+                     DrawRLEPic(screen, m_cloudSprites, m_cloudPicData, cloud.picNum, offset, sx, sy);
                 }
             }
         }
@@ -556,13 +681,13 @@ void SceneManager::DrawClouds(SDL_Renderer* renderer, int centerX, int centerY)
 }
 
 void SceneManager::DrawWorldMap(SDL_Renderer* renderer, int centerX, int centerY) {
-    if (m_mmpIdxData.empty() || m_mmpPicData.empty() || m_worldEarth.empty()) {
+    if (m_mmpIdxData.empty() || m_mmpPicData.empty() || !m_worldMap.isLoaded()) {
         static bool loggedEmpty = false;
         if (!loggedEmpty) {
             std::cerr << "[DrawWorldMap] MaxMap or World resources empty! "
                       << "Idx: " << m_mmpIdxData.size()
                       << " Pic: " << m_mmpPicData.size()
-                      << " Earth: " << m_worldEarth.size() << std::endl;
+                      << " World: " << (m_worldMap.isLoaded() ? "loaded" : "missing") << std::endl;
             loggedEmpty = true;
         }
         return;
@@ -582,19 +707,16 @@ void SceneManager::DrawWorldMap(SDL_Renderer* renderer, int centerX, int centerY
             int i1 = centerX + i + (sum / 2);
             int i2 = centerY - i + (sum - sum / 2);
 
-            if (i1 < 0 || i1 >= m_worldMapWidth || i2 < 0 || i2 >= m_worldMapHeight) continue;
             // Visible range check (roughly match building loop range for consistency)
             // if (!(sum >= -29 && sum <= 41 && i >= -16 && i <= 16)) continue; 
-
-            int idx = i1 * m_worldMapWidth + i2;
-            // Check bounds just in case
-            if (idx < 0 || idx >= (int)m_worldEarth.size()) continue;
+            const WorldTile* tile = m_worldMap.tile(i1, i2);
+            if (!tile) continue;
 
             int sx, sy;
             GetPositionOnScreen(i1, i2, centerX, centerY, sx, sy);
 
             // Draw Earth (Ground)
-            int16_t eTile = m_worldEarth[idx];
+            int16_t eTile = tile->earth;
             {
                 int picNum = eTile / 2;
                 int offset = 0;
@@ -607,22 +729,22 @@ void SceneManager::DrawWorldMap(SDL_Renderer* renderer, int centerX, int centerY
                     }
                 }
                 if (offset >= 0 && offset < (int)m_mmpPicData.size()) {
-                    GraphicsUtils::DrawRLE8(GameManager::getInstance().getScreenSurface(), sx, sy,
-                                            &m_mmpPicData[offset], m_mmpPicData.size() - offset);
+                    DrawRLEPic(GameManager::getInstance().getScreenSurface(), m_mmpSprites, m_mmpPicData,
+                               picNum - 1, offset, sx, sy);
                 }
             }
 
             // Draw Surface (Decor/Roads/Trees)
-            if (!m_worldSurface.empty()) {
-                int16_t sTile = m_worldSurface[idx];
+            {
+                int16_t sTile = tile->surface;
                 if (sTile > 0) {
                     int picNum = sTile / 2;
                     int idxIndex = picNum - 1;
                     if (idxIndex >= 0 && idxIndex < (int)m_mmpIdxData.size()) {
                         int offset = m_mmpIdxData[idxIndex];
                         if (offset >= 0 && offset < (int)m_mmpPicData.size()) {
-                            GraphicsUtils::DrawRLE8(GameManager::getInstance().getScreenSurface(), sx, sy,
-                                                    &m_mmpPicData[offset], m_mmpPicData.size() - offset);
+                            DrawRLEPic(GameManager::getInstance().getScreenSurface(), m_mmpSprites, m_mmpPicData,
+                                       idxIndex, offset, sx, sy);
                         }
                     }
                 }
@@ -651,21 +773,14 @@ void SceneManager::DrawWorldMap(SDL_Renderer* renderer, int centerX, int centerY
             int i1 = centerX + i + (sum / 2);
             int i2 = centerY - i + (sum - sum / 2);
 
-            if (i1 < 0 || i1 >= m_worldMapWidth || i2 < 0 || i2 >= m_worldMapHeight) {
-                continue;
-            }
+            const WorldTile* tile = m_worldMap.tile(i1, i2);
+            if (!tile) continue;
 
-            int idx = i1 * m_worldMapWidth + i2;
-            if (idx < 0 || idx >= (int)m_worldBuilding.size()) continue;
-
-            int16_t tempPic = 0;
-            if (!m_worldBuilding.empty()) {
-                tempPic = m_worldBuilding[idx];
-            }
+            int16_t tempPic = tile->building;
             
             // Check Referenced Building Layer (BuildX)
-            if (tempPic == 0 && !m_worldBuildX.empty()) {
-                int16_t sceneId = m_worldBuildX[idx];
+            if (tempPic == 0) {
+                int16_t sceneId = tile->buildX;
                 if (sceneId > 0 && sceneId < (int)m_scenes.size()) {
                     int16_t mapNum = m_scenes[sceneId].getMapNum();
                     if (mapNum > 0) {
@@ -726,8 +841,8 @@ void SceneManager::DrawWorldMap(SDL_Renderer* renderer, int centerX, int centerY
         if (idxIndex >= 0 && idxIndex < (int)m_mmpIdxData.size()) {
             int offset = m_mmpIdxData[idxIndex];
             if (offset >= 0 && offset < (int)m_mmpPicData.size()) {
-                GraphicsUtils::DrawRLE8(GameManager::getInstance().getScreenSurface(), sx, sy,
-                                        &m_mmpPicData[offset], m_mmpPicData.size() - offset);
+                DrawRLEPic(GameManager::getInstance().getScreenSurface(), m_mmpSprites, m_mmpPicData,
+                           idxIndex, offset, sx, sy);
             }
         }
     }
@@ -777,10 +892,11 @@ void SceneManager::DrawScene(SDL_Renderer* renderer, int centerX, int centerY) {
     }
     
     // Check if Map Data is loaded
-    if (m_mapData.empty()) {
+    SceneTileView tiles = GetSceneTiles(m_currentSceneId);
+    if (!tiles) {
         static bool loggedMap = false;
         if (!loggedMap) {
-            std::cerr << "[DrawScene] CRITICAL: Map Data (allsin.grp) is empty! Cannot draw scene." << std::endl;
+            std::cerr << "[DrawScene] CRITICAL: Map Data (allsin.grp) is empty or scene " << m_currentSceneId << " is unavailable! Cannot draw scene." << std::endl;
             loggedMap = true;
         }
         return; // Nothing to draw
@@ -797,8 +913,8 @@ void SceneManager::DrawScene(SDL_Renderer* renderer, int centerX, int centerY) {
     bool hidePlayer = false;
             
     // Fill with active events
-    if (m_currentSceneId >= 0 && m_currentSceneId < (int)m_eventData.size()) {
-        const auto& events = m_eventData[m_currentSceneId].data;
+    if (const EventData* current = SceneEvents(m_currentSceneId)) {
+        const auto& events = current->data;
         // In Pascal, Scene.Data (SData) Layer 3 contains the Event Index.
         // We should iterate the visible area (or the whole map if small) and check Layer 3.
         
@@ -835,8 +951,11 @@ void SceneManager::DrawScene(SDL_Renderer* renderer, int centerX, int centerY) {
             // Check if visible (roughly)
             if (sx < -100 || sx > 640 + 100 || sy < -100 || sy > 480 + 100) continue;
 
+            // 一次取出这一格的全部图层
+            const SceneTile& cell = tiles.at(i, j);
+
             // Layer 0 (Ground)
-            int16_t t0 = GetSceneTile(m_currentSceneId, 0, i, j);
+            int16_t t0 = cell.layer[0];
             // Pascal: if SData > 0 then DrawSPic... else if < 0 DrawSNewPic...
             // For now assume > 0 (Standard)
             if (t0 != 0) {
@@ -845,16 +964,16 @@ void SceneManager::DrawScene(SDL_Renderer* renderer, int centerX, int centerY) {
             }
 
             // Layer 1 (Surface/Object)
-            int16_t t1 = GetSceneTile(m_currentSceneId, 1, i, j);
-            int16_t h1 = GetSceneTile(m_currentSceneId, 4, i, j); // Height
+            int16_t t1 = cell.layer[1];
+            int16_t h1 = cell.layer[4]; // Height
             if (t1 != 0) {
                  if (t1 > 0) DrawSmpSprite(renderer, t1 / 2 - 1, sx, sy - h1);
                  else DrawScenePicSprite(renderer, -t1 / 2 - 1, sx, sy - h1);
             }
             
             // Layer 2 (Above)
-            int16_t t2 = GetSceneTile(m_currentSceneId, 2, i, j);
-            int16_t h2 = GetSceneTile(m_currentSceneId, 5, i, j); // Height 2? Or same height?
+            int16_t t2 = cell.layer[2];
+            int16_t h2 = cell.layer[5]; // Height 2? Or same height?
             // Pascal uses SData[..., 5, ...] for Layer 2 height offset
             if (t2 != 0) {
                  if (t2 > 0) DrawSmpSprite(renderer, t2 / 2 - 1, sx, sy - h2);
@@ -863,12 +982,12 @@ void SceneManager::DrawScene(SDL_Renderer* renderer, int centerX, int centerY) {
             
             // Layer 3 (Events)
             // SData[..., 3, i, j] contains Event Index
-            int16_t eventIdx = GetSceneTile(m_currentSceneId, 3, i, j);
+            int16_t eventIdx = cell.layer[3];
             if (eventIdx >= 0) {
                 // Look up DData
                 int16_t pic = GetEventData(m_currentSceneId, eventIdx, 5);
                 if (pic != 0) {
-                     int16_t h = GetSceneTile(m_currentSceneId, 4, i, j); // Events usually stand on ground/object height
+                     int16_t h = cell.layer[4]; // Events usually stand on ground/object height
                      if (pic > 0) {
                          DrawSmpSprite(renderer, pic / 2 - 1, sx, sy - h);
                      } else {
@@ -885,7 +1004,7 @@ void SceneManager::DrawScene(SDL_Renderer* renderer, int centerX, int centerY) {
                 // Pascal: 2501 + SFace * 7 + SStep
                 // SFace: 0,1,2,3?
                 int playerPic = 2501 + face * 7 + step;
-                int16_t h = GetSceneTile(m_currentSceneId, 4, i, j);
+                int16_t h = cell.layer[4];
                 DrawSmpSprite(renderer, playerPic, sx, sy - h); // 2501 is index? No, 2501 is PicNum.
                 // Wait, DrawSmpSprite takes INDEX.
                 // Pascal: DrawSPic(2501...).
@@ -980,8 +1099,10 @@ void SceneManager::DrawScene(SDL_Renderer* renderer, int centerX, int centerY) {
             // Culling
             if (x < -200 || x > 840 || y < -200 || y > 680) continue; 
 
+            const SceneTile& cell = tiles.at(i1, i2);
+
             // Layer 0: Ground
-            int16_t tile0 = GetSceneTile(m_currentSceneId, 0, i1, i2);
+            int16_t tile0 = cell.layer[0];
             if (tile0 > 0) {
                 // Fix: Tile index off by one (user feedback)
                 // (tile / 2) - 1 maps 2 -> 0, 4 -> 1, etc.
@@ -989,21 +1110,21 @@ void SceneManager::DrawScene(SDL_Renderer* renderer, int centerX, int centerY) {
             }
             
             // Layer 1: Building
-            int16_t tile1 = GetSceneTile(m_currentSceneId, 1, i1, i2);
-            int16_t height1 = GetSceneTile(m_currentSceneId, 4, i1, i2);
+            int16_t tile1 = cell.layer[1];
+            int16_t height1 = cell.layer[4];
             if (tile1 > 0) {
                 DrawTile(renderer, (tile1 / 2) - 1, x, y - height1, 0, 0);
             }
             
             // Layer 2: Decor
-            int16_t tile2 = GetSceneTile(m_currentSceneId, 2, i1, i2);
-            int16_t height2 = GetSceneTile(m_currentSceneId, 5, i1, i2);
+            int16_t tile2 = cell.layer[2];
+            int16_t height2 = cell.layer[5];
             if (tile2 > 0) {
                 DrawTile(renderer, (tile2 / 2) - 1, x, y - height2, 0, 0);
             }
             
             // Layer 3: Event
-            int16_t tile3 = GetSceneTile(m_currentSceneId, 3, i1, i2);
+            int16_t tile3 = cell.layer[3];
             
             if (tile3 >= 0 && tile3 < 200) { // tile3 is Event ID (0..199)
                 // tile3 is eventIndex. Get EventData to find pic.
@@ -1042,15 +1163,15 @@ void SceneManager::DrawScene(SDL_Renderer* renderer, int centerX, int centerY) {
 static const float CHAR_SCALE = 1.15f;
 
 void SceneManager::DrawTile(SDL_Renderer* renderer, int picIndex, int x, int y, int offX, int offY) {
-    if (picIndex < 0 || picIndex >= m_smpIdxData.size()) return;
+    if (picIndex < 0 || picIndex >= static_cast<int>(m_smpIdxData.size())) return;
     
     int offset = m_smpIdxData[picIndex];
-    if (offset <= 0 || offset >= m_smpPicData.size()) return; // Offset 0 is usually invalid/empty
+    if (offset <= 0 || offset >= static_cast<int>(m_smpPicData.size())) return; // Offset 0 is usually invalid/empty
     
     SDL_Surface* screen = GameManager::getInstance().getScreenSurface();
     if (!screen) return;
     
-    GraphicsUtils::DrawRLE8(screen, x, y, &m_smpPicData[offset], m_smpPicData.size() - offset);
+    DrawRLEPic(screen, m_smpSprites, m_smpPicData, picIndex, offset, x, y);
 }
 
 void SceneManager::DrawSmpSprite(SDL_Renderer* renderer, int picIndex, int x, int y, int frame) {
@@ -1080,7 +1201,7 @@ void SceneManager::DrawSmpSprite(SDL_Renderer* renderer, int picIndex, int x, in
     //    std::cout << "[DrawSmpSprite] Drawing Pic " << picIndex << " at " << x << "," << y << " Offset: " << offset << std::endl;
     // }
     
-    GraphicsUtils::DrawRLE8(screen, x, y, &m_smpPicData[offset], m_smpPicData.size() - offset, 0, CHAR_SCALE);
+    DrawRLEPic(screen, m_smpSprites, m_smpPicData, picIndex, offset, x, y, CHAR_SCALE);
 }
 
 void SceneManager::DrawMmapSprite(SDL_Renderer* renderer, int picIndex, int x, int y, int frame) {
@@ -1093,7 +1214,18 @@ void SceneManager::DrawMmapSprite(SDL_Renderer* renderer, int picIndex, int x, i
     SDL_Surface* screen = GameManager::getInstance().getScreenSurface();
     if (!screen) return;
     
-    GraphicsUtils::DrawRLE8(screen, x, y, &m_mmpPicData[offset], m_mmpPicData.size() - offset, 0, CHAR_SCALE);
+    DrawRLEPic(screen, m_mmpSprites, m_mmpPicData, picIndex, offset, x, y, CHAR_SCALE);
+}
+
+void SceneManager::DrawRLEPic(SDL_Surface* screen, const SpriteCache& cache, const MappedFile& pics,
+                              int index, int offset, int x, int y, float scale) {
+    SpriteCache::Sprite sp;
+    if (index >= 0 && cache.get(index, sp)) {
+        GraphicsUtils::DrawIndexed8(screen, x, y, sp.w, sp.h, sp.x, sp.y, sp.stride, sp.pixels, sp.mask, 0, scale);
+        return;
+    }
+    if (offset < 0 || offset >= (int)pics.size()) return;
+    GraphicsUtils::DrawRLE8(screen, x, y, &pics[offset], pics.size() - offset, 0, scale);
 }
 
 void SceneManager::DrawScenePicSprite(SDL_Renderer* renderer, int picIndex, int x, int y, int frame) {
@@ -0,0 +1,340 @@
+#include "SpriteCache.h"
+#include "FileLoader.h"
+#include <SDL3_image/SDL_image.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+
+const char* SpriteCache::CACHE_DIR = "cache";
+
+namespace {
+    const char CACHE_MAGIC[8] = { 'K', 'Y', 'S', 'S', 'P', 'R', 'C', '\0' };
+    const uint32_t CACHE_VERSION = 1;
+    const size_t ALIGNMENT = 16;
+
+    size_t AlignUp(size_t v) {
+        return (v + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    }
+
+    // 组装缓存文件：头 | 条目表 | 16 字节对齐的位图
+    struct ImageBuilder {
+        std::vector<uint8_t> image;
+        size_t entryBase = 0;
+
+        ImageBuilder(uint32_t kind, uint32_t count, size_t headerSize, size_t entrySize) {
+            entryBase = headerSize;
+            image.resize(AlignUp(headerSize + entrySize * count), 0);
+            std::memcpy(image.data(), CACHE_MAGIC, sizeof(CACHE_MAGIC));
+            std::memcpy(image.data() + 8, &CACHE_VERSION, 4);
+            std::memcpy(image.data() + 12, &kind, 4);
+            std::memcpy(image.data() + 16, &count, 4);
+        }
+
+        // Reserve an aligned block, return its offset
+        size_t allocate(size_t size) {
+            size_t offset = AlignUp(image.size());
+            image.resize(offset + AlignUp(size), 0);
+            return offset;
+        }
+    };
+
+    uint64_t Fnv1a(uint64_t h, const uint8_t* data, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            h ^= data[i];
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+}
+
+bool SpriteCache::openRLE(const std::string& grpName, const std::string& idxName, const std::string& cacheName) {
+    return openOrBuild(KIND_RLE8, { grpName, idxName }, cacheName);
+}
+
+bool SpriteCache::openPic(const std::string& picName, const std::string& cacheName) {
+    return openOrBuild(KIND_ARGB, { picName }, cacheName);
+}
+
+void SpriteCache::close() {
+    m_file = MappedFile();
+    m_entries = nullptr;
+    m_count = 0;
+    m_kind = 0;
+}
+
+SpriteCache::SourceKey SpriteCache::statSources(const std::vector<std::string>& sources) {
+    SourceKey key;
+    for (const auto& name : sources) {
+        MappedFile packed = FileLoader::findPacked(name);
+        if (!packed.empty()) {
+            // 包内条目没有独立的修改时间，只能靠哈希校验
+            key.size += packed.size();
+            key.mtime = 0;
+            continue;
+        }
+
+        std::error_code ec;
+        std::filesystem::path path = FileLoader::getResourcePath(name);
+        uint64_t size = std::filesystem::file_size(path, ec);
+        if (ec) return SourceKey();
+        key.size += size;
+        auto mtime = std::filesystem::last_write_time(path, ec);
+        if (!ec) {
+            key.mtime = std::max<int64_t>(key.mtime, mtime.time_since_epoch().count());
+        }
+    }
+    return key;
+}
+
+uint64_t SpriteCache::hashSources(const std::vector<MappedFile>& data) {
+    uint64_t h = 14695981039346656037ull;
+    for (const auto& d : data) h = Fnv1a(h, d.data(), d.size());
+    return h;
+}
+
+bool SpriteCache::adopt(MappedFile file, Kind kind) {
+    if (file.size() < sizeof(CacheHeader)) return false;
+
+    CacheHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+        header.version != CACHE_VERSION || header.kind != kind) {
+        return false;
+    }
+    if (sizeof(CacheHeader) + uint64_t(header.count) * sizeof(CacheEntry) > file.size()) return false;
+
+    m_file = std::move(file);
+    m_entries = reinterpret_cast<const CacheEntry*>(m_file.data() + sizeof(CacheHeader));
+    m_count = header.count;
+    m_kind = kind;
+    return true;
+}
+
+bool SpriteCache::openOrBuild(Kind kind, const std::vector<std::string>& sources, const std::string& cacheName) {
+    close();
+
+    SourceKey key = statSources(sources);
+    if (key.size == 0) return false;
+
+    std::string cachePath = std::string(CACHE_DIR) + "/" + cacheName;
+    MappedFile cached = MappedFile::open(cachePath);
+
+    CacheHeader header;
+    bool headerOk = false;
+    if (cached.size() >= sizeof(header)) {
+        std::memcpy(&header, cached.data(), sizeof(header));
+        headerOk = std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0 &&
+                   header.version == CACHE_VERSION && header.kind == kind &&
+                   header.srcSize == key.size;
+    }
+
+    // 大小与修改时间都一致：不读源文件，直接使用
+    if (headerOk && key.mtime != 0 && header.srcMtime == key.mtime && adopt(cached, kind)) {
+        return true;
+    }
+
+    std::vector<MappedFile> data;
+    for (const auto& name : sources) {
+        data.push_back(FileLoader::mapFile(name));
+        if (data.back().empty()) return false;
+    }
+    key.hash = hashSources(data);
+
+    // 修改时间变了但内容没变 (例如重新拷贝了资源)
+    if (headerOk && header.srcHash == key.hash && adopt(cached, kind)) {
+        return true;
+    }
+    cached = MappedFile();
+
+    uint64_t startTicks = SDL_GetTicks();
+    std::vector<uint8_t> image = (kind == KIND_RLE8) ? buildRLE(data[0], data[1]) : buildPic(data[0]);
+    if (image.empty()) return false;
+
+    std::memcpy(image.data() + offsetof(CacheHeader, srcSize), &key.size, 8);
+    std::memcpy(image.data() + offsetof(CacheHeader, srcMtime), &key.mtime, 8);
+    std::memcpy(image.data() + offsetof(CacheHeader, srcHash), &key.hash, 8);
+
+    // 先写临时文件再改名，避免中途退出留下半个缓存
+    std::error_code ec;
+    std::filesystem::create_directories(CACHE_DIR, ec);
+    std::string tmpPath = cachePath + ".tmp";
+    bool written = false;
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (out) {
+            out.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+            written = out.good();
+        }
+    }
+    if (written) {
+        std::filesystem::rename(tmpPath, cachePath, ec);
+        written = !ec;
+    }
+    if (!written) {
+        std::filesystem::remove(tmpPath, ec);
+        std::cerr << "[SpriteCache] Could not write " << cachePath << ", using in-memory cache" << std::endl;
+    }
+
+    size_t bytes = image.size();
+    if (!adopt(MappedFile::fromBuffer(std::move(image)), kind)) return false;
+    std::cout << "[SpriteCache] Built " << cachePath << ": " << m_count << " sprites, " << bytes
+              << " bytes in " << (SDL_GetTicks() - startTicks) << " ms" << std::endl;
+    return true;
+}
+
+std::vector<uint8_t> SpriteCache::buildRLE(const MappedFile& grp, const MappedFile& idx) {
+    auto offsets = idx.as<int32_t>();
+    uint32_t count = static_cast<uint32_t>(offsets.size());
+    ImageBuilder builder(KIND_RLE8, count, sizeof(CacheHeader), sizeof(CacheEntry));
+
+    for (uint32_t i = 0; i < count; ++i) {
+        CacheEntry e;
+        std::memset(&e, 0, sizeof(e));
+
+        int32_t offset = offsets[i];
+        if (offset >= 0 && static_cast<size_t>(offset) + 8 <= grp.size()) {
+            // 与 GraphicsUtils::DrawRLE8 相同的解码规则
+            const uint8_t* raw = grp.data() + offset;
+            const uint8_t* end = grp.data() + grp.size();
+            int16_t w = static_cast<int16_t>(raw[0] | (raw[1] << 8));
+            int16_t h = static_cast<int16_t>(raw[2] | (raw[3] << 8));
+            int16_t xs = static_cast<int16_t>(raw[4] | (raw[5] << 8));
+            int16_t ys = static_cast<int16_t>(raw[6] | (raw[7] << 8));
+
+            auto decode = [&](auto&& plot) {
+                const uint8_t* ptr = raw + 8;
+                for (int iy = 0; iy < h; ++iy) {
+                    if (ptr >= end) break;
+                    uint8_t packets = *ptr++;
+                    int cx = 0;
+                    int state = 0;
+                    for (int ip = 0; ip < packets; ++ip) {
+                        if (ptr >= end) break;
+                        uint8_t val = *ptr++;
+                        if (state == 0) {
+                            cx += val;
+                            state = 1;
+                        } else if (state == 1) {
+                            state = 2 + val;
+                        } else {
+                            plot(cx, iy, val);
+                            cx++;
+                            state--;
+                            if (state == 2) state = 0;
+                        }
+                    }
+                }
+            };
+
+            // 第一遍求实际宽度 (原始数据可能越过声明的 w)
+            int width = std::max<int>(w, 0);
+            decode([&](int cx, int, uint8_t) { width = std::max(width, cx + 1); });
+
+            if (width > 0 && h > 0) {
+                size_t stride = AlignUp(static_cast<size_t>(width));
+                size_t plane = stride * static_cast<size_t>(h);
+                size_t base = builder.allocate(plane * 2);
+                decode([&](int cx, int iy, uint8_t val) {
+                    builder.image[base + iy * stride + cx] = val;
+                    builder.image[base + plane + iy * stride + cx] = 1;
+                });
+                e.w = width;
+                e.h = h;
+                e.x = xs;
+                e.y = ys;
+                e.stride = static_cast<uint32_t>(stride);
+                e.offset = base;
+            }
+        }
+        std::memcpy(builder.image.data() + builder.entryBase + i * sizeof(CacheEntry), &e, sizeof(e));
+    }
+    return builder.image;
+}
+
+std::vector<uint8_t> SpriteCache::buildPic(const MappedFile& pic) {
+    if (pic.size() < 4) return {};
+    int32_t count = 0;
+    std::memcpy(&count, pic.data(), 4);
+    if (count <= 0 || static_cast<size_t>(count + 1) * 4 > pic.size()) return {};
+
+    ImageBuilder builder(KIND_ARGB, static_cast<uint32_t>(count), sizeof(CacheHeader), sizeof(CacheEntry));
+
+    for (int32_t i = 0; i < count; ++i) {
+        CacheEntry e;
+        std::memset(&e, 0, sizeof(e));
+
+        // PicLoader::loadPic 的索引方式：表中第 i+1 项是第 i 张的结束偏移
+        int32_t start = (i == 0) ? (count + 1) * 4 : 0;
+        int32_t endOffset = 0;
+        if (i > 0) std::memcpy(&start, pic.data() + i * 4, 4);
+        std::memcpy(&endOffset, pic.data() + (i + 1) * 4, 4);
+        int32_t pngLen = endOffset - start - 12;
+
+        if (pngLen > 0 && start >= 0 && static_cast<size_t>(start) + 12 + pngLen <= pic.size()) {
+            const uint8_t* ptr = pic.data() + start;
+            std::memcpy(&e.x, ptr, 4);
+            std::memcpy(&e.y, ptr + 4, 4);
+            std::memcpy(&e.black, ptr + 8, 4);
+
+            SDL_Surface* decoded = nullptr;
+            SDL_IOStream* io = SDL_IOFromConstMem(ptr + 12, pngLen);
+            if (io) decoded = IMG_Load_IO(io, true);
+            SDL_Surface* argb = decoded ? SDL_ConvertSurface(decoded, SDL_PIXELFORMAT_ARGB8888) : nullptr;
+            if (decoded) SDL_DestroySurface(decoded);
+
+            if (argb && SDL_LockSurface(argb)) {
+                size_t rowBytes = static_cast<size_t>(argb->w) * 4;
+                size_t stride = AlignUp(rowBytes);
+                size_t base = builder.allocate(stride * argb->h);
+                for (int y = 0; y < argb->h; ++y) {
+                    std::memcpy(builder.image.data() + base + y * stride,
+                                static_cast<const uint8_t*>(argb->pixels) + y * argb->pitch, rowBytes);
+                }
+                SDL_UnlockSurface(argb);
+                e.w = argb->w;
+                e.h = argb->h;
+                e.stride = static_cast<uint32_t>(stride);
+                e.offset = base;
+            }
+            if (argb) SDL_DestroySurface(argb);
+        }
+        std::memcpy(builder.image.data() + builder.entryBase + i * sizeof(CacheEntry), &e, sizeof(e));
+    }
+    return builder.image;
+}
+
+bool SpriteCache::get(int index, Sprite& out) const {
+    if (index < 0 || static_cast<uint32_t>(index) >= m_count) return false;
+
+    CacheEntry e;
+    std::memcpy(&e, &m_entries[index], sizeof(e));
+    if (e.w <= 0 || e.h <= 0) return false;
+
+    size_t plane = static_cast<size_t>(e.stride) * e.h;
+    if (e.offset + plane * (m_kind == KIND_RLE8 ? 2 : 1) > m_file.size()) return false;
+
+    out.w = e.w;
+    out.h = e.h;
+    out.x = e.x;
+    out.y = e.y;
+    out.black = e.black;
+    out.stride = static_cast<int>(e.stride);
+    out.pixels = m_file.data() + e.offset;
+    out.mask = (m_kind == KIND_RLE8) ? out.pixels + plane : nullptr;
+    return true;
+}
+
+SDL_Surface* SpriteCache::createSurface(int index) const {
+    Sprite sp;
+    if (m_kind != KIND_ARGB || !get(index, sp)) return nullptr;
+
+    SDL_Surface* surface = SDL_CreateSurface(sp.w, sp.h, SDL_PIXELFORMAT_ARGB8888);
+    if (!surface) return nullptr;
+    for (int y = 0; y < sp.h; ++y) {
+        std::memcpy(static_cast<uint8_t*>(surface->pixels) + y * surface->pitch,
+                    sp.pixels + static_cast<size_t>(y) * sp.stride, static_cast<size_t>(sp.w) * 4);
+    }
+    return surface;
+}
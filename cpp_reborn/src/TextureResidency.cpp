@@ -0,0 +1,82 @@
+#include "TextureResidency.h"
+#include <iomanip>
+
+void TextureResidency::init(int slotCount, LoadFunc loader, uint64_t idleReleaseMs) {
+    releaseAll();
+    m_slots.assign(slotCount > 0 ? slotCount : 0, Slot());
+    m_loader = std::move(loader);
+    m_idleReleaseMs = idleReleaseMs;
+}
+
+SDL_Texture* TextureResidency::acquire(int slot) {
+    if (slot < 0 || slot >= static_cast<int>(m_slots.size())) return nullptr;
+    Slot& s = m_slots[slot];
+    s.stats.lastUsedMs = SDL_GetTicks();
+
+    if (s.texture) {
+        ++s.stats.hits;
+        return s.texture;
+    }
+    if (s.missing || !m_loader) return nullptr;
+
+    s.texture = m_loader(slot);
+    if (!s.texture) {
+        s.missing = true;
+        return nullptr;
+    }
+    ++s.stats.loads;
+    float w = 0, h = 0;
+    SDL_GetTextureSize(s.texture, &w, &h);
+    s.stats.bytes = static_cast<uint64_t>(w) * static_cast<uint64_t>(h) * 4;
+    return s.texture;
+}
+
+int TextureResidency::trim(uint64_t nowMs) {
+    int released = 0;
+    for (auto& s : m_slots) {
+        if (s.texture && nowMs >= s.stats.lastUsedMs && nowMs - s.stats.lastUsedMs >= m_idleReleaseMs) {
+            SDL_DestroyTexture(s.texture);
+            s.texture = nullptr;
+            ++s.stats.evictions;
+            ++released;
+        }
+    }
+    return released;
+}
+
+void TextureResidency::releaseAll() {
+    for (auto& s : m_slots) {
+        if (s.texture) {
+            SDL_DestroyTexture(s.texture);
+            s.texture = nullptr;
+        }
+    }
+}
+
+int TextureResidency::residentCount() const {
+    int n = 0;
+    for (const auto& s : m_slots) {
+        if (s.texture) ++n;
+    }
+    return n;
+}
+
+uint64_t TextureResidency::residentBytes() const {
+    uint64_t total = 0;
+    for (const auto& s : m_slots) {
+        if (s.texture) total += s.stats.bytes;
+    }
+    return total;
+}
+
+void TextureResidency::printStats(std::ostream& os, const char* const* names) const {
+    os << "[TextureResidency] " << residentCount() << "/" << m_slots.size() << " resident, "
+       << (residentBytes() / 1024) << " KB" << std::endl;
+    for (size_t i = 0; i < m_slots.size(); ++i) {
+        const Slot& s = m_slots[i];
+        os << "  " << std::setw(2) << i << " " << std::left << std::setw(12) << (names ? names[i] : "")
+           << std::right << (s.texture ? " resident" : " released")
+           << "  loads=" << s.stats.loads << " hits=" << s.stats.hits
+           << " evictions=" << s.stats.evictions << " size=" << (s.stats.bytes / 1024) << "KB" << std::endl;
+    }
+}
@@ -0,0 +1,188 @@
+#include "TileLayer.h"
+#include <cstring>
+
+void TileLayer::assign(const int16_t* tiles, size_t count) {
+    clear();
+    m_size = std::min<size_t>(count, 65536);
+    m_kind = Kind::Dense;
+    m_dense.assign(tiles, tiles + m_size);
+    compact();
+}
+
+void TileLayer::clear() {
+    m_kind = Kind::Dense;
+    m_size = 0;
+    m_fill = 0;
+    std::vector<int16_t>().swap(m_dense);
+    std::vector<uint16_t>().swap(m_index);
+    std::vector<int16_t>().swap(m_values);
+}
+
+void TileLayer::copyTo(int16_t* out) const {
+    switch (m_kind) {
+    case Kind::Dense:
+        if (m_size > 0) std::memcpy(out, m_dense.data(), m_size * sizeof(int16_t));
+        break;
+    case Kind::Runs:
+        for (size_t r = 0; r < m_index.size(); ++r) {
+            size_t end = (r + 1 < m_index.size()) ? m_index[r + 1] : m_size;
+            std::fill(out + m_index[r], out + end, m_values[r]);
+        }
+        break;
+    case Kind::Sparse:
+        std::fill(out, out + m_size, m_fill);
+        for (size_t k = 0; k < m_index.size(); ++k) out[m_index[k]] = m_values[k];
+        break;
+    }
+}
+
+void TileLayer::set(size_t i, int16_t value) {
+    if (i >= m_size || get(i) == value) return;
+    if (m_kind != Kind::Dense) {
+        std::vector<int16_t> dense(m_size);
+        copyTo(dense.data());
+        std::vector<uint16_t>().swap(m_index);
+        std::vector<int16_t>().swap(m_values);
+        m_dense.swap(dense);
+        m_kind = Kind::Dense;
+    }
+    m_dense[i] = value;
+}
+
+void TileLayer::compact() {
+    if (m_size == 0) return;
+    std::vector<int16_t> tiles(m_size);
+    copyTo(tiles.data());
+
+    // 游程数
+    size_t runs = 1;
+    for (size_t i = 1; i < m_size; ++i) {
+        if (tiles[i] != tiles[i - 1]) ++runs;
+    }
+
+    // 出现最多的值作为 Sparse 的填充值
+    std::vector<int16_t> sorted(tiles);
+    std::sort(sorted.begin(), sorted.end());
+    int16_t fill = sorted[0];
+    size_t best = 0;
+    for (size_t i = 0; i < sorted.size();) {
+        size_t j = i;
+        while (j < sorted.size() && sorted[j] == sorted[i]) ++j;
+        if (j - i > best) {
+            best = j - i;
+            fill = sorted[i];
+        }
+        i = j;
+    }
+    size_t exceptions = m_size - best;
+
+    // 每个条目 4 字节 (下标 + 值)；至少省一半才放弃 Dense 的直接寻址
+    size_t denseBytes = m_size * sizeof(int16_t);
+    size_t runBytes = runs * 4;
+    size_t sparseBytes = exceptions * 4;
+
+    std::vector<uint16_t>().swap(m_index);
+    std::vector<int16_t>().swap(m_values);
+    if (sparseBytes * 2 <= denseBytes && sparseBytes <= runBytes) {
+        m_kind = Kind::Sparse;
+        m_fill = fill;
+        m_index.reserve(exceptions);
+        m_values.reserve(exceptions);
+        for (size_t i = 0; i < m_size; ++i) {
+            if (tiles[i] != fill) {
+                m_index.push_back(static_cast<uint16_t>(i));
+                m_values.push_back(tiles[i]);
+            }
+        }
+        std::vector<int16_t>().swap(m_dense);
+    } else if (runBytes * 2 <= denseBytes) {
+        m_kind = Kind::Runs;
+        m_index.reserve(runs);
+        m_values.reserve(runs);
+        for (size_t i = 0; i < m_size; ++i) {
+            if (i == 0 || tiles[i] != tiles[i - 1]) {
+                m_index.push_back(static_cast<uint16_t>(i));
+                m_values.push_back(tiles[i]);
+            }
+        }
+        std::vector<int16_t>().swap(m_dense);
+    } else {
+        m_kind = Kind::Dense;
+        m_dense.swap(tiles);
+    }
+}
+
+size_t TileLayer::memoryBytes() const {
+    return m_dense.capacity() * sizeof(int16_t) + m_index.capacity() * sizeof(uint16_t) +
+           m_values.capacity() * sizeof(int16_t);
+}
+
+void TileLayerFile::resize(size_t count) {
+    m_layers.clear();
+    m_layers.resize(count * m_layerCount);
+}
+
+void TileLayerFile::decode(size_t index, const uint8_t* raw) {
+    // raw 来自字节缓冲，不保证 2 字节对齐
+    std::vector<int16_t> tiles(m_tilesPerLayer);
+    for (size_t l = 0; l < m_layerCount; ++l) {
+        std::memcpy(tiles.data(), raw + l * m_tilesPerLayer * sizeof(int16_t), m_tilesPerLayer * sizeof(int16_t));
+        m_layers[index * m_layerCount + l].assign(tiles.data(), tiles.size());
+    }
+}
+
+void TileLayerFile::encode(size_t index, uint8_t* out) const {
+    std::vector<int16_t> tiles(m_tilesPerLayer);
+    for (size_t l = 0; l < m_layerCount; ++l) {
+        m_layers[index * m_layerCount + l].copyTo(tiles.data());
+        std::memcpy(out + l * m_tilesPerLayer * sizeof(int16_t), tiles.data(), m_tilesPerLayer * sizeof(int16_t));
+    }
+}
+
+void TileLayerFile::release(size_t index) {
+    for (size_t l = 0; l < m_layerCount; ++l) m_layers[index * m_layerCount + l].clear();
+}
+
+size_t TileLayerFile::payloadBytes(size_t index) const {
+    size_t total = 0;
+    for (size_t l = 0; l < m_layerCount; ++l) total += m_layers[index * m_layerCount + l].memoryBytes();
+    return total;
+}
+
+void TileLayerFile::onWritten(size_t index) {
+    // 写入时展开成 Dense 的图层重新压缩
+    for (size_t l = 0; l < m_layerCount; ++l) m_layers[index * m_layerCount + l].compact();
+}
+
+void InterleavedTileFile::resize(size_t count) {
+    m_tiles.clear();
+    m_tiles.resize(count);
+}
+
+void InterleavedTileFile::decode(size_t index, const uint8_t* raw) {
+    std::vector<int16_t>& tiles = m_tiles[index];
+    tiles.resize(m_layerCount * m_tilesPerLayer);
+    for (size_t l = 0; l < m_layerCount; ++l) {
+        const uint8_t* plane = raw + l * m_tilesPerLayer * sizeof(int16_t);
+        for (size_t t = 0; t < m_tilesPerLayer; ++t) {
+            int16_t v;
+            std::memcpy(&v, plane + t * sizeof(int16_t), sizeof(int16_t));
+            tiles[t * m_layerCount + l] = v;
+        }
+    }
+}
+
+void InterleavedTileFile::encode(size_t index, uint8_t* out) const {
+    const std::vector<int16_t>& tiles = m_tiles[index];
+    for (size_t l = 0; l < m_layerCount; ++l) {
+        uint8_t* plane = out + l * m_tilesPerLayer * sizeof(int16_t);
+        for (size_t t = 0; t < m_tilesPerLayer; ++t) {
+            int16_t v = tiles[t * m_layerCount + l];
+            std::memcpy(plane + t * sizeof(int16_t), &v, sizeof(int16_t));
+        }
+    }
+}
+
+void InterleavedTileFile::release(size_t index) {
+    std::vector<int16_t>().swap(m_tiles[index]);
+}
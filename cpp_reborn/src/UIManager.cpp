@@ -4,14 +4,22 @@
 #include "SoundManager.h"
 #include "TextManager.h"
 #include "GraphicsUtils.h"
+#include "FrameStreamer.h"
+#include "SaveSlotInfo.h"
 #include <SDL3/SDL.h>
 #include <SDL3_ttf/SDL_ttf.h>
 #include <iostream>
 #include <cmath>
+#include <ctime>
 #include <algorithm>
 
 namespace {
     std::string g_loadedFontPath;
+
+    const char* const kSystemTextureNames[] = {
+        "title", "magic", "state", "system", "map", "skill",
+        "menu_esc", "menu_back", "battle", "teammate", "item"
+    };
 }
 
 UIManager& UIManager::getInstance() {
@@ -64,17 +72,8 @@ void UIManager::Cleanup() {
         TTF_CloseFont(m_font);
         m_font = nullptr;
     }
-    if (m_texTitle) SDL_DestroyTexture(m_texTitle);
-    if (m_texMagic) SDL_DestroyTexture(m_texMagic);
-    if (m_texState) SDL_DestroyTexture(m_texState);
-    if (m_texSystem) SDL_DestroyTexture(m_texSystem);
-    if (m_texMap) SDL_DestroyTexture(m_texMap);
-    if (m_texSkill) SDL_DestroyTexture(m_texSkill);
-    if (m_texMenuEsc) SDL_DestroyTexture(m_texMenuEsc);
-    if (m_texMenuEscBack) SDL_DestroyTexture(m_texMenuEscBack);
-    if (m_texBattle) SDL_DestroyTexture(m_texBattle);
-    if (m_texTeammate) SDL_DestroyTexture(m_texTeammate);
-    if (m_texMenuItem) SDL_DestroyTexture(m_texMenuItem);
+    PrintTextureStats();
+    m_systemTextures.releaseAll();
     if (m_texMenuBackground) SDL_DestroyTexture(m_texMenuBackground);
     
     TTF_Quit();
@@ -90,36 +89,76 @@ SDL_Color UIManager::Uint32ToColor(uint32_t color) {
 }
 
 bool UIManager::LoadSystemGraphics() {
-    if (m_texTitle) return true; 
-
-    auto loadTex = [&](int index) -> SDL_Texture* {
-        PicImage pic = PicLoader::loadPic("resource/Background.Pic", index);
-        if (pic.surface) {
-            SDL_Texture* tex = SDL_CreateTextureFromSurface(m_renderer, pic.surface);
-            if (tex) {
-                SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND); // 确保透明通道生效
+    if (m_systemTextures.isInitialized()) return true;
+
+    // 只建立索引，不创建纹理；各菜单第一次绘制时才加载对应底图 (见 GetSystemTexture)。
+    // 预解码缓存命中时直接把 ARGB 像素上传为纹理，省去 PNG 解码，打开菜单不会卡顿。
+    m_backgroundSprites.openPic("resource/Background.Pic", "background.kcc");
+
+    m_systemTextures.init(SYSTEM_TEXTURE_COUNT, [this](int index) -> SDL_Texture* {
+        SDL_Texture* tex = nullptr;
+        SpriteCache::Sprite sp;
+        if (m_backgroundSprites.isOpen() && m_backgroundSprites.get(index, sp)) {
+            tex = SDL_CreateTexture(m_renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, sp.w, sp.h);
+            if (tex) SDL_UpdateTexture(tex, NULL, sp.pixels, sp.stride);
+        } else {
+            PicImage pic = PicLoader::loadPic("resource/Background.Pic", index);
+            if (pic.surface) {
+                tex = SDL_CreateTextureFromSurface(m_renderer, pic.surface);
+                PicLoader::freePic(pic);
             }
-            PicLoader::freePic(pic);
-            return tex;
         }
-        return nullptr;
-    };
+        if (tex) {
+            SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND); // 确保透明通道生效
+        }
+        return tex;
+    }, SYSTEM_TEXTURE_IDLE_MS);
 
-    m_texTitle = loadTex(0);
-    m_texMagic = loadTex(1);
-    m_texState = loadTex(2);
-    m_texSystem = loadTex(3);
-    m_texMap = loadTex(4);
-    m_texSkill = loadTex(5);
-    m_texMenuEsc = loadTex(6);
-    m_texMenuEscBack = loadTex(7);
-    m_texBattle = loadTex(8);
-    m_texTeammate = loadTex(9);
-    m_texMenuItem = loadTex(10);
-    
     return true;
 }
 
+SDL_Texture* UIManager::GetSystemTexture(SystemTexture id) {
+    if (!m_systemTextures.isInitialized()) LoadSystemGraphics();
+    return m_systemTextures.acquire(id);
+}
+
+bool UIManager::ReloadResource(const std::string& name) {
+    if (name != "background.pic") return false;
+    // 纹理下次使用时从新缓存重新创建
+    m_systemTextures.releaseAll();
+    m_backgroundSprites.openPic("resource/Background.Pic", "background.kcc");
+    return true;
+}
+
+void UIManager::PrintTextureStats() const {
+    m_systemTextures.printStats(std::cout, kSystemTextureNames);
+}
+
+void UIManager::ReportMemory(MemoryStats& stats) const {
+    const char* owner = "UIManager";
+    stats.add(owner, "background.kcc", m_backgroundSprites.sizeBytes(), m_backgroundSprites.count(),
+              m_backgroundSprites.isMapped());
+    stats.add(owner, "system_textures", m_systemTextures.residentBytes(), m_systemTextures.residentCount(), false, true);
+
+    uint64_t bytes = 0, count = 0;
+    for (SDL_Texture* tex : { m_texBeginBackground, m_texMenuBackground }) {
+        float w = 0, h = 0;
+        if (tex && SDL_GetTextureSize(tex, &w, &h)) {
+            bytes += static_cast<uint64_t>(w) * static_cast<uint64_t>(h) * 4;
+            ++count;
+        }
+    }
+    stats.add(owner, "backdrops", bytes, count, false, true);
+}
+
+void UIManager::TrimSystemGraphics() {
+    // 每秒检查一次即可
+    uint64_t now = SDL_GetTicks();
+    if (now - m_lastTrimMs < 1000) return;
+    m_lastTrimMs = now;
+    m_systemTextures.trim(now);
+}
+
 void UIManager::CaptureScreen() {
     if (m_texMenuBackground) {
         SDL_DestroyTexture(m_texMenuBackground);
@@ -127,8 +166,16 @@ void UIManager::CaptureScreen() {
     }
     // In SDL3, use SDL_RenderReadPixels to get surface
     SDL_Surface* surface = SDL_RenderReadPixels(m_renderer, NULL);
+    m_saveThumbnail.clear();
     if (surface) {
         m_texMenuBackground = SDL_CreateTextureFromSurface(m_renderer, surface);
+        // 顺便缩成存档缩略图 (几千个像素，只在打开菜单时做一次)
+        SDL_Surface* argb = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_ARGB8888);
+        if (argb) {
+            m_saveThumbnail = SaveSlotInfo::downscale(static_cast<const uint32_t*>(argb->pixels), argb->w, argb->h,
+                                                      argb->pitch, SAVE_THUMB_W, SAVE_THUMB_H);
+            SDL_DestroySurface(argb);
+        }
         SDL_DestroySurface(surface);
     }
 }
@@ -187,12 +234,14 @@ void UIManager::DrawHead(int headId, int x, int y) {
 }
 
 void UIManager::RenderMenuSystem(int menuSelection) {
-    if (m_texMenuEscBack) {
+    SDL_Texture* texMenuEscBack = GetSystemTexture(TEX_MENU_ESC_BACK);
+    SDL_Texture* texMenuEsc = GetSystemTexture(TEX_MENU_ESC);
+    if (texMenuEscBack) {
         // 底图贴图 (Index 7) 包含两个横向并列的 300x300 圆环
         // Pascal 源码中使用 (0, 0, 300, 300) 作为显示底图
         SDL_FRect src = { 0, 0, 300, 300 };
         SDL_FRect dest = { 170, 70, 300, 300 };
-        SDL_RenderTexture(m_renderer, m_texMenuEscBack, &src, &dest);
+        SDL_RenderTexture(m_renderer, texMenuEscBack, &src, &dest);
     }
     
     int x = 270;
@@ -213,14 +262,14 @@ void UIManager::RenderMenuSystem(int menuSelection) {
         SDL_FRect src = { srcX, srcY, 100, 100 };
         SDL_FRect dest = { (float)positionX[i], (float)positionY[i], 100, 100 };
         
-        if (m_texMenuEsc) {
-            SDL_RenderTexture(m_renderer, m_texMenuEsc, &src, &dest);
+        if (texMenuEsc) {
+            SDL_RenderTexture(m_renderer, texMenuEsc, &src, &dest);
         }
     }
 }
 
 void UIManager::ShowMenu() {
-    if (!m_texMenuEsc) LoadSystemGraphics();
+    LoadSystemGraphics();
     
     CaptureScreen();
 
@@ -327,10 +376,10 @@ void UIManager::SelectShowStatus() {
 }
 
 void UIManager::ShowStatus(int roleId) {
-    if (!m_texState) LoadSystemGraphics();
+    SDL_Texture* texState = GetSystemTexture(TEX_STATE);
 
-    if (m_texState) {
-        SDL_RenderTexture(m_renderer, m_texState, NULL, NULL);
+    if (texState) {
+        SDL_RenderTexture(m_renderer, texState, NULL, NULL);
     }
     
     Role& role = GameManager::getInstance().getRole(roleId);
@@ -484,7 +533,7 @@ void UIManager::ShowStatus(int roleId) {
 }
 
 void UIManager::SelectShowMagic() {
-    if (!m_texMagic) LoadSystemGraphics();
+    LoadSystemGraphics();
     
     auto& game = GameManager::getInstance();
     const auto& team = game.getTeamList();
@@ -534,10 +583,10 @@ void UIManager::SelectShowMagic() {
 }
 
 void UIManager::ShowMagic(int roleId, int selectedIndex) {
-    if (!m_texMagic) LoadSystemGraphics();
+    SDL_Texture* texMagic = GetSystemTexture(TEX_MAGIC);
 
-    if (m_texMagic) {
-        SDL_RenderTexture(m_renderer, m_texMagic, NULL, NULL);
+    if (texMagic) {
+        SDL_RenderTexture(m_renderer, texMagic, NULL, NULL);
     }
 
     Role& role = GameManager::getInstance().getRole(roleId);
@@ -665,9 +714,9 @@ void UIManager::SelectShowSystem() {
 }
 
 void UIManager::ShowSystem(int selectedIndex) {
-    if (!m_texSystem) LoadSystemGraphics();
-    if (m_texSystem) {
-        SDL_RenderTexture(m_renderer, m_texSystem, NULL, NULL);
+    SDL_Texture* texSystem = GetSystemTexture(TEX_SYSTEM);
+    if (texSystem) {
+        SDL_RenderTexture(m_renderer, texSystem, NULL, NULL);
     }
 
     const char* labels[] = {
@@ -764,9 +813,9 @@ void UIManager::SelectShowSkill() {
 }
 
 void UIManager::ShowSkill(int petId, int selectedIndex) {
-    if (!m_texSkill) LoadSystemGraphics();
-    if (m_texSkill) {
-        SDL_RenderTexture(m_renderer, m_texSkill, NULL, NULL);
+    SDL_Texture* texSkill = GetSystemTexture(TEX_SKILL);
+    if (texSkill) {
+        SDL_RenderTexture(m_renderer, texSkill, NULL, NULL);
     }
     // TODO: Implement actual pet display logic from Pascal
     DrawShadowTextUtf8(" ————目前尚無寵物————", 120, 50, 0xFFFFFFFF, 0x000000FF);
@@ -815,9 +864,9 @@ void UIManager::SelectShowTeammate() {
 }
 
 void UIManager::ShowTeammate(int tMenu, int rMenu, int position) {
-    if (!m_texTeammate) LoadSystemGraphics();
-    if (m_texTeammate) {
-        SDL_RenderTexture(m_renderer, m_texTeammate, NULL, NULL);
+    SDL_Texture* texTeammate = GetSystemTexture(TEX_TEAMMATE);
+    if (texTeammate) {
+        SDL_RenderTexture(m_renderer, texTeammate, NULL, NULL);
     }
 
     int x1 = 120;
@@ -873,9 +922,9 @@ void UIManager::SelectShowItem() {
 }
 
 void UIManager::ShowItem(int menuSelection) {
-    if (!m_texMenuItem) LoadSystemGraphics();
-    if (m_texMenuItem) {
-        SDL_RenderTexture(m_renderer, m_texMenuItem, NULL, NULL);
+    SDL_Texture* texMenuItem = GetSystemTexture(TEX_MENU_ITEM);
+    if (texMenuItem) {
+        SDL_RenderTexture(m_renderer, texMenuItem, NULL, NULL);
     }
 
     const char* labels[] = { " 全部物品", " 劇情物品", " 神兵寶甲", " 武功秘笈", " 靈丹妙藥", " 傷人暗器" };
@@ -958,44 +1007,41 @@ void UIManager::PlayTitleAnimation() {
     int frameCount = PicLoader::getPicCount("resource/Begin.Pic");
     if (frameCount <= 0) return;
 
-    bool skip = false;
-    SDL_Event event;
-
     // 播放开场动画 (Begin.Pic)
-    for (int i = 0; i < frameCount && !skip; ++i) {
+    // 工作线程提前解码几帧并转换好像素格式，主线程只负责上传纹理和按 40ms 节拍呈现
+    // (同步 Pascal 的 sdl_delay(20))
+    FrameStreamer streamer;
+    streamer.start(frameCount, [](int index) -> SDL_Surface* {
+        PicImage pic = PicLoader::loadPic("resource/Begin.Pic", index);
+        if (!pic.surface) return nullptr;
+        SDL_Surface* frame = SDL_ConvertSurface(pic.surface, SDL_PIXELFORMAT_ARGB8888);
+        PicLoader::freePic(pic);
+        return frame;
+    });
+
+    FrameStreamer::PlaybackOptions options;
+    options.frameIntervalMs = 40;
+    options.shouldStop = []() {
         // 检测跳过输入
+        SDL_Event event;
         while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_EVENT_QUIT) {
-                skip = true;
-                break;
-            }
+            if (event.type == SDL_EVENT_QUIT) return true;
             if (event.type == SDL_EVENT_KEY_UP) {
                 if (event.key.key == SDLK_ESCAPE || event.key.key == SDLK_RETURN || event.key.key == SDLK_SPACE) {
-                    skip = true;
-                    break;
+                    return true;
                 }
             }
         }
-
-        PicImage pic = PicLoader::loadPic("resource/Begin.Pic", i);
-        if (pic.surface) {
-            SDL_Texture* tex = SDL_CreateTextureFromSurface(m_renderer, pic.surface);
-            if (tex) {
-                SDL_RenderClear(m_renderer);
-                
-                // 模拟 Pascal 的 ZoomPic 逻辑，拉伸至全屏
-                int w, h;
-                SDL_GetWindowSize(m_window, &w, &h);
-                SDL_FRect dest = { 0.0f, 0.0f, (float)w, (float)h };
-                SDL_RenderTexture(m_renderer, tex, NULL, &dest);
-                
-                SDL_RenderPresent(m_renderer);
-                SDL_DestroyTexture(tex);
-            }
-            PicLoader::freePic(pic);
-        }
-        SDL_Delay(40); // 同步 Pascal 的 sdl_delay(20)
-    }
+        return false;
+    };
+    options.draw = [this](SDL_Renderer* renderer, SDL_Texture* tex) {
+        // 模拟 Pascal 的 ZoomPic 逻辑，拉伸至全屏
+        int w, h;
+        SDL_GetWindowSize(m_window, &w, &h);
+        SDL_FRect dest = { 0.0f, 0.0f, (float)w, (float)h };
+        SDL_RenderTexture(renderer, tex, NULL, &dest);
+    };
+    streamer.play(m_renderer, options);
 
     // 动画播放完后，加载 Background.Pic 的 Index 1 作为开始菜单背景
     if (m_texBeginBackground) {
@@ -1087,11 +1133,47 @@ bool UIManager::ShowSaveLoadMenu(bool isSave) {
     SDL_Event event;
     const int SLOT_COUNT = 6;
     const char* slots[] = { "進度一", "進度二", "進度三", "進度四", "進度五", "自動檔" };
+    // 自動檔: 自动存档轮换时指最近写的那一个
+    const int autoSlot = GameManager::getInstance().LatestAutoSaveSlot();
+    auto slotOf = [autoSlot](int i) { return (i == 5) ? autoSlot : (i + 1); };
     bool loaded = false;
 
+    // 各存档位的说明只读 R*.inf 的头部；缩略图在第一次选中时才读
+    SaveSlotInfo infos[SLOT_COUNT];
+    bool hasInfo[SLOT_COUNT] = {};
+    SDL_Texture* thumbs[SLOT_COUNT] = {};
+    bool thumbTried[SLOT_COUNT] = {};
+    auto readInfos = [&]() {
+        for (int i = 0; i < SLOT_COUNT; ++i) {
+            hasInfo[i] = GameManager::getInstance().ReadSaveSlotInfo(slotOf(i), infos[i]);
+            if (thumbs[i]) SDL_DestroyTexture(thumbs[i]);
+            thumbs[i] = nullptr;
+            thumbTried[i] = false;
+        }
+    };
+    auto thumbFor = [&](int i) -> SDL_Texture* {
+        if (!hasInfo[i] || thumbTried[i]) return thumbs[i];
+        thumbTried[i] = true;
+        SaveSlotInfo full;
+        if (GameManager::getInstance().ReadSaveSlotInfo(slotOf(i), full, true) && !full.thumbnail.empty()) {
+            thumbs[i] = SDL_CreateTexture(m_renderer, SDL_PIXELFORMAT_RGB565, SDL_TEXTUREACCESS_STATIC,
+                                          full.thumbWidth, full.thumbHeight);
+            if (thumbs[i]) SDL_UpdateTexture(thumbs[i], NULL, full.thumbnail.data(), full.thumbWidth * 2);
+        }
+        return thumbs[i];
+    };
+    auto releaseThumbs = [&]() {
+        for (SDL_Texture*& thumb : thumbs) {
+            if (thumb) SDL_DestroyTexture(thumb);
+            thumb = nullptr;
+        }
+    };
+    readInfos();
+
     while (running) {
         while (SDL_PollEvent(&event)) {
             if (event.type == SDL_EVENT_QUIT) {
+                releaseThumbs();
                 GameManager::getInstance().Quit();
                 return false;
             }
@@ -1104,10 +1186,14 @@ bool UIManager::ShowSaveLoadMenu(bool isSave) {
                     currentSelection = (currentSelection + SLOT_COUNT - 1) % SLOT_COUNT;
                 } else if (event.key.key == SDLK_RETURN || event.key.key == SDLK_SPACE) {
                     if (isSave) {
-                        GameManager::getInstance().SaveGame((currentSelection == 5) ? 6 : (currentSelection + 1));
-                        ShowDialogue("進度已保存", 0, 0); 
+                        // 后台写盘，完成后由 GameManager 更新提示
+                        if (GameManager::getInstance().SaveGame(slotOf(currentSelection))) {
+                            SetStatusMessage("正在保存…", 10000);
+                        } else {
+                            ShowDialogue("保存失敗", 0, 0);
+                        }
                     } else {
-                        loaded = GameManager::getInstance().LoadGame((currentSelection == 5) ? 6 : (currentSelection + 1));
+                        loaded = GameManager::getInstance().LoadGame(slotOf(currentSelection));
                         if (loaded) {
                             running = false;
                         } else {
@@ -1135,9 +1221,38 @@ bool UIManager::ShowSaveLoadMenu(bool isSave) {
             DrawShadowTextUtf8(slots[i], 170 + i * 70, 160, color, 0x000000FF);
         }
 
+        // 选中存档位的说明: 缩略图、场景、队首等级、存档时间
+        const int sel = currentSelection;
+        if (hasInfo[sel]) {
+            const SaveSlotInfo& info = infos[sel];
+            if (SDL_Texture* thumb = thumbFor(sel)) {
+                SDL_FRect dst = { 170.0f, 200.0f, (float)info.thumbWidth, (float)info.thumbHeight };
+                SDL_RenderTexture(m_renderer, thumb, NULL, &dst);
+            }
+            TextManager& text = TextManager::getInstance();
+            std::string place = (info.sceneId < 0) ? std::string("大地圖") : text.nameToUtf8(info.sceneName);
+            place += " (" + std::to_string(info.mapX) + "," + std::to_string(info.mapY) + ")";
+            DrawShadowTextUtf8(place, 270, 200, 0xFFFFFFFF, 0x000000FF);
+            if (!info.leadName.empty()) {
+                DrawShadowTextUtf8(text.nameToUtf8(info.leadName) + " 等級 " + std::to_string(info.leadLevel),
+                                   270, 225, 0xFFFFFFFF, 0x000000FF);
+            }
+            DrawShadowTextUtf8("隊伍 " + std::to_string(info.team.size()) + " 人", 270, 250, 0xFFFFFFFF, 0x000000FF);
+            char when[32] = {};
+            std::time_t t = static_cast<std::time_t>(info.savedAt);
+            if (const std::tm* local = std::localtime(&t)) std::strftime(when, sizeof(when), "%Y-%m-%d %H:%M", local);
+            DrawShadowTextUtf8(when, 270, 275, 0xFFFFFFFF, 0x000000FF);
+        } else {
+            DrawShadowTextUtf8("（無說明）", 270, 200, 0xAAAAAAFF, 0x000000FF);
+        }
+
+        // 后台存档写完后重读说明
+        if (GameManager::getInstance().PollSaves() > 0) readInfos();
+        DrawStatusMessage();
         SDL_RenderPresent(m_renderer);
         SDL_Delay(16);
     }
+    releaseThumbs();
     return loaded;
 }
 
@@ -1525,3 +1640,17 @@ void UIManager::FlashScreen(uint32_t color, int durationMs) {
 void UIManager::UpdateScreen() {
     SDL_RenderPresent(m_renderer);
 }
+
+void UIManager::SetStatusMessage(const std::string& textUtf8, uint32_t durationMs) {
+    m_statusMessage = textUtf8;
+    m_statusUntilMs = SDL_GetTicks() + durationMs;
+}
+
+void UIManager::DrawStatusMessage() {
+    if (m_statusMessage.empty()) return;
+    if (SDL_GetTicks() >= m_statusUntilMs) {
+        m_statusMessage.clear();
+        return;
+    }
+    DrawShadowTextUtf8(m_statusMessage, 20, 440, 0xFFFF00FF, 0x000000FF);
+}
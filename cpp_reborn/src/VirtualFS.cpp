@@ -0,0 +1,150 @@
+#include "VirtualFS.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <cctype>
+
+namespace fs = std::filesystem;
+
+namespace {
+    bool EndsWith(const std::string& s, const std::string& suffix) {
+        return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    std::string Trim(const std::string& s) {
+        size_t b = s.find_first_not_of(" \t\r\n");
+        if (b == std::string::npos) return "";
+        size_t e = s.find_last_not_of(" \t\r\n");
+        return s.substr(b, e - b + 1);
+    }
+}
+
+bool VirtualFS::mount(const std::string& root) {
+    std::error_code ec;
+    Layer layer;
+    layer.root = root;
+    int index = static_cast<int>(m_layers.size());
+    size_t added = 0;
+
+    if (fs::is_directory(root, ec)) {
+        m_layers.push_back(std::move(layer));
+        for (fs::recursive_directory_iterator it(root, ec), end; it != end; it.increment(ec)) {
+            if (ec) break;
+            if (!it->is_regular_file(ec)) continue;
+            Entry e;
+            e.layer = index;
+            e.name = ResourcePack::normalizeName(it->path().lexically_relative(root).generic_string());
+            e.path = it->path().generic_string();
+            if (ec || e.name.empty()) continue;
+            addEntry(std::move(e));
+            ++added;
+        }
+    } else if (fs::is_regular_file(root, ec)) {
+        auto pack = std::make_unique<ResourcePack>();
+        if (!pack->open(root)) {
+            std::cerr << "[VirtualFS] Failed to mount pack: " << root << std::endl;
+            return false;
+        }
+        layer.pack = std::move(pack);
+        m_layers.push_back(std::move(layer));
+        const ResourcePack& p = *m_layers.back().pack;
+        for (size_t i = 0; i < p.entryCount(); ++i) {
+            Entry e;
+            e.layer = index;
+            e.name = p.entryName(i);
+            if (e.name.empty()) continue;
+            addEntry(std::move(e));
+            ++added;
+        }
+    } else {
+        std::cerr << "[VirtualFS] Layer not found: " << root << std::endl;
+        return false;
+    }
+
+    std::cout << "[VirtualFS] Mounted layer " << index << ": " << root << " (" << added << " files)" << std::endl;
+    return true;
+}
+
+void VirtualFS::clear() {
+    m_entries.clear();
+    m_records.clear();
+    m_layers.clear();
+}
+
+void VirtualFS::addEntry(Entry entry) {
+    // "<grp>.d/<n>[.ext]" 为单条记录覆盖
+    size_t slash = entry.name.rfind('/');
+    if (slash != std::string::npos && slash >= 2 && entry.name.compare(slash - 2, 2, ".d") == 0) {
+        std::string grp = entry.name.substr(0, slash - 2);
+        std::string file = entry.name.substr(slash + 1);
+        size_t digits = 0;
+        while (digits < file.size() && std::isdigit(static_cast<unsigned char>(file[digits]))) ++digits;
+        if (!grp.empty() && digits > 0 && digits <= 9 && (digits == file.size() || file[digits] == '.')) {
+            m_records[grp][std::stoi(file.substr(0, digits))] = entry;
+        }
+    }
+
+    // 上层提供了整个 grp: 下层的单条记录覆盖是针对旧 grp 的，丢掉 (同一层的保留)
+    auto records = m_records.find(entry.name);
+    if (records != m_records.end()) {
+        RecordOverrides& overrides = records->second;
+        for (auto it = overrides.begin(); it != overrides.end();) {
+            it = it->second.layer < entry.layer ? overrides.erase(it) : std::next(it);
+        }
+        if (overrides.empty()) m_records.erase(records);
+    }
+
+    std::string key = entry.name;
+    auto shadowed = m_entries.find(key);
+    if (shadowed != m_entries.end() && shadowed->second.layer < entry.layer && !shadowed->second.path.empty()) {
+        ++m_layers[entry.layer].shadowedFiles;
+    }
+    m_entries[key] = std::move(entry);
+}
+
+const VirtualFS::Entry* VirtualFS::find(const std::string& name) const {
+    if (m_entries.empty()) return nullptr;
+    auto it = m_entries.find(ResourcePack::normalizeName(name));
+    return it != m_entries.end() ? &it->second : nullptr;
+}
+
+MappedFile VirtualFS::map(const Entry& entry) const {
+    if (entry.layer < 0 || entry.layer >= static_cast<int>(m_layers.size())) return {};
+    const Layer& layer = m_layers[entry.layer];
+    if (layer.pack) return layer.pack->find(entry.name);
+    return MappedFile::open(entry.path);
+}
+
+const VirtualFS::RecordOverrides* VirtualFS::recordOverrides(const std::string& grpName) const {
+    if (m_records.empty()) return nullptr;
+    auto it = m_records.find(ResourcePack::normalizeName(grpName));
+    return it != m_records.end() ? &it->second : nullptr;
+}
+
+std::vector<std::string> VirtualFS::discoverMods(const std::string& modsDir) {
+    std::vector<std::string> roots;
+    std::error_code ec;
+    if (!fs::is_directory(modsDir, ec)) return roots;
+
+    std::ifstream order((fs::path(modsDir) / "load_order.txt").string());
+    if (order) {
+        std::string line;
+        while (std::getline(order, line)) {
+            line = Trim(line);
+            if (line.empty() || line[0] == '#') continue;
+            roots.push_back((fs::path(modsDir) / line).generic_string());
+        }
+        return roots;
+    }
+
+    for (const auto& entry : fs::directory_iterator(modsDir, ec)) {
+        std::string name = entry.path().filename().string();
+        std::string lower = ResourcePack::normalizeName(name);
+        if (entry.is_directory(ec) || (entry.is_regular_file(ec) && EndsWith(lower, ".pak"))) {
+            roots.push_back(entry.path().generic_string());
+        }
+    }
+    std::sort(roots.begin(), roots.end());
+    return roots;
+}
@@ -0,0 +1,125 @@
+#include "WorldMap.h"
+#include "FileLoader.h"
+#include <iostream>
+
+namespace {
+    std::vector<int16_t> LoadLayer(const std::string& filename) {
+        size_t bytes = 0;
+        auto layer = FileLoader::loadFileAs<int16_t>(filename, &bytes);
+        if (layer.empty()) {
+            layer = FileLoader::loadFileAs<int16_t>("resource/" + filename, &bytes);
+            if (layer.empty()) {
+                return {};
+            }
+        }
+        if (bytes != WorldMap::SIZE * WorldMap::SIZE * 2) {
+            std::cerr << "[WorldMap] Warning: " << filename
+                      << " size mismatch, expect " << (WorldMap::SIZE * WorldMap::SIZE * 2)
+                      << " bytes, got " << bytes << std::endl;
+        }
+        return layer;
+    }
+}
+
+bool WorldMap::load() {
+    auto earth    = LoadLayer("EARTH.002");
+    auto surface  = LoadLayer("surface.002");
+    auto building = LoadLayer("building.002");
+    auto buildX   = LoadLayer("buildx.002");
+    auto buildY   = LoadLayer("buildy.002");
+
+    if (earth.empty()) {
+        std::cerr << "[WorldMap] Failed to load EARTH.002" << std::endl;
+        return false;
+    }
+
+    if (surface.empty() || building.empty() || buildX.empty() || buildY.empty()) {
+        std::cerr << "[WorldMap] Warning: some world layers missing. "
+                  << "Surface=" << surface.size()
+                  << " Building=" << building.size()
+                  << " BuildX=" << buildX.size()
+                  << " BuildY=" << buildY.size() << std::endl;
+    }
+
+    assign(earth, surface, building, buildX, buildY);
+    std::cout << "[WorldMap] World layers loaded, " << SIZE << "x" << SIZE << " tiles" << std::endl;
+    return true;
+}
+
+void WorldMap::assign(const std::vector<int16_t>& earth, const std::vector<int16_t>& surface,
+                      const std::vector<int16_t>& building, const std::vector<int16_t>& buildX,
+                      const std::vector<int16_t>& buildY) {
+    const size_t count = static_cast<size_t>(SIZE) * SIZE;
+    auto at = [](const std::vector<int16_t>& layer, size_t i) -> int16_t {
+        return i < layer.size() ? layer[i] : 0;
+    };
+
+    // 保留已有的入口 (重载图层时场景入口不变)
+    std::vector<WorldTile> tiles(count);
+    for (size_t i = 0; i < count; ++i) {
+        WorldTile& t = tiles[i];
+        t.earth = at(earth, i);
+        t.surface = at(surface, i);
+        t.building = at(building, i);
+        t.buildX = at(buildX, i);
+        t.buildY = at(buildY, i);
+        if (i < m_tiles.size()) t.entrance = m_tiles[i].entrance;
+        t.flags = computeFlags(static_cast<int>(i / SIZE), static_cast<int>(i % SIZE), t);
+    }
+    m_tiles.swap(tiles);
+}
+
+uint16_t WorldMap::computeFlags(int x, int y, const WorldTile& t) {
+    // 与原 GameManager::CanWalkWorld 的判断顺序完全相同
+    const int16_t earth = t.earth;
+    const int16_t surface = t.surface;
+    uint16_t flags = 0;
+
+    bool canwalk = (t.buildX == 0);
+    if (x <= 0 || x >= SIZE - 1 || y <= 0 || y >= SIZE - 1 ||
+        (surface >= 1692 && surface <= 1700)) {
+        canwalk = false;
+    }
+    if (earth == 838 || (earth >= 612 && earth <= 670)) {
+        canwalk = false;
+    }
+
+    if ((earth >= 358 && earth <= 362) ||
+        (earth >= 506 && earth <= 670) ||
+        (earth >= 1016 && earth <= 1022)) {
+        flags |= WATER;
+        if (earth == 838 || (earth >= 612 && earth <= 670)) {
+            canwalk = false;
+        } else if (surface >= 1746 && surface <= 1788) {
+            canwalk = false;
+        } else {
+            canwalk = true;
+        }
+    }
+
+    int surfaceHalf = surface / 2;
+    if ((surfaceHalf >= 863 && surfaceHalf <= 872) ||
+        (surfaceHalf >= 852 && surfaceHalf <= 854) ||
+        (surfaceHalf >= 858 && surfaceHalf <= 860)) {
+        canwalk = true;
+    }
+
+    if (canwalk) flags |= WALKABLE;
+    return flags;
+}
+
+void WorldMap::resetEntrances(const SceneTable& scenes) {
+    if (m_tiles.empty()) return;
+    for (auto& t : m_tiles) t.entrance = -1;
+
+    auto mark = [this](int x, int y, int sceneId) {
+        if (x >= 0 && x < SIZE && y >= 0 && y < SIZE) {
+            m_tiles[static_cast<size_t>(x) * SIZE + y].entrance = static_cast<int16_t>(sceneId);
+        }
+    };
+    for (int i = 0; i < static_cast<int>(scenes.size()); ++i) {
+        const Scene& scene = scenes[i];
+        mark(scene.getMainEntranceX1(), scene.getMainEntranceY1(), i);
+        mark(scene.getMainEntranceX2(), scene.getMainEntranceY2(), i);
+    }
+}
@@ -0,0 +1,100 @@
+// kys_pack: 把 resource 目录打包成单文件资源包 (kys.pak)
+// 用法: kys_pack [--compress] <resource_dir> [output.pak]
+// 默认输出到 <resource_dir>/kys.pak，运行时 FileLoader 会优先使用它。
+#include <iostream>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <map>
+#include "ResourcePack.h"
+
+namespace fs = std::filesystem;
+
+int main(int argc, char* argv[]) {
+    bool compress = false;
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--compress" || a == "-c") {
+            compress = true;
+        } else {
+            args.push_back(a);
+        }
+    }
+
+    if (args.empty()) {
+        std::cerr << "Usage: kys_pack [--compress] <resource_dir> [output.pak]" << std::endl;
+        return 1;
+    }
+
+    fs::path root = args[0];
+    if (!fs::is_directory(root)) {
+        std::cerr << "Not a directory: " << root.string() << std::endl;
+        return 1;
+    }
+    fs::path outPath = args.size() > 1 ? fs::path(args[1]) : root / "kys.pak";
+
+    std::vector<ResourcePack::BuildInput> inputs;
+    uint64_t totalBytes = 0;
+    std::error_code ec;
+    for (auto it = fs::recursive_directory_iterator(root, ec); it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        if (ec) break;
+        if (!it->is_regular_file()) continue;
+
+        // 不把旧的包自己打进去
+        std::error_code eqEc;
+        if (fs::equivalent(it->path(), outPath, eqEc) || it->path().filename() == "kys.pak") continue;
+
+        ResourcePack::BuildInput input;
+        input.name = fs::relative(it->path(), root).generic_string();
+        input.path = it->path().string();
+        std::error_code sizeEc;
+        uint64_t size = it->file_size(sizeEc);
+        if (sizeEc) {
+            std::cerr << "Cannot read " << input.path << ": " << sizeEc.message() << std::endl;
+            return 1;
+        }
+        totalBytes += size;
+        inputs.push_back(input);
+    }
+
+    if (ec) {
+        std::cerr << "Cannot list " << root.string() << ": " << ec.message() << std::endl;
+        return 1;
+    }
+
+    // 按名字排序，输出稳定，同目录的文件在包内相邻
+    std::sort(inputs.begin(), inputs.end(), [](const ResourcePack::BuildInput& a, const ResourcePack::BuildInput& b) {
+        return a.name < b.name;
+    });
+
+    // 包内查找不分大小写: 只差大小写的两个文件打进去后只能找到一个
+    std::map<std::string, std::string> byKey;
+    bool collision = false;
+    for (const auto& input : inputs) {
+        auto inserted = byKey.emplace(ResourcePack::normalizeName(input.name), input.path);
+        if (!inserted.second) {
+            std::cerr << "Names differ only by case: " << inserted.first->second << " and " << input.path << std::endl;
+            collision = true;
+        }
+    }
+    if (collision) return 1;
+
+    std::cout << "Packing " << inputs.size() << " files (" << totalBytes << " bytes) from " << root.string()
+              << (compress ? " with compression" : "") << std::endl;
+
+    if (!ResourcePack::write(outPath.string(), inputs, compress)) {
+        std::cerr << "Failed to write " << outPath.string() << std::endl;
+        return 1;
+    }
+
+    ResourcePack check;
+    if (!check.open(outPath.string()) || check.entryCount() != inputs.size()) {
+        std::cerr << "Verification failed for " << outPath.string() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Wrote " << outPath.string() << " (" << fs::file_size(outPath) << " bytes)" << std::endl;
+    return 0;
+}
@@ -1,10 +1,53 @@
 #include "GameManager.h"
+#include "SceneManager.h"
+#include "FileLoader.h"
 #include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
 
 int main(int argc, char* argv[]) {
     std::cout << "Starting KYS C++ Refactor Project..." << std::endl;
     
     GameManager& game = GameManager::getInstance();
+
+    // --compact-scenes: 场景图层压缩存放 (省内存，绘制稍慢)，须在读入存档之前设置
+    // --journal-saves: 场景存档改动追加到 .jnl，退出时合并
+    // --compressed-saves: 存档写成压缩容器 (读档总能识别两种格式)
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--compact-scenes") == 0) {
+            SceneManager::getInstance().SetSceneLayout(SceneLayout::Compact);
+        }
+        if (std::strcmp(argv[i], "--journal-saves") == 0) {
+            SceneManager::getInstance().SetSaveWriteMode(PagedFile::WriteMode::Journal);
+        }
+        if (std::strcmp(argv[i], "--compressed-saves") == 0) {
+            game.SetSaveCompression(true);
+        }
+        // --dev: 资源读入内存而不是映射，编辑器截断正在映射的文件时不会崩溃 (须在 Init 之前)
+        if (std::strcmp(argv[i], "--dev") == 0) {
+            FileLoader::setReadLooseFiles(true);
+        }
+    }
+
+    // --export-raw-save <slot> <dir>: 把存档转成原版格式写到 dir 后退出 (只读写文件，不需要窗口和音频)
+    for (int i = 1; i + 2 < argc; ++i) {
+        if (std::strcmp(argv[i], "--export-raw-save") == 0) {
+            bool ok = game.ExportRawSave(std::atoi(argv[i + 1]), argv[i + 2]);
+            return ok ? 0 : 1;
+        }
+    }
+
+    // --autosave-slots <n>: 自动存档在 R6 .. R(5+n) 之间轮换 (0 关闭，默认 1 = 原版的自動檔)
+    // --autosave-interval <秒>: 定时自动存档 (0 只在场景切换时存)
+    AutoSaveConfig autoSave;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--autosave-slots") == 0) autoSave.slotCount = std::max(0, std::atoi(argv[i + 1]));
+        if (std::strcmp(argv[i], "--autosave-interval") == 0) {
+            autoSave.intervalMs = static_cast<uint64_t>(std::max(0, std::atoi(argv[i + 1]))) * 1000;
+        }
+    }
+    game.SetAutoSaveConfig(autoSave);
     
     // Initialize the engine and load data
     if (!game.Init()) {
@@ -12,6 +55,13 @@ int main(int argc, char* argv[]) {
         return -1;
     }
     
+    // --dev: 监视资源目录，修改后热重载
+    // --memstats: 启动后打印一次内存统计 (游戏中按 F9 随时打印)
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--dev") == 0) game.EnableDevMode();
+        if (std::strcmp(argv[i], "--memstats") == 0) game.PrintMemoryReport();
+    }
+
     // Enter the main game loop
     game.Run();
     
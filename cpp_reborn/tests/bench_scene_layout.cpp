@@ -0,0 +1,172 @@
+// 场景图层布局对比: 原 [layer][x][y] 平面数组 / TileLayer 紧凑图层 / 按格交错
+// 每种布局都完整扫描 64x64 场景并读取一格的 6 个图层。
+// "per tile" 每格都经 PagedFile 取一次场景 (LRU 更新，与 GetSceneTile 相同)；
+// "per scan" 每次扫描只取一次，之后直接按下标读 (与 DrawScene 经 SceneTileView 的访问方式相同)。
+// planar (memory) 是不经 PagedFile 的原版数组，只作参考。
+// 用法: bench_scene_layout [iterations]
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <filesystem>
+#include <cstdlib>
+#include "TileLayer.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr int MAP = 64;
+    constexpr int LAYERS = 6;
+    constexpr int TILES = MAP * MAP;
+
+    // 接近真实场景的数据: 地面每格不同，建筑/装饰成片，事件层与高度层大多为 -1 / 0
+    std::vector<int16_t> MakeScene(std::mt19937& rng) {
+        std::vector<int16_t> s(LAYERS * TILES, 0);
+        std::uniform_int_distribution<int> pic(1, 3000);
+        std::uniform_int_distribution<int> pct(0, 99);
+        for (int t = 0; t < TILES; ++t) {
+            s[0 * TILES + t] = static_cast<int16_t>(pic(rng) * 2);
+            s[1 * TILES + t] = (t / 256) % 3 == 0 ? static_cast<int16_t>(400 + (t / 512) * 2) : 0;
+            s[2 * TILES + t] = pct(rng) < 5 ? static_cast<int16_t>(pic(rng) * 2) : 0;
+            s[3 * TILES + t] = pct(rng) < 2 ? static_cast<int16_t>(pct(rng)) : -1;
+            s[4 * TILES + t] = s[1 * TILES + t] ? 8 : 0;
+            s[5 * TILES + t] = s[2 * TILES + t] ? 4 : 0;
+        }
+        return s;
+    }
+
+    template <typename Fn>
+    double NsPerTile(int iterations, Fn&& scan) {
+        long long sink = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int it = 0; it < iterations; ++it) sink += scan();
+        auto end = std::chrono::steady_clock::now();
+        if (sink == 42) std::cout << "";
+        double ns = std::chrono::duration<double, std::nano>(end - start).count();
+        return ns / (static_cast<double>(iterations) * TILES);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 2000;
+    const int sceneCount = 8;
+    const int sceneId = 3;
+
+    std::mt19937 rng(12345);
+    std::vector<int16_t> planar;
+    for (int s = 0; s < sceneCount; ++s) {
+        auto scene = MakeScene(rng);
+        planar.insert(planar.end(), scene.begin(), scene.end());
+    }
+
+    const fs::path file = fs::absolute("bench_scene_layout.grp");
+    {
+        std::ofstream f(file, std::ios::binary | std::ios::trunc);
+        f.write(reinterpret_cast<const char*>(planar.data()), planar.size() * sizeof(int16_t));
+    }
+
+    RawPagedFile paged;
+    TileLayerFile compact(LAYERS, TILES);
+    InterleavedTileFile interleaved(LAYERS, TILES);
+    if (!paged.open(file.string(), LAYERS * TILES * sizeof(int16_t), sceneCount) ||
+        !compact.open(file.string(), sceneCount) || !interleaved.open(file.string(), sceneCount)) {
+        std::cerr << "Failed to open " << file << std::endl;
+        return 1;
+    }
+
+    // 原布局: 每次 GetSceneTile 都重新计算 scene/layer 偏移
+    auto planarGet = [&](int layer, int x, int y) -> int16_t {
+        size_t index = static_cast<size_t>(sceneId) * LAYERS * TILES + static_cast<size_t>(layer) * TILES + x * MAP + y;
+        return index < planar.size() ? planar[index] : -1;
+    };
+
+    double planarNs = NsPerTile(iterations, [&]() {
+        long long sum = 0;
+        for (int x = 0; x < MAP; ++x)
+            for (int y = 0; y < MAP; ++y)
+                for (int l = 0; l < LAYERS; ++l) sum += planarGet(l, x, y);
+        return sum;
+    });
+
+    // 同样的平面布局，但与另外两种一样从 PagedFile 取出
+    double pagedNs = NsPerTile(iterations, [&]() {
+        long long sum = 0;
+        for (int x = 0; x < MAP; ++x)
+            for (int y = 0; y < MAP; ++y) {
+                const int16_t* scene = reinterpret_cast<const int16_t*>(paged.read(sceneId));
+                for (int l = 0; l < LAYERS; ++l) sum += scene[l * TILES + x * MAP + y];
+            }
+        return sum;
+    });
+
+    double compactNs = NsPerTile(iterations, [&]() {
+        long long sum = 0;
+        for (int x = 0; x < MAP; ++x)
+            for (int y = 0; y < MAP; ++y) {
+                const TileLayer* layers = compact.layers(sceneId);
+                for (int l = 0; l < LAYERS; ++l) sum += layers[l].get(x * MAP + y);
+            }
+        return sum;
+    });
+
+    double interleavedNs = NsPerTile(iterations, [&]() {
+        long long sum = 0;
+        for (int x = 0; x < MAP; ++x)
+            for (int y = 0; y < MAP; ++y) {
+                const int16_t* tile = interleaved.tile(sceneId, x * MAP + y);
+                for (int l = 0; l < LAYERS; ++l) sum += tile[l];
+            }
+        return sum;
+    });
+
+    double pagedScanNs = NsPerTile(iterations, [&]() {
+        long long sum = 0;
+        const int16_t* scene = reinterpret_cast<const int16_t*>(paged.read(sceneId));
+        for (int x = 0; x < MAP; ++x)
+            for (int y = 0; y < MAP; ++y)
+                for (int l = 0; l < LAYERS; ++l) sum += scene[l * TILES + x * MAP + y];
+        return sum;
+    });
+
+    double interleavedScanNs = NsPerTile(iterations, [&]() {
+        long long sum = 0;
+        const int16_t* scene = interleaved.tile(sceneId, 0);
+        for (int x = 0; x < MAP; ++x)
+            for (int y = 0; y < MAP; ++y) {
+                const int16_t* tile = scene + (x * MAP + y) * LAYERS;
+                for (int l = 0; l < LAYERS; ++l) sum += tile[l];
+            }
+        return sum;
+    });
+
+    // 载入/写出时的布局转换开销
+    auto convStart = std::chrono::steady_clock::now();
+    for (int s = 0; s < sceneCount; ++s) interleaved.tile(s, 0);
+    bool saved = interleaved.save((fs::path(file).replace_extension(".out")).string());
+    double convMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - convStart).count();
+
+    for (int s = 0; s < sceneCount; ++s) compact.layers(s);
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "[bench_scene_layout] " << iterations << " full-scene scans, 6 layers per tile" << std::endl;
+    for (int s = 0; s < sceneCount; ++s) paged.read(s);
+    std::cout << "  planar (memory)        " << std::setw(8) << planarNs << " ns/tile  "
+              << (LAYERS * TILES * 2) / 1024 << " KB/scene" << std::endl;
+    std::cout << "  planar paged, per tile " << std::setw(8) << pagedNs << " ns/tile  "
+              << paged.residentBytes() / sceneCount / 1024 << " KB/scene" << std::endl;
+    std::cout << "  compact, per tile      " << std::setw(8) << compactNs << " ns/tile  "
+              << compact.residentBytes() / sceneCount / 1024 << " KB/scene" << std::endl;
+    std::cout << "  interleaved, per tile  " << std::setw(8) << interleavedNs << " ns/tile  "
+              << interleaved.residentBytes() / sceneCount / 1024 << " KB/scene" << std::endl;
+    std::cout << "  planar paged, per scan " << std::setw(8) << pagedScanNs << " ns/tile" << std::endl;
+    std::cout << "  interleaved, per scan  " << std::setw(8) << interleavedScanNs << " ns/tile" << std::endl;
+    std::cout << "  interleaved load+save of " << sceneCount << " scenes: " << convMs << " ms"
+              << (saved ? "" : " (save failed)") << std::endl;
+
+    fs::remove(file);
+    fs::remove(fs::path(file).replace_extension(".out"));
+    return 0;
+}
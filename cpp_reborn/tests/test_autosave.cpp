@@ -0,0 +1,95 @@
+#include <iostream>
+#include <string>
+#include "AutoSave.h"
+
+static int g_failures = 0;
+
+static void Check(bool cond, const std::string& msg) {
+    if (cond) {
+        std::cout << "[PASS] " << msg << std::endl;
+    } else {
+        std::cout << "[FAIL] " << msg << std::endl;
+        ++g_failures;
+    }
+}
+
+using Trigger = AutoSaveScheduler::Trigger;
+
+int main() {
+    AutoSaveConfig config;
+    config.firstSlot = 6;
+    config.slotCount = 3;
+    config.intervalMs = 10000;
+    config.minGapMs = 3000;
+    config.frameBudgetMs = 4.0;
+    config.ioBytesPerMinute = 1000;
+    config.ioMsPerMinute = 0;
+
+    {
+        AutoSaveScheduler off;
+        AutoSaveConfig none = config;
+        none.slotCount = 0;
+        off.setConfig(none);
+        off.reset(0);
+        off.onSceneChange(100);
+        Check(off.poll(100, false, 0) == Trigger::None && off.poll(100000, false, 0) == Trigger::None, "Disabled: never saves");
+    }
+
+    const uint64_t KB = 1024, MB = 1024 * 1024;
+    AutoSaveScheduler a;
+    a.setConfig(config);
+    a.reset(0);
+    Check(a.poll(500, false, 100 * KB) == Trigger::None, "Nothing to do before any trigger");
+    Check(a.estimateSnapshotMs(2 * MB) == 2 * AutoSaveScheduler::DEFAULT_MS_PER_MIB, "Default copy speed before a measurement");
+
+    // 场景切换
+    a.onSceneChange(20000);
+    Check(a.poll(20005, false, 8 * MB) == Trigger::None, "Scene change over the frame budget is deferred");
+    Check(a.poll(20010, true, 100 * KB) == Trigger::None, "Busy writer defers the scene change");
+    Check(a.poll(20020, true, 100 * KB) == Trigger::None && a.stats(20020).deferred == 1, "Deferral counted once per trigger");
+    Check(a.poll(20030, false, 100 * KB) == Trigger::SceneChange, "Scene change fires when the writer is free");
+    Check(a.slotAt(0) == 6, "First autosave goes to slot 6");
+    a.recordSnapshot(20030, 6, 12.0, 1 * MB);
+    a.recordWrite(20100, true, 30.0, 400);
+    Check(a.slotAt(0) == 7 && a.slotAt(2) == 6, "Rotation moves to slot 7");
+    Check(a.estimateSnapshotMs(MB / 2) == 6.0, "Copy speed learned from the snapshot");
+
+    a.onSceneChange(21000);
+    Check(a.poll(21000, false, 100 * KB) == Trigger::None && a.stats(21000).dropped == 1, "Scene change inside the gap is dropped");
+
+    // 12 ms/MiB: 512 KB 预计 6 ms > 单帧预算 4 ms，两种触发都推迟
+    Check(a.poll(31000, false, MB / 2) == Trigger::None, "Timer over the frame budget is deferred");
+    a.onSceneChange(31500);
+    Check(a.poll(31500, false, MB / 2) == Trigger::None, "Scene change over the frame budget is deferred too");
+    Check(a.poll(31600, false, 200 * KB) == Trigger::SceneChange, "Fires once the copy fits in the frame");
+    a.recordSnapshot(31600, a.slotAt(0), 1.5, 300 * KB);
+    a.recordWrite(31650, true, 20.0, 400);
+
+    // I/O 预算: 一分钟内已写 800 字节，下一次预计再 400 > 1000
+    a.onSceneChange(35000);
+    Check(a.poll(35000, false, 100 * KB) == Trigger::None, "Over the per-minute byte budget: deferred");
+    AutoSaveScheduler::Stats s = a.stats(35000);
+    Check(s.bytesLastMinute == 800 && s.writeMsLastMinute == 50.0, "Last-minute window totals");
+    Check(a.poll(38000, false, 100 * KB) == Trigger::None, "Scene change expires after the grace period");
+
+    // 第一笔写盘移出一分钟窗口，定时器触发
+    Check(a.poll(81600, false, 100 * KB) == Trigger::Timer, "Timer fires once the budget frees up");
+    Check(a.slotAt(0) == 8, "Third slot");
+    a.recordSnapshot(81600, 8, 1.0, 100 * KB);
+    Check(a.slotAt(0) == 6, "Rotation wraps to the first slot");
+    a.recordWrite(81700, false, 5.0, 0);
+
+    s = a.stats(81700);
+    Check(s.saves == 3 && s.failures == 1 && s.maxSnapshotMs == 12.0 && s.totalSnapshotMs == 14.5 &&
+          s.lastSnapshotBytes == 100 * KB, "Snapshot metrics");
+    Check(s.totalWriteMs == 55.0 && s.totalBytes == 800 && s.bytesLastMinute == 400, "Write metrics");
+
+    // 读档后: 定时器重新计时，复制速度回到默认
+    a.reset(90000);
+    Check(a.stats(90000).lastSnapshotMs < 0 && a.estimateSnapshotMs(MB) == AutoSaveScheduler::DEFAULT_MS_PER_MIB,
+          "Reset forgets the snapshot cost");
+    Check(a.poll(95000, false, 100 * KB) == Trigger::None, "After reset the timer starts over");
+    Check(a.poll(100000, false, 100 * KB) == Trigger::Timer, "Timer after a full interval");
+
+    return g_failures == 0 ? 0 : 1;
+}
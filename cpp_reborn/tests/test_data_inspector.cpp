@@ -0,0 +1,205 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include "DataInspector.h"
+#include "SaveContainer.h"
+#include "Role.h"
+#include "Item.h"
+#include "Scene.h"
+#include "Magic.h"
+
+namespace fs = std::filesystem;
+
+static int g_failures = 0;
+
+static void Check(bool cond, const std::string& msg) {
+    if (cond) {
+        std::cout << "[PASS] " << msg << std::endl;
+    } else {
+        std::cout << "[FAIL] " << msg << std::endl;
+        ++g_failures;
+    }
+}
+
+namespace {
+    const char GBK_NAME[] = "\xD5\xC5\xC8\xFD"; // 张三
+    const char UTF8_NAME[] = "\xE5\xBC\xA0\xE4\xB8\x89";
+
+    const int ROLES = 4, ITEMS = 3, SCENES = 2, MAGICS = 1, SHOP_BYTES = 10;
+    const int HEADER_VALUES = 11 + MAX_TEAM_SIZE + MAX_ITEM_AMOUNT * 2;
+
+    SaveLayout MakeLayout() {
+        SaveLayout l;
+        l.roleOffset = HEADER_VALUES * 2;
+        l.itemOffset = l.roleOffset + ROLES * static_cast<int32_t>(ROLE_DATA_SIZE) * 2;
+        l.sceneOffset = l.itemOffset + ITEMS * static_cast<int32_t>(ITEM_DATA_SIZE) * 2;
+        l.magicOffset = l.sceneOffset + SCENES * static_cast<int32_t>(SCENE_DATA_SIZE) * 2;
+        l.shopOffset = l.magicOffset + MAGICS * static_cast<int32_t>(MAGIC_DATA_SIZE) * 2;
+        l.totalLength = l.shopOffset + SHOP_BYTES;
+        return l;
+    }
+
+    void WriteIdx(const fs::path& path, const SaveLayout& l) {
+        int32_t offsets[6] = { l.roleOffset, l.itemOffset, l.sceneOffset, l.magicOffset, l.shopOffset, l.totalLength };
+        std::ofstream f(path, std::ios::binary);
+        f.write(reinterpret_cast<const char*>(offsets), sizeof(offsets));
+    }
+
+    // 场景 1 "客栈", 队伍 {0, 2}, 背包两格。'damaged': 队伍里多一个不存在的 9 号，2 号 HP 超过上限
+    std::vector<uint8_t> MakeSave(const SaveLayout& l, bool damaged) {
+        std::vector<int16_t> header(HEADER_VALUES, 0);
+        header[1] = 1;  // scene
+        header[2] = 30; // x
+        header[3] = 40; // y
+        for (int i = 0; i < MAX_TEAM_SIZE; ++i) header[11 + i] = -1;
+        header[11] = 0;
+        header[12] = 2;
+        if (damaged) header[13] = 9;
+        for (int i = 0; i < MAX_ITEM_AMOUNT; ++i) header[17 + i * 2] = -1;
+        header[17] = 1;
+        header[18] = 5;
+        header[19] = 2;
+        header[20] = 7;
+
+        std::vector<uint8_t> bytes(l.totalLength, 0);
+        std::memcpy(bytes.data(), header.data(), header.size() * 2);
+        for (int i = 0; i < ROLES; ++i) {
+            Role r;
+            r.setName(i == 0 ? GBK_NAME : "Role" + std::to_string(i));
+            r.setLevel(static_cast<int16>(10 + i));
+            r.setMaxHP(100);
+            r.setCurrentHP(damaged && i == 2 ? 150 : 80);
+            std::memcpy(bytes.data() + l.roleOffset + i * ROLE_DATA_SIZE * 2, r.getRawData(), ROLE_DATA_SIZE * 2);
+        }
+        std::memcpy(bytes.data() + l.sceneOffset + SCENE_DATA_SIZE * 2 + 2, "\xBF\xCD\xD5\xBB", 4); // 场景 1 名字: 客栈
+        return bytes;
+    }
+
+    void WriteFile(const fs::path& path, const void* data, size_t size) {
+        fs::create_directories(path.parent_path());
+        std::ofstream f(path, std::ios::binary);
+        f.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    }
+}
+
+int main() {
+    // 文本
+    Check(DataInspector::gbkToUtf8("Hero") == "Hero", "ASCII passes through");
+    Check(DataInspector::gbkToUtf8(GBK_NAME) == UTF8_NAME, "GBK name converted to UTF-8");
+    Check(DataInspector::gbkToUtf8("A\xFF").find("\xEF\xBF\xBD") != std::string::npos, "Unconvertible byte becomes U+FFFD");
+    Check(DataInspector::jsonEscape("a\"b\\c\n\x01") == "a\\\"b\\\\c\\n\\u0001", "JSON escaping");
+    Check(DataInspector::csvField("a,b") == "\"a,b\"" && DataInspector::csvField("q\"") == "\"q\"\"\"" &&
+          DataInspector::csvField("plain") == "plain", "CSV quoting");
+
+    std::vector<std::atomic<int>> hits(1000);
+    DataInspector::parallelFor(hits.size(), 8, [&](size_t i) { ++hits[i]; });
+    bool once = true;
+    for (auto& h : hits) once = once && h == 1;
+    Check(once, "parallelFor runs every index exactly once");
+
+    // 存档目录: 一份原始, 一份压缩, 子目录里一份被截断的
+    const fs::path root = fs::absolute("test_data_inspector_tmp");
+    fs::remove_all(root);
+    const SaveLayout layout = MakeLayout();
+    std::vector<uint8_t> save = MakeSave(layout, false);
+    WriteFile(root / "player1" / "R1.grp", save.data(), save.size());
+    WriteIdx(root / "player1" / "ranger.idx", layout);
+    Check(SaveContainer::writeFile((root / "player1" / "R2.grp").string(), save.data(), save.size(), true), "Write compressed save");
+    std::vector<uint8_t> broken = MakeSave(layout, true);
+    broken.resize(layout.shopOffset);
+    WriteFile(root / "player1" / "old" / "R10.grp", broken.data(), broken.size());
+    WriteFile(root / "player1" / "R1.grp.tmp", save.data(), save.size());
+    WriteFile(root / "player1" / "readme.txt", "x", 1);
+
+    std::vector<std::string> saves = DataInspector::findSaves(root.string());
+    Check(saves.size() == 3, "Three saves found recursively");
+    Check(DataInspector::findLayout((root / "player1" / "old" / "R10.grp").string()) == (root / "player1" / "ranger.idx").string(),
+          "ranger.idx found in a parent directory");
+    Check(DataInspector::findLayout(root.string()).empty(), "No ranger.idx above the root");
+
+    std::vector<SaveReport> reports(saves.size());
+    DataInspector::parallelFor(saves.size(), 3, [&](size_t i) { reports[i] = DataInspector::inspectSave(saves[i], layout, true); });
+    const SaveReport* r1 = nullptr;
+    const SaveReport* r2 = nullptr;
+    const SaveReport* r10 = nullptr;
+    for (const auto& r : reports) {
+        std::string name = fs::path(r.path).filename().string();
+        if (name == "R1.grp") r1 = &r;
+        if (name == "R2.grp") r2 = &r;
+        if (name == "R10.grp") r10 = &r;
+    }
+    Check(r1 && r2 && r10, "Every save has a report");
+    if (!r1 || !r2 || !r10) return 1;
+
+    Check(r1->ok && !r1->compressed && r1->problems.empty(), "Raw save reads clean");
+    Check(r1->sceneId == 1 && r1->sceneName == "\xE5\xAE\xA2\xE6\xA0\x88" && r1->mapX == 30 && r1->mapY == 40, "Scene and position");
+    Check(r1->team.size() == 2 && r1->team[0].name == UTF8_NAME && r1->team[1].level == 12 && r1->team[0].hp == 80,
+          "Team members with names and stats");
+    Check(r1->itemKinds == 2 && r1->itemTotal == 12 && r1->inventory.size() == 2 && r1->inventory[1].itemId == 2,
+          "Inventory slots");
+    Check(r1->roleCount == ROLES && r1->itemCount == ITEMS && r1->sceneCount == SCENES && r1->magicCount == MAGICS, "Table sizes");
+    Check(r2->ok && r2->compressed && r2->rawBytes == save.size() && r2->team.size() == 2, "Compressed save unpacked");
+    Check(r10->ok && r10->problems.size() == 3, "Truncated save: size, hp and team problems");
+
+    SaveReport missing = DataInspector::inspectSave((root / "R99.grp").string(), layout);
+    Check(!missing.ok && !missing.error.empty(), "Missing file reported as an error");
+    SaveReport noLayout = DataInspector::inspectSave(saves[0], SaveLayout());
+    Check(!noLayout.ok, "Save without ranger.idx reported as an error");
+
+    std::ostringstream json;
+    DataInspector::write(json, reports, DataInspector::Format::Json, true);
+    Check(json.str().front() == '[' && json.str().find(std::string("\"name\": \"") + UTF8_NAME + "\"") != std::string::npos &&
+          json.str().find("\"inventory\": [[1, 5], [2, 7]]") != std::string::npos, "JSON output");
+    std::ostringstream csv;
+    DataInspector::write(csv, reports, DataInspector::Format::Csv);
+    std::string csvText = csv.str();
+    Check(std::count(csvText.begin(), csvText.end(), '\n') == 4 && csvText.compare(0, 8, "path,ok,") == 0, "CSV output: header + one row per save");
+
+    // 场景数据: 2 个场景。场景 0 的事件 3 在 (5, 7)，事件层一致；场景 1 的事件层没有刷新
+    // S*.grp 按层存放: 每个场景 [layer][64*64]
+    const size_t plane = 64 * 64, mapScene = plane * 6, eventScene = 200 * 11;
+    std::vector<int16_t> sdata(mapScene * 2, 0);
+    for (size_t sc = 0; sc < 2; ++sc) std::fill_n(sdata.begin() + sc * mapScene + 3 * plane, plane, static_cast<int16_t>(-1));
+    for (int i = 0; i < 10; ++i) sdata[i] = 100;
+    sdata[3 * plane + 5 * 64 + 7] = 3;
+    std::fill_n(sdata.begin() + mapScene, plane, static_cast<int16_t>(7)); // 场景 1 的第 0 层铺满
+    std::vector<int16_t> ddata(eventScene * 2, 0);
+    ddata[3 * 11 + 4] = 501;
+    ddata[3 * 11 + 10] = 5;
+    ddata[3 * 11 + 9] = 7;
+    ddata[eventScene + 0 * 11 + 10] = 9;
+    ddata[eventScene + 0 * 11 + 9] = 9;
+    WriteFile(root / "player1" / "S1.grp", sdata.data(), sdata.size() * 2);
+    std::vector<uint8_t> dbytes(ddata.size() * 2);
+    std::memcpy(dbytes.data(), ddata.data(), dbytes.size());
+    Check(SaveContainer::writeFile((root / "player1" / "D1.grp").string(), dbytes.data(), dbytes.size(), true), "Write compressed DData");
+
+    auto pairs = DataInspector::findSceneData(root.string());
+    Check(pairs.size() == 1 && fs::path(pairs[0].second).filename() == "D1.grp", "S1/D1 paired");
+    auto single = DataInspector::findSceneData((root / "player1" / "S1.grp").string());
+    Check(single.size() == 1 && single[0].second == pairs[0].second, "Single map file paired with its event file");
+
+    SceneDataReport scenes = DataInspector::inspectSceneData(pairs[0].first, pairs[0].second);
+    Check(scenes.ok && scenes.compressed && scenes.mapScenes == 2 && scenes.eventScenes == 2, "Scene data read");
+    Check(scenes.scenes.size() == 2 && scenes.scenes[0].tiles[0] == 10 && scenes.scenes[0].tiles[3] == 1 &&
+          scenes.scenes[0].events == 1 && scenes.scenes[0].placed == 1 && scenes.scenes[0].stale == 0, "Scene 0 stats");
+    Check(scenes.scenes[1].tiles[0] == 64 * 64 && scenes.scenes[1].tiles[1] == 0 && scenes.scenes[1].tiles[2] == 0 &&
+          scenes.scenes[1].tiles[4] == 0 && scenes.scenes[1].tiles[5] == 0, "Full layer 0 counted only in layer 0");
+    Check(scenes.scenes[1].stale == 1 && scenes.stale == 1 && scenes.problems.size() == 1, "Stale event layer flagged");
+
+    SceneDataReport lonely = DataInspector::inspectSceneData(pairs[0].first, (root / "D7.grp").string());
+    Check(!lonely.ok, "Missing event file reported as an error");
+
+    std::ostringstream sceneCsv;
+    DataInspector::write(sceneCsv, std::vector<SceneDataReport>{ scenes }, DataInspector::Format::Csv, true);
+    std::string sceneCsvText = sceneCsv.str();
+    Check(std::count(sceneCsvText.begin(), sceneCsvText.end(), '\n') == 3, "Per-scene CSV rows");
+
+    fs::remove_all(root);
+    return g_failures == 0 ? 0 : 1;
+}
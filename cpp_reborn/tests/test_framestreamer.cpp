@@ -0,0 +1,66 @@
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "FrameStreamer.h"
+
+static int g_failures = 0;
+
+static void Check(bool cond, const std::string& msg) {
+    if (cond) {
+        std::cout << "[PASS] " << msg << std::endl;
+    } else {
+        std::cout << "[FAIL] " << msg << std::endl;
+        ++g_failures;
+    }
+}
+
+int main() {
+    FrameStreamer streamer(3);
+
+    // 帧按顺序到达，每帧的第一个像素写入帧号
+    const int frames = 40;
+    std::atomic<int> maxAhead{ 0 };
+    std::atomic<int> consumed{ 0 };
+    streamer.start(frames, [&](int index) -> SDL_Surface* {
+        SDL_Surface* s = SDL_CreateSurface(4, 4, SDL_PIXELFORMAT_ARGB8888);
+        if (s) static_cast<uint32_t*>(s->pixels)[0] = uint32_t(index);
+        int ahead = index - consumed.load();
+        if (ahead > maxAhead) maxAhead = ahead;
+        return s;
+    });
+
+    bool ordered = true;
+    bool pixelsOk = true;
+    int got = 0, index = 0;
+    SDL_Surface* surface = nullptr;
+    while (streamer.nextFrame(index, surface)) {
+        if (index != got) ordered = false;
+        if (!surface || static_cast<uint32_t*>(surface->pixels)[0] != uint32_t(index)) pixelsOk = false;
+        if (surface) SDL_DestroySurface(surface);
+        ++got;
+        consumed = got;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    Check(got == frames, "All frames delivered");
+    Check(ordered, "Frames delivered in order");
+    Check(pixelsOk, "Frame contents match their index");
+    // 环大小为 3：解码最多领先消费者 3 帧 (+1 为正在解码的那一帧)
+    Check(maxAhead <= 4, "Worker stays within the ring size");
+
+    // 中途停止后可以重新开始另一段序列
+    streamer.start(1000, [](int) -> SDL_Surface* { return SDL_CreateSurface(2, 2, SDL_PIXELFORMAT_ARGB8888); });
+    streamer.nextFrame(index, surface);
+    if (surface) SDL_DestroySurface(surface);
+    streamer.stop();
+    Check(!streamer.nextFrame(index, surface), "No frames after stop");
+
+    streamer.start(5, [](int) -> SDL_Surface* { return nullptr; });
+    got = 0;
+    while (streamer.nextFrame(index, surface)) ++got;
+    Check(got == 5, "Streamer is reusable after stop (empty frames included)");
+
+    Check(!streamer.start(0, [](int) -> SDL_Surface* { return nullptr; }), "Empty sequence is rejected");
+
+    return g_failures == 0 ? 0 : 1;
+}
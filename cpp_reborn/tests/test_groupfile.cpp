@@ -0,0 +1,83 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <thread>
+#include <cstring>
+#include <cstdio>
+#include <filesystem>
+#include "FileLoader.h"
+#include "GroupFile.h"
+
+static int g_failures = 0;
+
+static void Check(bool cond, const std::string& msg) {
+    if (cond) {
+        std::cout << "[PASS] " << msg << std::endl;
+    } else {
+        std::cout << "[FAIL] " << msg << std::endl;
+        ++g_failures;
+    }
+}
+
+static void WriteFile(const std::string& path, const void* data, size_t size) {
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    f.write(reinterpret_cast<const char*>(data), size);
+}
+
+int main() {
+    // 构造一个三条记录的 grp: "AAAA" | "" | "BBBBBB"
+    // idx 为结束偏移: 4, 4, 10
+    const std::string grpPath = "test_groupfile.grp";
+    const std::string idxPath = "test_groupfile.idx";
+    const char grp[] = "AAAABBBBBB";
+    const int32_t idx[] = { 4, 4, 10 };
+    WriteFile(grpPath, grp, 10);
+    WriteFile(idxPath, idx, sizeof(idx));
+
+    // 用绝对路径避免走资源目录探测
+    std::string g = std::filesystem::absolute(grpPath).string();
+    std::string i = std::filesystem::absolute(idxPath).string();
+
+    auto file = GroupFile::open(g, i);
+    Check(file != nullptr, "GroupFile opens grp/idx pair");
+    if (!file) return 1;
+
+    Check(file->count() == 3, "record count matches idx entries");
+    Check(file->recordSize(0) == 4, "record 0 starts at 0");
+    Check(file->recordSize(1) == 0, "empty record has size 0");
+    Check(file->recordSize(2) == 6, "record 2 spans [idx[1], idx[2])");
+    Check(file->record(3).empty() && file->record(-1).empty(), "out of range records are empty");
+    Check(file->recordOffset(0) == 0 && file->recordOffset(2) == 4, "recordOffset follows Pascal idx[i-1]");
+
+    MappedFile r2 = file->record(2);
+    Check(r2.size() == 6 && std::memcmp(r2.data(), "BBBBBB", 6) == 0, "record view content");
+
+    Check(GroupFile::open(g, i) == file, "second open hits the cache");
+
+    auto copy = FileLoader::loadGroupRecord(g, i, 0);
+    Check(copy.size() == 4 && std::memcmp(copy.data(), "AAAA", 4) == 0, "loadGroupRecord uses end-offset semantics");
+
+    // 多线程并发读取
+    std::vector<std::thread> workers;
+    std::vector<int> ok(4, 0);
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&, t]() {
+            int good = 1;
+            for (int n = 0; n < 10000; ++n) {
+                auto f = GroupFile::open(g, i);
+                if (!f || f->record(n % 3).size() != f->recordSize(n % 3)) good = 0;
+            }
+            ok[t] = good;
+        });
+    }
+    for (auto& w : workers) w.join();
+    Check(ok[0] && ok[1] && ok[2] && ok[3], "concurrent record() access");
+
+    GroupFile::clearCache();
+    Check(file->record(0).size() == 4, "views stay valid after clearCache");
+
+    file.reset();
+    std::remove(grpPath.c_str());
+    std::remove(idxPath.c_str());
+    return g_failures == 0 ? 0 : 1;
+}
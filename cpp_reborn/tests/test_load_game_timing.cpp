@@ -0,0 +1,167 @@
+// 读档计时: 原逐字段 ifstream 读法 vs 整份读入后按表拷贝 (SaveImageReader)
+// 生成 6 个与真实存档同样大小的 R*.grp，每种读法循环读全部存档，结果必须逐字段相同。
+// 用法: test_load_game_timing [rounds]
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <filesystem>
+#include <cstdlib>
+#include "GameTypes.h"
+#include "Role.h"
+#include "Item.h"
+#include "Scene.h"
+#include "Magic.h"
+#include "SaveImage.h"
+#include "SaveContainer.h"
+
+namespace fs = std::filesystem;
+
+static int g_failures = 0;
+
+static void Check(bool cond, const std::string& msg) {
+    if (cond) {
+        std::cout << "[PASS] " << msg << std::endl;
+    } else {
+        std::cout << "[FAIL] " << msg << std::endl;
+        ++g_failures;
+    }
+}
+
+namespace {
+    const int SLOTS = 6;
+    const int ROLES = 1000, ITEMS = 400, SCENES = 200, MAGICS = 400, SHOP_BYTES = 1800;
+    const int HEADER_VALUES = 11 + MAX_TEAM_SIZE + MAX_ITEM_AMOUNT * 2;
+
+    struct Loaded {
+        std::vector<int16_t> header;
+        RoleTable roles;
+        ItemTable items;
+        SceneTable scenes;
+        MagicTable magics;
+        std::vector<uint8_t> shop;
+    };
+
+    template <typename T, size_t N>
+    bool SameTable(const RecordTable<T, N>& a, const RecordTable<T, N>& b) {
+        return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * N * sizeof(int16_t)) == 0);
+    }
+
+    bool Same(const Loaded& a, const Loaded& b) {
+        return a.header == b.header && SameTable(a.roles, b.roles) && SameTable(a.items, b.items) &&
+               SameTable(a.scenes, b.scenes) && SameTable(a.magics, b.magics) && a.shop == b.shop;
+    }
+
+    // 原 LoadGame: 每个字段一次 2 字节 read，每条记录一个临时 vector
+    template <typename T, size_t N>
+    void ReadTablePerField(std::ifstream& file, int32_t begin, int32_t end, size_t values, RecordTable<T, N>& out) {
+        file.seekg(begin, std::ios::beg);
+        int count = (end - begin) / static_cast<int>(values * 2);
+        out.resize(count);
+        for (int i = 0; i < count; ++i) {
+            std::vector<int16_t> buffer(values);
+            file.read(reinterpret_cast<char*>(buffer.data()), values * 2);
+            out[i].setDataVector(buffer);
+        }
+    }
+
+    Loaded LoadPerField(const std::string& path, const SaveLayout& layout) {
+        Loaded l;
+        std::ifstream file(path, std::ios::binary);
+        l.header.resize(layout.roleOffset / 2);
+        for (auto& v : l.header) file.read(reinterpret_cast<char*>(&v), 2);
+        ReadTablePerField(file, layout.roleOffset, layout.itemOffset, ROLE_DATA_SIZE, l.roles);
+        ReadTablePerField(file, layout.itemOffset, layout.sceneOffset, ITEM_DATA_SIZE, l.items);
+        ReadTablePerField(file, layout.sceneOffset, layout.magicOffset, SCENE_DATA_SIZE, l.scenes);
+        ReadTablePerField(file, layout.magicOffset, layout.shopOffset, MAGIC_DATA_SIZE, l.magics);
+        l.shop.resize(layout.totalLength - layout.shopOffset);
+        file.seekg(layout.shopOffset, std::ios::beg);
+        file.read(reinterpret_cast<char*>(l.shop.data()), l.shop.size());
+        return l;
+    }
+
+    // 新 LoadGame: 一次读入，整段拷贝
+    Loaded LoadTables(const std::string& path, const SaveLayout& layout) {
+        Loaded l;
+        std::vector<uint8_t> bytes;
+        SaveContainer::readFile(path, bytes);
+        SaveImageReader image(layout, std::move(bytes));
+        l.header = image.header();
+        image.getTable(layout.roleOffset, layout.itemOffset, l.roles);
+        image.getTable(layout.itemOffset, layout.sceneOffset, l.items);
+        image.getTable(layout.sceneOffset, layout.magicOffset, l.scenes);
+        image.getTable(layout.magicOffset, layout.shopOffset, l.magics);
+        l.shop = image.getBytes(layout.shopOffset, layout.totalLength);
+        return l;
+    }
+
+    template <typename Fn>
+    double MsPerSlot(int rounds, const std::vector<std::string>& paths, Fn&& load) {
+        size_t sink = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; ++r) {
+            for (const auto& path : paths) sink += load(path).roles.size();
+        }
+        auto end = std::chrono::steady_clock::now();
+        if (sink == 42) std::cout << "";
+        return std::chrono::duration<double, std::milli>(end - start).count() / (rounds * paths.size());
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int rounds = argc > 1 ? std::max(1, std::atoi(argv[1])) : 20;
+
+    const fs::path root = fs::absolute("test_load_game_timing_tmp");
+    fs::remove_all(root);
+    fs::create_directories(root);
+
+    SaveLayout layout;
+    layout.roleOffset = HEADER_VALUES * 2;
+    layout.itemOffset = layout.roleOffset + ROLES * static_cast<int32_t>(ROLE_DATA_SIZE) * 2;
+    layout.sceneOffset = layout.itemOffset + ITEMS * static_cast<int32_t>(ITEM_DATA_SIZE) * 2;
+    layout.magicOffset = layout.sceneOffset + SCENES * static_cast<int32_t>(SCENE_DATA_SIZE) * 2;
+    layout.shopOffset = layout.magicOffset + MAGICS * static_cast<int32_t>(MAGIC_DATA_SIZE) * 2;
+    layout.totalLength = layout.shopOffset + SHOP_BYTES;
+
+    std::mt19937 rng(7);
+    std::vector<std::string> paths;
+    for (int slot = 1; slot <= SLOTS; ++slot) {
+        std::vector<uint8_t> bytes(layout.totalLength);
+        for (auto& b : bytes) b = static_cast<uint8_t>(rng());
+        fs::path path = root / ("R" + std::to_string(slot) + ".grp");
+        // 一半存成压缩容器，两种格式都要能读
+        Check(SaveContainer::writeFile(path.string(), bytes.data(), bytes.size(), slot % 2 == 0), "Write " + path.filename().string());
+        paths.push_back(path.string());
+    }
+
+    // 原读法不认识容器: 比较时用未压缩的同一份内容
+    std::vector<std::string> rawPaths;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        std::string raw = paths[i] + ".raw";
+        SaveContainer::exportRaw(paths[i], raw);
+        rawPaths.push_back(raw);
+    }
+    bool same = true;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        same = same && Same(LoadPerField(rawPaths[i], layout), LoadTables(paths[i], layout));
+    }
+    Check(same, "Table-driven load matches the per-field load on every slot");
+
+    double perField = MsPerSlot(rounds, rawPaths, [&](const std::string& p) { return LoadPerField(p, layout); });
+    double tables = MsPerSlot(rounds, rawPaths, [&](const std::string& p) { return LoadTables(p, layout); });
+    std::vector<std::string> packed;
+    for (int i = 1; i < SLOTS; i += 2) packed.push_back(paths[i]);
+    double container = MsPerSlot(rounds, packed, [&](const std::string& p) { return LoadTables(p, layout); });
+
+    std::cout << std::fixed << std::setprecision(3)
+              << "Save " << layout.totalLength << " bytes, " << rounds << " rounds x " << SLOTS << " slots\n"
+              << "  per-field ifstream : " << perField << " ms/slot\n"
+              << "  single read + copy : " << tables << " ms/slot\n"
+              << "  container + copy   : " << container << " ms/slot" << std::endl;
+
+    fs::remove_all(root);
+    return g_failures == 0 ? 0 : 1;
+}
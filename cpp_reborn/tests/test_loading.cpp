@@ -68,6 +68,16 @@ int main(int argc, char* argv[]) {
     std::cout << "\n--- Testing Data Access (Crash Check) ---" << std::endl;
     int16_t tile = SceneManager::getInstance().GetSceneTile(70, 0, 20, 20);
     std::cout << "GetSceneTile(70, 0, 20, 20) = " << tile << std::endl;
+
+    SceneTileView tiles = SceneManager::getInstance().GetSceneTiles(70);
+    if (tiles) {
+        bool same = true;
+        for (int l = 0; l < SCENE_LAYERS; ++l) {
+            same = same && tiles.get(l, 20, 20) == SceneManager::getInstance().GetSceneTile(70, l, 20, 20);
+        }
+        std::cout << (same ? "[PASS]" : "[FAIL]") << " GetSceneTiles(70) matches GetSceneTile" << std::endl;
+    }
+    std::cout << "GetSceneTiles(-1) valid = " << SceneManager::getInstance().GetSceneTiles(-1).valid() << std::endl;
     
     int16_t event = SceneManager::getInstance().GetEventData(70, 0, 0);
     std::cout << "GetEventData(70, 0, 0) = " << event << std::endl;
@@ -0,0 +1,58 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstdio>
+#include "MemoryStats.h"
+
+static int g_failures = 0;
+
+static void Check(bool cond, const std::string& msg) {
+    if (cond) {
+        std::cout << "[PASS] " << msg << std::endl;
+    } else {
+        std::cout << "[FAIL] " << msg << std::endl;
+        ++g_failures;
+    }
+}
+
+int main() {
+    MemoryStats stats;
+
+    stats.begin();
+    stats.add("SceneManager", "smp", 4096, 10, true);
+    stats.add("SceneManager", "scene_pics", 1000, 2);
+    stats.add("SceneManager", "scene_pics", 500, 1);
+    stats.add("UIManager", "system_textures", 2048, 1, false, true);
+
+    Check(stats.entries().size() == 3, "Same (owner, asset) accumulates into one entry");
+    Check(stats.entries()[1].bytes == 1500 && stats.entries()[1].count == 3, "Bytes and counts are summed");
+    Check(stats.totalBytes() == 4096 + 1500 + 2048, "Total bytes");
+    Check(stats.peakTotalBytes() == stats.totalBytes(), "Peak total tracks the first sample");
+
+    // 第二次采样变小: 当前值重置，峰值保留
+    stats.begin();
+    stats.add("SceneManager", "smp", 4096, 10, true);
+    stats.add("SceneManager", "scene_pics", 100, 1);
+    Check(stats.entries()[1].bytes == 100 && stats.entries()[1].peakBytes == 1500, "Entry peak survives a new sample");
+    Check(stats.entries()[2].bytes == 0 && stats.entries()[2].peakBytes == 2048, "Unreported entry drops to zero but keeps its peak");
+    Check(stats.totalBytes() == 4196, "Total reflects the latest sample");
+    Check(stats.peakTotalBytes() == 4096 + 1500 + 2048, "Peak total is kept");
+
+    std::ostringstream out;
+    stats.print(out);
+    Check(out.str().find("scene_pics") != std::string::npos, "Report lists assets");
+
+    const std::string csv = "test_memory_stats.csv";
+    Check(stats.writeCsv(csv), "CSV written");
+    std::ifstream in(csv);
+    std::string header, row;
+    std::getline(in, header);
+    std::getline(in, row);
+    Check(header == "owner,asset,kind,bytes,count,peak_bytes", "CSV header");
+    Check(row == "SceneManager,smp,mapped,4096,10,4096", "CSV row");
+    in.close();
+    std::remove(csv.c_str());
+
+    return g_failures == 0 ? 0 : 1;
+}
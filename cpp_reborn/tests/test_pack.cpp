@@ -0,0 +1,105 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <random>
+#include <cstring>
+#include <cstdio>
+#include "LzCodec.h"
+#include "ResourcePack.h"
+
+static int g_failures = 0;
+
+static void Check(bool cond, const std::string& msg) {
+    if (cond) {
+        std::cout << "[PASS] " << msg << std::endl;
+    } else {
+        std::cout << "[FAIL] " << msg << std::endl;
+        ++g_failures;
+    }
+}
+
+static bool RoundTrip(const std::vector<uint8_t>& data) {
+    auto packed = LzCodec::compress(data.data(), data.size());
+    if (packed.size() > LzCodec::maxCompressedSize(data.size())) return false;
+    std::vector<uint8_t> out(data.size());
+    if (!LzCodec::decompress(packed.data(), packed.size(), out.data(), out.size())) return false;
+    return out == data;
+}
+
+static void WriteFile(const std::string& path, const std::vector<uint8_t>& data) {
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    f.write(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+int main() {
+    std::mt19937 rng(12345);
+
+    // --- LzCodec ---
+    std::vector<uint8_t> empty;
+    Check(RoundTrip(empty), "LZ round trip: empty input");
+
+    std::vector<uint8_t> noise(70000);
+    for (auto& b : noise) b = static_cast<uint8_t>(rng());
+    Check(RoundTrip(noise), "LZ round trip: incompressible data");
+
+    // 类似地图层的数据：大段重复的 int16
+    std::vector<uint8_t> tiles(64 * 64 * 2 * 6);
+    for (size_t i = 0; i < tiles.size(); i += 2) {
+        int16_t v = (i / 512) % 3 == 0 ? 0 : static_cast<int16_t>(40 + (i / 2048));
+        std::memcpy(&tiles[i], &v, 2);
+    }
+    auto packedTiles = LzCodec::compress(tiles.data(), tiles.size());
+    Check(RoundTrip(tiles) && packedTiles.size() < tiles.size() / 4, "LZ round trip: repetitive tile data compresses");
+
+    std::vector<uint8_t> runs(1000, 'A');
+    Check(RoundTrip(runs), "LZ round trip: overlapping match (single byte run)");
+
+    std::vector<uint8_t> corrupt = packedTiles;
+    corrupt.resize(corrupt.size() / 2);
+    std::vector<uint8_t> sink(tiles.size());
+    Check(!LzCodec::decompress(corrupt.data(), corrupt.size(), sink.data(), sink.size()), "LZ rejects truncated input");
+
+    // --- ResourcePack ---
+    WriteFile("test_pack_a.bin", tiles);
+    WriteFile("test_pack_b.bin", noise);
+    std::vector<ResourcePack::BuildInput> inputs = {
+        { "Scene/Tiles.BIN", "test_pack_a.bin" },
+        { "smp", "test_pack_b.bin" },
+    };
+    Check(ResourcePack::write("test_pack.pak", inputs, true), "pack written");
+
+    ResourcePack pack;
+    Check(pack.open("test_pack.pak") && pack.entryCount() == 2, "pack opens with 2 entries");
+    Check(pack.contains("scene/tiles.bin") && pack.contains("scene\\TILES.bin"), "lookup is case and separator insensitive");
+    Check(!pack.contains("scene/missing.bin"), "missing entry not found");
+
+    MappedFile a = pack.find("scene/tiles.bin");
+    Check(a.size() == tiles.size() && std::memcmp(a.data(), tiles.data(), tiles.size()) == 0, "compressed entry decodes");
+
+    MappedFile b = pack.find("smp");
+    Check(b.size() == noise.size() && std::memcmp(b.data(), noise.data(), noise.size()) == 0, "raw entry content");
+    Check(reinterpret_cast<uintptr_t>(b.data()) % ResourcePack::ALIGNMENT == 0, "raw entry is 16-byte aligned");
+
+    pack.close();
+
+    // 读不了的输入和只差大小写的名字: 失败，不留下半个包
+    std::vector<ResourcePack::BuildInput> unreadable = { { "smp", "test_pack_missing.bin" } };
+    Check(!ResourcePack::write("test_pack_bad.pak", unreadable, false) && !std::ifstream("test_pack_bad.pak"),
+          "unreadable input fails the pack");
+    std::vector<ResourcePack::BuildInput> clash = { { "SMP", "test_pack_a.bin" }, { "smp", "test_pack_b.bin" } };
+    Check(!ResourcePack::write("test_pack_bad.pak", clash, false) && !std::ifstream("test_pack_bad.pak"),
+          "names differing only by case are rejected");
+    WriteFile("test_pack_empty.bin", {});
+    std::vector<ResourcePack::BuildInput> emptyInput = { { "empty", "test_pack_empty.bin" } };
+    Check(ResourcePack::write("test_pack_bad.pak", emptyInput, false) && pack.open("test_pack_bad.pak") &&
+          pack.contains("empty") && pack.find("empty").empty(), "empty file packs as an empty entry");
+    pack.close();
+    std::remove("test_pack_bad.pak");
+    std::remove("test_pack_empty.bin");
+    std::remove("test_pack.pak");
+    std::remove("test_pack_a.bin");
+    std::remove("test_pack_b.bin");
+
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,228 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <chrono>
+#include "PagedFile.h"
+
+namespace fs = std::filesystem;
+
+static int g_failures = 0;
+
+static void Check(bool cond, const std::string& msg) {
+    if (cond) {
+        std::cout << "[PASS] " << msg << std::endl;
+    } else {
+        std::cout << "[FAIL] " << msg << std::endl;
+        ++g_failures;
+    }
+}
+
+static std::string ReadAll(const fs::path& path) {
+    std::ifstream f(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+}
+
+int main() {
+    const fs::path root = fs::absolute("test_paged_tmp");
+    fs::remove_all(root);
+    fs::create_directories(root);
+
+    // 5 条 4 字节记录: "AAAA" "BBBB" ... "EEEE"
+    const fs::path src = root / "S1.grp";
+    {
+        std::ofstream f(src, std::ios::binary);
+        f << "AAAABBBBCCCCDDDDEEEE";
+    }
+
+    RawPagedFile pages;
+    Check(!pages.open((root / "missing.grp").string(), 4, 2), "Missing file is rejected");
+    Check(pages.open(src.string(), 4, 2), "Open paged file");
+    Check(pages.count() == 5 && pages.residentCount() == 0, "Nothing is read on open");
+
+    const uint8_t* rec = pages.read(1);
+    Check(rec && std::string(reinterpret_cast<const char*>(rec), 4) == "BBBB", "Record paged in on first read");
+    Check(pages.read(5) == nullptr, "Out of range record");
+
+    pages.read(0);
+    pages.read(1);  // 1 比 0 新
+    pages.read(2);  // 上限 2: 淘汰 0
+    Check(!pages.isResident(0) && pages.isResident(1) && pages.isResident(2), "Least recently used record is evicted");
+
+    uint8_t* w = pages.write(3);
+    w[0] = 'x';
+    pages.read(4);
+    pages.read(0);
+    Check(pages.isResident(3) && pages.isDirty(3), "Dirty record is never evicted");
+
+    // 换源前检查: locate() 失败或成功都不动当前打开的文件
+    PagedFile::Source source;
+    Check(!PagedFile::locate((root / "missing.grp").string(), 4, source) && pages.isDirty(3) && pages.count() == 5,
+          "Failed locate leaves the open file alone");
+    Check(PagedFile::locate(src.string(), 8, source) && source.records == 2 && pages.isDirty(3) &&
+          pages.sourcePath() == src.string(), "locate checks the record count without switching");
+
+    // 写回同一文件: 只改动记录 3
+    Check(pages.save(src.string()), "Save in place");
+    Check(ReadAll(src) == "AAAABBBBCCCCxDDDEEEE" && !fs::exists(src.string() + ".tmp"),
+          "Dirty record written back through an atomic replace");
+    Check(!pages.isDirty(3) && pages.stats().writeBacks == 1, "Record is clean after write-back");
+
+    // 另存为新文件: 未驻留的记录从源文件复制
+    pages.write(4)[3] = 'y';
+    const fs::path other = root / "S2.grp";
+    Check(pages.save(other.string()), "Save to another slot");
+    Check(ReadAll(other) == "AAAABBBBCCCCxDDDEEEy", "Full image written to new slot");
+    Check(ReadAll(src) == "AAAABBBBCCCCxDDDEEEE", "Source slot untouched by save-as");
+
+    // 之后从新文件分页
+    pages.write(0)[0] = 'z';
+    Check(pages.save(other.string()), "Save in place after save-as");
+    Check(ReadAll(other) == "zAAABBBBCCCCxDDDEEEy", "New slot became the page source");
+
+    // 异步存档: 快照之后、提交之前再次修改的记录保持 dirty
+    pages.write(1)[0] = 'q';
+    PagedFile::Snapshot snap = pages.snapshot(other.string());
+    Check(snap.kind == PagedFile::Snapshot::Kind::InPlace && snap.indices.size() == 1, "Snapshot carries only dirty records");
+    pages.write(1)[1] = 'r';
+    Check(PagedFile::writeSnapshot(snap), "Write snapshot");
+    pages.commit(snap, true);
+    Check(ReadAll(other) == "zAAAqBBBCCCCxDDDEEEy", "Snapshot contents written, later edit not");
+    Check(pages.isDirty(1), "Record modified during the write stays dirty");
+    Check(pages.save(other.string()) && ReadAll(other) == "zAAAqrBBCCCCxDDDEEEy", "Later edit saved next time");
+
+    pages.write(2)[0] = 's';
+    PagedFile::Snapshot failed = pages.snapshot(other.string());
+    pages.commit(failed, false);
+    Check(pages.isDirty(2), "Failed write keeps records dirty");
+    pages.save(other.string());
+
+    // 日志模式: 改动追加到 .jnl，源文件不动；重新打开时日志生效
+    const fs::path jsrc = root / "S3.grp";
+    const fs::path jnl = root / "S3.grp.jnl";
+    {
+        std::ofstream f(jsrc, std::ios::binary);
+        f << "AAAABBBBCCCCDDDDEEEEFFFFGGGGHHHH";
+    }
+    RawPagedFile journaled;
+    journaled.setWriteMode(PagedFile::WriteMode::Journal, 4.0);
+    Check(journaled.open(jsrc.string(), 4, 2), "Open for journal saves");
+    journaled.write(1)[0] = 'j';
+    Check(journaled.save(jsrc.string()), "Journal save");
+    Check(ReadAll(jsrc) == "AAAABBBBCCCCDDDDEEEEFFFFGGGGHHHH", "Source untouched by journal save");
+    Check(fs::file_size(jnl) == 24 + 16 && journaled.journalRecords() == 1, "One patch block appended");
+    journaled.write(1)[1] = 'k';
+    journaled.write(6)[0] = 'l';
+    Check(journaled.save(jsrc.string()) && fs::file_size(jnl) == 24 + 16 * 3, "Later saves append only changed records");
+    journaled.read(0);
+    journaled.read(2);
+    journaled.read(3); // 记录 1 被淘汰，之后从日志读回
+    const uint8_t* back = journaled.read(1);
+    Check(back && std::string(reinterpret_cast<const char*>(back), 4) == "jkBB", "Evicted record read back from the journal");
+
+    RawPagedFile reopened;
+    Check(reopened.open(jsrc.string(), 4, 2) && reopened.journalRecords() == 2, "Journal applied on open");
+    Check(std::string(reinterpret_cast<const char*>(reopened.read(6)), 4) == "lGGG", "Journaled record visible after reopen");
+
+    // 写到一半的尾块被丢弃
+    {
+        std::ofstream f(jnl, std::ios::binary | std::ios::app);
+        f << "KPCH\x01";
+    }
+    RawPagedFile torn;
+    Check(torn.open(jsrc.string(), 4, 2) && torn.journalRecords() == 2 && fs::file_size(jnl) == 24 + 16 * 3,
+          "Torn tail dropped");
+
+    // 导出原版格式: 日志叠加后写出，存档本身和日志不动
+    const fs::path exported = root / "export" / "S3.grp";
+    Check(PagedFile::exportRaw(jsrc.string(), exported.string(), 4) &&
+          ReadAll(exported) == "AAAAjkBBCCCCDDDDEEEEFFFFlGGGHHHH", "Export applies the journal");
+    Check(ReadAll(jsrc) == "AAAABBBBCCCCDDDDEEEEFFFFGGGGHHHH" && fs::file_size(jnl) == 24 + 16 * 3,
+          "Export leaves the slot and its journal alone");
+
+    // 复制存档目录会改变修改时间: 日志按源文件的大小和 CRC 判断，仍然有效
+    const fs::path copyDir = root / "copied";
+    fs::create_directories(copyDir);
+    fs::copy_file(jsrc, copyDir / "S3.grp");
+    fs::copy_file(jnl, copyDir / "S3.grp.jnl");
+    fs::last_write_time(copyDir / "S3.grp", fs::last_write_time(jsrc) - std::chrono::hours(48));
+    RawPagedFile copied;
+    Check(copied.open((copyDir / "S3.grp").string(), 4, 2) && copied.journalRecords() == 2 &&
+          std::string(reinterpret_cast<const char*>(copied.read(1)), 4) == "jkBB", "Journal kept after copying the directory");
+    {
+        std::fstream f(copyDir / "S3.grp", std::ios::binary | std::ios::in | std::ios::out);
+        f.seekp(8);
+        f << "Z"; // 同样大小、不同内容
+    }
+    RawPagedFile replaced;
+    Check(replaced.open((copyDir / "S3.grp").string(), 4, 2) && replaced.journalRecords() == 0,
+          "Journal of another base ignored");
+
+    // 换源时旧源文件的日志合并: 另存为别的档 (写盘线程合并)、open() 别的文件
+    auto writeBase = [](const fs::path& path) {
+        std::ofstream f(path, std::ios::binary);
+        f << "AAAABBBBCCCCDDDD";
+    };
+    const fs::path s4 = root / "S4.grp", s5 = root / "S5.grp", s6 = root / "S6.grp";
+    writeBase(s4);
+    RawPagedFile switching;
+    switching.setWriteMode(PagedFile::WriteMode::Journal, 4.0);
+    switching.open(s4.string(), 4, 1);
+    switching.write(1)[0] = 'p';
+    switching.save(s4.string());
+    switching.read(0); // 记录 1 被淘汰，只在日志里
+    switching.write(2)[0] = 'q';
+    PagedFile::Snapshot moveSnap = switching.snapshot(s5.string());
+    Check(PagedFile::writeSnapshot(moveSnap), "Save to another slot");
+    Check(ReadAll(s4) == "AAAApBBBCCCCDDDD" && !fs::exists(root / "S4.grp.jnl"),
+          "Old source merged with what was saved, not with unsaved records");
+    const uint8_t* merged = switching.read(1);
+    Check(merged && std::string(reinterpret_cast<const char*>(merged), 4) == "pBBB", "Read before commit falls back to the merged file");
+    switching.commit(moveSnap, true);
+    Check(ReadAll(s5) == "AAAApBBBqCCCDDDD" && switching.sourcePath() == s5.string(), "New slot has everything");
+
+    switching.write(3)[0] = 'r';
+    switching.save(s5.string());
+    writeBase(s6);
+    Check(switching.open(s6.string(), 4, 1) && ReadAll(s5) == "AAAApBBBqCCCrDDD" && !fs::exists(root / "S5.grp.jnl"),
+          "Opening another file merges the old journal");
+
+    // 合并: 原版可读的完整文件，日志删除
+    Check(reopened.compact(), "Compact journal");
+    Check(ReadAll(jsrc) == "AAAAjkBBCCCCDDDDEEEEFFFFlGGGHHHH" && !fs::exists(jnl), "Journal merged into the file");
+    Check(reopened.stats().compactions == 1 && reopened.journalRecords() == 0, "Compaction counted");
+
+    // 日志超过比例时自动合并
+    RawPagedFile small;
+    small.setWriteMode(PagedFile::WriteMode::Journal, 0.5);
+    small.open(jsrc.string(), 4, 8);
+    small.write(0)[0] = 'm';
+    small.write(2)[0] = 'n';
+    Check(small.save(jsrc.string()) && !fs::exists(jnl) && ReadAll(jsrc) == "mAAAjkBBnCCCDDDDEEEEFFFFlGGGHHHH",
+          "Large journal compacted on save");
+
+    // 尾部不足一条的字节被忽略
+    {
+        std::ofstream f(root / "odd.grp", std::ios::binary);
+        f << "AAAABB";
+    }
+    RawPagedFile odd;
+    Check(odd.open((root / "odd.grp").string(), 4, 2) && odd.count() == 1, "Trailing partial record ignored");
+
+    // 打不开的新文件不影响当前已打开的文件
+    {
+        std::ofstream f(root / "empty.grp", std::ios::binary);
+    }
+    Check(!odd.open((root / "missing.grp").string(), 4, 2) && !odd.open((root / "empty.grp").string(), 4, 2),
+          "Missing and empty files rejected");
+    const uint8_t* kept = odd.read(0);
+    Check(odd.count() == 1 && kept && std::string(reinterpret_cast<const char*>(kept), 4) == "AAAA",
+          "Failed open keeps the current file");
+    odd.write(0)[0] = 'o';
+    Check(odd.save((root / "odd.grp").string()) && ReadAll(root / "odd.grp") == "oAAABB",
+          "In-place save keeps the trailing bytes");
+
+    fs::remove_all(root);
+    return g_failures == 0 ? 0 : 1;
+}
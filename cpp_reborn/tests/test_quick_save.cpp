@@ -0,0 +1,135 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include "PagedFile.h"
+#include "SnapshotRing.h"
+
+namespace fs = std::filesystem;
+
+static int g_failures = 0;
+
+static void Check(bool cond, const std::string& msg) {
+    if (cond) {
+        std::cout << "[PASS] " << msg << std::endl;
+    } else {
+        std::cout << "[FAIL] " << msg << std::endl;
+        ++g_failures;
+    }
+}
+
+static std::string ReadAll(const fs::path& path) {
+    std::ifstream f(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+}
+
+static std::string Record(RawPagedFile& pages, size_t index) {
+    const uint8_t* rec = pages.read(index);
+    return rec ? std::string(reinterpret_cast<const char*>(rec), pages.recordSize()) : std::string();
+}
+
+int main() {
+    // 环: 新的在前，满了丢最旧的，外面拿着的引用不受影响
+    SnapshotRing<int> ring(3);
+    Check(ring.empty() && ring.latest() == nullptr, "Empty ring");
+    auto first = ring.push(1);
+    ring.push(2);
+    ring.push(3);
+    ring.push(4);
+    Check(ring.size() == 3 && *ring.latest() == 4 && *ring.at(2) == 2 && ring.at(3) == nullptr, "Oldest dropped when full");
+    Check(*first == 1, "Dropped entry still readable through its reference");
+    ring.setCapacity(1);
+    Check(ring.size() == 1 && *ring.latest() == 4, "Shrinking keeps the newest");
+
+    const fs::path root = fs::absolute("test_quick_save_tmp");
+    fs::remove_all(root);
+    fs::create_directories(root);
+    const fs::path src = root / "S1.grp";
+    {
+        std::ofstream f(src, std::ios::binary);
+        f << "AAAABBBBCCCCDDDDEEEE";
+    }
+
+    RawPagedFile pages;
+    Check(pages.open(src.string(), 4, 2), "Open paged file");
+    pages.write(1)[0] = 'b';
+
+    PagedFile::Image firstImage;
+    Check(pages.capture(firstImage), "Capture every record");
+    Check(firstImage.records.size() == 5 && *firstImage.records[1] == std::vector<uint8_t>{ 'b', 'B', 'B', 'B' } &&
+          *firstImage.records[4] == std::vector<uint8_t>{ 'E', 'E', 'E', 'E' }, "Dirty and unread records captured");
+    Check(pages.residentCount() == 1, "Capture does not page records in");
+
+    pages.write(3)[0] = 'd';
+    PagedFile::Image secondImage;
+    Check(pages.capture(secondImage, &firstImage), "Capture again");
+    Check(secondImage.records[0] == firstImage.records[0] && secondImage.records[1] == firstImage.records[1],
+          "Unchanged records shared with the previous image");
+    Check(secondImage.records[3] != firstImage.records[3] && (*secondImage.records[3])[0] == 'd',
+          "Changed record copied");
+
+    // 写盘之后再改: 恢复时不读盘
+    Check(pages.save(src.string()), "Save in place");
+    pages.write(1)[1] = 'x';
+    pages.write(2)[0] = 'c';
+    pages.read(0);
+    pages.read(4); // 记录 3 已写出，可被淘汰
+    Check(pages.restore(firstImage) >= 2, "Restore the first image");
+    Check(Record(pages, 1) == "bBBB" && Record(pages, 2) == "CCCC" && Record(pages, 3) == "DDDD",
+          "Records match the first image");
+    Check(pages.isDirty(1) && pages.isDirty(3), "Restored records are dirty");
+    Check(pages.restore(firstImage) == 0, "Restoring the same image again replaces nothing");
+
+    Check(pages.save(src.string()), "Save restored state");
+    Check(ReadAll(src) == "AAAAbBBBCCCCDDDDEEEE", "Saved file equals the first image");
+
+    // 重新打开 (读档) 之后也能恢复，按内容比较
+    const fs::path other = root / "S2.grp";
+    {
+        std::ofstream f(other, std::ios::binary);
+        f << "0000111122223333";
+    }
+    Check(pages.open(other.string(), 4, 2), "Open another slot");
+    Check(pages.restore(firstImage) == -1, "Image for a different record count rejected");
+    Check(pages.open(src.string(), 4, 2), "Reopen the slot");
+    pages.write(0)[0] = 'z';
+    Check(pages.restore(secondImage) >= 1 && Record(pages, 0) == "AAAA" && Record(pages, 3) == "dDDD",
+          "Restore across a reopen");
+
+    // 写到另一个存档位
+    const fs::path flushed = root / "S3.grp";
+    Check(PagedFile::writeSnapshot(PagedFile::snapshotOf(secondImage, flushed.string())), "Write an image to a slot");
+    Check(ReadAll(flushed) == "AAAAbBBBCCCCdDDDEEEE", "Written slot equals the image");
+
+    // 自动存档: 主线程不读盘，未驻留的记录由写盘线程从源文件和日志读
+    const fs::path jsrc = root / "S4.grp";
+    {
+        std::ofstream f(jsrc, std::ios::binary);
+        f << "AAAABBBBCCCCDDDDEEEE";
+    }
+    RawPagedFile journaled;
+    journaled.setWriteMode(PagedFile::WriteMode::Journal, 4.0);
+    journaled.open(jsrc.string(), 4, 2);
+    journaled.write(1)[0] = 'j';
+    journaled.save(jsrc.string());
+    journaled.read(0); // 记录 1 只在日志里
+    journaled.write(3)[0] = 'w';
+    const uint64_t pageIns = journaled.stats().pageIns;
+    Check(journaled.captureBytes(nullptr, true) == 8 && journaled.captureBytes(nullptr, false) == 20,
+          "Deferred capture copies only resident records");
+    PagedFile::Image deferred;
+    Check(journaled.capture(deferred, nullptr, true) && journaled.stats().pageIns == pageIns, "Deferred capture reads nothing");
+    Check(!deferred.records[1] && !deferred.records[4] && deferred.records[0] && deferred.records[3], "Non-resident records left null");
+    PagedFile::Image next;
+    journaled.capture(next, &deferred, true);
+    Check(next.records[3] == deferred.records[3] && journaled.captureBytes(&deferred, true) == 0, "Deferred images share too");
+    const fs::path autoSlot = root / "S6.grp";
+    Check(PagedFile::writeSnapshot(PagedFile::snapshotOf(deferred, autoSlot.string())) &&
+          ReadAll(autoSlot) == "AAAAjBBBCCCCwDDDEEEE", "Worker fills deferred records from the source and journal");
+    fs::remove(jsrc.string() + ".jnl");
+    Check(PagedFile::snapshotOf(deferred, autoSlot.string()).base.size() == 20, "Journal merged meanwhile: read from the file");
+
+    fs::remove_all(root);
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include "Role.h"
+#include "Item.h"
+#include "Scene.h"
+#include "SaveImage.h"
+
+static int g_failures = 0;
+
+static void Check(bool cond, const std::string& msg) {
+    if (cond) {
+        std::cout << "[PASS] " << msg << std::endl;
+    } else {
+        std::cout << "[FAIL] " << msg << std::endl;
+        ++g_failures;
+    }
+}
+
+namespace {
+    template <typename Fn>
+    double MsPer(int rounds, Fn&& fn) {
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; ++r) fn();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / rounds;
+    }
+}
+
+int main() {
+    // 视图与块
+    RoleTable roles(3);
+    Check(roles.size() == 3 && roles[2].getLevel() == 0, "New records are zero");
+    roles[1].setLevel(7);
+    roles[1].setName("Hero");
+    Check(roles.data()[ROLE_DATA_SIZE + 15] == 7, "Setter writes into the block");
+    Check(roles[1].getRawData() == roles.data() + ROLE_DATA_SIZE && roles[1].isView(), "Record i is a view at i * N");
+    Check(roles[1].getName() == "Hero", "Strings through the view");
+
+    Role copy = roles[1];
+    copy.setLevel(9);
+    Check(!copy.isView() && roles[1].getLevel() == 7, "A copy owns its data");
+    roles[0] = copy;
+    Check(roles[0].isView() && roles[0].getLevel() == 9 && roles.data()[15] == 9, "Assignment writes through the view");
+
+    Role standalone;
+    standalone.setMaxHP(321);
+    roles.push_back(standalone);
+    Check(roles.size() == 4 && roles[3].getMaxHP() == 321 && roles[1].getLevel() == 7, "push_back keeps earlier records");
+    Check(roles[0].getRawData() == roles.data() && roles[3].getRawData() == roles.data() + 3 * ROLE_DATA_SIZE,
+          "Views rebound after the block grows");
+
+    RoleTable copied = roles;
+    copied[1].setLevel(50);
+    Check(roles[1].getLevel() == 7 && copied[1].getLevel() == 50 && copied[1].getRawData() == copied.data() + ROLE_DATA_SIZE,
+          "Table copy is independent");
+    const int16_t* block = copied.data();
+    RoleTable moved = std::move(copied);
+    Check(moved.data() == block && moved[1].getLevel() == 50 && moved[1].getRawData() == block + ROLE_DATA_SIZE,
+          "Move keeps the block and the views");
+    roles = moved;
+    Check(roles[1].getLevel() == 50 && roles[1].getRawData() == roles.data() + ROLE_DATA_SIZE, "Table assignment");
+
+    // 未对齐的缓冲区，一次拷贝
+    std::vector<uint8_t> packed(1 + 2 * ITEM_DATA_SIZE * 2, 0);
+    int16_t value = 1234;
+    std::memcpy(packed.data() + 1 + (ITEM_DATA_SIZE + 2) * 2, &value, 2);
+    ItemTable items;
+    items.assign(packed.data() + 1, 2);
+    Check(items.size() == 2 && items[1].getRawData()[2] == 1234, "assign from an unaligned buffer");
+    items.resize(1);
+    Check(items.size() == 1 && items.data() == items[0].getRawData(), "Shrink");
+    items.clear();
+    Check(items.empty(), "Clear");
+
+    // 单独对象: WarData 的 setDataVector 可以变长，视图不会
+    Scene owned;
+    owned.setDataVector(std::vector<int16>(SCENE_DATA_SIZE + 4, 5));
+    Check(owned.getDataSize() == SCENE_DATA_SIZE + 4 && owned.getMapNum() == 5, "Owned record grows");
+    SceneTable scenes(2);
+    scenes[0].setDataVector(std::vector<int16>(SCENE_DATA_SIZE + 4, 6));
+    Check(scenes[0].getDataSize() == SCENE_DATA_SIZE && scenes[1].getListNum() == 0 && scenes[0].getMapNum() == 6,
+          "View keeps its size, neighbours untouched");
+
+    // 存档: 整段写出、读回
+    SaveLayout layout;
+    layout.roleOffset = 4;
+    layout.itemOffset = layout.roleOffset + 4 * static_cast<int32_t>(ROLE_DATA_SIZE) * 2;
+    layout.sceneOffset = layout.itemOffset + 10; // less than one item
+    layout.magicOffset = layout.sceneOffset + 2 * static_cast<int32_t>(SCENE_DATA_SIZE) * 2;
+    layout.shopOffset = layout.magicOffset;
+    layout.totalLength = layout.shopOffset + 2;
+    SaveImageWriter writer(layout);
+    Check(writer.putTable(layout.roleOffset, layout.itemOffset, roles) == 4, "Write role table");
+    scenes[1].getRawData()[23] = 77;
+    Check(writer.putTable(layout.sceneOffset, layout.magicOffset, scenes) == 2, "Write scene table");
+    ItemTable oneItem(1);
+    Check(writer.putTable(layout.itemOffset, layout.sceneOffset, oneItem) == 0, "Record larger than the section dropped");
+
+    std::vector<uint8_t> bytes = writer.bytes();
+    bytes.resize(layout.magicOffset - 2); // last scene cut short
+    SaveImageReader reader(layout, bytes);
+    RoleTable readRoles;
+    SceneTable readScenes;
+    Check(reader.getTable(layout.roleOffset, layout.itemOffset, readRoles) == 4 &&
+          std::memcmp(readRoles.data(), roles.data(), 4 * ROLE_DATA_SIZE * 2) == 0, "Roles read back");
+    Check(reader.getTable(layout.sceneOffset, layout.magicOffset, readScenes) == 2 && readScenes[0].getMapNum() == 6 &&
+          readScenes[1].getMapNum() == 77 && readScenes[1].getRawData()[25] == 0, "Truncated scene: missing values are 0");
+
+    // 快照 (QuickSave) 的开销: 每条记录一个 vector 对比一块连续内存
+    const size_t COUNT = 1000;
+    std::vector<Role> perObject(COUNT);
+    RoleTable table(COUNT);
+    for (size_t i = 0; i < COUNT; ++i) {
+        perObject[i].setLevel(static_cast<int16>(i));
+        table[i].setLevel(static_cast<int16>(i));
+    }
+    size_t sink = 0;
+    double vectorMs = MsPer(200, [&] { std::vector<Role> c = perObject; sink += c[COUNT - 1].getLevel(); });
+    double tableMs = MsPer(200, [&] { RoleTable c = table; sink += c[COUNT - 1].getLevel(); });
+    int64_t sum = 0;
+    double iterMs = MsPer(200, [&] { for (const Role& r : table) sum += r.getLevel(); });
+    std::cout << "Copy " << COUNT << " roles: per-object " << vectorMs << " ms, table " << tableMs << " ms; iterate "
+              << iterMs << " ms (" << sink + sum % 2 << ")" << std::endl;
+
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,72 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <filesystem>
+#include "ResourceWatcher.h"
+
+namespace fs = std::filesystem;
+
+static int g_failures = 0;
+
+static void Check(bool cond, const std::string& msg) {
+    if (cond) {
+        std::cout << "[PASS] " << msg << std::endl;
+    } else {
+        std::cout << "[FAIL] " << msg << std::endl;
+        ++g_failures;
+    }
+}
+
+static void WriteFile(const fs::path& path, const std::string& text) {
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    f << text;
+}
+
+// 轮询直到出现变化或超时 (轮询模式每秒扫描一次，因此最长等 3 秒)
+static std::vector<std::string> WaitForChanges(ResourceWatcher& watcher) {
+    std::vector<std::string> changed;
+    for (int i = 0; i < 300 && changed.empty(); ++i) {
+        watcher.poll(changed);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return changed;
+}
+
+int main() {
+    const fs::path root = fs::absolute("test_watcher_tmp");
+    fs::remove_all(root);
+    fs::create_directories(root / "sub");
+    WriteFile(root / "Talk.grp", "old");
+
+    ResourceWatcher watcher;
+    Check(!watcher.start({ (root / "missing").string() }), "Missing root is rejected");
+    Check(watcher.start({ root.string() }, 50), "Watcher started");
+
+    std::vector<std::string> none;
+    watcher.poll(none);
+    Check(none.empty(), "No changes reported at start");
+
+    // 确保修改时间与初始快照不同
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    WriteFile(root / "Talk.grp", "new contents");
+    auto changed = WaitForChanges(watcher);
+    Check(changed.size() == 1 && changed[0] == "talk.grp", "Modified file reported with its normalized name");
+
+    WriteFile(root / "sub" / "a.bin", "x");
+    changed = WaitForChanges(watcher);
+    Check(std::find(changed.begin(), changed.end(), "sub/a.bin") != changed.end(), "File in a subdirectory reported");
+
+    // 多次快速写入只报告一次
+    WriteFile(root / "smp", "1");
+    WriteFile(root / "smp", "12");
+    changed = WaitForChanges(watcher);
+    Check(std::count(changed.begin(), changed.end(), "smp") == 1, "Repeated writes are merged");
+
+    watcher.stop();
+    fs::remove_all(root);
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <filesystem>
+#include "Crc32c.h"
+#include "SaveContainer.h"
+#include "PagedFile.h"
+
+namespace fs = std::filesystem;
+
+static int g_failures = 0;
+
+static void Check(bool cond, const std::string& msg) {
+    if (cond) {
+        std::cout << "[PASS] " << msg << std::endl;
+    } else {
+        std::cout << "[FAIL] " << msg << std::endl;
+        ++g_failures;
+    }
+}
+
+static std::vector<uint8_t> ReadAll(const fs::path& path) {
+    std::ifstream f(path, std::ios::binary);
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+}
+
+int main() {
+    // CRC-32C 标准测试值
+    const char* check = "123456789";
+    Check(Crc32c::computeSoftware(check, 9) == 0xE3069283u, "Software CRC-32C of \"123456789\"");
+    Check(Crc32c::compute(check, 9) == 0xE3069283u, "CRC-32C of \"123456789\"");
+    Check(Crc32c::compute(check + 4, 5, Crc32c::compute(check, 4)) == 0xE3069283u, "CRC continued over two parts");
+    std::vector<uint8_t> noise(100003);
+    uint32_t seed = 12345;
+    for (auto& b : noise) {
+        seed = seed * 1103515245u + 12345u;
+        b = static_cast<uint8_t>(seed >> 16);
+    }
+    Check(Crc32c::compute(noise.data(), noise.size()) == Crc32c::computeSoftware(noise.data(), noise.size()),
+          std::string("Hardware and table CRC agree (hardware: ") + (Crc32c::hardware() ? "yes" : "no") + ")");
+
+    // 类似 SData 的数据: 大半是 0，少量重复图块
+    std::vector<uint8_t> scene(6 * 64 * 64 * 2 * 3, 0);
+    for (size_t i = 0; i < scene.size() / 6; i += 2) scene[i] = static_cast<uint8_t>((i / 2) % 7 + 1);
+    std::vector<uint8_t> packed = SaveContainer::pack(scene.data(), scene.size(), 16 * 1024);
+    Check(SaveContainer::isContainer(packed.data(), packed.size()), "Packed data is a container");
+    Check(packed.size() * 10 < scene.size(), "Scene-like data shrinks more than 10x");
+    std::vector<uint8_t> raw;
+    Check(SaveContainer::unpack(packed.data(), packed.size(), raw) && raw == scene, "Round trip");
+
+    std::vector<uint8_t> packedNoise = SaveContainer::pack(noise.data(), noise.size());
+    Check(packedNoise.size() < noise.size() + 64 && SaveContainer::unpack(packedNoise.data(), packedNoise.size(), raw) &&
+          raw == noise, "Incompressible blocks stored raw");
+
+    std::vector<uint8_t> empty = SaveContainer::pack(nullptr, 0);
+    Check(SaveContainer::unpack(empty.data(), empty.size(), raw) && raw.empty(), "Empty file");
+
+    // 损坏检测
+    std::vector<uint8_t> damaged = packed;
+    damaged.back() ^= 0x40;
+    Check(!SaveContainer::unpack(damaged.data(), damaged.size(), raw), "Flipped payload bit detected");
+    damaged = packed;
+    damaged[20] ^= 1; // rawSize
+    Check(!SaveContainer::unpack(damaged.data(), damaged.size(), raw), "Damaged header detected");
+    Check(!SaveContainer::unpack(packed.data(), packed.size() - 3, raw), "Truncated container rejected");
+
+    // 文件: 两种格式都能读，导出为原始格式
+    const fs::path root = fs::absolute("test_save_container_tmp");
+    fs::remove_all(root);
+    fs::create_directories(root);
+    const fs::path plainPath = root / "R1.grp";
+    const fs::path packedPath = root / "R2.grp";
+    Check(SaveContainer::writeFile(plainPath.string(), scene.data(), scene.size(), false), "Write raw save");
+    Check(SaveContainer::writeFile(packedPath.string(), scene.data(), scene.size(), true), "Write compressed save");
+    Check(ReadAll(plainPath) == scene && !SaveContainer::isContainerFile(plainPath.string()), "Raw save is untouched bytes");
+    Check(SaveContainer::isContainerFile(packedPath.string()), "Compressed save is a container");
+    Check(SaveContainer::readFile(plainPath.string(), raw) && raw == scene, "readFile passes raw saves through");
+    Check(SaveContainer::readFile(packedPath.string(), raw) && raw == scene, "readFile unpacks containers");
+    Check(SaveContainer::exportRaw(packedPath.string(), (root / "export" / "R2.grp").string()) &&
+          ReadAll(root / "export" / "R2.grp") == scene, "Export to the original format");
+    {
+        std::ofstream f(plainPath.string() + ".jnl", std::ios::binary);
+        f << "KJNL";
+    }
+    Check(!SaveContainer::exportRaw(plainPath.string(), (root / "export" / "R1.grp").string()) &&
+          !fs::exists(root / "export" / "R1.grp"), "Export refused while a journal is pending");
+    fs::remove(plainPath.string() + ".jnl");
+
+    // 分页文件: 压缩存档写出后从内存分页，重新打开也能读
+    const fs::path sPath = root / "S1.grp";
+    {
+        std::ofstream f(sPath, std::ios::binary);
+        f << "AAAABBBBCCCCDDDDEEEE";
+    }
+    RawPagedFile pages;
+    pages.setCompressed(true);
+    Check(pages.open(sPath.string(), 4, 2), "Open raw SData");
+    pages.write(2)[0] = 'c';
+    Check(pages.save(sPath.string()), "Compressed save over the open file");
+    Check(SaveContainer::isContainerFile(sPath.string()) && !pages.isDirty(2), "File became a container");
+    Check(pages.sourcePath().empty() && std::memcmp(pages.read(4), "EEEE", 4) == 0 &&
+          std::memcmp(pages.read(2), "cCCC", 4) == 0, "Records paged from the written image");
+    pages.write(0)[0] = 'a';
+    Check(pages.save(sPath.string()), "Second compressed save");
+
+    RawPagedFile reopened;
+    Check(reopened.open(sPath.string(), 4, 2) && reopened.count() == 5, "Reopen the container");
+    Check(std::memcmp(reopened.read(0), "aAAA", 4) == 0 && std::memcmp(reopened.read(2), "cCCC", 4) == 0,
+          "Records read back from the container");
+    Check(reopened.save((root / "S2.grp").string()) && !SaveContainer::isContainerFile((root / "S2.grp").string()),
+          "Uncompressed save-as writes the raw format");
+    std::vector<uint8_t> s2 = ReadAll(root / "S2.grp");
+    Check(std::string(s2.begin(), s2.end()) == "aAAABBBBcCCCDDDDEEEE", "Raw save-as content");
+
+    fs::remove_all(root);
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,121 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <filesystem>
+#include "SaveImage.h"
+
+namespace fs = std::filesystem;
+
+static int g_failures = 0;
+
+static void Check(bool cond, const std::string& msg) {
+    if (cond) {
+        std::cout << "[PASS] " << msg << std::endl;
+    } else {
+        std::cout << "[FAIL] " << msg << std::endl;
+        ++g_failures;
+    }
+}
+
+// 与 Role/Item 相同的接口 (getRawData / getDataSize)
+struct Record {
+    std::vector<int16_t> data;
+    const int16_t* getRawData() const { return data.data(); }
+    size_t getDataSize() const { return data.size(); }
+};
+
+// 读回用: 与 Role/Item 一样，默认构造即为定长记录
+template <size_t N>
+struct FixedRecord {
+    int16_t data[N] = {};
+    int16_t* getRawData() { return data; }
+    size_t getDataSize() const { return N; }
+};
+
+static std::vector<uint8_t> ReadAll(const fs::path& path) {
+    std::ifstream f(path, std::ios::binary);
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+}
+
+int main() {
+    const fs::path root = fs::absolute("test_save_image_tmp");
+    fs::remove_all(root);
+    fs::create_directories(root);
+
+    // 头部 6 字节, Role 8 字节 (2 条 2 值记录), Item 6 字节, Scene 0, Magic 4, Shop 3
+    {
+        int32_t offsets[6] = { 6, 14, 20, 20, 24, 27 };
+        std::ofstream f(root / "ranger.idx", std::ios::binary);
+        f.write(reinterpret_cast<const char*>(offsets), sizeof(offsets));
+    }
+    SaveLayout layout;
+    Check(SaveLayout::load((root / "ranger.idx").string(), layout), "Load ranger.idx");
+    Check(layout.roleOffset == 6 && layout.shopOffset == 24 && layout.totalLength == 27, "Offsets read");
+    {
+        int32_t bad[6] = { 6, 4, 20, 20, 24, 27 };
+        std::ofstream f(root / "bad.idx", std::ios::binary);
+        f.write(reinterpret_cast<const char*>(bad), sizeof(bad));
+    }
+    SaveLayout rejected;
+    Check(!SaveLayout::load((root / "bad.idx").string(), rejected), "Out of order offsets rejected");
+    Check(!SaveLayout::load((root / "missing.idx").string(), rejected), "Missing ranger.idx rejected");
+
+    SaveImageWriter image(layout);
+    Check(image.bytes().size() == 27, "Image has the full file length");
+
+    image.putHeader({ 1, 2, 3, 4 }); // 8 字节 > 6: 截断
+    std::vector<Record> roles = { { { 10, 11 } }, { { 12, 13 } }, { { 14, 15 } } };
+    Check(image.putTable(layout.roleOffset, layout.itemOffset, roles, 2) == 2, "Records that do not fit are dropped");
+    std::vector<Record> items = { { { 20, 21, 22 } } };
+    Check(image.putTable(layout.itemOffset, layout.sceneOffset, items, 2) == 1, "Longer record truncated to record size");
+    std::vector<Record> none;
+    Check(image.putTable(layout.sceneOffset, layout.magicOffset, none, 2) == 0, "Empty section");
+    std::vector<Record> magics = { { { 30 } } };
+    image.putTable(layout.magicOffset, layout.shopOffset, magics, 2);
+    image.putBytes(layout.shopOffset, layout.totalLength, { 0xAA, 0xBB, 0xCC, 0xDD });
+
+    // 原逐字段写法的结果
+    std::vector<uint8_t> expected(27, 0);
+    auto put16 = [&](size_t at, int16_t v) { std::memcpy(&expected[at], &v, 2); };
+    put16(0, 1); put16(2, 2); put16(4, 3);
+    put16(6, 10); put16(8, 11); put16(10, 12); put16(12, 13);
+    put16(14, 20); put16(16, 21);
+    put16(20, 30);
+    expected[24] = 0xAA; expected[25] = 0xBB; expected[26] = 0xCC;
+    Check(image.bytes() == expected, "Image matches the per-field layout byte for byte");
+
+    const fs::path save = root / "R1.grp";
+    {
+        std::ofstream f(save, std::ios::binary);
+        f << "old save contents that are longer than the new one";
+    }
+    Check(image.writeTo(save.string()), "Atomic write");
+    Check(ReadAll(save) == expected, "Existing save replaced");
+    Check(!fs::exists(root / "R1.grp.tmp"), "Temp file renamed away");
+
+    Check(image.writeTo((root / "new" / "R2.grp").string()), "Atomic write creates the directory");
+
+    // 读回: 一次读入后按表拷贝
+    SaveImageReader reader(layout, ReadAll(save));
+    std::vector<int16_t> header = reader.header();
+    Check(header == std::vector<int16_t>({ 1, 2, 3 }), "Header read up to RoleOffset");
+    std::vector<FixedRecord<2>> readRoles(5);
+    Check(reader.getTable(layout.roleOffset, layout.itemOffset, readRoles, 2) == 2 && readRoles.size() == 2 &&
+          readRoles[1].data[0] == 12 && readRoles[1].data[1] == 13, "Role table copied record by record");
+    std::vector<FixedRecord<3>> readItems;
+    reader.getTable(layout.itemOffset, layout.sceneOffset, readItems, 2);
+    Check(readItems.size() == 1 && readItems[0].data[1] == 21 && readItems[0].data[2] == 0,
+          "Wider record keeps its tail zeroed");
+    Check(reader.getBytes(layout.shopOffset, layout.totalLength) == std::vector<uint8_t>({ 0xAA, 0xBB, 0xCC }), "Shop bytes");
+
+    std::vector<uint8_t> shortFile = expected;
+    shortFile.resize(25);
+    SaveImageReader shortReader(layout, shortFile);
+    Check(shortReader.getBytes(layout.shopOffset, layout.totalLength) == std::vector<uint8_t>({ 0xAA, 0, 0 }),
+          "Bytes past the end of a short file are 0");
+
+    fs::remove_all(root);
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,99 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include "SaveSlotInfo.h"
+
+namespace fs = std::filesystem;
+
+static int g_failures = 0;
+
+static void Check(bool cond, const std::string& msg) {
+    if (cond) {
+        std::cout << "[PASS] " << msg << std::endl;
+    } else {
+        std::cout << "[FAIL] " << msg << std::endl;
+        ++g_failures;
+    }
+}
+
+int main() {
+    const fs::path root = fs::absolute("test_save_slot_info_tmp");
+    fs::remove_all(root);
+    fs::create_directories(root);
+
+    Check(SaveSlotInfo::pathFor("save/R1.grp") == "save/R1.inf", "R1.grp -> R1.inf");
+    Check(SaveSlotInfo::pathFor("save.d/ranger") == "save.d/ranger.inf", "Extension only taken from the file name");
+
+    SaveSlotInfo info;
+    info.sceneId = 70;
+    info.sceneName = "\xD0\xA1\xB4\xE5"; // GBK
+    info.mapX = 31;
+    info.mapY = -2;
+    info.leadName = "\xD0\xA1\xCF\xBA\xD7\xD3\xB0\xA1\xB0\xA1\xB0\xA1\xB0\xA1\xB0\xA1\xB0\xA1"; // 18 bytes
+    info.leadLevel = 12;
+    info.team = { 0, 3, 7 };
+    info.savedAt = 1700000000;
+    info.thumbWidth = 4;
+    info.thumbHeight = 2;
+    info.thumbnail = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+    std::vector<uint8_t> bytes = info.serialize();
+    Check(bytes.size() == SaveSlotInfo::HEADER_SIZE + 16, "Header plus 4x2 RGB565 thumbnail");
+
+    SaveSlotInfo header;
+    Check(SaveSlotInfo::parse(bytes.data(), SaveSlotInfo::HEADER_SIZE, header, false), "Header alone parses");
+    Check(header.sceneId == 70 && header.mapX == 31 && header.mapY == -2 && header.leadLevel == 12,
+          "Scene, position and level round trip");
+    Check(header.sceneName == info.sceneName, "Scene name round trips");
+    Check(header.leadName == info.leadName.substr(0, SaveSlotInfo::NAME_BYTES), "Long name truncated to NAME_BYTES");
+    Check(header.team == info.team && header.savedAt == 1700000000, "Team and timestamp round trip");
+    Check(header.thumbWidth == 4 && header.thumbHeight == 2 && header.thumbnail.empty(),
+          "Thumbnail size known, pixels not read");
+
+    const std::string path = (root / "R1.inf").string();
+    Check(info.writeTo(path), "Write R1.inf");
+    SaveSlotInfo fromDisk;
+    Check(SaveSlotInfo::read(path, fromDisk) && fromDisk.thumbnail.empty() && fromDisk.sceneId == 70,
+          "Header-only read from disk");
+    Check(SaveSlotInfo::read(path, fromDisk, true) && fromDisk.thumbnail == info.thumbnail, "Thumbnail read on request");
+
+    SaveSlotInfo plain;
+    plain.thumbWidth = 8; // no pixels: stored without a thumbnail
+    plain.thumbHeight = 8;
+    std::vector<uint8_t> plainBytes = plain.serialize();
+    SaveSlotInfo plainBack;
+    Check(plainBytes.size() == SaveSlotInfo::HEADER_SIZE &&
+          SaveSlotInfo::parse(plainBytes.data(), plainBytes.size(), plainBack, true) &&
+          plainBack.thumbWidth == 0 && plainBack.thumbnail.empty() && plainBack.sceneId == -1,
+          "Missing thumbnail stored as 0x0");
+
+    // 损坏或不认识的文件
+    SaveSlotInfo rejected;
+    Check(!SaveSlotInfo::read((root / "missing.inf").string(), rejected), "Missing file rejected");
+    Check(!SaveSlotInfo::parse(bytes.data(), SaveSlotInfo::HEADER_SIZE - 1, rejected, false), "Short header rejected");
+    std::vector<uint8_t> badMagic = bytes;
+    badMagic[0] = 'X';
+    Check(!SaveSlotInfo::parse(badMagic.data(), badMagic.size(), rejected, false), "Bad magic rejected");
+    std::vector<uint8_t> badVersion = bytes;
+    badVersion[4] = 99;
+    Check(!SaveSlotInfo::parse(badVersion.data(), badVersion.size(), rejected, false), "Unknown version rejected");
+    SaveSlotInfo truncated;
+    Check(SaveSlotInfo::parse(bytes.data(), bytes.size() - 2, truncated, true) && truncated.thumbnail.empty(),
+          "Truncated thumbnail skipped, header kept");
+
+    // 缩略图: 4x4 ARGB 缩到 2x2 取每块左上角
+    std::vector<uint32_t> frame(16, 0);
+    frame[0] = 0xFFFF0000;       // red at (0,0)
+    frame[2] = 0xFF00FF00;       // green at (2,0)
+    frame[8] = 0xFF0000FF;       // blue at (0,2)
+    frame[10] = 0xFFFFFFFF;      // white at (2,2)
+    std::vector<uint16_t> small = SaveSlotInfo::downscale(frame.data(), 4, 4, 16, 2, 2);
+    Check(small.size() == 4 && small[0] == 0xF800 && small[1] == 0x07E0 && small[2] == 0x001F && small[3] == 0xFFFF,
+          "Downscale point-samples to RGB565");
+    Check(SaveSlotInfo::downscale(nullptr, 4, 4, 16, 2, 2).empty(), "Downscale without a frame is empty");
+
+    fs::remove_all(root);
+    return g_failures == 0 ? 0 : 1;
+}
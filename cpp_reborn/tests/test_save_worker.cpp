@@ -0,0 +1,69 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "SaveWorker.h"
+
+static int g_failures = 0;
+
+static void Check(bool cond, const std::string& msg) {
+    if (cond) {
+        std::cout << "[PASS] " << msg << std::endl;
+    } else {
+        std::cout << "[FAIL] " << msg << std::endl;
+        ++g_failures;
+    }
+}
+
+int main() {
+    const std::thread::id mainThread = std::this_thread::get_id();
+    std::vector<int> written;   // 只在工作线程上写
+    std::vector<int> completed; // 只在主线程上写
+    bool writeOffMainThread = true;
+    bool doneOnMainThread = true;
+    std::atomic<bool> release{ false };
+
+    {
+        SaveWorker worker;
+        Check(!worker.busy() && worker.poll() == 0, "Idle worker");
+
+        // 第一个写盘任务等待放行，确认 submit 不阻塞主线程
+        worker.submit(
+            [&](std::string&) {
+                while (!release) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                writeOffMainThread = writeOffMainThread && std::this_thread::get_id() != mainThread;
+                written.push_back(1);
+                return true;
+            },
+            [&](bool ok, const std::string&) {
+                doneOnMainThread = doneOnMainThread && std::this_thread::get_id() == mainThread;
+                completed.push_back(ok ? 1 : -1);
+            });
+        worker.submit(
+            [&](std::string& error) {
+                written.push_back(2);
+                error = "disk full";
+                return false;
+            },
+            [&](bool ok, const std::string& error) {
+                doneOnMainThread = doneOnMainThread && std::this_thread::get_id() == mainThread;
+                completed.push_back(ok ? 2 : (error == "disk full" ? -2 : 0));
+            });
+
+        Check(worker.busy() && completed.empty(), "Submit returns before the write");
+        release = true;
+        worker.wait();
+        Check(written == std::vector<int>({ 1, 2 }), "Writes run in submit order");
+        Check(completed == std::vector<int>({ 1, -2 }), "Completion and error reported by wait()");
+        Check(writeOffMainThread && doneOnMainThread, "Write on worker thread, callback on main thread");
+        Check(!worker.busy(), "Idle after wait");
+
+        worker.submit([&](std::string&) { written.push_back(3); return true; }, nullptr);
+        // 析构时写完剩余任务
+    }
+    Check(written.size() == 3 && written[2] == 3, "Pending write finished on destruction");
+
+    return g_failures == 0 ? 0 : 1;
+}
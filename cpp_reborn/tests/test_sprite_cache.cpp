@@ -0,0 +1,240 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include "SpriteCache.h"
+#include "GraphicsUtils.h"
+
+namespace fs = std::filesystem;
+
+static int g_failures = 0;
+
+static void Check(bool cond, const std::string& msg) {
+    if (cond) {
+        std::cout << "[PASS] " << msg << std::endl;
+    } else {
+        std::cout << "[FAIL] " << msg << std::endl;
+        ++g_failures;
+    }
+}
+
+// 一张贴图: 每行的调色板索引，-1 为透明
+struct TestSprite {
+    int xs = 0, ys = 0;
+    std::vector<std::vector<int>> rows;
+};
+
+// 与原版相同的 RLE8 编码: w h xs ys，每行 { 字节数, (跳过, 个数, 像素...)* }
+static std::vector<uint8_t> EncodeRLE(const TestSprite& sprite) {
+    auto put16 = [](std::vector<uint8_t>& out, int v) {
+        out.push_back(static_cast<uint8_t>(v & 0xFF));
+        out.push_back(static_cast<uint8_t>((v >> 8) & 0xFF));
+    };
+    size_t w = 0;
+    for (const auto& row : sprite.rows) w = std::max(w, row.size());
+    std::vector<uint8_t> out;
+    put16(out, static_cast<int>(w));
+    put16(out, static_cast<int>(sprite.rows.size()));
+    put16(out, sprite.xs);
+    put16(out, sprite.ys);
+    for (const auto& row : sprite.rows) {
+        std::vector<uint8_t> packets;
+        size_t x = 0, drawn = 0;
+        while (x < row.size()) {
+            while (x < row.size() && row[x] < 0) ++x;
+            if (x == row.size()) break;
+            size_t run = x;
+            while (run < row.size() && row[run] >= 0) ++run;
+            packets.push_back(static_cast<uint8_t>(x - drawn)); // 跳过的透明像素
+            packets.push_back(static_cast<uint8_t>(run - x));
+            for (; x < run; ++x) packets.push_back(static_cast<uint8_t>(row[x]));
+            drawn = run;
+        }
+        out.push_back(static_cast<uint8_t>(packets.size()));
+        out.insert(out.end(), packets.begin(), packets.end());
+    }
+    return out;
+}
+
+static void WriteFile(const fs::path& path, const std::vector<uint8_t>& bytes) {
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    f.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+static std::vector<uint8_t> ReadAll(const fs::path& path) {
+    std::ifstream f(path, std::ios::binary);
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+}
+
+// grp = 各贴图依次排列，idx = 每张的起始偏移 (smp/sdx 的格式)
+static void WriteArchive(const fs::path& grp, const fs::path& idx, const std::vector<TestSprite>& sprites,
+                         std::vector<std::vector<uint8_t>>& encoded) {
+    std::vector<uint8_t> data;
+    std::vector<int32_t> offsets;
+    encoded.clear();
+    for (const auto& s : sprites) {
+        offsets.push_back(static_cast<int32_t>(data.size()));
+        encoded.push_back(EncodeRLE(s));
+        data.insert(data.end(), encoded.back().begin(), encoded.back().end());
+    }
+    WriteFile(grp, data);
+    std::vector<uint8_t> idxBytes(offsets.size() * 4);
+    std::memcpy(idxBytes.data(), offsets.data(), idxBytes.size());
+    WriteFile(idx, idxBytes);
+}
+
+static bool SameSurface(SDL_Surface* a, SDL_Surface* b) {
+    for (int y = 0; y < a->h; ++y) {
+        if (std::memcmp(static_cast<uint8_t*>(a->pixels) + y * a->pitch, static_cast<uint8_t*>(b->pixels) + y * b->pitch,
+                        static_cast<size_t>(a->w) * 4) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void Clear(SDL_Surface* s) {
+    for (int y = 0; y < s->h; ++y) std::memset(static_cast<uint8_t*>(s->pixels) + y * s->pitch, 0, static_cast<size_t>(s->w) * 4);
+}
+
+int main() {
+    const fs::path root = fs::absolute("test_sprite_cache_tmp");
+    fs::remove_all(root);
+    fs::create_directories(root);
+
+    // 调色板: 4 组 256 色，各分量不同，便于发现索引错位
+    std::vector<uint8_t> palette(4 * 768);
+    for (size_t i = 0; i < palette.size(); ++i) palette[i] = static_cast<uint8_t>((i * 7 + i / 3) % 64);
+    WriteFile(root / "mmap.col", palette);
+    GraphicsUtils::loadPalette((root / "mmap.col").string());
+
+    std::vector<TestSprite> sprites(3);
+    sprites[0].xs = 3;
+    sprites[0].ys = 5;
+    sprites[0].rows = { { 1, 2, 3, -1, -1, 4, 5 }, { -1, -1, 6 }, {}, { 7, -1, 8, -1, 9, 10, 11, 12 }, { 200, 201 } };
+    sprites[1].xs = -2;
+    sprites[1].ys = 0;
+    for (int y = 0; y < 9; ++y) {
+        std::vector<int> row;
+        for (int x = 0; x < 11; ++x) row.push_back(((x + y) % 4 == 0) ? -1 : (x * 13 + y * 5) % 256);
+        sprites[1].rows.push_back(row);
+    }
+    sprites[2].xs = 0;
+    sprites[2].ys = 0;
+    sprites[2].rows = { { -1, -1, -1, 40 } };
+
+    const fs::path grp = root / "smp";
+    const fs::path idx = root / "sdx";
+    std::vector<std::vector<uint8_t>> encoded;
+    WriteArchive(grp, idx, sprites, encoded);
+
+    const std::string cacheName = "test_sprite_cache.kcc";
+    const fs::path cachePath = fs::path(SpriteCache::CACHE_DIR) / cacheName;
+    fs::remove(cachePath);
+
+    SpriteCache cache;
+    Check(cache.openRLE(grp.string(), idx.string(), cacheName) && cache.count() == 3 && fs::exists(cachePath),
+          "Cache built on first open");
+
+    // DrawIndexed8 与 DrawRLE8 逐像素一致: 原尺寸、放大、缩小，部分越出画面，带阴影
+    SDL_Surface* expected = SDL_CreateSurface(40, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Surface* actual = SDL_CreateSurface(40, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (!expected || !actual) {
+        std::cout << "[SKIP] Cannot create surfaces: " << SDL_GetError() << std::endl;
+        return 0;
+    }
+    struct Placement { int x, y, shadow; float scale; };
+    const Placement placements[] = {
+        { 10, 10, 0, 1.0f }, { 1, 2, 0, 1.0f }, { 36, 30, 0, 1.0f }, { 12, 12, -1, 1.0f },
+        { 15, 14, 0, 2.0f }, { 15, 14, 0, 1.5f }, { 20, 16, 2, 1.25f }, { 5, 5, 0, 0.5f }, { 38, 1, 0, 1.75f }
+    };
+    for (size_t i = 0; i < sprites.size(); ++i) {
+        SpriteCache::Sprite sp;
+        bool found = cache.get(static_cast<int>(i), sp);
+        Check(found && sp.x == sprites[i].xs && sp.y == sprites[i].ys && sp.h == static_cast<int>(sprites[i].rows.size()),
+              "Sprite " + std::to_string(i) + " header");
+        for (const Placement& p : placements) {
+            Clear(expected);
+            Clear(actual);
+            GraphicsUtils::DrawRLE8(expected, p.x, p.y, encoded[i].data(), encoded[i].size(), p.shadow, p.scale);
+            GraphicsUtils::DrawIndexed8(actual, p.x, p.y, sp.w, sp.h, sp.x, sp.y, sp.stride, sp.pixels, sp.mask,
+                                        p.shadow, p.scale);
+            Check(found && SameSurface(expected, actual),
+                  "Sprite " + std::to_string(i) + " at (" + std::to_string(p.x) + "," + std::to_string(p.y) + ") scale " +
+                      std::to_string(p.scale) + " shadow " + std::to_string(p.shadow) + " matches DrawRLE8");
+        }
+    }
+    SpriteCache::Sprite last;
+    Clear(actual);
+    cache.get(2, last);
+    GraphicsUtils::DrawIndexed8(actual, 10, 10, last.w, last.h, last.x, last.y, last.stride, last.pixels, last.mask);
+    Check(GraphicsUtils::GetPixel(actual, 13, 10) == GraphicsUtils::getPaletteColor(40) &&
+          GraphicsUtils::GetPixel(actual, 12, 10) == 0, "Skipped pixels stay transparent");
+    SDL_DestroySurface(expected);
+    SDL_DestroySurface(actual);
+    cache.close();
+
+    // 缓存失效: 在缓存的位图区留一个记号，重建后记号消失，直接使用时记号还在
+    auto markCache = [&] {
+        std::vector<uint8_t> bytes = ReadAll(cachePath);
+        bytes.back() ^= 0x5A;
+        WriteFile(cachePath, bytes);
+        return bytes.back();
+    };
+    auto cacheKept = [&](uint8_t mark) {
+        std::vector<uint8_t> bytes = ReadAll(cachePath);
+        return !bytes.empty() && bytes.back() == mark;
+    };
+    auto bumpMtime = [&](const fs::path& path) {
+        fs::last_write_time(path, fs::last_write_time(path) + std::chrono::seconds(5));
+    };
+
+    uint8_t mark = markCache();
+    Check(cache.openRLE(grp.string(), idx.string(), cacheName) && cacheKept(mark), "Unchanged sources reuse the cache");
+    cache.close();
+
+    bumpMtime(grp);
+    Check(cache.openRLE(grp.string(), idx.string(), cacheName) && cacheKept(mark),
+          "Newer mtime with the same content: hash matches, cache reused");
+    cache.close();
+
+    // 缓存头里的哈希不对 (修改时间也对不上时才会校验)
+    {
+        std::vector<uint8_t> bytes = ReadAll(cachePath);
+        const size_t hashOffset = 8 + 4 * 4 + 8 + 8; // magic, version/kind/count/reserved, srcSize, srcMtime
+        bytes[hashOffset] ^= 0xFF;
+        WriteFile(cachePath, bytes);
+    }
+    bumpMtime(grp);
+    Check(cache.openRLE(grp.string(), idx.string(), cacheName) && !cacheKept(mark), "Stale hash forces a rebuild");
+    cache.close();
+
+    // 大小相同、内容不同
+    mark = markCache();
+    sprites[2].rows[0][3] = 41;
+    WriteArchive(grp, idx, sprites, encoded);
+    bumpMtime(grp);
+    SpriteCache::Sprite changed;
+    Check(cache.openRLE(grp.string(), idx.string(), cacheName) && !cacheKept(mark) && cache.get(2, changed) &&
+          changed.pixels[3] == 41, "Changed content with the same size forces a rebuild");
+    cache.close();
+
+    // 大小变了: 即使修改时间碰巧相同也重建
+    mark = markCache();
+    auto oldTime = fs::last_write_time(grp);
+    sprites[2].rows[0].push_back(42);
+    WriteArchive(grp, idx, sprites, encoded);
+    fs::last_write_time(grp, oldTime);
+    Check(cache.openRLE(grp.string(), idx.string(), cacheName) && !cacheKept(mark) && cache.get(2, changed) &&
+          changed.w == 5, "Changed size forces a rebuild");
+    cache.close();
+
+    fs::remove(cachePath);
+    std::error_code ec;
+    fs::remove(SpriteCache::CACHE_DIR, ec); // 只在为空时删除
+    fs::remove_all(root);
+    return g_failures == 0 ? 0 : 1;
+}
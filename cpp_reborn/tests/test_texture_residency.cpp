@@ -0,0 +1,67 @@
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include "TextureResidency.h"
+
+static int g_failures = 0;
+
+static void Check(bool cond, const std::string& msg) {
+    if (cond) {
+        std::cout << "[PASS] " << msg << std::endl;
+    } else {
+        std::cout << "[FAIL] " << msg << std::endl;
+        ++g_failures;
+    }
+}
+
+int main() {
+    // 软件渲染器即可创建纹理，不需要窗口
+    SDL_Surface* target = SDL_CreateSurface(64, 64, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = target ? SDL_CreateSoftwareRenderer(target) : nullptr;
+    if (!renderer) {
+        std::cout << "[SKIP] No software renderer: " << SDL_GetError() << std::endl;
+        return 0;
+    }
+
+    const uint64_t idle = 5000;
+    int loaderCalls = 0;
+    TextureResidency residency;
+    residency.init(3, [&](int slot) -> SDL_Texture* {
+        ++loaderCalls;
+        if (slot == 2) return nullptr; // 缺失的贴图
+        return SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, 16, 8);
+    }, idle);
+
+    Check(residency.residentCount() == 0, "Nothing is resident before first use");
+
+    SDL_Texture* a = residency.acquire(0);
+    SDL_Texture* b = residency.acquire(0);
+    Check(a && a == b, "Second acquire reuses the resident texture");
+    Check(residency.stats(0).loads == 1 && residency.stats(0).hits == 1, "Stats count one load and one hit");
+    Check(residency.stats(0).bytes == 16 * 8 * 4, "Resident size is tracked");
+
+    Check(residency.acquire(2) == nullptr && residency.acquire(2) == nullptr, "Missing slot returns nullptr");
+    Check(loaderCalls == 2, "Missing slot is not reloaded every frame");
+    Check(residency.acquire(7) == nullptr, "Out-of-range slot returns nullptr");
+
+    residency.acquire(1);
+    uint64_t earliest = std::min(residency.stats(0).lastUsedMs, residency.stats(1).lastUsedMs);
+    uint64_t latest = std::max(residency.stats(0).lastUsedMs, residency.stats(1).lastUsedMs);
+    Check(residency.trim(earliest + idle - 1) == 0, "Recently used textures stay resident");
+    Check(residency.residentCount() == 2, "Two textures resident");
+
+    Check(residency.trim(latest + idle) == 2, "Idle textures are released");
+    Check(residency.residentCount() == 0 && residency.residentBytes() == 0, "Nothing resident after trim");
+    Check(residency.stats(0).evictions == 1, "Eviction is counted");
+
+    Check(residency.acquire(0) != nullptr && residency.stats(0).loads == 2, "Released texture reloads on next use");
+
+    std::ostringstream report;
+    residency.printStats(report);
+    Check(report.str().find("loads=2") != std::string::npos, "Stats report lists per-slot loads");
+
+    residency.releaseAll();
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroySurface(target);
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,117 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include "TileLayer.h"
+
+namespace fs = std::filesystem;
+
+static int g_failures = 0;
+
+static void Check(bool cond, const std::string& msg) {
+    if (cond) {
+        std::cout << "[PASS] " << msg << std::endl;
+    } else {
+        std::cout << "[FAIL] " << msg << std::endl;
+        ++g_failures;
+    }
+}
+
+static bool SameTiles(const TileLayer& layer, const std::vector<int16_t>& tiles) {
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        if (layer.get(i) != tiles[i]) return false;
+    }
+    std::vector<int16_t> out(tiles.size());
+    layer.copyTo(out.data());
+    return out == tiles;
+}
+
+int main() {
+    const size_t N = 64 * 64;
+
+    // 事件层: 全是 -1，零星几个事件号
+    std::vector<int16_t> events(N, -1);
+    events[5] = 0;
+    events[1000] = 7;
+    events[N - 1] = 199;
+    TileLayer sparse;
+    sparse.assign(events.data(), N);
+    Check(sparse.kind() == TileLayer::Kind::Sparse, "Mostly -1 layer is stored sparse");
+    Check(SameTiles(sparse, events), "Sparse layer round-trips");
+    Check(sparse.memoryBytes() * 8 < N * sizeof(int16_t), "Sparse layer is far smaller than dense");
+
+    // 装饰层: 几大片相同值
+    std::vector<int16_t> runs(N, 0);
+    for (size_t i = 1024; i < 2048; ++i) runs[i] = 12;
+    for (size_t i = 3000; i < N; ++i) runs[i] = 40;
+    TileLayer rle;
+    rle.assign(runs.data(), N);
+    Check(rle.kind() == TileLayer::Kind::Sparse || rle.kind() == TileLayer::Kind::Runs, "Large blocks are not dense");
+    for (size_t i = 1024; i < 2048; i += 2) runs[i] = 13; // 交错: 稀疏不划算
+    rle.assign(runs.data(), N);
+    Check(rle.kind() == TileLayer::Kind::Dense, "Alternating tiles stay dense");
+    for (size_t i = 1024; i < 2048; ++i) runs[i] = 12;
+    for (size_t i = 0; i < 1024; ++i) runs[i] = static_cast<int16_t>(i / 64); // 16 段
+    rle.assign(runs.data(), N);
+    Check(rle.kind() == TileLayer::Kind::Runs, "Banded layer is stored as runs");
+    Check(SameTiles(rle, runs), "Run-length layer round-trips");
+
+    // 地面层: 每格不同
+    std::vector<int16_t> ground(N);
+    for (size_t i = 0; i < N; ++i) ground[i] = static_cast<int16_t>(i * 7);
+    TileLayer dense;
+    dense.assign(ground.data(), N);
+    Check(dense.kind() == TileLayer::Kind::Dense && SameTiles(dense, ground), "Varied layer stays dense");
+
+    // 写入: 相同值不展开，不同值展开为 Dense，compact 后恢复
+    sparse.set(5, 0);
+    Check(sparse.kind() == TileLayer::Kind::Sparse, "Writing an identical value keeps the layer compact");
+    sparse.set(6, 3);
+    events[6] = 3;
+    Check(sparse.kind() == TileLayer::Kind::Dense && SameTiles(sparse, events), "Write expands to dense");
+    sparse.compact();
+    Check(sparse.kind() == TileLayer::Kind::Sparse && SameTiles(sparse, events), "Compact re-packs the layer");
+
+    // TileLayerFile: 2 个场景，每场景 2 层 4 格
+    const fs::path root = fs::absolute("test_tile_layer_tmp");
+    fs::remove_all(root);
+    fs::create_directories(root);
+    const fs::path file = root / "allsin.grp";
+    std::vector<int16_t> raw = { -1, -1, -1, -1, 1, 2, 3, 4, 0, 0, 0, 9, 5, 5, 5, 5 };
+    {
+        std::ofstream f(file, std::ios::binary);
+        f.write(reinterpret_cast<const char*>(raw.data()), raw.size() * sizeof(int16_t));
+    }
+    TileLayerFile pages(2, 4);
+    Check(pages.open(file.string(), 1) && pages.count() == 2, "Open layered file");
+    const TileLayer* s1 = pages.layers(1);
+    Check(s1 && s1[0].get(3) == 9 && s1[1].get(0) == 5, "Scene layers paged in");
+    pages.modifyLayers(1)[0].set(0, 8);
+    Check(pages.save(file.string()), "Save layered file");
+    std::ifstream in(file, std::ios::binary);
+    std::vector<int16_t> back(raw.size());
+    in.read(reinterpret_cast<char*>(back.data()), back.size() * sizeof(int16_t));
+    raw[8] = 8;
+    Check(back == raw, "Modified layer written back in original layout");
+    in.close();
+
+    // InterleavedTileFile: 同一文件，一格的两层相邻
+    InterleavedTileFile tiles(2, 4);
+    Check(tiles.open(file.string(), 1) && tiles.count() == 2, "Open interleaved file");
+    const int16_t* t3 = tiles.tile(1, 3);
+    Check(t3 && t3[0] == 9 && t3[1] == 5, "Tile record holds every layer");
+    const int16_t* t0 = tiles.tile(0, 1);
+    Check(t0 && t0[0] == -1 && t0[1] == 2, "Record of another scene");
+    tiles.modifyTile(1, 2)[1] = 7;
+    Check(tiles.isDirty(1) && !tiles.isDirty(0), "modifyTile marks the scene dirty");
+    Check(tiles.save(file.string()), "Save interleaved file");
+    in.open(file, std::ios::binary);
+    in.read(reinterpret_cast<char*>(back.data()), back.size() * sizeof(int16_t));
+    raw[14] = 7;
+    Check(back == raw, "Interleaved record written back in original layout");
+    in.close();
+    fs::remove_all(root);
+
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,122 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include "VirtualFS.h"
+#include "GroupFile.h"
+#include "ResourcePack.h"
+
+namespace fs = std::filesystem;
+
+static int g_failures = 0;
+
+static void Check(bool cond, const std::string& msg) {
+    if (cond) {
+        std::cout << "[PASS] " << msg << std::endl;
+    } else {
+        std::cout << "[FAIL] " << msg << std::endl;
+        ++g_failures;
+    }
+}
+
+static void WriteFile(const fs::path& path, const std::string& text) {
+    fs::create_directories(path.parent_path());
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    f.write(text.data(), text.size());
+}
+
+static std::string AsString(const MappedFile& file) {
+    return std::string(reinterpret_cast<const char*>(file.data()), file.size());
+}
+
+int main() {
+    const fs::path root = fs::absolute("test_vfs_tmp");
+    fs::remove_all(root);
+
+    // base: 两个文件 + 一个子目录
+    WriteFile(root / "base" / "Begin.Pic", "base-begin");
+    WriteFile(root / "base" / "kdef.grp", "AAAABBBBBB");
+    WriteFile(root / "base" / "sub" / "a.txt", "base-a");
+
+    // mod1 (目录): 覆盖 Begin.Pic，并单独替换 kdef.grp 的记录 1 和追加记录 3
+    WriteFile(root / "mods" / "mod1" / "begin.pic", "mod1-begin");
+    WriteFile(root / "mods" / "mod1" / "kdef.grp.d" / "1.bin", "XY");
+    WriteFile(root / "mods" / "mod1" / "kdef.grp.d" / "3", "ZZZ");
+
+    // mod2 (资源包): 覆盖 sub/a.txt
+    WriteFile(root / "staging" / "a.txt", "mod2-a");
+    std::vector<ResourcePack::BuildInput> inputs = { { "sub/a.txt", (root / "staging" / "a.txt").string() } };
+    Check(ResourcePack::write((root / "mods" / "mod2.pak").string(), inputs, false), "Build mod2.pak");
+
+    auto mods = VirtualFS::discoverMods((root / "mods").string());
+    Check(mods.size() == 2 && mods[0].find("mod1") != std::string::npos, "Mods discovered in name order");
+
+    VirtualFS vfs;
+    Check(vfs.mount((root / "base").string()), "Mount base directory");
+    for (const auto& m : mods) vfs.mount(m);
+    Check(vfs.layerCount() == 3, "Three layers mounted");
+    Check(!vfs.mount((root / "missing").string()), "Missing layer is rejected");
+
+    const VirtualFS::Entry* begin = vfs.find("BEGIN.PIC");
+    Check(begin && begin->layer == 1 && AsString(vfs.map(*begin)) == "mod1-begin", "Upper directory layer overrides base");
+
+    const VirtualFS::Entry* a = vfs.find("sub\\a.txt");
+    Check(a && a->path.empty() && AsString(vfs.map(*a)) == "mod2-a", "Pack layer overrides loose file");
+    Check(vfs.layerShadowedFiles(1) == 1 && vfs.layerShadowedFiles(2) == 1 && vfs.layerShadowedFiles(0) == 0,
+          "Loose files hidden by each layer counted");
+
+    // --dev: 读入内存的文件不受之后的截断影响
+    MappedFile held = MappedFile::read((root / "base" / "sub" / "a.txt").string());
+    WriteFile(root / "base" / "sub" / "a.txt", "");
+    Check(!held.isMapped() && AsString(held) == "base-a", "Heap copy survives truncation on disk");
+    WriteFile(root / "base" / "sub" / "a.txt", "base-a");
+
+    const VirtualFS::Entry* grp = vfs.find("kdef.grp");
+    Check(grp && grp->layer == 0, "Untouched files resolve to base");
+    Check(vfs.find("nothing.here") == nullptr, "Unknown names are not found");
+
+    // 记录级覆盖
+    const VirtualFS::RecordOverrides* rec = vfs.recordOverrides("kdef.grp");
+    Check(rec && rec->size() == 2 && rec->count(1) && rec->count(3), "Record overrides collected");
+
+    std::map<int, MappedFile> overrides;
+    for (const auto& kv : *rec) overrides[kv.first] = vfs.map(kv.second);
+    GroupFile file(vfs.map(*grp), { 4, 4, 10 }, std::move(overrides));
+    Check(file.count() == 4, "Override past the end appends a record");
+    Check(AsString(file.record(0)) == "AAAA", "Base record kept");
+    Check(AsString(file.record(1)) == "XY" && file.isOverridden(1), "Record 1 replaced");
+    Check(AsString(file.record(2)) == "BBBBBB", "Base record after override kept");
+    Check(AsString(file.record(3)) == "ZZZ", "Appended record readable");
+    Check(AsString(file.recordFrom(0, 6)) == "AAAABB", "recordFrom reads past the record end");
+    Check(AsString(file.recordFrom(1, 6)) == "XY", "recordFrom of an override stays inside it");
+
+    MappedFile flatGrp, flatIdx;
+    file.flatten(flatGrp, flatIdx);
+    auto ends = flatIdx.as<int32_t>();
+    Check(AsString(flatGrp) == "AAAAXYBBBBBBZZZ", "Flattened grp splices overrides");
+    Check(ends.size() == 4 && ends[0] == 4 && ends[1] == 6 && ends[2] == 12 && ends[3] == 15, "Flattened idx end offsets");
+    Check(!flatIdx.isMapped() && !ends.isMapped(), "Flattened idx is reported as heap memory");
+
+    GroupFile plain(vfs.map(*grp), { 4, 4, 10 });
+    plain.flatten(flatGrp, flatIdx);
+    Check(flatGrp.data() == plain.data().data(), "Flatten without overrides is zero-copy");
+
+    // 上层整个替换 kdef.grp: mod1 的记录覆盖不再套在新 grp 上，同层的覆盖保留
+    WriteFile(root / "mod3" / "kdef.grp", "CCCCDDDD");
+    WriteFile(root / "mod3" / "kdef.grp.d" / "2.bin", "W");
+    VirtualFS layered;
+    layered.mount((root / "base").string());
+    layered.mount(mods[0]);
+    layered.mount((root / "mod3").string());
+    const VirtualFS::RecordOverrides* upper = layered.recordOverrides("kdef.grp");
+    Check(layered.find("kdef.grp")->layer == 2 && upper && upper->size() == 1 && upper->count(2) &&
+          upper->at(2).layer == 2, "Whole grp from an upper layer drops lower record overrides");
+    VirtualFS replaced;
+    replaced.mount(mods[0]);
+    replaced.mount((root / "base").string());
+    Check(replaced.recordOverrides("kdef.grp") == nullptr, "No overrides left for a replaced grp");
+
+    fs::remove_all(root);
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,65 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "WorldMap.h"
+
+static int g_failures = 0;
+
+static void Check(bool cond, const std::string& msg) {
+    if (cond) {
+        std::cout << "[PASS] " << msg << std::endl;
+    } else {
+        std::cout << "[FAIL] " << msg << std::endl;
+        ++g_failures;
+    }
+}
+
+int main() {
+    const size_t N = WorldMap::SIZE * WorldMap::SIZE;
+    auto index = [](int x, int y) { return static_cast<size_t>(x) * WorldMap::SIZE + y; };
+
+    std::vector<int16_t> earth(N, 100), surface(N, 0), building(N, 0), buildX(N, 0), buildY(N, 0);
+    earth[index(10, 10)] = 360;      // 水面
+    earth[index(11, 10)] = 620;      // 深水 (不可走)
+    buildX[index(12, 10)] = 3;       // 建筑占位
+    surface[index(13, 10)] = 1695;   // 障碍
+    surface[index(14, 10)] = 1695;
+    buildX[index(14, 10)] = 3;
+    surface[index(15, 10)] = 865 * 2; // 桥: 总是可走
+    buildX[index(15, 10)] = 3;
+    building[index(16, 10)] = 42;
+
+    WorldMap map;
+    Check(map.tile(0, 0) == nullptr, "No tiles before load");
+    map.assign(earth, surface, building, buildX, buildY);
+    Check(map.isLoaded(), "Map assigned");
+    Check(map.tile(-1, 0) == nullptr && map.tile(0, WorldMap::SIZE) == nullptr, "Out of range tiles");
+
+    const WorldTile* plain = map.tile(20, 20);
+    Check(plain && (plain->flags & WorldMap::WALKABLE) && !(plain->flags & WorldMap::WATER), "Plain ground is walkable");
+    Check(!(map.tile(0, 20)->flags & WorldMap::WALKABLE), "Map border is blocked");
+    Check((map.tile(10, 10)->flags & WorldMap::WATER) && (map.tile(10, 10)->flags & WorldMap::WALKABLE), "Shallow water: ship");
+    Check((map.tile(11, 10)->flags & WorldMap::WATER) && !(map.tile(11, 10)->flags & WorldMap::WALKABLE), "Deep water blocked");
+    Check(!(map.tile(12, 10)->flags & WorldMap::WALKABLE), "BuildX blocks");
+    Check(!(map.tile(13, 10)->flags & WorldMap::WALKABLE), "Obstacle surface blocks");
+    Check(map.tile(15, 10)->flags & WorldMap::WALKABLE, "Bridge surface overrides blockers");
+    Check(map.tile(16, 10)->building == 42 && map.tile(16, 10)->earth == 100, "All layers in one record");
+
+    SceneTable scenes(2);
+    scenes[1].getRawData()[11] = 30; // MainEntranceX1
+    scenes[1].getRawData()[10] = 40; // MainEntranceY1
+    scenes[1].getRawData()[13] = 31; // MainEntranceX2
+    scenes[1].getRawData()[12] = 41; // MainEntranceY2
+    scenes[0].getRawData()[11] = -1;
+    scenes[0].getRawData()[10] = -1;
+    scenes[0].getRawData()[13] = 0;
+    scenes[0].getRawData()[12] = 0;
+    map.resetEntrances(scenes);
+    Check(map.tile(30, 40)->entrance == 1 && map.tile(31, 41)->entrance == 1, "Scene entrances marked");
+    Check(map.tile(0, 0)->entrance == 0 && map.tile(20, 20)->entrance == -1, "Other tiles have no entrance");
+
+    map.assign(earth, surface, building, buildX, buildY);
+    Check(map.tile(30, 40)->entrance == 1, "Reloading layers keeps entrances");
+
+    return g_failures == 0 ? 0 : 1;
+}